@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LuaCallBenchmark.h"
+
+#include "TestUtils.h"
+
+#include "../zap/luaLevelGenerator.h"
+#include "../zap/ServerGame.h"
+
+#include "../zap/stringUtils.h"
+
+#include "tnlPlatform.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+// Set up once, outside the timed loop
+static const char *setupCode =
+   "local item = ResourceItem.new(point.new(0, 0)) "
+   "local p = point.new(1, 2) "
+   "local a1, a2, b1, b2 = point.new(0, 0), point.new(2, 2), point.new(0, 2), point.new(2, 0) ";
+
+static const char *calls[] = {
+   "item:getPos()",                             // No arguments to check
+   "item:setPos(p)",                            // Near the top of BfObject's function table
+   "item:setSelected(false)",                   // Near the bottom of it
+   "Geom.segmentsIntersect(a1, a2, b1, b2)",    // Module function, found through the module's profile map
+};
+
+
+bool LuaCallBenchmark::run(U32 callCount, Vector<Result> &results, string &errorMessage)
+{
+   ServerGame *serverGame = newServerGame();
+
+   if(!LuaScriptRunner::startLua(serverGame->getSettings()->getFolderManager()->luaDir))
+   {
+      delete serverGame;
+      errorMessage = "Could not start Lua";
+      return false;
+   }
+
+   bool ok = true;
+
+   // Scoped so the levelgen is gone before we shut Lua down
+   {
+      LuaLevelGenerator levelgen(serverGame);
+      ok = levelgen.prepareEnvironment();
+
+      results.clear();
+
+      for(U32 i = 0; ok && i < ARRAYSIZE(calls); i++)
+      {
+         string code = string(setupCode) + "for i = 1, " + itos(callCount) + " do " + calls[i] + " end";
+
+         S64 start = Platform::getHighPrecisionTimerValue();
+         ok = levelgen.runString(code);
+         F64 ms = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+         Result result;
+         result.call = calls[i];
+         result.nsPerCall = ms * 1000000 / callCount;
+         results.push_back(result);
+      }
+
+      if(!ok)
+         errorMessage = "Benchmark script failed; see the log for details";
+   }
+
+   LuaScriptRunner::shutdown();
+   delete serverGame;
+
+   return ok;
+}
+
+
+void LuaCallBenchmark::printResults(U32 callCount, const Vector<Result> &results)
+{
+   printf("Lua calls, %u of each\n", callCount);
+
+   for(S32 i = 0; i < results.size(); i++)
+      printf("  %-45s %8.1f ns/call\n", results[i].call.c_str(), results[i].nsPerCall);
+}
+
+
+};
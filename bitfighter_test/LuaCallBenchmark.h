@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LUA_CALL_BENCHMARK_H_
+#define _LUA_CALL_BENCHMARK_H_
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <string>
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+
+// Times calls from a levelgen script into a handful of our Lua-bound functions, to see what a script pays for each
+// trip into C++.  Each call is made in a tight Lua loop, so what's measured is the binding overhead -- LuaWrapper
+// unwrapping the object, and checkArgList() matching the arguments -- plus whatever little work the function does.
+// getPos() takes no arguments and skips checkArgList(), so it's the floor the others can be compared against.
+class LuaCallBenchmark
+{
+public:
+   struct Result
+   {
+      string call;
+      F64 nsPerCall;
+   };
+
+   static bool run(U32 calls, Vector<Result> &results, string &errorMessage);
+
+   static void printResults(U32 calls, const Vector<Result> &results);
+};
+
+
+};
+
+#endif
@@ -0,0 +1,274 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ServerBenchmark.h"
+
+#include "TestUtils.h"
+
+#include "../zap/ClientGame.h"
+#include "../zap/ClientInfo.h"
+#include "../zap/config.h"
+#include "../zap/GameManager.h"
+#include "../zap/gameConnection.h"
+#include "../zap/ObjectPool.h"
+#include "../zap/ServerGame.h"
+#include "../zap/UIGame.h"
+#include "../zap/UIManager.h"
+
+#include "../zap/stringUtils.h"
+
+#include "tnlRandom.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+// Constructor
+ServerBenchmark::Options::Options()
+{
+   levelFile = "ctf.level";
+   robots = 8;
+   clients = 0;
+   warmupTicks = 200;
+   ticks = 6000;
+   timeDelta = 10;
+   seed = 1;
+}
+
+
+// Constructor
+ServerBenchmark::ServerBenchmark(const Options &options)
+{
+   mOptions = options;
+}
+
+
+static U64 getPooledAllocationCount()
+{
+   U64 count = 0;
+
+   for(ObjectPool *pool = ObjectPool::getFirstPool(); pool; pool = pool->getNextPool())
+      count += pool->getAllocCount();
+
+   return count;
+}
+
+
+// Sums the traffic on the server's end of each human connection
+static void getServerTraffic(ServerGame *server, U64 &bytesSent, U64 &bytesReceived)
+{
+   bytesSent = 0;
+   bytesReceived = 0;
+
+   for(S32 i = 0; i < server->getClientCount(); i++)
+   {
+      ClientInfo *clientInfo = server->getClientInfo(i);
+
+      if(clientInfo->isRobot() || !clientInfo->getConnection())
+         continue;
+
+      bytesSent     += clientInfo->getConnection()->mPacketSendBytesTotal;
+      bytesReceived += clientInfo->getConnection()->mPacketRecvBytesTotal;
+   }
+}
+
+
+// Plays the part of the person at the keyboard for each fake client.  Key states are global, so this
+// has to be done for each client right before it idles.
+static void scriptClient(ClientGame *client, S32 index, U32 tick)
+{
+   static const S32 TicksPerLeg = 300;
+
+   GameSettings *settings = client->getSettings();
+
+   // Clockwise round the compass, each client starting at a different point
+   S32 leg = (tick / TicksPerLeg + index) % 4;
+
+   InputCodeManager::setState(UserInterface::getInputCode(settings, BINDING_UP),    leg == 0);
+   InputCodeManager::setState(UserInterface::getInputCode(settings, BINDING_RIGHT), leg == 1);
+   InputCodeManager::setState(UserInterface::getInputCode(settings, BINDING_DOWN),  leg == 2);
+   InputCodeManager::setState(UserInterface::getInputCode(settings, BINDING_LEFT),  leg == 3);
+}
+
+
+void ServerBenchmark::scriptClients(U32 tick)
+{
+   const Vector<ClientGame *> *clients = GameManager::getClientGames();
+
+   for(S32 i = 0; i < clients->size(); i++)
+   {
+      scriptClient(clients->get(i), i, tick);
+      clients->get(i)->idle(mOptions.timeDelta);
+   }
+
+   InputCodeManager::resetStates();
+}
+
+
+bool ServerBenchmark::run(Results &results, string &errorMessage)
+{
+   FolderManager folderManager;
+   string levelFile = joindir(joindir(folderManager.rootDataDir, "levels"), mOptions.levelFile);
+   string levelCode = readFile(levelFile);
+
+   if(levelCode == "")
+   {
+      errorMessage = "Could not read level file " + levelFile;
+      return false;
+   }
+
+   GamePair gamePair(levelCode, 0);
+   ServerGame *server = gamePair.server;
+
+   server->setAutoLeveling(false);     // We want the bots we asked for, no more and no less
+
+   for(S32 i = 0; i < mOptions.clients; i++)
+   {
+      gamePair.addClient("BenchPlayer" + itos(i));
+
+      ClientGame *client = gamePair.getClient(i);
+      UIManager *uiManager = client->getUIManager();
+
+      if(!uiManager->isCurrentUI<GameUserInterface>())
+         uiManager->activate<GameUserInterface>();
+
+      // Keep the trigger down for the whole run
+      uiManager->getUI<GameUserInterface>()->onKeyDown(UserInterface::getInputCode(client->getSettings(), BINDING_FIRE));
+   }
+
+   // Hosting and logging in both stir the time into the random number generator, so seed it once they're done
+   TNL::Random::setSeed(mOptions.seed);
+
+   // Bot arguments are [team] [script]; leaving the team up to the game
+   string noTeam = itos(NO_TEAM);
+   Vector<const char *> botArgs;
+
+   if(mOptions.robotScript != "")
+   {
+      botArgs.push_back(noTeam.c_str());
+      botArgs.push_back(mOptions.robotScript.c_str());
+   }
+
+   for(S32 i = 0; i < mOptions.robots; i++)
+   {
+      string error = server->addBot(botArgs, ClientInfo::ClassRobotAddedByAddbots);
+
+      if(error != "")
+      {
+         errorMessage = error;
+         return false;
+      }
+   }
+
+   server->unsuspendGame(false);      // A server with only robots on it would otherwise sit there doing nothing
+
+   U32 tick = 0;
+
+   for(U32 i = 0; i < mOptions.warmupTicks; i++, tick++)
+   {
+      GameManager::idleServerGame(mOptions.timeDelta);
+      scriptClients(tick);
+   }
+
+   TickProfiler *profiler = server->getTickProfiler();
+   profiler->reset();
+
+   U64 startBytesSent, startBytesReceived;
+   getServerTraffic(server, startBytesSent, startBytesReceived);
+
+   U64 startPooled = getPooledAllocationCount();
+
+   S64 serverTime = 0;
+   U64 allocations = 0;
+
+   for(U32 i = 0; i < mOptions.ticks; i++, tick++)
+   {
+      U64 startAllocations = getAllocationCount();
+      S64 start = Platform::getHighPrecisionTimerValue();
+
+      GameManager::idleServerGame(mOptions.timeDelta);
+
+      serverTime  += Platform::getHighPrecisionTimerValue() - start;
+      allocations += getAllocationCount() - startAllocations;
+
+      scriptClients(tick);
+   }
+
+   U64 endBytesSent, endBytesReceived;
+   getServerTraffic(server, endBytesSent, endBytesReceived);
+
+   F64 simulatedSeconds = F64(mOptions.ticks) * mOptions.timeDelta / 1000;
+
+   results.ticks = mOptions.ticks;
+   results.serverMs = Platform::getHighPrecisionMilliseconds(serverTime);
+   results.ticksPerSecond = results.serverMs > 0 ? mOptions.ticks * 1000 / results.serverMs : 0;
+   results.bytesPerClientPerSecond = mOptions.clients > 0 ? (endBytesSent - startBytesSent) / simulatedSeconds / mOptions.clients : 0;
+   results.bytesReceivedPerSecond = (endBytesReceived - startBytesReceived) / simulatedSeconds;
+   results.allocations = allocations;
+   results.pooledAllocations = getPooledAllocationCount() - startPooled;
+
+   TickProfiler::ZoneStats scriptStats = profiler->getStats(TickProfiler::StageScripts);
+   results.scriptMs = F64(scriptStats.mean) * scriptStats.samples;
+
+   results.zones.clear();
+   results.zoneStats.clear();
+
+   for(U32 i = 0; i < TickProfiler::getZoneCount(); i++)
+   {
+      TickProfiler::ZoneStats stats = profiler->getStats(i);
+
+      if(stats.samples > 0)
+      {
+         results.zones.push_back(i);
+         results.zoneStats.push_back(stats);
+      }
+   }
+
+   return true;
+}
+
+
+void ServerBenchmark::printResults(const Options &options, const Results &results)
+{
+   printf("Level %s, %d robots (%s), %d clients, %u ticks of %u ms, seed %u\n", options.levelFile.c_str(),
+          options.robots, options.robotScript == "" ? "default bot" : options.robotScript.c_str(), options.clients,
+          results.ticks, options.timeDelta, options.seed);
+
+   printf("  %.0f ticks/sec (%.1f ms of server time)\n", results.ticksPerSecond, results.serverMs);
+   printf("  %.0f bytes/sec sent per client, %.0f bytes/sec received from all clients\n",
+          results.bytesPerClientPerSecond, results.bytesReceivedPerSecond);
+   printf("  %llu allocations (%.1f per tick), %llu from object pools\n", results.allocations,
+          results.ticks > 0 ? F64(results.allocations) / results.ticks : 0.0, results.pooledAllocations);
+
+   // How many bots one core could keep thinking in real time, if thinking were all it had to do
+   F64 simulatedMs = F64(results.ticks) * options.timeDelta;
+
+   if(options.robots > 0 && results.scriptMs > 0)
+   {
+      F64 thinkShare = results.scriptMs / simulatedMs / options.robots;    // Fraction of a core each bot needs
+      printf("  %.3f ms thinking per robot per simulated second, or %.0f bots/core\n", thinkShare * 1000, 1 / thinkShare);
+   }
+
+   if(results.zones.size() == 0)
+   {
+      printf("  No tick profile; was this built with BF_NO_TICK_PROFILER?\n");
+      return;
+   }
+
+   printf("  %-20s %10s %10s %10s %10s   (ms, percentiles over the last %d ticks)\n",
+          "zone", "mean", "p50", "p99", "max", TickProfiler::HistoryLength);
+
+   for(S32 i = 0; i < results.zones.size(); i++)
+   {
+      const TickProfiler::ZoneStats &stats = results.zoneStats[i];
+
+      printf("  %-20s %10.4f %10.4f %10.4f %10.4f\n", TickProfiler::getZoneName(results.zones[i]),
+             stats.mean, stats.p50, stats.p99, stats.max);
+   }
+}
+
+
+};
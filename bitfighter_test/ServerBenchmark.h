@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _SERVER_BENCHMARK_H_
+#define _SERVER_BENCHMARK_H_
+
+#include "TickProfiler.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <string>
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+U64 getAllocationCount();     // Heap allocations since startup; provided by the benchmark's main
+
+
+// Runs a ServerGame for a fixed number of ticks, on a fixed timestep, with robots and/or fake clients connected
+// over loopback, and reports how fast the server got through them.  Everything that feeds the simulation is
+// either seeded or fixed, so two runs on the same build play out the same game, and two builds can be compared.
+//
+// Fake clients are real ClientGames with a script standing in for the player: each one flies a square, holding
+// up, right, down, then left for a few seconds at a time, and keeps its trigger held down.
+class ServerBenchmark
+{
+public:
+   struct Options
+   {
+      string levelFile;       // Relative to the levels folder
+      S32 robots;
+      string robotScript;     // Empty for the server's default bot; "native:s_bot" pits the C++ port against the script
+      S32 clients;
+      U32 warmupTicks;        // Run, but not measured, to get past level loading and spawning
+      U32 ticks;
+      U32 timeDelta;          // Simulated ms per tick
+      U32 seed;
+
+      Options();              // Constructor
+   };
+
+   struct Results
+   {
+      U32 ticks;
+      F64 serverMs;                   // Wall clock time spent in ServerGame::idle
+      F64 ticksPerSecond;             // ...or how many ticks the server could run in a real second
+      F64 bytesPerClientPerSecond;    // Sent by the server, per fake client, per simulated second
+      F64 bytesReceivedPerSecond;     // From all fake clients, per simulated second
+      U64 allocations;                // Heap allocations made during the server's ticks
+      U64 pooledAllocations;          // Objects handed out by the object pools during the same ticks
+      F64 scriptMs;                   // Time in the scripts stage, which is where the bots do their thinking
+
+      Vector<U32> zones;                          // Tick profiler zones with samples, stages first
+      Vector<TickProfiler::ZoneStats> zoneStats;
+   };
+
+private:
+   Options mOptions;
+
+   void scriptClients(U32 tick);
+
+public:
+   explicit ServerBenchmark(const Options &options);    // Constructor
+
+   bool run(Results &results, string &errorMessage);
+
+   static void printResults(const Options &options, const Results &results);
+};
+
+
+};
+
+#endif
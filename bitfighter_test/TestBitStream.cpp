@@ -0,0 +1,442 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "tnlBitStream.h"
+#include "tnlPlatform.h"
+#include "Point.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <string>
+
+namespace Zap
+{
+
+using namespace TNL;
+using namespace std;
+
+
+// Cheap deterministic generator so failures are reproducible
+static U32 nextRand(U32 &seed)
+{
+   seed = seed * 1664525 + 1013904223;
+   return seed >> 8;
+}
+
+
+// Writes value one bit at a time with writeFlag, which never touches more than a single byte.  That gives us a
+// reference encoding to hold the word-at-a-time paths against.
+static void writeReferenceBits(BitStream &s, U64 value, U32 bitCount)
+{
+   for(U32 i = 0; i < bitCount; i++)
+      s.writeFlag(((value >> i) & 1) != 0);
+}
+
+
+static U64 maskBits(U64 value, U32 bitCount)
+{
+   return bitCount == 64 ? value : value & ((U64(1) << bitCount) - 1);
+}
+
+
+TEST(BitStreamTest, IntRoundTripIsBitIdentical)
+{
+   const U32 BufferSize = 512;
+   U8 buffer[BufferSize];
+   U8 referenceBuffer[BufferSize];
+
+   memset(buffer, 0, sizeof(buffer));
+   memset(referenceBuffer, 0, sizeof(referenceBuffer));
+
+   BitStream s(buffer, BufferSize);
+   BitStream reference(referenceBuffer, BufferSize);
+
+   U32 seed = 1234;
+   Vector<U64> values;
+   Vector<U32> bitCounts;
+
+   // Keep going right up to the end of the buffer so the fallback near the end gets used too
+   while(true)
+   {
+      U32 bitCount = nextRand(seed) % 64 + 1;
+      U64 value = (U64(nextRand(seed)) << 40) ^ (U64(nextRand(seed)) << 20) ^ nextRand(seed);
+
+      if(s.getBitPosition() + bitCount > BufferSize * 8)
+         break;
+
+      if(bitCount <= 32)
+         s.writeInt(U32(value), U8(bitCount));
+      else
+         s.writeInt64(value, U8(bitCount));
+
+      writeReferenceBits(reference, value, bitCount);
+
+      values.push_back(maskBits(value, bitCount));
+      bitCounts.push_back(bitCount);
+   }
+
+   EXPECT_TRUE(s.isValid());
+   ASSERT_EQ(reference.getBitPosition(), s.getBitPosition());
+   EXPECT_EQ(0, memcmp(buffer, referenceBuffer, BufferSize));
+
+   s.setBitPosition(0);
+
+   for(S32 i = 0; i < values.size(); i++)
+   {
+      U64 value = bitCounts[i] <= 32 ? s.readInt(U8(bitCounts[i])) : s.readInt64(U8(bitCounts[i]));
+      ASSERT_EQ(values[i], value) << "Mismatch at value " << i << ", bitCount " << bitCounts[i];
+   }
+
+   EXPECT_TRUE(s.isValid());
+}
+
+
+TEST(BitStreamTest, BitsRoundTripIsBitIdentical)
+{
+   const U32 BufferSize = 256;
+   U8 buffer[BufferSize];
+   U8 referenceBuffer[BufferSize];
+
+   memset(buffer, 0, sizeof(buffer));
+   memset(referenceBuffer, 0, sizeof(referenceBuffer));
+
+   BitStream s(buffer, BufferSize);
+   BitStream reference(referenceBuffer, BufferSize);
+
+   U32 seed = 42;
+   U8 source[16];
+
+   // Odd sizes and offsets, on both sides of the 57 bit cutoff
+   for(U32 bitCount = 1; bitCount <= 96; bitCount += 5)
+   {
+      for(U32 i = 0; i < sizeof(source); i++)
+         source[i] = U8(nextRand(seed));
+
+      s.writeFlag(true);      // Knock the stream off byte alignment
+      reference.writeFlag(true);
+
+      s.writeBits(bitCount, source);
+
+      for(U32 i = 0; i < bitCount; i++)
+         reference.writeFlag((source[i >> 3] & (1 << (i & 0x7))) != 0);
+   }
+
+   ASSERT_EQ(reference.getBitPosition(), s.getBitPosition());
+   EXPECT_EQ(0, memcmp(buffer, referenceBuffer, BufferSize));
+
+   seed = 42;
+   s.setBitPosition(0);
+
+   for(U32 bitCount = 1; bitCount <= 96; bitCount += 5)
+   {
+      for(U32 i = 0; i < sizeof(source); i++)
+         source[i] = U8(nextRand(seed));
+
+      U8 dest[16];
+      memset(dest, 0, sizeof(dest));
+
+      EXPECT_TRUE(s.readFlag());
+      s.readBits(bitCount, dest);
+
+      for(U32 i = 0; i < bitCount; i++)
+         ASSERT_EQ((source[i >> 3] >> (i & 0x7)) & 1, (dest[i >> 3] >> (i & 0x7)) & 1) << "bitCount " << bitCount << ", bit " << i;
+   }
+}
+
+
+// writeIntAt patches values into the middle of a stream; the bits around the patch must not change
+TEST(BitStreamTest, WritesLeaveNeighboringBitsAlone)
+{
+   U8 buffer[32];
+
+   for(U32 bitPos = 0; bitPos < 16; bitPos++)
+      for(U32 bitCount = 1; bitCount <= 32; bitCount++)
+      {
+         memset(buffer, 0xFF, sizeof(buffer));
+         BitStream s(buffer, sizeof(buffer));
+
+         s.writeIntAt(0, U8(bitCount), bitPos);
+
+         for(U32 i = 0; i < sizeof(buffer) * 8; i++)
+         {
+            bool expected = i < bitPos || i >= bitPos + bitCount;
+            ASSERT_EQ(expected, s.testBit(i)) << "bitPos " << bitPos << ", bitCount " << bitCount << ", bit " << i;
+         }
+      }
+}
+
+
+TEST(BitStreamTest, ReadPastEndSetsError)
+{
+   U8 buffer[8];
+   memset(buffer, 0, sizeof(buffer));
+
+   BitStream s(buffer, sizeof(buffer));
+   s.setBitPosition(60);
+
+   EXPECT_EQ(0u, s.readInt(8));
+   EXPECT_FALSE(s.isValid());
+}
+
+
+TEST(BitStreamTest, ResizableStreamGrows)
+{
+   BitStream s;
+
+   for(U32 i = 0; i < 10000; i++)
+      s.writeInt(i, 17);
+
+   EXPECT_TRUE(s.isValid());
+
+   s.setBitPosition(0);
+
+   for(U32 i = 0; i < 10000; i++)
+      ASSERT_EQ(i, s.readInt(17));
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Roughly what a ship's packUpdate looks like: a handful of flags, some ranged ints and low-precision floats, and
+// a couple of full points
+static void writeGhostUpdate(BitStream &s, U32 i)
+{
+   if(s.writeFlag(i & 1))
+      s.writeRangedU32(i & 0x3FF, 0, 1023);
+
+   if(s.writeFlag(i & 2))
+   {
+      s.writeFloat((i & 0xFF) / 255.0f, 5);
+      s.writeSignedFloat(((i & 0xFF) - 128) / 128.0f, 10);
+   }
+
+   s.writeFlag(i & 4);
+   s.writeEnum(i % 9, 9);
+
+   Point pos((F32)i, i * 0.5f);
+   Point vel(i * 0.25f, -(F32)i);
+   pos.write(&s);
+   vel.write(&s);
+
+   s.writeInt(i, 32);
+}
+
+
+static U32 readGhostUpdate(BitStream &s)
+{
+   U32 checksum = 0;
+
+   if(s.readFlag())
+      checksum += s.readRangedU32(0, 1023);
+
+   if(s.readFlag())
+   {
+      checksum += U32(s.readFloat(5) * 100);
+      checksum += U32(s.readSignedFloat(10) * 100);
+   }
+
+   checksum += s.readFlag();
+   checksum += s.readEnum(9);
+
+   Point pos, vel;
+   pos.read(&s);
+   vel.read(&s);
+   checksum += U32(pos.x + vel.y);
+
+   return checksum + s.readInt(32);
+}
+
+
+// Not a correctness test -- reports how long typical ghost updates take to pack and unpack
+TEST(BitStreamTest, DISABLED_GhostUpdateBenchmark)
+{
+   const U32 UpdatesPerPacket = 12;      // About what fits in a full packet
+   const U32 Packets = 200000;
+
+   PacketStream s;
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(U32 packet = 0; packet < Packets; packet++)
+   {
+      s.setBitPosition(0);
+
+      for(U32 i = 0; i < UpdatesPerPacket; i++)
+         writeGhostUpdate(s, packet * UpdatesPerPacket + i);
+   }
+
+   F64 writeMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+   ASSERT_TRUE(s.isValid());
+
+   U32 checksum = 0;
+   start = Platform::getHighPrecisionTimerValue();
+
+   for(U32 packet = 0; packet < Packets; packet++)
+   {
+      s.setBitPosition(0);
+
+      for(U32 i = 0; i < UpdatesPerPacket; i++)
+         checksum += readGhostUpdate(s);
+   }
+
+   F64 readMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+   ASSERT_TRUE(s.isValid());
+
+   F64 updates = F64(Packets) * UpdatesPerPacket;
+   printf("Ghost updates: %.1f ns/write, %.1f ns/read (checksum %u)\n",
+          writeMs * 1000000 / updates, readMs * 1000000 / updates, checksum);
+}
+
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// A sampling of the sort of thing that goes through writeString: chat, names, level names, and server messages
+static const char *chatCorpus[] = {
+   "gg",
+   "lol",
+   "Anyone up for a game of CTF on Ghost Ship?",
+   "nice shot!",
+   "brb",
+   "Who keeps stealing our flag??",
+   "Need an engineer on the turret by our base",
+   "ChumpChange",
+   "Watusimoto",
+   "raptor",
+   "sam686",
+   "Quartz Ring of Death",
+   "Bitfighter Sam's Server [Official]",
+   "Level change in 10 seconds...",
+   "/vote next",
+   "@raptor you there?",
+   "GG all, thanks for the games :)",
+   "can someone explain how the nexus works?",
+   "Hold the zone!!! 3 more seconds",
+   "I'm going to grab the flag, cover me",
+   "teleporter on the left is a trap",
+   "k",
+   "ty",
+   "2v2 anyone? Loser buys pizza",
+   "Server is restarting for maintenance in 5 minutes",
+   "The quick brown fox jumps over the lazy dog 1234567890",
+   "(^_^) ~~ {braces} | #hash %percent",
+};
+
+
+TEST(BitStreamTest, StringEncodingUnchanged)
+{
+   // Captured from the tree-walking encoder this one replaced; clients and servers have to agree on these
+   static const U8 gg[] = { 0x0a, 0xf4, 0x3d };
+   static const U8 ctf[] = { 0xaa, 0x74, 0x52, 0x45, 0xe9, 0xcf, 0xd7, 0xb7, 0xa9, 0x5d, 0x5e, 0x9f, 0xe8, 0x4f, 0xb7,
+                             0x5b, 0x6d, 0x5d, 0xf5, 0x94, 0x2e, 0x76, 0xd6, 0x06, 0x37, 0x9d, 0xb9, 0x5e, 0x05 };
+
+   U8 buffer[256];
+   memset(buffer, 0, sizeof(buffer));
+
+   BitStream s(buffer, sizeof(buffer));
+   s.writeString("gg");
+   EXPECT_EQ(22u, s.getBitPosition());
+   EXPECT_EQ(0, memcmp(buffer, gg, sizeof(gg)));
+
+   memset(buffer, 0, sizeof(buffer));
+   s.reset();
+   s.writeString(chatCorpus[2]);
+   EXPECT_EQ(229u, s.getBitPosition());
+   EXPECT_EQ(0, memcmp(buffer, ctf, sizeof(ctf)));
+}
+
+
+TEST(BitStreamTest, StringRoundTrip)
+{
+   Vector<string> strings;
+
+   for(U32 i = 0; i < ARRAYSIZE(chatCorpus); i++)
+      strings.push_back(chatCorpus[i]);
+
+   // Every character, including the rare ones with long codes
+   string allChars;
+   for(U32 i = 1; i < 256; i++)
+      allChars += char(i);
+   strings.push_back(allChars);
+
+   U32 seed = 99;
+   for(U32 i = 0; i < 50; i++)
+   {
+      string random;
+      U32 len = nextRand(seed) % 80;
+      for(U32 j = 0; j < len; j++)
+         random += char(nextRand(seed) % 255 + 1);
+      strings.push_back(random);
+   }
+
+   for(S32 i = 0; i < strings.size(); i++)
+   {
+      U8 buffer[512];
+      BitStream s(buffer, sizeof(buffer));
+      s.writeString(strings[i].c_str());
+
+      // Only let the reader see exactly what was written, so decoding has to cope with running into the end
+      U32 bits = s.getBitPosition();
+      BitStream reader(buffer, sizeof(buffer));
+      reader.setMaxBitSizes(bits);
+
+      char out[256];
+      reader.readString(out);
+
+      EXPECT_EQ(strings[i], string(out));
+      EXPECT_EQ(bits, reader.getBitPosition());
+      EXPECT_TRUE(reader.isValid());
+   }
+}
+
+
+// Not a correctness test -- reports how long chat lines take to encode and decode
+TEST(BitStreamTest, DISABLED_StringBenchmark)
+{
+   const U32 Passes = 20000;
+   const U32 Lines = ARRAYSIZE(chatCorpus);
+
+   PacketStream s;
+
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(U32 pass = 0; pass < Passes; pass++)
+   {
+      s.reset();
+      for(U32 i = 0; i < Lines; i++)
+         s.writeString(chatCorpus[i]);
+   }
+
+   F64 writeMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+   ASSERT_TRUE(s.isValid());
+
+   char out[256];
+   U32 checksum = 0;
+   start = Platform::getHighPrecisionTimerValue();
+
+   for(U32 pass = 0; pass < Passes; pass++)
+   {
+      s.setBitPosition(0);
+      s.clearStringBuffer();
+      for(U32 i = 0; i < Lines; i++)
+      {
+         s.readString(out);
+         checksum += U8(out[0]);
+      }
+   }
+
+   F64 readMs = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+   ASSERT_TRUE(s.isValid());
+
+   F64 strings = F64(Passes) * Lines;
+   printf("Chat lines: %.1f ns/write, %.1f ns/read (checksum %u)\n",
+          writeMs * 1000000 / strings, readMs * 1000000 / strings, checksum);
+}
+
+};
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "../zap/BotNavMeshZone.h"
+#include "../zap/gridDB.h"
+
+#include "gtest/gtest.h"
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+class BotNavMeshTest : public testing::Test
+{
+protected:
+	GridDatabase mDatabase;
+	Vector<BotNavMeshZone *> mZones;
+
+	virtual void TearDown()
+	{
+		mZones.deleteAndClear();
+	}
+
+	void addZone(F32 left, F32 top, F32 right, F32 bottom)
+	{
+		BotNavMeshZone *zone = new BotNavMeshZone(mZones.size());
+		zone->disableTriangulation();
+
+		zone->addVert(Point(left, top));
+		zone->addVert(Point(right, top));
+		zone->addVert(Point(right, bottom));
+		zone->addVert(Point(left, bottom));
+
+		zone->addToZoneDatabase(&mDatabase);
+		mZones.push_back(zone);
+	}
+
+	void link(S32 from, S32 to, const Point &borderStart, const Point &borderEnd, bool isTeleporter = false)
+	{
+		NeighboringZone neighbor;
+		neighbor.zoneID = to;
+		neighbor.borderStart = borderStart;
+		neighbor.borderEnd = borderEnd;
+		neighbor.borderCenter = isTeleporter ? borderStart : (borderStart + borderEnd) * 0.5;
+		neighbor.center = mZones[to]->getCenter();
+		neighbor.distTo = isTeleporter ? 0 : mZones[from]->getCenter().distanceTo(neighbor.borderCenter);
+		neighbor.isTeleporter = isTeleporter;
+
+		mZones[from]->mNeighbors.push_back(neighbor);
+	}
+};
+
+
+// Three zones in an L, and a fourth we can only get to by teleporter:
+//
+//   0 1     3
+//     2
+TEST_F(BotNavMeshTest, findZonePath)
+{
+	addZone(0, 0, 100, 100);
+	addZone(100, 0, 200, 100);
+	addZone(100, 100, 200, 200);
+	addZone(400, 0, 500, 100);
+
+	link(0, 1, Point(100, 0), Point(100, 100));
+	link(1, 0, Point(100, 0), Point(100, 100));
+	link(1, 2, Point(100, 100), Point(200, 100));
+	link(2, 1, Point(100, 100), Point(200, 100));
+	link(2, 3, Point(150, 150), Point(450, 50), true);
+
+	Vector<U16> path = AStar::findZonePath(&mZones, 0, 2);
+	ASSERT_EQ(3, path.size());
+	EXPECT_EQ(0, path[0]);
+	EXPECT_EQ(1, path[1]);
+	EXPECT_EQ(2, path[2]);
+
+	// Teleporters only go one way
+	EXPECT_EQ(4, AStar::findZonePath(&mZones, 0, 3).size());
+	EXPECT_EQ(0, AStar::findZonePath(&mZones, 3, 0).size());
+}
+
+
+TEST_F(BotNavMeshTest, findCorners)
+{
+	addZone(0, 0, 100, 100);
+	addZone(100, 0, 200, 100);
+	addZone(100, 100, 200, 200);
+	addZone(400, 0, 500, 100);
+
+	link(0, 1, Point(100, 0), Point(100, 100));
+	link(1, 2, Point(200, 100), Point(100, 100));      // Which way round the border goes shouldn't matter
+	link(2, 3, Point(150, 150), Point(450, 50), true);
+
+	Vector<U16> path;
+	Vector<Point> corners;
+
+	// Straight across one border: nothing to go around
+	path.push_back(0);
+	path.push_back(1);
+	AStar::findCorners(&mZones, path, Point(50, 50), Point(150, 50), corners);
+	ASSERT_EQ(1, corners.size());
+	EXPECT_EQ(Point(150, 50), corners[0]);
+
+	// Around the inside of the L, keeping a little way off the corner where all three zones meet
+	path.push_back(2);
+	AStar::findCorners(&mZones, path, Point(50, 50), Point(150, 150), corners);
+	ASSERT_EQ(3, corners.size());
+	EXPECT_GT(100, corners[0].y);
+	EXPECT_EQ(100, corners[0].x);
+	EXPECT_LT(100, corners[1].x);
+	EXPECT_EQ(100, corners[1].y);
+	EXPECT_EQ(Point(150, 150), corners[2]);
+
+	// Into the teleporter, then on from where it drops us
+	path.clear();
+	path.push_back(2);
+	path.push_back(3);
+	AStar::findCorners(&mZones, path, Point(150, 180), Point(480, 80), corners);
+	ASSERT_EQ(2, corners.size());
+	EXPECT_EQ(Point(150, 150), corners[0]);
+	EXPECT_EQ(Point(480, 80), corners[1]);
+}
+
+
+};
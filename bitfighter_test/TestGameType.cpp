@@ -4,11 +4,122 @@
 //------------------------------------------------------------------------------
 
 #include "gameType.h"
+#include "gameConnection.h"
+#include "gridDB.h"
+
 #include "gtest/gtest.h"
 
 namespace Zap
 {
 
-// Need some tests here!
+// Stands in for a level item when all we care about is what kind of thing it is and where it is
+class ScopeTestObject : public DatabaseObject
+{
+public:
+   ScopeTestObject(U8 typeNumber, const Rect &extent)
+   {
+      mObjectTypeNumber = typeNumber;
+      setExtent(extent);
+   }
+};
+
+
+static bool contains(const Vector<DatabaseObject *> &objects, DatabaseObject *obj)
+{
+   for(S32 i = 0; i < objects.size(); i++)
+      if(objects[i] == obj)
+         return true;
+
+   return false;
+}
+
+
+// Walk the scope rect around a level full of walls with some asteroids among them, and check that what the
+// incremental query finds each packet leaves the client with the same things in scope as a full rescope would.
+// Static objects the incremental query skips have to be ones that were in range last packet, since TNL leaves
+// those in scope by themselves.
+TEST(GameTypeTest, incrementalScoping)
+{
+   GridDatabase database(false);
+
+   for(S32 x = 0; x < 30; x++)
+      for(S32 y = 0; y < 30; y++)
+      {
+         Point pos(x * 100.0f, y * 100.0f);
+         U8 typeNumber = (x + y) % 7 == 0 ? AsteroidTypeNumber : BarrierTypeNumber;
+         (new ScopeTestObject(typeNumber, Rect(pos, pos + Point(40 + x, 25 + y))))->addToDatabase(&database);
+      }
+
+   GameConnection connection;
+
+   // Small steps every which way, a few that land exactly on the walls' edges, and a jump clear of the last rect
+   Vector<Point> steps;
+   for(S32 i = 0; i < 20; i++)
+      steps.push_back(Point(30, 0));
+   for(S32 i = 0; i < 20; i++)
+      steps.push_back(Point(17, 23));
+   for(S32 i = 0; i < 10; i++)
+      steps.push_back(Point(0, -50));
+   for(S32 i = 0; i < 10; i++)
+      steps.push_back(Point(-45.5f, -12.25f));
+   steps.push_back(Point(1500, 900));
+   for(S32 i = 0; i < 10; i++)
+      steps.push_back(Point(-100, 100));
+
+   Rect scopeRect(Point(-200, -150), Point(600, 450));
+   Rect lastRect;
+   bool first = true;
+
+   for(S32 i = 0; i <= steps.size(); i++)
+   {
+      Vector<DatabaseObject *> found, everything;
+      connection.findObjectsInScope(&database, scopeRect, found);
+      database.findObjects((TestFunc)isAnyObjectType, everything, scopeRect);
+
+      for(S32 j = 0; j < found.size(); j++)
+         EXPECT_TRUE(found[j]->getExtent().intersects(scopeRect)) << "Packet " << i << ": found something out of range";
+
+      for(S32 j = 0; j < everything.size(); j++)
+      {
+         DatabaseObject *obj = everything[j];
+
+         if(contains(found, obj))
+            continue;
+
+         EXPECT_TRUE(!first && isStaticObjectType(obj->getObjectTypeNumber()) && obj->getExtent().intersects(lastRect))
+               << "Packet " << i << ": missed object at " << obj->getExtent().getCenter().toString();
+      }
+
+      lastRect = scopeRect;
+      first = false;
+
+      if(i < steps.size())
+         scopeRect.offset(steps[i]);
+   }
+
+   // A new wall where we were already looking has to be found, even though none of the scope rect is new
+   ScopeTestObject *wall = new ScopeTestObject(BarrierTypeNumber, Rect(scopeRect.getCenter(), scopeRect.getCenter() + Point(10, 10)));
+   wall->addToDatabase(&database);
+
+   Vector<DatabaseObject *> found;
+   connection.findObjectsInScope(&database, scopeRect, found);
+   EXPECT_TRUE(contains(found, wall));
+
+   // And so does one that's been moved into range
+   found.clear();
+   connection.findObjectsInScope(&database, scopeRect, found);
+   EXPECT_FALSE(contains(found, wall));      // Nothing's changed, so no need to look again
+
+   ScopeTestObject *farWall = new ScopeTestObject(BarrierTypeNumber, Rect(Point(-5000, -5000), Point(-4990, -4990)));
+   farWall->addToDatabase(&database);
+   connection.findObjectsInScope(&database, scopeRect, found);
+   EXPECT_FALSE(contains(found, farWall));
+
+   found.clear();
+   farWall->setExtent(Rect(scopeRect.getCenter() - Point(10, 10), scopeRect.getCenter()));
+   connection.findObjectsInScope(&database, scopeRect, found);
+   EXPECT_TRUE(contains(found, farWall));
+}
+
 
 };
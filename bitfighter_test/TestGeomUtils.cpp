@@ -428,5 +428,65 @@ TEST(GeomUtilsTest, pointInHexagon)
 }
 
 
+static F32 overlapArea(const Rect &a, const Rect &b)
+{
+   F32 w = getMin(a.max.x, b.max.x) - getMax(a.min.x, b.min.x);
+   F32 h = getMin(a.max.y, b.max.y) - getMax(a.min.y, b.min.y);
+   return (w > 0 && h > 0) ? w * h : 0;
+}
+
+
+TEST(GeomUtilsTest, rectSubtract)
+{
+   Rect rect(0, 0, 100, 100);
+   Vector<Rect> pieces;
+
+   // No overlap gives back the whole rect; full coverage gives nothing
+   rect.subtract(Rect(200, 200, 300, 300), pieces);
+   ASSERT_EQ(1, pieces.size());
+   EXPECT_EQ(rect, pieces[0]);
+
+   rect.subtract(Rect(-10, -10, 110, 110), pieces);
+   EXPECT_EQ(0, pieces.size());
+
+   // The scope rect moving a bit each packet, in every direction
+   const Point offsets[] = { Point(30, 0), Point(0, -30), Point(30, 30), Point(-30, 30), Point(0, 0) };
+
+   for(U32 i = 0; i < ARRAYSIZE(offsets); i++)
+   {
+      Rect old(rect);
+      old.offset(offsets[i]);
+      rect.subtract(old, pieces);
+
+      // Pieces don't overlap each other or the old rect, and make up exactly the new area
+      F32 area = 0;
+      for(S32 j = 0; j < pieces.size(); j++)
+      {
+         EXPECT_EQ(0, overlapArea(pieces[j], old));
+         for(S32 k = j + 1; k < pieces.size(); k++)
+            EXPECT_EQ(0, overlapArea(pieces[j], pieces[k]));
+
+         area += pieces[j].getWidth() * pieces[j].getHeight();
+      }
+
+      EXPECT_FLOAT_EQ(rect.getWidth() * rect.getHeight() - overlapArea(rect, old), area);
+
+      // Any object in the new rect but not the old one touches one of the pieces
+      for(S32 x = -20; x < 120; x += 7)
+         for(S32 y = -20; y < 120; y += 7)
+         {
+            Rect extent(F32(x), F32(y), F32(x + 5), F32(y + 5));
+            if(!extent.intersects(rect) || extent.intersects(old))
+               continue;
+
+            bool found = false;
+            for(S32 j = 0; j < pieces.size(); j++)
+               found = found || extent.intersects(pieces[j]);
+
+            EXPECT_TRUE(found) << "Missed " << extent.toString();
+         }
+   }
+}
+
 
 };
\ No newline at end of file
@@ -0,0 +1,592 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "gameConnection.h"
+#include "PointObject.h"
+
+#include "tnlGhostConnection.h"
+#include "tnlNetObject.h"
+#include "tnlBitStream.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace Zap
+{
+
+using namespace TNL;
+
+static const S32 WorldSize = 2048;     // Objects stay in a box this size, like the area the game scopes around a player
+
+
+// Moving object that sends its quantized position and velocity, either the way the game used to (offsets into the
+// scope area, velocity as angle and speed) or as deltas.  The server-side object records exactly what it sent, so
+// the test can check the client got the same values.
+class DeltaTestObject : public NetObject
+{
+   typedef NetObject Parent;
+
+public:
+   enum MaskBits {
+      PositionMask = BIT(0),
+   };
+
+   F32 pos[2];
+   F32 vel[2];
+   S32 sent[4];         // Server: last values written
+   S32 received[4];     // Client: last values read
+
+   DeltaTestObject()
+   {
+      mNetFlags.set(Ghostable);
+      for(S32 i = 0; i < 2; i++)
+         pos[i] = vel[i] = 0;
+      for(S32 i = 0; i < 4; i++)
+         sent[i] = received[i] = 0;
+   }
+
+   void move(F32 seconds)
+   {
+      for(S32 i = 0; i < 2; i++)
+      {
+         pos[i] += vel[i] * seconds;
+         if(pos[i] < 0 || pos[i] > WorldSize - 1)
+         {
+            vel[i] = -vel[i];
+            pos[i] = pos[i] < 0 ? -pos[i] : 2 * (WorldSize - 1) - pos[i];
+         }
+      }
+
+      if(vel[0] != 0 || vel[1] != 0)
+         setMaskBits(PositionMask);
+   }
+
+   U32 packUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream)
+   {
+      if(stream->writeFlag(updateMask & PositionMask))
+      {
+         // Velocity goes out as whole units per second either way, so the two encodings carry the same information
+         sent[0] = S32(floor(pos[0] + 0.5f));
+         sent[1] = S32(floor(pos[1] + 0.5f));
+         sent[2] = S32(floor(vel[0] + 0.5f));
+         sent[3] = S32(floor(vel[1] + 0.5f));
+
+         if(connection->isGhostDeltaCompression())
+            connection->writeGhostDelta(stream, sent, 4);
+         else
+         {
+            stream->writeRangedU32(sent[0], 0, WorldSize - 1);
+            stream->writeRangedU32(sent[1], 0, WorldSize - 1);
+
+            if(!stream->writeFlag(sent[2] == 0 && sent[3] == 0))
+            {
+               stream->writeSignedInt(sent[2], 10);
+               stream->writeSignedInt(sent[3], 10);
+            }
+         }
+      }
+
+      return 0;
+   }
+
+   void unpackUpdate(GhostConnection *connection, BitStream *stream)
+   {
+      if(!stream->readFlag())
+         return;
+
+      if(connection->isGhostDeltaCompression())
+         connection->readGhostDelta(stream, received, 4);
+      else
+      {
+         received[0] = stream->readRangedU32(0, WorldSize - 1);
+         received[1] = stream->readRangedU32(0, WorldSize - 1);
+
+         if(stream->readFlag())
+            received[2] = received[3] = 0;
+         else
+         {
+            received[2] = stream->readSignedInt(10);
+            received[3] = stream->readSignedInt(10);
+         }
+      }
+   }
+
+   TNL_DECLARE_CLASS(DeltaTestObject);
+};
+
+TNL_IMPLEMENT_NETOBJECT(DeltaTestObject);
+
+
+// Both ends of the connection, driven by hand the way GameRecorderServer and GameRecorderPlayback drive theirs
+class DeltaTestConnection : public GhostConnection
+{
+   typedef GhostConnection Parent;
+
+public:
+   DeltaTestConnection() { }
+
+   ~DeltaTestConnection()
+   {
+      mNotifyQueueTail = NULL;
+   }
+
+   void setup(bool sending, bool delta)
+   {
+      setGhostDeltaCompression(delta);
+      mEventClassCount = NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeEvent);
+      mEventClassBitSize = getNextBinLog2(mEventClassCount);
+      mGhostClassCount = NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeObject);
+      mGhostClassBitSize = getNextBinLog2(mGhostClassCount);
+      mConnectionParameters.mDebugObjectSizes = false;
+      mConnectionState = Connected;
+
+      if(sending)
+      {
+         setGhostFrom(true);
+         setGhostTo(false);
+         mConnectionParameters.mIsInitiator = false;
+         activateGhosting();
+         rpcReadyForNormalGhosts_remote(mGhostingSequence);
+      }
+      else
+      {
+         setGhostFrom(false);
+         setGhostTo(true);
+         mConnectionParameters.mIsInitiator = true;
+      }
+   }
+
+   void writeTestPacket(BitStream *stream, GhostPacketNotify *notify)
+   {
+      mNotifyQueueTail = notify;
+      prepareWritePacket();
+      writePacket(stream, notify);
+   }
+
+   void notifyTestPacket(GhostPacketNotify *notify, bool received)
+   {
+      if(received)
+         packetReceived(notify);
+      else
+         packetDropped(notify);
+   }
+
+   void readTestPacket(BitStream *stream)
+   {
+      readPacket(stream);
+   }
+
+   DeltaTestObject *getLocalGhost(S32 index)
+   {
+      return index < mLocalGhosts.size() ? static_cast<DeltaTestObject *>(mLocalGhosts[index]) : NULL;
+   }
+
+   TNL_DECLARE_NETCONNECTION(DeltaTestConnection);
+};
+
+TNL_IMPLEMENT_NETCONNECTION(DeltaTestConnection, NetClassGroupGame, false);
+
+
+// Scopes every object it's given
+class DeltaTestScope : public NetObject
+{
+public:
+   Vector<DeltaTestObject *> objects;
+
+   void performScopeQuery(GhostConnection *connection)
+   {
+      for(S32 i = 0; i < objects.size(); i++)
+         connection->objectInScope(objects[i]);
+   }
+};
+
+
+struct DeltaRunResult
+{
+   U32 totalBytes;
+   U32 packets;
+   U32 mismatches;      // Updates the client decoded differently from what the server sent
+   U32 updatesChecked;
+};
+
+
+// Runs a few hundred packets' worth of moving objects through a connection.  Every lossEvery'th packet is
+// lost, and packets are acked latency packets after they're sent, like a connection with some ping.
+static DeltaRunResult runDeltaRun(bool delta, U32 lossEvery, U32 latency)
+{
+   const S32 ObjectCount = 60;
+   const U32 PacketCount = 300;
+   const F32 TickSeconds = 0.032f;
+
+   DeltaRunResult result = { 0, 0, 0, 0 };
+
+   NetClassRep::initialize();
+
+   DeltaTestConnection *server = new DeltaTestConnection();
+   DeltaTestConnection *client = new DeltaTestConnection();
+   server->setup(true, delta);
+   client->setup(false, delta);
+
+   DeltaTestScope scope;
+   server->setScopeObject(&scope);
+
+   // A mix of fast, slow and parked objects, all deterministic
+   U32 seed = 12345;
+   for(S32 i = 0; i < ObjectCount; i++)
+   {
+      DeltaTestObject *obj = new DeltaTestObject();
+      for(S32 j = 0; j < 2; j++)
+      {
+         seed = seed * 1664525 + 1013904223;
+         obj->pos[j] = F32(seed >> 8 & 1023) + 512;
+         seed = seed * 1664525 + 1013904223;
+         obj->vel[j] = (i % 4 == 0) ? 0 : F32(S32(seed >> 8 & 1023) - 512) * (i % 2 ? 1.0f : 0.25f);
+      }
+      scope.objects.push_back(obj);
+   }
+
+   Vector<GhostConnection::GhostPacketNotify *> inFlight;
+   Vector<bool> delivered;
+
+   for(U32 packet = 0; packet < PacketCount; packet++)
+   {
+      for(S32 i = 0; i < ObjectCount; i++)
+         scope.objects[i]->move(TickSeconds);
+      NetObject::collapseDirtyList();     // NetInterface normally does this before sending
+
+      U8 buffer[MaxPacketDataSize];
+      BitStream stream(buffer, sizeof(buffer));
+      GhostConnection::GhostPacketNotify *notify = new GhostConnection::GhostPacketNotify();
+      server->writeTestPacket(&stream, notify);
+
+      bool lost = lossEvery && packet % lossEvery == lossEvery - 1;
+      stream.zeroToByteBoundary();
+      result.totalBytes += stream.getBytePosition();
+      result.packets++;
+
+      if(!lost)
+      {
+         BitStream received(buffer, stream.getBytePosition());
+         client->readTestPacket(&received);
+
+         // Anything sent in this packet should now match on the client
+         for(GhostConnection::GhostRef *ref = notify->ghostList; ref; ref = ref->nextRef)
+         {
+            if(!ref->hasDeltaSnapshot && delta)
+               continue;
+
+            DeltaTestObject *serverObj = static_cast<DeltaTestObject *>(ref->ghost->obj);
+            DeltaTestObject *clientObj = client->getLocalGhost(ref->ghost->index);
+            if(!serverObj || !clientObj)
+               continue;
+
+            result.updatesChecked++;
+            if(memcmp(serverObj->sent, clientObj->received, sizeof(serverObj->sent)) != 0)
+               result.mismatches++;
+         }
+      }
+
+      inFlight.push_back(notify);
+      delivered.push_back(!lost);
+
+      // Acks come back a few packets later
+      while(inFlight.size() > S32(latency))
+      {
+         server->notifyTestPacket(inFlight[0], delivered[0]);
+         delete inFlight[0];
+         inFlight.erase(0);
+         delivered.erase(0);
+      }
+   }
+
+   while(inFlight.size() > 0)
+   {
+      server->notifyTestPacket(inFlight[0], delivered[0]);
+      delete inFlight[0];
+      inFlight.erase(0);
+      delivered.erase(0);
+   }
+
+   delete server;
+   delete client;
+   for(S32 i = 0; i < scope.objects.size(); i++)
+      delete scope.objects[i];
+
+   return result;
+}
+
+
+TEST(GhostConnectionTest, DeltaUpdatesMatchWithoutLoss)
+{
+   DeltaRunResult result = runDeltaRun(true, 0, 3);
+   EXPECT_GT(result.updatesChecked, 0u);
+   EXPECT_EQ(0u, result.mismatches);
+}
+
+
+TEST(GhostConnectionTest, DeltaUpdatesSurviveLoss)
+{
+   // Lose some packets, then lose a lot of them, so some updates fall back to absolute values
+   DeltaRunResult someLoss = runDeltaRun(true, 7, 3);
+   EXPECT_GT(someLoss.updatesChecked, 0u);
+   EXPECT_EQ(0u, someLoss.mismatches);
+
+   DeltaRunResult heavyLoss = runDeltaRun(true, 2, 20);
+   EXPECT_GT(heavyLoss.updatesChecked, 0u);
+   EXPECT_EQ(0u, heavyLoss.mismatches);
+}
+
+
+// Compares bytes on the wire with and without delta updates, through the same write/read path the game
+// recorder and playback use
+TEST(GhostConnectionTest, DeltaBandwidth)
+{
+   DeltaRunResult absolute      = runDeltaRun(false, 0, 3);
+   DeltaRunResult deltas        = runDeltaRun(true, 0, 3);
+   DeltaRunResult absoluteLossy = runDeltaRun(false, 10, 6);
+   DeltaRunResult deltasLossy   = runDeltaRun(true, 10, 6);
+
+   EXPECT_EQ(0u, absolute.mismatches);
+   EXPECT_LT(deltas.totalBytes, absolute.totalBytes);
+   EXPECT_LT(deltasLossy.totalBytes, absoluteLossy.totalBytes);
+
+   printf("Ghost updates, %u packets: absolute %u bytes, delta %u bytes (%.0f%%); "
+          "with 10%% loss: absolute %u bytes, delta %u bytes (%.0f%%)\n", absolute.packets,
+          absolute.totalBytes, deltas.totalBytes, 100.0 * deltas.totalBytes / absolute.totalBytes,
+          absoluteLossy.totalBytes, deltasLossy.totalBytes, 100.0 * deltasLossy.totalBytes / absoluteLossy.totalBytes);
+}
+
+
+// Per-class bit usage should add up to what actually went out, counting each update once
+TEST(GhostConnectionTest, BitUsageStats)
+{
+   NetClassRep::resetBitUsage();
+   DeltaRunResult result = runDeltaRun(false, 0, 3);
+
+   NetClassRep *rep = &DeltaTestObject::dynClassRep;
+   EXPECT_EQ(60u, rep->getInitialUpdateCount());
+   EXPECT_GT(rep->getPartialUpdateCount(), 0u);
+   EXPECT_GE(rep->getPackTime(), 0);
+
+   U64 bits = rep->getInitialUpdateBitsUsed() + rep->getPartialUpdateBitsUsed();
+   EXPECT_GT(bits, U64(result.totalBytes) * 8 / 2);   // Most of each packet is object updates...
+   EXPECT_LT(bits, U64(result.totalBytes) * 8);       // ...but there's some overhead
+
+   NetClassRep::resetBitUsage();
+   EXPECT_EQ(0u, rep->getInitialUpdateCount());
+   EXPECT_EQ(0u, rep->getPartialUpdateBitsUsed());
+}
+
+
+// Sends its position and velocity the way ships and MoveItems do.  As a control object, it sends its exact
+// position as its control state, which is what the connection measures relative points from.
+class PositionTestObject : public PointObject
+{
+   typedef PointObject Parent;
+
+public:
+   Point vel;
+
+   PositionTestObject() { mNetFlags.set(Ghostable); }
+
+   void move(const Point &delta)
+   {
+      setPos(getPos() + delta);
+      setMaskBits(FirstFreeMask);
+   }
+
+   U32 packUpdate(GhostConnection *connection, U32 updateMask, BitStream *stream)
+   {
+      writePositionAndVelocity(connection, getPos(), vel, 1000, stream);
+      return 0;
+   }
+
+   void unpackUpdate(GhostConnection *connection, BitStream *stream)
+   {
+      Point pos;
+      readPositionAndVelocity(connection, pos, vel, 1000, stream);
+      setPos(pos);
+   }
+
+   void writeControlState(BitStream *stream)
+   {
+      stream->write(getPos().x);
+      stream->write(getPos().y);
+   }
+
+   void readControlState(BitStream *stream)
+   {
+      Point pos;
+      stream->read(&pos.x);
+      stream->read(&pos.y);
+      setPos(pos);
+   }
+
+   bool onGhostAdd(GhostConnection *connection) { return true; }     // No ClientGame to add it to
+
+   TNL_DECLARE_CLASS(PositionTestObject);
+};
+
+TNL_IMPLEMENT_NETOBJECT(PositionTestObject);
+
+
+class PositionTestConnection : public GameConnection
+{
+public:
+   ~PositionTestConnection()
+   {
+      mNotifyQueueTail = NULL;
+      mConnectionParameters.mIsInitiator = true;      // There's no ServerGame for ~GameConnection to tell we've gone
+   }
+
+   void setup(bool sending)
+   {
+      setGhostDeltaCompression(true);
+      mEventClassCount = NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeEvent);
+      mEventClassBitSize = getNextBinLog2(mEventClassCount);
+      mGhostClassCount = NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeObject);
+      mGhostClassBitSize = getNextBinLog2(mGhostClassCount);
+      mConnectionParameters.mDebugObjectSizes = false;
+      mConnectionState = Connected;
+      setGhostFrom(sending);
+      setGhostTo(!sending);
+      mConnectionParameters.mIsInitiator = !sending;
+
+      if(sending)
+      {
+         activateGhosting();
+         rpcReadyForNormalGhosts_remote(mGhostingSequence);
+      }
+   }
+
+   // Sends one packet from this connection to client, and acks it
+   void sendTo(PositionTestConnection *client)
+   {
+      NetObject::collapseDirtyList();
+
+      U8 buffer[MaxPacketDataSize];
+      BitStream stream(buffer, sizeof(buffer));
+      PacketNotify *notify = allocNotify();
+      mNotifyQueueTail = notify;
+      prepareWritePacket();
+      writePacket(&stream, notify);
+
+      stream.zeroToByteBoundary();
+      BitStream received(buffer, stream.getBytePosition());
+      client->readPacket(&received);
+
+      packetReceived(notify);
+      delete notify;
+   }
+
+   TNL_DECLARE_NETCONNECTION(PositionTestConnection);
+};
+
+TNL_IMPLEMENT_NETCONNECTION(PositionTestConnection, NetClassGroupGame, false);
+
+
+class PositionTestScope : public NetObject
+{
+public:
+   Vector<PositionTestObject *> objects;
+
+   void performScopeQuery(GhostConnection *connection)
+   {
+      for(S32 i = 0; i < objects.size(); i++)
+         connection->objectInScope(objects[i]);
+   }
+};
+
+
+// Delta updates round to whole units, which is only as good as the game sends anything near the player's ship.
+// Spectators and objects out past the relative range have to keep getting exact positions.
+static void checkPositionRoundTrip(bool hasControlObject)
+{
+   NetClassRep::initialize();
+
+   PositionTestConnection *server = new PositionTestConnection();
+   PositionTestConnection *client = new PositionTestConnection();
+   server->setup(true);
+   client->setup(false);
+
+   PositionTestObject *ship = new PositionTestObject();
+   PositionTestObject *nearby = new PositionTestObject();
+   PositionTestObject *faraway = new PositionTestObject();
+
+   ship->setPos(Point(1000.3f, 1000.7f));
+   nearby->setPos(ship->getPos() + Point(120.4f, -80.35f));
+   nearby->vel.set(150.3f, -20.6f);
+   faraway->setPos(ship->getPos() + Point(5000.25f, 3000.5f));
+   faraway->vel.set(-60.45f, 10.2f);
+
+   PositionTestScope scope;
+   scope.objects.push_back(ship);
+   scope.objects.push_back(nearby);
+   scope.objects.push_back(faraway);
+   server->setScopeObject(&scope);
+
+   if(hasControlObject)
+      server->setControlObject(ship);
+
+   for(S32 packet = 0; packet < 20; packet++)
+   {
+      ship->move(Point(3.1f, -1.7f));
+      nearby->move(Point(-2.35f, 4.8f));
+      faraway->move(Point(1.15f, 0.45f));
+
+      server->sendTo(client);
+
+      // The first packet or two go out before the client has the ship, so aren't compressed relative to it
+      if(packet < 3)
+         continue;
+
+      for(S32 i = 0; i < scope.objects.size(); i++)
+      {
+         PositionTestObject *serverObj = scope.objects[i];
+         PositionTestObject *clientObj = static_cast<PositionTestObject *>(client->resolveGhost(server->getGhostIndex(serverObj)));
+         ASSERT_TRUE(clientObj != NULL);
+
+         Point pos = clientObj->getPos();
+
+         if(hasControlObject && serverObj != faraway)
+         {
+            EXPECT_EQ(floor(pos.x), pos.x) << "Object " << i << " should have come as a delta";
+            EXPECT_NEAR(serverObj->getPos().x, pos.x, 0.5f);
+            EXPECT_NEAR(serverObj->getPos().y, pos.y, 0.5f);
+            EXPECT_NEAR(serverObj->vel.x, clientObj->vel.x, 0.5f);
+            EXPECT_NEAR(serverObj->vel.y, clientObj->vel.y, 0.5f);
+         }
+         else
+         {
+            EXPECT_EQ(serverObj->getPos().x, pos.x) << "Object " << i << " lost precision";
+            EXPECT_EQ(serverObj->getPos().y, pos.y) << "Object " << i << " lost precision";
+         }
+      }
+   }
+
+   server->setControlObject(NULL);
+   delete server;
+   delete client;
+   delete ship;
+   delete nearby;
+   delete faraway;
+}
+
+
+TEST(GhostConnectionTest, PositionDeltasNearControlObject)
+{
+   checkPositionRoundTrip(true);
+}
+
+
+TEST(GhostConnectionTest, PositionsExactForSpectators)
+{
+   checkPositionRoundTrip(false);
+}
+
+
+};
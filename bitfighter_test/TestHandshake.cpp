@@ -0,0 +1,290 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "tnlNetInterface.h"
+#include "tnlNetConnection.h"
+#include "tnlClientPuzzle.h"
+#include "tnlPlatform.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+using namespace TNL;
+
+static const U16 ServerPort = 28123;
+static const char *ServerAddress = "IP:127.0.0.1:28123";
+static const char *ClientAddress = "IP:127.0.0.1:28124";
+
+
+// Bare connection, just enough to complete a handshake
+class HandshakeTestConnection : public NetConnection
+{
+public:
+   static U32 establishedCount;
+
+   void onConnectionEstablished()
+   {
+      Parent::onConnectionEstablished();
+
+      if(!isInitiator())
+         establishedCount++;
+   }
+
+   typedef NetConnection Parent;
+   TNL_DECLARE_NETCONNECTION(HandshakeTestConnection);
+};
+
+U32 HandshakeTestConnection::establishedCount = 0;
+
+TNL_IMPLEMENT_NETCONNECTION(HandshakeTestConnection, NetClassGroupGame, true);
+
+
+struct FloodResult
+{
+   U32 connected;
+   F64 serverMs;     // Time the server's main loop spent handling packets, in total
+   F64 maxStallMs;   // Longest single pass of the server's main loop
+};
+
+
+// Connects clientCount clients to a server over loopback all at once, the way everyone reconnects after
+// a server restart, and times the server's main loop while it deals with them.  Our tomcrypt build has
+// no bignum backend, so there's no key exchange here; this covers the puzzle check and the queueing.
+static FloodResult runHandshakeFlood(U32 clientCount, U32 handshakeThreads)
+{
+   FloodResult result;
+   result.serverMs = 0;
+   result.maxStallMs = 0;
+
+   HandshakeTestConnection::establishedCount = 0;
+
+   NetInterface *server = new NetInterface(Address(IPProtocol, Address::Any, ServerPort));
+   server->setHandshakeThreadCount(handshakeThreads);
+
+   Address serverAddress(ServerAddress);
+
+   Vector<NetInterface *> clients;
+   for(U32 i = 0; i < clientCount; i++)
+   {
+      NetInterface *client = new NetInterface(Address(IPProtocol, Address::Any, 0));
+      clients.push_back(client);
+
+      HandshakeTestConnection *conn = new HandshakeTestConnection();
+      conn->connect(client, serverAddress);
+   }
+
+   U32 startTime = Platform::getRealMilliseconds();
+
+   while(HandshakeTestConnection::establishedCount < clientCount &&
+         Platform::getRealMilliseconds() - startTime < 30000)
+   {
+      for(S32 i = 0; i < clients.size(); i++)
+      {
+         clients[i]->checkIncomingPackets();
+         clients[i]->processConnections();
+      }
+
+      S64 start = Platform::getHighPrecisionTimerValue();
+
+      server->checkIncomingPackets();
+      server->processConnections();
+
+      F64 ms = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+      result.serverMs += ms;
+      if(ms > result.maxStallMs)
+         result.maxStallMs = ms;
+
+      Platform::sleep(1);
+   }
+
+   result.connected = HandshakeTestConnection::establishedCount;
+
+   for(S32 i = 0; i < clients.size(); i++)
+      delete clients[i];
+   delete server;
+
+   return result;
+}
+
+
+TEST(HandshakeTest, InlineHandshake)
+{
+   FloodResult result = runHandshakeFlood(4, 0);
+   EXPECT_EQ(4, result.connected);
+}
+
+
+TEST(HandshakeTest, ThreadedHandshake)
+{
+   FloodResult result = runHandshakeFlood(4, 2);
+   EXPECT_EQ(4, result.connected);
+}
+
+
+// Not a correctness test -- reports how long the server's main thread spends on a flood of handshakes, inline
+// and on worker threads
+TEST(HandshakeTest, DISABLED_HandshakeFloodBenchmark)
+{
+   const U32 Clients = 32;
+
+   FloodResult inlineResult   = runHandshakeFlood(Clients, 0);
+   FloodResult threadedResult = runHandshakeFlood(Clients, 4);
+
+   EXPECT_EQ(Clients, inlineResult.connected);
+   EXPECT_EQ(Clients, threadedResult.connected);
+
+   printf("Handshake flood, %u clients: inline %.1f ms on main thread (worst pass %.2f ms), "
+          "threaded %.1f ms (worst pass %.2f ms)\n", Clients,
+          inlineResult.serverMs, inlineResult.maxStallMs, threadedResult.serverMs, threadedResult.maxStallMs);
+}
+
+
+
+// Feeds connect challenges straight into the packet handler, on a simulated clock
+class PuzzleTestInterface : public NetInterface
+{
+public:
+   PuzzleTestInterface() : NetInterface(Address(IPProtocol, Address::Any, 0))
+   {
+      // Do nothing
+   }
+
+   void receiveChallengeRequests(U32 count)
+   {
+      Address client(ClientAddress);
+
+      for(U32 i = 0; i < count; i++)
+      {
+         PacketStream request;
+         Nonce clientNonce;
+         clientNonce.getRandom();
+
+         clientNonce.write(&request);
+         request.writeFlag(false);     // Key exchange
+         request.writeFlag(false);     // Certificate
+         request.setBitPosition(0);
+
+         handleConnectChallengeRequest(client, &request);
+      }
+   }
+
+   void tick(U32 time)
+   {
+      mPuzzleManager.tick(time);
+   }
+};
+
+
+// Runs the interface for the given number of seconds at a steady request rate, returning the
+// difficulty at the end of each second
+static Vector<U32> runRequests(PuzzleTestInterface &server, U32 &time, U32 seconds, U32 requestsPerSecond)
+{
+   Vector<U32> difficulties;
+
+   for(U32 i = 0; i < seconds * 10; i++)
+   {
+      server.receiveChallengeRequests(requestsPerSecond / 10);
+      time += 100;
+      server.tick(time);
+
+      if(i % 10 == 9)
+         difficulties.push_back(server.getPuzzleManager().getCurrentDifficulty());
+   }
+
+   return difficulties;
+}
+
+
+TEST(HandshakeTest, PuzzleDifficultyFollowsRequestRate)
+{
+   PuzzleTestInterface server;
+   ClientPuzzleManager &puzzles = server.getPuzzleManager();
+
+   U32 time = 1000;
+   server.tick(time);
+   ASSERT_EQ(ClientPuzzleManager::InitialPuzzleDifficulty, puzzles.getCurrentDifficulty());
+
+   // Idle server makes things easy for clients
+   runRequests(server, time, 10, 0);
+   EXPECT_EQ(ClientPuzzleManager::MinPuzzleDifficulty, puzzles.getCurrentDifficulty());
+
+   // A flood pushes the difficulty up a step at a time, all the way to the max
+   Vector<U32> flood = runRequests(server, time, 20, 200);
+   for(S32 i = 1; i < flood.size(); i++)
+      EXPECT_GE(flood[i], flood[i - 1]);
+   EXPECT_EQ(ClientPuzzleManager::MaxPuzzleDifficulty, puzzles.getCurrentDifficulty());
+   EXPECT_GT(puzzles.getRequestRate(), F32(ClientPuzzleManager::HighRequestRate));
+
+   // Ordinary traffic, between the thresholds, leaves it where it is
+   runRequests(server, time, 30, 10);
+   EXPECT_EQ(ClientPuzzleManager::MaxPuzzleDifficulty, puzzles.getCurrentDifficulty());
+
+   // And it comes back down once things quiet down
+   runRequests(server, time, 20, 0);
+   EXPECT_EQ(ClientPuzzleManager::MinPuzzleDifficulty, puzzles.getCurrentDifficulty());
+}
+
+
+TEST(HandshakeTest, PuzzleDifficultyFollowsHandshakeLoad)
+{
+   ClientPuzzleManager puzzles;
+   Nonce clientNonce;
+   clientNonce.getRandom();
+
+   U32 time = 1000;
+   puzzles.tick(time);
+
+   const U32 startDifficulty = puzzles.getCurrentDifficulty();
+
+   // Expensive handshakes with hardly any requests still raise the difficulty
+   while(puzzles.getCurrentDifficulty() == startDifficulty && time < 10000)
+   {
+      puzzles.recordHandshakeTime(10);
+      time += 100;
+      puzzles.tick(time);
+   }
+
+   ASSERT_EQ(startDifficulty + 1, puzzles.getCurrentDifficulty());
+   Nonce serverNonce = puzzles.getCurrentNonce();
+
+   // Clients that were given the old difficulty get a grace period...
+   EXPECT_EQ(ClientPuzzleManager::Success, puzzles.checkParameters(clientNonce, serverNonce, startDifficulty));
+   EXPECT_EQ(ClientPuzzleManager::Success, puzzles.checkParameters(clientNonce, serverNonce, startDifficulty + 2));
+   EXPECT_EQ(ClientPuzzleManager::InvalidPuzzleDifficulty, puzzles.checkParameters(clientNonce, serverNonce, startDifficulty - 1));
+   EXPECT_EQ(ClientPuzzleManager::InvalidPuzzleDifficulty,
+             puzzles.checkParameters(clientNonce, serverNonce, ClientPuzzleManager::MaxPuzzleDifficulty + 1));
+
+   // ...but not forever.  Keep a moderate load going so the difficulty doesn't drop back down.
+   for(U32 i = 0; i < ClientPuzzleManager::DifficultyGracePeriod / 100; i++)
+   {
+      puzzles.recordHandshakeTime(1);
+      time += 100;
+      puzzles.tick(time);
+   }
+
+   serverNonce = puzzles.getCurrentNonce();
+   EXPECT_GT(puzzles.getCurrentDifficulty(), startDifficulty);
+   EXPECT_EQ(ClientPuzzleManager::InvalidPuzzleDifficulty, puzzles.checkParameters(clientNonce, serverNonce, startDifficulty));
+}
+
+
+TEST(HandshakeTest, FixedPuzzleDifficulty)
+{
+   PuzzleTestInterface server;
+   server.getPuzzleManager().setAdaptiveDifficulty(false);
+
+   U32 time = 1000;
+   server.tick(time);
+   runRequests(server, time, 10, 200);
+
+   EXPECT_EQ(ClientPuzzleManager::InitialPuzzleDifficulty, server.getPuzzleManager().getCurrentDifficulty());
+}
+
+
+};
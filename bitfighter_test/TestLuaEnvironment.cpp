@@ -122,6 +122,21 @@ TEST_F(LuaEnvironmentTest, immutability)
 }
 
 
+TEST_F(LuaEnvironmentTest, argumentChecking)
+{
+   // Each call site only looks up its parameter profile the first time; make sure the remembered profile still
+   // gets checked, for both class methods and module functions
+   for(S32 i = 0; i < 2; i++)
+   {
+      EXPECT_TRUE (levelgen->runString("ResourceItem.new():setPos(point.new(1, 2))"));
+      EXPECT_FALSE(levelgen->runString("ResourceItem.new():setPos('here')"));
+
+      EXPECT_TRUE (levelgen->runString("assert(Geom.segmentsIntersect(point.new(0, 0), point.new(2, 2), point.new(0, 2), point.new(2, 0)))"));
+      EXPECT_FALSE(levelgen->runString("Geom.segmentsIntersect(point.new(0, 0))"));
+   }
+}
+
+
 TEST_F(LuaEnvironmentTest, findAllObjects)
 {
    EXPECT_TRUE(levelgen->runString("bf:addItem(ResourceItem.new(point.new(0,0)))"));
@@ -145,4 +160,61 @@ TEST_F(LuaEnvironmentTest, findAllObjects)
 }
 
 
+TEST_F(LuaEnvironmentTest, eachObject)
+{
+   EXPECT_TRUE(levelgen->runString("bf:addItem(ResourceItem.new(point.new(0,0)))"));
+   EXPECT_TRUE(levelgen->runString("bf:addItem(ResourceItem.new(point.new(300,300)))"));
+   EXPECT_TRUE(levelgen->runString("bf:addItem(TestItem.new(point.new(200,200)))"));
+
+   EXPECT_TRUE(levelgen->runString("function count(...) local n = 0; for obj in bf:eachObject(...) do n = n + 1 end; return n end"));
+   EXPECT_TRUE(levelgen->runString("function countInArea(...) local n = 0; for obj in bf:eachObjectInArea(...) do n = n + 1 end; return n end"));
+
+   EXPECT_TRUE(levelgen->runString("assert(count() == 3)"));
+   EXPECT_TRUE(levelgen->runString("assert(count(ObjType.ResourceItem) == 2)"));
+   EXPECT_TRUE(levelgen->runString("assert(count(ObjType.ResourceItem, ObjType.TestItem) == 3)"));
+   EXPECT_TRUE(levelgen->runString("assert(count(ObjType.TestItem, ObjType.ResourceItem, ObjType.TestItem) == 3)"));
+   EXPECT_TRUE(levelgen->runString("assert(countInArea(point.new(-10,-10), point.new(250,250), ObjType.ResourceItem) == 1)"));
+   EXPECT_TRUE(levelgen->runString("assert(countInArea(point.new(-10,-10), point.new(250,250), ObjType.ResourceItem, ObjType.TestItem) == 2)"));
+
+   // Results are shared, but must notice things coming and going
+   EXPECT_TRUE(levelgen->runString("bf:addItem(ResourceItem.new(point.new(100,100)))"));
+   EXPECT_TRUE(levelgen->runString("assert(count(ObjType.ResourceItem) == 3)"));
+   EXPECT_TRUE(levelgen->runString("assert(#bf:findAllObjects(ObjType.ResourceItem) == 3)"));
+   EXPECT_TRUE(levelgen->runString("assert(countInArea(point.new(-10,-10), point.new(250,250), ObjType.ResourceItem) == 2)"));
+
+   // Moving something changes what's in an area
+   EXPECT_TRUE(levelgen->runString("for obj in bf:eachObject(ObjType.TestItem) do obj:setPos(point.new(1000,1000)) end"));
+   EXPECT_TRUE(levelgen->runString("assert(countInArea(point.new(-10,-10), point.new(250,250), ObjType.TestItem) == 0)"));
+
+   // Removing objects as we go is fine, even though removeFromGame() deletes them on the spot
+   EXPECT_TRUE(levelgen->runString("for obj in bf:eachObject(ObjType.ResourceItem) do obj:removeFromGame() end"));
+   EXPECT_TRUE(levelgen->runString("assert(count(ObjType.ResourceItem) == 0)"));
+   EXPECT_TRUE(levelgen->runString("assert(count() == 1)"));
+
+   // Stopping early is the point of the exercise
+   EXPECT_TRUE(levelgen->runString("for obj in bf:eachObject() do break end"));
+}
+
+
+// Mines come from an object pool that hands back the most recently freed slot first, so mines added while we're
+// iterating land right where the ones we just deleted were.  They weren't there when we searched, so mustn't turn up.
+TEST_F(LuaEnvironmentTest, eachObjectSkipsReusedMemory)
+{
+   EXPECT_TRUE(levelgen->runString("mines = { }; for i = 1, 4 do mines[i] = Mine.new(point.new(i * 100, 0)); bf:addItem(mines[i]) end"));
+
+   EXPECT_TRUE(levelgen->runString(
+         "seen = 0 "
+         "for obj in bf:eachObject(ObjType.Mine) do "
+         "   seen = seen + 1 "
+         "   if seen == 1 then "
+         "      for i = 1, 4 do if mines[i]:getId() ~= obj:getId() then mines[i]:removeFromGame() end end "
+         "      for i = 1, 3 do bf:addItem(Mine.new(point.new(i * 100, 500))) end "
+         "   end "
+         "end"));
+
+   EXPECT_TRUE(levelgen->runString("assert(seen == 1)"));
+   EXPECT_TRUE(levelgen->runString("assert(#bf:findAllObjects(ObjType.Mine) == 4)"));
+}
+
+
 };
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "../zap/LuaException.h"
+#include "../zap/LuaScriptCache.h"
+#include "../zap/stringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+namespace Zap
+{
+
+using namespace std;
+using namespace TNL;
+
+class LuaScriptCacheTest : public testing::Test
+{
+protected:
+   lua_State *L;
+   string bytecodeDir;
+
+   virtual void SetUp()
+   {
+      L = luaL_newstate();
+
+      bytecodeDir = "lua_cache_test";
+      clearBytecodeDir();
+
+      LuaScriptCache::setMaxScripts(32);
+      LuaScriptCache::setBytecodeDir("");
+      LuaScriptCache::resetStats();
+   }
+
+
+   virtual void TearDown()
+   {
+      LuaScriptCache::clear(L);
+      LuaScriptCache::setBytecodeDir("");
+      lua_close(L);
+
+      clearBytecodeDir();
+      remove("cache_test_a.lua");
+      remove("cache_test_b.lua");
+      remove("cache_test_c.lua");
+   }
+
+
+   void clearBytecodeDir()
+   {
+      Vector<string> files;
+      getFilesFromFolder(bytecodeDir, files);
+
+      for(S32 i = 0; i < files.size(); i++)
+         remove(joindir(bytecodeDir, files[i]).c_str());
+   }
+
+
+   // Loads the script, runs it, and returns what it returned
+   S32 run(const string &filename, bool keepInMemory = true)
+   {
+      LuaScriptCache::load(L, filename, keepInMemory);
+      EXPECT_EQ(0, lua_pcall(L, 0, 1, 0));
+
+      S32 result = (S32)lua_tointeger(L, -1);
+      lua_pop(L, 1);
+
+      return result;
+   }
+
+
+   void expectStats(U32 memoryHits, U32 bytecodeHits, U32 compiles)
+   {
+      EXPECT_EQ(memoryHits,   LuaScriptCache::getStats().memoryHits);
+      EXPECT_EQ(bytecodeHits, LuaScriptCache::getStats().bytecodeHits);
+      EXPECT_EQ(compiles,     LuaScriptCache::getStats().compiles);
+   }
+};
+
+
+TEST_F(LuaScriptCacheTest, memoryCache)
+{
+   writeFile("cache_test_a.lua", "return 1");
+
+   EXPECT_EQ(1, run("cache_test_a.lua"));
+   EXPECT_EQ(1, run("cache_test_a.lua"));
+   expectStats(1, 0, 1);
+
+   // Edited file; a different size, as the modification time only has a resolution of a second
+   writeFile("cache_test_a.lua", "return 222");
+   EXPECT_EQ(222, run("cache_test_a.lua"));
+   expectStats(1, 0, 2);
+
+   // Not kept, so not found next time either
+   writeFile("cache_test_b.lua", "return 2");
+   EXPECT_EQ(2, run("cache_test_b.lua", false));
+   EXPECT_EQ(2, run("cache_test_b.lua"));
+   expectStats(1, 0, 4);
+}
+
+
+TEST_F(LuaScriptCacheTest, leastRecentlyUsedGoesFirst)
+{
+   LuaScriptCache::setMaxScripts(2);
+
+   writeFile("cache_test_a.lua", "return 1");
+   writeFile("cache_test_b.lua", "return 2");
+   writeFile("cache_test_c.lua", "return 3");
+
+   run("cache_test_a.lua");
+   run("cache_test_b.lua");
+   run("cache_test_a.lua");      // b is now the oldest...
+   run("cache_test_c.lua");      // ...so this pushes it out
+   expectStats(1, 0, 3);
+
+   run("cache_test_a.lua");
+   expectStats(2, 0, 3);
+
+   run("cache_test_b.lua");
+   expectStats(2, 0, 4);
+}
+
+
+TEST_F(LuaScriptCacheTest, bytecodeCache)
+{
+   LuaScriptCache::setBytecodeDir(bytecodeDir);
+
+   writeFile("cache_test_a.lua", "local x = 40\nreturn x + 2");
+   EXPECT_EQ(42, run("cache_test_a.lua"));
+   expectStats(0, 0, 1);
+
+   // As if the server had restarted
+   LuaScriptCache::clear(L);
+   EXPECT_EQ(42, run("cache_test_a.lua"));
+   expectStats(0, 1, 1);
+
+   // Edited scripts don't pick up the old bytecode
+   writeFile("cache_test_a.lua", "local x = 40\nreturn x + 3");
+   EXPECT_EQ(43, run("cache_test_a.lua", false));
+   expectStats(0, 1, 2);
+
+   // And neither does a damaged bytecode file
+   Vector<string> files;
+   getFilesFromFolder(bytecodeDir, files);
+   ASSERT_EQ(2, files.size());
+
+   for(S32 i = 0; i < files.size(); i++)
+      writeFile(joindir(bytecodeDir, files[i]), "return 99");
+
+   EXPECT_EQ(43, run("cache_test_a.lua", false));
+   expectStats(0, 1, 3);
+
+   // Errors still name the script and line
+   writeFile("cache_test_b.lua", "local x = 1\nx = = 2");
+
+   try
+   {
+      LuaScriptCache::load(L, "cache_test_b.lua", true);
+      FAIL() << "Expected a compile error";
+   }
+   catch(LuaException &e)
+   {
+      EXPECT_NE(string::npos, e.msg.find("cache_test_b.lua:2:"));
+   }
+}
+
+
+};
@@ -9,7 +9,10 @@
 
 #include "../master/master.h"
 #include "../master/MasterServerConnection.h"
+#include "../master/LruCache.h"
+#include "../master/database.h"
 #include "masterConnection.h"
+#include "stringUtils.h"
 #include "ClientGame.h"
 #include "UIManager.h"
 
@@ -39,5 +42,194 @@ TEST(MasterTest, Sanity)
 
    delete clientGame;
 }
+
+
+TEST(MasterTest, LruCache)
+{
+   LruCache<U32, S32> cache(2);
+
+   cache.insert(1, shared_ptr<S32>(new S32(10)));
+   cache.insert(2, shared_ptr<S32>(new S32(20)));
+   EXPECT_EQ(10, *cache.find(1));         // 1 is now most recently used...
+
+   cache.insert(3, shared_ptr<S32>(new S32(30)));
+   EXPECT_TRUE(cache.find(2).get() == NULL);    // ...so 2 got evicted
+   EXPECT_EQ(10, *cache.find(1));
+   EXPECT_EQ(30, *cache.find(3));
+
+   EXPECT_EQ(2U, cache.size());
+   EXPECT_EQ(3U, cache.getHits());
+   EXPECT_EQ(1U, cache.getMisses());
+   EXPECT_EQ(1U, cache.getEvictions());
+
+   // Iteration is least recently used first
+   EXPECT_EQ(1U, cache.begin()->first);
+
+   cache.setMaxSize(1);
+   EXPECT_EQ(1U, cache.size());
+   EXPECT_TRUE(cache.find(3).get() != NULL);
+}
+
+
+// Runs the stats lookups that follow each successful phpBB login, returning logins per second
+static F64 timeLogins(DbWriter::DatabaseWriter &writer, const Vector<string> &names, S32 logins)
+{
+   S64 start = Platform::getHighPrecisionTimerValue();
+
+   for(S32 i = 0; i < logins; i++)
+   {
+      writer.getAchievements(names[i % names.size()].c_str());
+      writer.getGamesPlayed(names[i % names.size()].c_str());
+   }
+
+   F64 ms = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+   return logins * 1000.0 / max(ms, 0.001);
+}
+
+
+// We don't have a phpBB server here, so a local sqlite stats database stands in for it
+static void addTestPlayers(DbWriter::DatabaseWriter &writer, Vector<string> &names)
+{
+   names.push_back("Alpha");
+   names.push_back("O'Brien");      // Quotes must survive parameter binding
+   names.push_back("Zed");
+
+   writer.insertAchievement(BADGE_TWENTY_FIVE_FLAGS, names[0].c_str(), "Server", "1.2.3.4");
+   writer.insertAchievement(BADGE_BBB_GOLD,          names[0].c_str(), "Server", "1.2.3.4");
+   writer.insertAchievement(BADGE_BBB_GOLD,          names[1].c_str(), "Server", "1.2.3.4");
+}
+
+
+TEST(MasterTest, LoginStats)
+{
+   const char *dbFile = "login_stats_test.db";
+   remove(dbFile);
+
+   DbWriter::DatabaseWriter writer(dbFile);
+
+   Vector<string> names;
+   addTestPlayers(writer, names);
+
+   EXPECT_EQ(BIT(BADGE_TWENTY_FIVE_FLAGS) | BIT(BADGE_BBB_GOLD), (S32)writer.getAchievements(names[0].c_str()));
+   EXPECT_EQ(BIT(BADGE_BBB_GOLD), (S32)writer.getAchievements(names[1].c_str()));
+   EXPECT_EQ(0, (S32)writer.getAchievements(names[2].c_str()));
+   EXPECT_EQ(0, writer.getGamesPlayed(names[1].c_str()));
+
+   const S32 Logins = 20;
+
+   DbWriter::DbConnectionPool::setEnabled(false);
+   timeLogins(writer, names, Logins);
+   EXPECT_EQ(0, DbWriter::DbConnectionPool::getIdleCount());
+
+   DbWriter::DbConnectionPool::setEnabled(true);
+   timeLogins(writer, names, Logins);
+   EXPECT_EQ(1, DbWriter::DbConnectionPool::getIdleCount());     // Every lookup reused the same connection
+
+   DbWriter::DbConnectionPool::closeAll();
+   remove(dbFile);
+}
+
+
+// Saves whatever's in the caches and returns what was written, or "" if nothing was
+static string snapshotCaches(const char *filename)
+{
+   remove(filename);
+   MasterServerConnection::saveCacheSnapshot(filename);
+   EXPECT_FALSE(fileExists(string(filename) + ".tmp"));
+
+   return fileExists(filename) ? readFile(filename) : "";
+}
+
+
+TEST(MasterTest, CacheSnapshot)
+{
+   const char *snapshotFile = "cache_snapshot_test.txt";
+   const char *loadFile     = "cache_snapshot_test_in.txt";
+
+   // Written in the order saveCacheSnapshot() writes things, so saving what we load should give the same file back
+   string snapshot =
+         "# Bitfighter master cache snapshot v1\n"
+         "H 2 2 4\n"
+         "Top Players\n"
+         "Top Scorers\n"
+         "Alpha\n"      "1200\n"
+         "Bravo Two\n"  "900\n"
+         "Alpha\n"      "55\n"
+         "O'Brien\n"    "40\n"
+         "T 10 7\n"
+         "T 11 -3\n"
+         "P 10 1 O'Brien\n"
+         "P 11 -1 Player With Spaces\n";
+
+   MasterServerConnection::clearCaches();
+   writeFile(loadFile, snapshot);
+   MasterServerConnection::loadCacheSnapshot(loadFile);
+   EXPECT_EQ(snapshot, snapshotCaches(snapshotFile));
+
+   // And once more, from the file we just saved
+   MasterServerConnection::clearCaches();
+   MasterServerConnection::loadCacheSnapshot(snapshotFile);
+   EXPECT_EQ(snapshot, snapshotCaches(snapshotFile));
+
+   // A damaged file gives us what we can read: unreadable lines are skipped, and a record cut off part way is dropped
+   MasterServerConnection::clearCaches();
+   writeFile(loadFile,
+         "# Bitfighter master cache snapshot v1\n"
+         "T 10 7\n"
+         "T ten 7\n"
+         "Q 1 2 3\n"
+         "P 11 -1 Player With Spaces\n"
+         "P 12 5\n"
+         "H 2 2 4\n"
+         "Top Players\n"
+         "Top Scorers\n"
+         "Alpha\n");
+   MasterServerConnection::loadCacheSnapshot(loadFile);
+   EXPECT_EQ("# Bitfighter master cache snapshot v1\n"
+             "T 10 7\n"
+             "P 11 -1 Player With Spaces\n", snapshotCaches(snapshotFile));
+
+   // A file that isn't a snapshot at all gets ignored, and with nothing cached, saving writes nothing
+   MasterServerConnection::clearCaches();
+   writeFile(loadFile, "T 10 7\nP 10 1 O'Brien\n");
+   MasterServerConnection::loadCacheSnapshot(loadFile);
+   EXPECT_EQ("", snapshotCaches(snapshotFile));
+
+   // Nor does an empty one
+   writeFile(loadFile, "");
+   MasterServerConnection::loadCacheSnapshot(loadFile);
+   EXPECT_EQ("", snapshotCaches(snapshotFile));
+
+   MasterServerConnection::clearCaches();
+   remove(loadFile);
+   remove(snapshotFile);
+}
+
+
+// Not a correctness test -- reports how many logins' worth of stats lookups we can do a second, with and
+// without pooled connections
+TEST(MasterTest, DISABLED_LoginBenchmark)
+{
+   const char *dbFile = "login_stress_test.db";
+   remove(dbFile);
+
+   DbWriter::DatabaseWriter writer(dbFile);
+
+   Vector<string> names;
+   addTestPlayers(writer, names);
+
+   const S32 Logins = 2000;
+
+   DbWriter::DbConnectionPool::setEnabled(false);
+   F64 unpooled = timeLogins(writer, names, Logins);
+
+   DbWriter::DbConnectionPool::setEnabled(true);
+   F64 pooled = timeLogins(writer, names, Logins);
+
+   printf("Logins/sec: %.0f unpooled, %.0f pooled\n", unpooled, pooled);
+
+   DbWriter::DbConnectionPool::closeAll();
+   remove(dbFile);
+}
 	
 };
@@ -17,6 +17,7 @@
 #include "gameType.h"
 #include "ServerGame.h"
 #include "ClientGame.h"
+#include "projectile.h"
 #include "SystemFunctions.h"
 
 #include "GeomUtils.h"
@@ -243,5 +244,46 @@ TEST_F(ObjectTest, LuaSanity)
    lua_close(L);
 }
 
+
+#ifndef BF_NO_OBJECT_POOLS
+TEST_F(ObjectTest, PooledProjectiles)
+{
+   ObjectPool &pool = Projectile::getObjectPool();
+   U32 live = pool.getLiveCount();
+
+   Vector<Projectile *> projectiles;
+   for(S32 i = 0; i < 50; i++)
+      projectiles.push_back(new Projectile());
+
+   EXPECT_EQ(live + 50, pool.getLiveCount());
+   EXPECT_GE(pool.getPeakCount(), live + 50);
+
+   U32 slots = pool.getSlotCount();
+
+   for(S32 i = 0; i < projectiles.size(); i++)
+      delete projectiles[i];
+
+   EXPECT_EQ(live, pool.getLiveCount());
+
+   // Another volley reuses the freed slots rather than growing the pool
+   for(S32 i = 0; i < projectiles.size(); i++)
+      projectiles[i] = new Projectile();
+
+   EXPECT_EQ(slots, pool.getSlotCount());
+
+   for(S32 i = 0; i < projectiles.size(); i++)
+      delete projectiles[i];
+
+   // Subclasses get their own pools, sized for them
+   Burst *mine = new Mine();
+   EXPECT_EQ(1, Mine::getObjectPool().getLiveCount());
+   EXPECT_EQ(0, Burst::getObjectPool().getLiveCount());
+   delete mine;
+
+   EXPECT_EQ(0, Mine::getObjectPool().getLiveCount());
+   EXPECT_EQ(0, Mine::getObjectPool().getOversizeCount());
+}
+#endif
+
    
 }; // namespace Zap
@@ -8,6 +8,9 @@
 #include "../zap/ServerGame.h"
 #include "../zap/gameType.h"
 #include "../zap/luaLevelGenerator.h"
+#include "../zap/robot.h"
+#include "../zap/stringUtils.h"
+
 #include "gtest/gtest.h"
 
 namespace Zap
@@ -62,6 +65,36 @@ TEST(RobotTest, luaRobotNew)
 }
 
 
+TEST(RobotTest, nativeBrain)
+{
+	GamePair gamePair;
+	gamePair.server->setAutoLeveling(false);
+
+	string noTeam = itos(NO_TEAM);
+	Vector<const char *> args;
+	args.push_back(noTeam.c_str());
+
+	args.push_back("native:no_such_bot");
+	EXPECT_NE("", gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots));
+
+	args[1] = "native:s_bot";
+	EXPECT_EQ("", gamePair.server->addBot(args, ClientInfo::ClassRobotAddedByAddbots));
+
+	for(U32 i = 0; i < 100; i++)
+		gamePair.idle(10);
+
+	ASSERT_EQ(1, gamePair.server->getBotCount());
+
+	Robot *bot = gamePair.server->getBot(0);
+	EXPECT_TRUE(bot->hasBrain());
+	EXPECT_EQ("S_Bot", string(bot->getClientInfo()->getName().getString()));
+
+	// Thinking every tick, just as the script would
+	Move move = bot->getCurrentMove();
+	EXPECT_TRUE(move.x != 0 || move.y != 0);
+}
+
+
 /** onShipSpawned doesn't fire?
 
 TEST(RobotTest, RemoveFromGameDuringInitialOnShipSpawn)
@@ -4,8 +4,17 @@
 //------------------------------------------------------------------------------
 
 #include "gameType.h"
+#include "GameManager.h"
 #include "ServerGame.h"
 #include "EngineeredItem.h"
+#include "TargetIndex.h"
+#include "ProjectileSystem.h"
+#include "projectile.h"
+#include "ZoneCoverage.h"
+#include "TickProfiler.h"
+#include "TickScheduler.h"
+#include "Zone.h"
+#include "GeomUtils.h"
 
 #include "TestUtils.h"
 
@@ -165,4 +174,412 @@ TEST(ServerGameTest, LoadoutManagementTests)
 }
 
 
+TEST(ServerGameTest, TargetIndex)
+{
+   ServerGame *serverGame = newServerGame();
+   GridDatabase *db = serverGame->getGameObjDatabase();
+
+   // Wall runs from (255, -255) to (255, 255)
+   serverGame->loadLevelFromString("GameType 10 8\nGridSize 255\nBarrierMaker 40 1 -1 1 1\n", db);
+
+   ResourceItem *viewer  = new ResourceItem();     // These cleaned up by database
+   ResourceItem *behind  = new ResourceItem();
+   ResourceItem *inSight = new ResourceItem();
+
+   viewer->setPos(Point(0, 0));
+   behind->setPos(Point(510, 0));
+   inSight->setPos(Point(0, 255));
+
+   viewer->setTeam(0);
+   behind->setTeam(1);
+   inSight->setTeam(1);
+
+   viewer->addToGame(serverGame, db);
+   behind->addToGame(serverGame, db);
+   inSight->addToGame(serverGame, db);
+
+   TargetIndex *index = serverGame->getTargetIndex();
+   index->startTick(db);
+
+   Vector<DatabaseObject *> fillVector;
+   index->findTargets((TestFunc)isTurretTargetType, Rect(Point(-100, -100), Point(600, 100)), fillVector);
+   EXPECT_EQ(2, fillVector.size());
+
+   fillVector.clear();
+   index->findEnemyTargets(0, (TestFunc)isTurretTargetType, Rect(Point(-100, -100), Point(600, 300)), fillVector);
+   EXPECT_EQ(2, fillVector.size());
+
+   fillVector.clear();
+   index->findEnemyTargets(1, (TestFunc)isTurretTargetType, Rect(Point(-100, -100), Point(600, 300)), fillVector);
+   ASSERT_EQ(1, fillVector.size());
+   EXPECT_EQ(viewer, fillVector[0]);
+
+   EXPECT_FALSE(index->canSee(viewer, viewer->getPos(), behind,  TargetIndex::BlockedByWalls));
+   EXPECT_TRUE (index->canSee(viewer, viewer->getPos(), inSight, TargetIndex::BlockedByWalls));
+   EXPECT_FALSE(index->canSee(viewer, viewer->getPos(), behind,  TargetIndex::BlockedByCollideables));
+   EXPECT_EQ(0, index->getVisibilityHitCount());
+
+   // Asking again gets the cached answer, but only for the same viewer looking from exactly the same spot; even a
+   // couple of units can put a wall corner in the way
+   EXPECT_FALSE(index->canSee(viewer, viewer->getPos(), behind, TargetIndex::BlockedByWalls));
+   EXPECT_EQ(1, index->getVisibilityHitCount());
+   EXPECT_FALSE(index->canSee(viewer, Point(2, 2), behind, TargetIndex::BlockedByWalls));
+   EXPECT_FALSE(index->canSee(inSight, viewer->getPos(), behind, TargetIndex::BlockedByWalls));
+   EXPECT_EQ(6, index->getVisibilityTestCount());
+   EXPECT_EQ(1, index->getVisibilityHitCount());
+
+   // Something arriving mid-tick can be targeted straight away
+   ResourceItem *arrival = new ResourceItem();
+   arrival->setPos(Point(100, 0));
+   arrival->setTeam(1);
+   arrival->addToGame(serverGame, db);
+
+   fillVector.clear();
+   index->findEnemyTargets(0, (TestFunc)isTurretTargetType, Rect(Point(-100, -100), Point(600, 100)), fillVector);
+   EXPECT_EQ(2, fillVector.size());
+   EXPECT_TRUE(fillVector.contains(arrival));
+
+   // Next tick, things may have moved
+   inSight->setPos(Point(510, 255));
+   index->startTick(db);
+   EXPECT_FALSE(index->canSee(viewer, viewer->getPos(), inSight, TargetIndex::BlockedByWalls));
+   EXPECT_EQ(0, index->getVisibilityHitCount());
+
+   delete serverGame;
+}
+
+
+static bool sortZonesBySerialNumber(Zone * const &a, Zone * const &b)
+{
+   return a->getSerialNumber() < b->getSerialNumber();
+}
+
+
+// The slow way, as MoveObject used to do it -- but in the order ZoneCoverage gives us
+static void findZonesContaining(GridDatabase *db, const Point &p, Vector<Zone *> &zones)
+{
+   Vector<DatabaseObject *> fillVector;
+   db->findObjects((TestFunc)isZoneType, fillVector, Rect(p, p));
+
+   zones.clear();
+   for(S32 i = 0; i < fillVector.size(); i++)
+   {
+      const Vector<Point> *poly = fillVector[i]->getCollisionPoly();
+      if(polygonContainsPoint(poly->address(), poly->size(), p))
+         zones.push_back(static_cast<Zone *>(fillVector[i]));
+   }
+
+   zones.sort(sortZonesBySerialNumber);
+}
+
+
+TEST(ServerGameTest, ZoneCoverage)
+{
+   ServerGame *serverGame = newServerGame();
+   GridDatabase *db = serverGame->getGameObjDatabase();
+
+   // Overlapping squares, a concave zone, and a loadout zone whose edges fall on cell borders
+   serverGame->loadLevelFromString(
+         "GameType 10 8\n"
+         "GridSize 255\n"
+         "Team Blue 0 0 1\n"
+         "Zone 0 0 2 0 2 2 0 2\n"
+         "Zone 1 1 3 1 3 3 1 3\n"
+         "Zone 0 4 4 4 4 8 2 5 0 8\n"
+         "LoadoutZone 0 0 -2 2 -2 2 -1 0 -1\n", db);
+
+   ZoneCoverage coverage;
+   Vector<Zone *> expected, found;
+
+   // Random points, plus points right on zone corners and edges
+   Vector<Point> points;
+   for(S32 i = 0; i < 20000; i++)
+      points.push_back(Point(TNL::Random::readF() * 1400 - 200, TNL::Random::readF() * 2800 - 700));
+
+   for(S32 x = -1; x <= 5; x++)
+      for(S32 y = -3; y <= 9; y++)
+      {
+         points.push_back(Point(x * 255, y * 255));
+         points.push_back(Point(x * 255 + 127.5f, y * 255));
+         points.push_back(Point(x * 255, y * 255 + 127.5f));
+      }
+
+   for(S32 i = 0; i < points.size(); i++)
+   {
+      findZonesContaining(db, points[i], expected);
+      coverage.findZones(db, points[i], found);
+
+      ASSERT_EQ(expected.size(), found.size()) << "At " << points[i].toString();
+      for(S32 j = 0; j < expected.size(); j++)
+         EXPECT_EQ(expected[j], found[j]);
+   }
+
+   // Most points shouldn't have needed a polygon test
+   EXPECT_LT(coverage.getPolygonTestCount(), U32(points.size() / 2));
+
+   // Coverage notices when zones come and go
+   Zone *zone = new Zone();
+   Vector<Point> geom;
+   geom.push_back(Point(-100, -100));
+   geom.push_back(Point(-50, -100));
+   geom.push_back(Point(-50, -50));
+   zone->GeomObject::setGeom(geom);
+   zone->onGeomChanged();
+   zone->addToGame(serverGame, db);
+
+   coverage.findZones(db, Point(-60, -90), found);
+   ASSERT_EQ(1, found.size());
+   EXPECT_EQ(zone, found[0]);
+
+   delete zone;
+   coverage.findZones(db, Point(-60, -90), found);
+   EXPECT_EQ(0, found.size());
+
+   delete serverGame;
+}
+
+
+TEST(ServerGameTest, ProjectileSystem)
+{
+   ServerGame *serverGame = newServerGame();
+   GridDatabase *db = serverGame->getGameObjDatabase();
+
+   // Wall runs from (255, -255) to (255, 255)
+   serverGame->loadLevelFromString("GameType 10 8\nGridSize 255\nBarrierMaker 40 1 -1 1 1\n", db);
+
+   Projectile *clear   = new Projectile(WeaponPhaser, Point(0, -1000), Point(500, 0), NULL);    // Cleaned up by database
+   Projectile *blocked = new Projectile(WeaponPhaser, Point(0, 0), Point(3000, 0), NULL);
+
+   clear->addToGame(serverGame, db);
+   blocked->addToGame(serverGame, db);
+
+   ProjectileSystem *projectiles = serverGame->getProjectileSystem();
+   EXPECT_EQ(2, projectiles->getProjectileCount());
+
+   projectiles->idle(db, 100);
+
+   // One flies through open space, the other has to be checked against the wall, and hits it
+   EXPECT_EQ(1, projectiles->getFreeFlightCount());
+   EXPECT_EQ(1, projectiles->getDetailedCount());
+
+   EXPECT_EQ(Point(50, -1000), clear->getPos());
+   EXPECT_TRUE(clear->isInFlight());
+   EXPECT_FALSE(blocked->isInFlight());
+
+   // Regular idling leaves them to the system
+   clear->idle(BfObject::ServerIdleMainLoop);
+   EXPECT_EQ(Point(50, -1000), clear->getPos());
+
+   // Bullets run out of time in the system too
+   for(S32 i = 0; i < 100 && !clear->isDeleted(); i++)
+      projectiles->idle(db, 100);
+
+   EXPECT_TRUE(clear->isDeleted());
+
+   delete serverGame;
+}
+
+
+
+TEST(ServerGameTest, TickProfiler)
+{
+   TickProfiler profiler;
+
+   // Ticks taking 1 to 100 thousand timer units, in a random order
+   Vector<S32> ticks;
+   for(S32 i = 1; i <= 100; i++)
+      ticks.push_back(i);
+   for(S32 i = ticks.size() - 1; i > 0; i--)
+      swap(ticks[i], ticks[TNL::Random::readI(0, i)]);
+
+   for(S32 i = 0; i < ticks.size(); i++)
+   {
+      profiler.addTime(TickProfiler::StageObjectIdle, ticks[i] * 1000);
+      profiler.endTick();
+   }
+
+   TickProfiler::ZoneStats stats = profiler.getStats(TickProfiler::StageObjectIdle);
+   EXPECT_EQ(100, stats.samples);
+   EXPECT_FLOAT_EQ(F32(Platform::getHighPrecisionMilliseconds(50500)),      stats.mean);
+   EXPECT_FLOAT_EQ(F32(Platform::getHighPrecisionMilliseconds(50 * 1000)),  stats.p50);
+   EXPECT_FLOAT_EQ(F32(Platform::getHighPrecisionMilliseconds(99 * 1000)),  stats.p99);
+   EXPECT_FLOAT_EQ(F32(Platform::getHighPrecisionMilliseconds(100 * 1000)), stats.max);
+
+   // Zones that were never entered have no samples, rather than a pile of zeros
+   EXPECT_EQ(0, profiler.getStats(TickProfiler::StageGameRecorder).samples);
+   EXPECT_EQ(0, profiler.getStats(TickProfiler::getTypeZone(BarrierTypeNumber)).samples);
+
+   // Only the most recent ticks count; the slow ones above roll out of the window
+   for(U32 i = 0; i < TickProfiler::HistoryLength; i++)
+   {
+      profiler.addTime(TickProfiler::StageObjectIdle, 1000);
+      profiler.endTick();
+   }
+
+   stats = profiler.getStats(TickProfiler::StageObjectIdle);
+   EXPECT_EQ(U32(TickProfiler::HistoryLength), stats.samples);
+   EXPECT_FLOAT_EQ(F32(Platform::getHighPrecisionMilliseconds(1000)), stats.max);
+
+   EXPECT_STREQ("Barrier", TickProfiler::getZoneName(TickProfiler::getTypeZone(BarrierTypeNumber)));
+
+   profiler.reset();
+   EXPECT_EQ(0, profiler.getTickCount());
+   EXPECT_EQ(0, profiler.getStats(TickProfiler::StageObjectIdle).samples);
+
+#ifndef BF_NO_TICK_PROFILER
+   // A real server fills in the stages, and the types that are on the map
+   ServerGame *serverGame = newServerGame();
+   GridDatabase *db = serverGame->getGameObjDatabase();
+   serverGame->loadLevelFromString("GameType 10 8\nGridSize 255\nBarrierMaker 40 1 -1 1 1\n", db);
+
+   TickProfiler *serverProfiler = serverGame->getTickProfiler();
+
+   // While suspended, all the server does is talk to its connections
+   for(S32 i = 0; i < 10; i++)
+      serverGame->idle(10);
+
+   EXPECT_EQ(10, serverProfiler->getStats(TickProfiler::StageConnections).samples);
+   EXPECT_EQ(0,  serverProfiler->getStats(TickProfiler::StageObjectIdle).samples);
+
+   serverGame->unsuspendGame(false);
+
+   for(S32 i = 0; i < 10; i++)
+      serverGame->idle(10);
+
+   EXPECT_EQ(20, serverProfiler->getTickCount());
+   EXPECT_EQ(20, serverProfiler->getStats(TickProfiler::StageTick).samples);
+   EXPECT_EQ(20, serverProfiler->getStats(TickProfiler::StageConnections).samples);
+   EXPECT_EQ(10, serverProfiler->getStats(TickProfiler::StageObjectIdle).samples);
+   EXPECT_EQ(10, serverProfiler->getStats(TickProfiler::StageGameType).samples);
+   EXPECT_EQ(10, serverProfiler->getStats(TickProfiler::getTypeZone(BarrierTypeNumber)).samples);
+   EXPECT_EQ(0,  serverProfiler->getStats(TickProfiler::getTypeZone(PlayerShipTypeNumber)).samples);
+
+   delete serverGame;
+#endif
+}
+
+
+TEST(ServerGameTest, TickScheduler)
+{
+   TickScheduler scheduler;
+   scheduler.setTickRate(100);
+   scheduler.setMaxCatchUpTicks(5);
+
+   EXPECT_EQ(10, scheduler.getTickPeriod());
+   EXPECT_EQ(0, scheduler.getTicksDue(0));      // Nothing happens until we start
+
+   scheduler.start(1000);
+   EXPECT_FALSE(scheduler.isSchedulingSends());
+
+   // The first tick is due right away, the next one on the following 10ms boundary, however late we wake up
+   EXPECT_EQ(1, scheduler.getTicksDue(1000));
+   EXPECT_EQ(0, scheduler.getTicksDue(1005));
+   EXPECT_DOUBLE_EQ(5, scheduler.getTimeUntilNextDeadline(1005));
+   EXPECT_EQ(1, scheduler.getTicksDue(1013));
+   EXPECT_DOUBLE_EQ(7, scheduler.getTimeUntilNextDeadline(1013));
+
+   // Falling a few ticks behind runs them back to back
+   EXPECT_EQ(3, scheduler.getTicksDue(1041));
+   EXPECT_EQ(2, scheduler.getStats().catchUpTicks);
+   EXPECT_DOUBLE_EQ(21, scheduler.getStats().maxLateness);
+
+   // Falling a long way behind drops all but the last few, and we carry on along the same grid
+   EXPECT_EQ(5, scheduler.getTicksDue(1204));
+   EXPECT_EQ(11, scheduler.getStats().droppedTicks);
+   EXPECT_EQ(10, scheduler.getStats().ticks);
+   EXPECT_DOUBLE_EQ(6, scheduler.getTimeUntilNextDeadline(1204));
+
+   scheduler.recordTickTime(4);
+   scheduler.recordTickTime(12);
+   EXPECT_EQ(1, scheduler.getStats().overruns);
+   EXPECT_DOUBLE_EQ(12, scheduler.getStats().maxTickTime);
+
+   // The clock being set back an hour starts a fresh grid from the new time, rather than waiting for the old one
+   EXPECT_EQ(0, scheduler.getTicksDue(1205));      // A little early is just early, though
+   EXPECT_EQ(1, scheduler.getTicksDue(1210 - 3600000));
+   EXPECT_EQ(1, scheduler.getStats().clockResets);
+   EXPECT_EQ(0, scheduler.getTicksDue(1215 - 3600000));
+   EXPECT_EQ(1, scheduler.getTicksDue(1220 - 3600000));
+
+   // And being set forward an hour runs no more than the usual catch-up ticks
+   EXPECT_EQ(5, scheduler.getTicksDue(1220));
+   EXPECT_DOUBLE_EQ(10, scheduler.getTimeUntilNextDeadline(1220));
+   EXPECT_EQ(1, scheduler.getStats().clockResets);
+
+   // With a send rate, packets go out on their own cadence, without making up for missed sends
+   scheduler.setSendRate(20);
+   scheduler.start(2000);
+   EXPECT_TRUE(scheduler.isSchedulingSends());
+   EXPECT_FALSE(scheduler.isSendDue(2049));
+   EXPECT_TRUE(scheduler.isSendDue(2050));
+   EXPECT_FALSE(scheduler.isSendDue(2099));
+   EXPECT_TRUE(scheduler.isSendDue(2230));
+   EXPECT_FALSE(scheduler.isSendDue(2279));
+   EXPECT_TRUE(scheduler.isSendDue(2280));
+   EXPECT_EQ(3, scheduler.getStats().sends);
+
+   scheduler.resetStats();
+   EXPECT_EQ(0, scheduler.getStats().ticks);
+
+   // A server whose scheduler is sending for it leaves packets out of idle() until asked
+   ServerGame *serverGame = newServerGame();
+   serverGame->unsuspendGame(false);
+   TickProfiler *serverProfiler = serverGame->getTickProfiler();
+
+   serverGame->getTickScheduler()->setSendRate(20);
+   serverGame->getTickScheduler()->start(0);
+
+   serverGame->idle(10);
+   EXPECT_EQ(0, serverProfiler->getStats(TickProfiler::StageConnections).samples);
+
+   serverGame->sendPackets();
+   serverGame->idle(10);
+
+#ifndef BF_NO_TICK_PROFILER
+   EXPECT_EQ(1, serverProfiler->getStats(TickProfiler::StageConnections).samples);
+#endif
+
+   serverGame->getTickScheduler()->stop();
+   serverGame->idle(10);
+
+#ifndef BF_NO_TICK_PROFILER
+   EXPECT_EQ(2, serverProfiler->getStats(TickProfiler::StageConnections).samples);
+#endif
+
+   delete serverGame;
+}
+
+
+
+TEST(ServerGameTest, SeveralGames)
+{
+   ServerGame *mainGame = newServerGame();
+   ServerGame *extraGame = newServerGame();
+
+   GameManager::setServerGame(mainGame);
+   GameManager::addServerGame(extraGame);
+   ASSERT_EQ(2, GameManager::getServerGames()->size());
+   EXPECT_EQ(mainGame, GameManager::getServerGame());
+
+   // Scripts in one game don't hear about, or get paused by, what goes on in the other
+   EXPECT_NE(mainGame->getEventManager(), extraGame->getEventManager());
+   extraGame->getEventManager()->setPaused(true);
+   EXPECT_FALSE(mainGame->getEventManager()->isPaused());
+
+   // Nor does one game loading its levels hold up the other
+   extraGame->setHostingModePhase(GameManager::LoadingLevels);
+   EXPECT_EQ(GameManager::NotHosting, mainGame->getHostingModePhase());
+   EXPECT_EQ(GameManager::NotHosting, GameManager::getHostingModePhase());
+
+   // All games share one FolderManager, which has to outlive any one game's settings
+   FolderManager *folderManager = GameSettings::getFolderManager();
+
+   GameManager::deleteServerGame(extraGame);
+   EXPECT_EQ(1, GameManager::getServerGames()->size());
+   EXPECT_EQ(mainGame, GameManager::getServerGame());
+   EXPECT_EQ(folderManager, GameSettings::getFolderManager());
+
+   GameManager::deleteServerGame();
+}
+
 };
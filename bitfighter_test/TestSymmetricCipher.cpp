@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "tnlSymmetricCipher.h"
+#include "tnlCryptoBackend.h"
+#include "tnlBitStream.h"
+#include "tnlPlatform.h"
+#include "tnlVector.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+namespace Zap
+{
+
+using namespace TNL;
+
+// Every backend that works on this machine; the portable one always comes first
+static Vector<CryptoBackend *> getBackends()
+{
+   Vector<CryptoBackend *> backends;
+   backends.push_back(CryptoBackend::getPortable());
+
+   if(CryptoBackend::getHardware())
+      backends.push_back(CryptoBackend::getHardware());
+
+   return backends;
+}
+
+
+static void fillTestData(U8 *data, U32 len, U32 seed)
+{
+   for(U32 i = 0; i < len; i++)
+   {
+      seed = seed * 1664525 + 1013904223;
+      data[i] = U8(seed >> 24);
+   }
+}
+
+
+TEST(SymmetricCipherTest, KnownAnswers)
+{
+   // FIPS-197, appendix C.1
+   const U8 key[16]       = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+   const U8 plainText[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+   const U8 expected[16]  = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+   // FIPS-180-2, hashes of "" and "abc"
+   const U8 emptyHash[32] = { 0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+                              0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55 };
+   const U8 abcHash[32]   = { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+                              0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad };
+
+   Vector<CryptoBackend *> backends = getBackends();
+
+   for(S32 i = 0; i < backends.size(); i++)
+   {
+      SCOPED_TRACE(backends[i]->getName());
+
+      CryptoBackend::AesKey expandedKey;
+      U8 cipherText[16];
+      backends[i]->aesSetup(key, &expandedKey);
+      backends[i]->aesEncryptBlock(&expandedKey, plainText, cipherText);
+      EXPECT_EQ(0, memcmp(expected, cipherText, 16));
+
+      U8 hash[32];
+      backends[i]->sha256((const U8 *) "", 0, hash);
+      EXPECT_EQ(0, memcmp(emptyHash, hash, 32));
+
+      backends[i]->sha256((const U8 *) "abc", 3, hash);
+      EXPECT_EQ(0, memcmp(abcHash, hash, 32));
+   }
+}
+
+
+// The backends have to agree exactly, since the two ends of a connection may be using different ones
+TEST(SymmetricCipherTest, BackendsMatch)
+{
+   Vector<CryptoBackend *> backends = getBackends();
+   if(backends.size() < 2)
+      return;
+
+   CryptoBackend *portable = backends[0];
+   CryptoBackend *hardware = backends[1];
+
+   U8 data[300];
+   fillTestData(data, sizeof(data), 1);
+
+   // Lengths either side of every padding boundary
+   for(U32 len = 0; len <= sizeof(data); len++)
+   {
+      U8 portableHash[32], hardwareHash[32];
+      portable->sha256(data, len, portableHash);
+      hardware->sha256(data, len, hardwareHash);
+      ASSERT_EQ(0, memcmp(portableHash, hardwareHash, 32)) << "length " << len;
+   }
+
+   for(U32 i = 0; i < 64; i++)
+   {
+      U8 key[16], block[16];
+      fillTestData(key, 16, i * 2);
+      fillTestData(block, 16, i * 2 + 1);
+
+      CryptoBackend::AesKey portableKey, hardwareKey;
+      portable->aesSetup(key, &portableKey);
+      hardware->aesSetup(key, &hardwareKey);
+
+      U8 portableOut[16], hardwareOut[16];
+      portable->aesEncryptBlock(&portableKey, block, portableOut);
+      hardware->aesEncryptBlock(&hardwareKey, block, hardwareOut);
+      ASSERT_EQ(0, memcmp(portableOut, hardwareOut, 16));
+   }
+}
+
+
+// Encrypts with one backend and decrypts with another, in uneven chunks so the byte-at-a-time and
+// block-at-a-time paths get mixed together
+TEST(SymmetricCipherTest, EncryptDecrypt)
+{
+   const U8 key[SymmetricCipher::KeySize] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+   const U8 iv[SymmetricCipher::BlockSize] = { 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+   const U32 chunks[] = { 1, 15, 16, 17, 3, 32, 40, 0, 100, 7 };
+
+   U8 plainText[256], reference[256];
+   fillTestData(plainText, sizeof(plainText), 7);
+
+   // Byte at a time with the portable backend, which is how the cipher always used to work
+   CryptoBackend::set(CryptoBackend::getPortable());
+   SymmetricCipher referenceCipher(key, iv);
+   for(U32 i = 0; i < sizeof(plainText); i++)
+      referenceCipher.encrypt(plainText + i, reference + i, 1);
+
+   Vector<CryptoBackend *> backends = getBackends();
+
+   for(S32 i = 0; i < backends.size(); i++)
+   {
+      for(S32 j = 0; j < backends.size(); j++)
+      {
+         CryptoBackend::set(backends[i]);
+         SymmetricCipher encryptor(key, iv);
+         CryptoBackend::set(backends[j]);
+         SymmetricCipher decryptor(key, iv);
+
+         U8 cipherText[256], decrypted[256];
+         U32 pos = 0;
+         for(U32 k = 0; pos < sizeof(plainText); k++)
+         {
+            U32 len = getMin(chunks[k % ARRAYSIZE(chunks)], U32(sizeof(plainText)) - pos);
+            encryptor.encrypt(plainText + pos, cipherText + pos, len);
+            decryptor.decrypt(cipherText + pos, decrypted + pos, len);
+            pos += len;
+         }
+
+         EXPECT_EQ(0, memcmp(reference, cipherText, sizeof(plainText)));
+         EXPECT_EQ(0, memcmp(plainText, decrypted, sizeof(plainText)));
+      }
+   }
+
+   CryptoBackend::set(NULL);
+}
+
+
+// Measures the per-packet cost of hashing and encrypting a full-size packet, and undoing it again
+TEST(SymmetricCipherTest, DISABLED_PacketThroughputBenchmark)
+{
+   const U32 Packets = 5000;
+   const U32 PacketSize = 1400;
+   const U32 HashSize = 5;    // Same as NetConnection's MessageSignatureBytes
+   const U32 HeaderSize = 8;
+
+   const U8 key[SymmetricCipher::KeySize] = { 0 };
+   const U8 iv[SymmetricCipher::BlockSize] = { 0 };
+
+   U8 payload[PacketSize];
+   fillTestData(payload, PacketSize, 3);
+
+   Vector<CryptoBackend *> backends = getBackends();
+
+   for(S32 i = 0; i < backends.size(); i++)
+   {
+      CryptoBackend::set(backends[i]);
+      SymmetricCipher sender(key, iv);
+      SymmetricCipher receiver(key, iv);
+
+      S64 start = Platform::getHighPrecisionTimerValue();
+
+      for(U32 j = 0; j < Packets; j++)
+      {
+         PacketStream packet;
+         packet.write(PacketSize, payload);
+
+         sender.setupCounter(j, 0, 0, 0);
+         packet.hashAndEncrypt(HashSize, HeaderSize, &sender);
+
+         BitStream received(packet.getBuffer(), packet.getBytePosition());
+         receiver.setupCounter(j, 0, 0, 0);
+         ASSERT_TRUE(received.decryptAndCheckHash(HashSize, HeaderSize, &receiver));
+      }
+
+      F64 ms = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - start);
+
+      printf("%-20s %u packets of %u bytes: %.1f ms, %.2f us per packet, %.1f MB/s\n", backends[i]->getName(),
+             Packets, PacketSize, ms, ms * 1000 / Packets, (F64(Packets) * PacketSize / (1024 * 1024)) / (ms / 1000));
+   }
+
+   CryptoBackend::set(NULL);
+}
+
+
+};
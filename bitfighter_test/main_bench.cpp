@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+// Bitfighter server benchmark
+//
+// Put it in the same folder as the tests, with the resources copied in, and run:
+//
+//    bitfighter_bench [-level ctf.level] [-robots 8] [-bot s_bot] [-clients 0] [-ticks 6000] [-warmup 200] [-delta 10] [-seed 1]
+//
+// where -bot names the bot script, or "native:s_bot" for the C++ port of the standard bot; compare the two with
+// the bots/core line.
+//
+// or, to time calls from Lua into the game instead:
+//
+//    bitfighter_bench -luacalls 1000000
+//
+// Benchmarks of smaller pieces (bitstreams, ciphers, handshakes, master logins) live alongside their unit tests,
+// disabled so they don't slow down every test run.  Run them with:
+//
+//    bitfighter_test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+#include "ServerBenchmark.h"
+#include "LuaCallBenchmark.h"
+
+#include "DisplayManager.h"
+#include "FontManager.h"
+
+#include "stringUtils.h"
+
+#include "tnl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+
+namespace Zap
+{
+void exitToOs(S32 errcode) { TNLAssert(false, "Should never be called!"); }
+void shutdownBitfighter()  { TNLAssert(false, "Should never be called!"); };
+
+static U64 allocationCount = 0;
+
+U64 getAllocationCount()
+{
+   return allocationCount;
+}
+}
+
+
+// Count every trip to the heap.  Not thread safe, so the count is only exact while the game is single threaded.
+void *operator new(size_t size)
+{
+   Zap::allocationCount++;
+
+   void *ptr = malloc(size ? size : 1);
+   if(!ptr)
+      throw std::bad_alloc();
+
+   return ptr;
+}
+
+
+void *operator new[](size_t size)
+{
+   return operator new(size);
+}
+
+
+void operator delete(void *ptr) throw()
+{
+   free(ptr);
+}
+
+
+void operator delete[](void *ptr) throw()
+{
+   free(ptr);
+}
+
+
+using namespace Zap;
+
+
+static void printUsage()
+{
+   printf("Usage: bitfighter_bench [-level <file in levels folder>] [-robots <n>] [-bot <script>] [-clients <n>] [-ticks <n>] "
+          "[-warmup <n>] [-delta <ms>] [-seed <n>]\n"
+          "       bitfighter_bench -luacalls <n>\n");
+}
+
+
+int main(int argc, char **argv)
+{
+   ServerBenchmark::Options options;
+   U32 luaCalls = 0;
+
+   for(S32 i = 1; i < argc; i++)
+   {
+      if(i + 1 >= argc)
+      {
+         printUsage();
+         return 1;
+      }
+
+      string arg = argv[i];
+      const char *val = argv[++i];
+
+      if(arg == "-level")
+         options.levelFile = val;
+      else if(arg == "-robots")
+         options.robots = atoi(val);
+      else if(arg == "-bot")
+         options.robotScript = val;
+      else if(arg == "-clients")
+         options.clients = atoi(val);
+      else if(arg == "-ticks")
+         options.ticks = atoi(val);
+      else if(arg == "-warmup")
+         options.warmupTicks = atoi(val);
+      else if(arg == "-delta")
+         options.timeDelta = atoi(val);
+      else if(arg == "-seed")
+         options.seed = atoi(val);
+      else if(arg == "-luacalls")
+         luaCalls = atoi(val);
+      else
+      {
+         printUsage();
+         return 1;
+      }
+   }
+
+   if(options.ticks == 0 || options.timeDelta == 0)
+   {
+      printUsage();
+      return 1;
+   }
+
+   DisplayManager::initialize();
+
+   string errorMessage;
+   bool ok;
+
+   if(luaCalls > 0)
+   {
+      Vector<LuaCallBenchmark::Result> results;
+
+      ok = LuaCallBenchmark::run(luaCalls, results, errorMessage);
+
+      if(ok)
+         LuaCallBenchmark::printResults(luaCalls, results);
+   }
+   else
+   {
+      ServerBenchmark benchmark(options);
+      ServerBenchmark::Results results;
+
+      ok = benchmark.run(results, errorMessage);
+
+      if(ok)
+         ServerBenchmark::printResults(options, results);
+   }
+
+   if(!ok)
+      printf("FAILED: %s\n", errorMessage.c_str());
+
+   FontManager::cleanup();
+   DisplayManager::cleanup();
+
+   return ok ? 0 : 1;
+}
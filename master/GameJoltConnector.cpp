@@ -114,6 +114,7 @@ static void onPlayerAuthenticatedOrQuit(const MasterSettings *settings, const Ma
       return;        // Parent process, return and get on with life
 
    // From here on down is child process... we'll never return!
+   DbWriter::DbConnectionPool::forgetAll();     // Pooled connections belong to our parent
    string nameList = "'" + sanitizeForSql(client->mPlayerOrServerName.getString()) + "'";
 
    updateGameJolt(settings, "http://gamejolt.com/api/game/v1/sessions/" + verb, secret, nameList);
@@ -170,6 +171,7 @@ void ping(const MasterSettings *settings, const Vector<MasterServerConnection *>
 
 
    // From here on down is child process... we'll never return!
+   DbWriter::DbConnectionPool::forgetAll();     // Pooled connections belong to our parent
 
    
    // Assemble list of all connected and authenticated players
@@ -227,6 +229,7 @@ void onPlayerAwardedAchievement(const MasterSettings *settings, const string &aw
 
 
    // From here on down is child process... we'll never return!
+   DbWriter::DbConnectionPool::forgetAll();     // Pooled connections belong to our parent
    string name = "'" + sanitizeForSql(awardedTo) + "'";
 
    DatabaseWriter databaseWriter = DbWriter::getDatabaseWriter(settings);
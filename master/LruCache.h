@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LRU_CACHE_H_
+#define _LRU_CACHE_H_
+
+#include "tnlTypes.h"
+
+#include <list>
+#include <map>
+#include <memory>
+
+using namespace TNL;
+using namespace std;
+
+namespace Master
+{
+
+// Size-bounded map that evicts the least recently used entry when full.  Values are held by
+// shared_ptr so that anyone still working with an evicted entry (a database thread, for example)
+// can safely finish with it.
+template <class Key, class Value>
+class LruCache
+{
+public:
+   typedef shared_ptr<Value> ValuePtr;
+
+private:
+   typedef list<pair<Key, ValuePtr> > EntryList;   // Most recently used at the front
+   typedef map<Key, typename EntryList::iterator> EntryIndex;
+
+   EntryList mEntries;
+   EntryIndex mIndex;
+   U32 mMaxSize;
+
+   U32 mHits;
+   U32 mMisses;
+   U32 mEvictions;
+
+public:
+   explicit LruCache(U32 maxSize) : mMaxSize(maxSize), mHits(0), mMisses(0), mEvictions(0)
+   {
+      // Do nothing
+   }
+
+
+   // Returns the entry for key, marking it as most recently used, or a NULL pointer on a miss
+   ValuePtr find(const Key &key)
+   {
+      typename EntryIndex::iterator it = mIndex.find(key);
+
+      if(it == mIndex.end())
+      {
+         mMisses++;
+         return ValuePtr();
+      }
+
+      mHits++;
+      mEntries.splice(mEntries.begin(), mEntries, it->second);    // Move to front, iterators stay valid
+      return it->second->second;
+   }
+
+
+   // Adds or replaces the entry for key, evicting the least recently used entries if we're over size
+   void insert(const Key &key, const ValuePtr &value)
+   {
+      typename EntryIndex::iterator it = mIndex.find(key);
+
+      if(it != mIndex.end())
+      {
+         it->second->second = value;
+         mEntries.splice(mEntries.begin(), mEntries, it->second);
+         return;
+      }
+
+      mEntries.push_front(make_pair(key, value));
+      mIndex[key] = mEntries.begin();
+
+      while(mEntries.size() > mMaxSize)
+      {
+         mIndex.erase(mEntries.back().first);
+         mEntries.pop_back();
+         mEvictions++;
+      }
+   }
+
+
+   void erase(const Key &key)
+   {
+      typename EntryIndex::iterator it = mIndex.find(key);
+
+      if(it == mIndex.end())
+         return;
+
+      mEntries.erase(it->second);
+      mIndex.erase(it);
+   }
+
+
+   // Removes all entries for which pred(value) returns true
+   template <class Predicate>
+   void eraseIf(Predicate pred)
+   {
+      typename EntryList::iterator it = mEntries.begin();
+
+      while(it != mEntries.end())
+      {
+         if(pred(it->second.get()))
+         {
+            mIndex.erase(it->first);
+            it = mEntries.erase(it);
+         }
+         else
+            ++it;
+      }
+   }
+
+
+   void clear()
+   {
+      mEntries.clear();
+      mIndex.clear();
+   }
+
+
+   void setMaxSize(U32 maxSize)
+   {
+      mMaxSize = maxSize;
+
+      while(mEntries.size() > mMaxSize)
+      {
+         mIndex.erase(mEntries.back().first);
+         mEntries.pop_back();
+         mEvictions++;
+      }
+   }
+
+
+   // For walking the cache, least recently used first -- inserting entries in this order rebuilds the same recency order
+   typedef typename EntryList::const_reverse_iterator const_iterator;
+   const_iterator begin() const { return mEntries.rbegin(); }
+   const_iterator end()   const { return mEntries.rend();   }
+
+   U32 size()         const { return (U32)mEntries.size(); }
+   U32 getMaxSize()   const { return mMaxSize;   }
+   U32 getHits()      const { return mHits;      }
+   U32 getMisses()    const { return mMisses;    }
+   U32 getEvictions() const { return mEvictions; }
+};
+
+
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include "DatabaseAccessThread.h"
 #include "authenticator.h"
 #include "GameJoltConnector.h"
+#include "LruCache.h"
 
 #include "../zap/version.h"
 #include "../zap/stringUtils.h"
@@ -35,9 +36,13 @@ public:
 
 
 // Define some statics
-HighScores MasterServerConnection::highScores;
 MasterServer *MasterServerConnection::mMaster = NULL;
 
+#ifdef VERIFY_PHPBB3
+static Mutex authenticatorMutex;
+static Authenticator *authenticator = NULL;     // Reused across logins, see verifyCredentials()
+#endif
+
 
 static S32 getNextId()
 {
@@ -77,13 +82,7 @@ MasterServerConnection::~MasterServerConnection()
 {
    // If we're in global chat, announce to anyone else in global chat that we are leaving
    if(isInGlobalChat)
-   {
-      const Vector<MasterServerConnection *> *clientList = mMaster->getClientList();
-
-      for(S32 i = 0; i < clientList->size(); i++)
-         if(clientList->get(i)->isInGlobalChat && clientList->get(i) != this)
-            clientList->get(i)->m2cPlayerLeftGlobalChat(mPlayerOrServerName);
-   }
+      mMaster->broadcastToClients(TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(this, m2cPlayerLeftGlobalChat, (mPlayerOrServerName)), this, true);
 
 
    // Remove this from the client/server lists
@@ -134,7 +133,12 @@ MasterServerConnection::PHPBB3AuthenticationStatus MasterServerConnection::verif
 
 #ifdef VERIFY_PHPBB3    // Defined in Linux Makefile, not in VC++ project
 {
-   Authenticator authenticator;
+   // Logins are checked one at a time on the database thread, so we hang onto a single authenticator and its
+   // connection rather than reconnecting to the phpBB database for each one
+   authenticatorMutex.lock();
+
+   if(!authenticator)
+      authenticator = new Authenticator();
 
    // Security levels: 0 = no security (no checking for sql-injection attempts, not recommended unless you add your own security)
    //          1 = basic security (prevents the use of any of these characters in the username: "(\"*^';&></) " including the space)
@@ -142,7 +146,7 @@ MasterServerConnection::PHPBB3AuthenticationStatus MasterServerConnection::verif
    //          2 = alphanumeric (only allows alphanumeric characters in the username)
    //
    // We'll use level 1 for now, so users can put special characters in their username
-   authenticator.initialize(mMaster->getSetting<string>("MySqlAddress"), 
+   authenticator->initialize(mMaster->getSetting<string>("MySqlAddress"), 
                               mMaster->getSetting<string>("DbUsername"), 
                               mMaster->getSetting<string>("DbPassword"), 
                               mMaster->getSetting<string>("Phpbb3Database"), 
@@ -150,7 +154,11 @@ MasterServerConnection::PHPBB3AuthenticationStatus MasterServerConnection::verif
                               1);
 
    S32 errorcode;
-   if(authenticator.authenticate(username, password, errorcode))   // returns true if the username was found and the password is correct
+   bool authenticated = authenticator->authenticate(username, password, errorcode);  // True if the username was found and the password is correct
+
+   authenticatorMutex.unlock();
+
+   if(authenticated)
       return Authenticated;
    else
    {
@@ -171,6 +179,20 @@ MasterServerConnection::PHPBB3AuthenticationStatus MasterServerConnection::verif
 #endif
 
 
+// Called at shutdown, once the database thread is done with them
+void MasterServerConnection::closeDatabaseConnections()
+{
+#ifdef VERIFY_PHPBB3
+   authenticatorMutex.lock();
+   delete authenticator;
+   authenticator = NULL;
+   authenticatorMutex.unlock();
+#endif
+
+   DbConnectionPool::closeAll();
+}
+
+
 class MasterSettings;
 
 
@@ -266,18 +288,8 @@ void MasterServerConnection::processAutentication(StringTableEntry newName, PHPB
       {
          if(isInGlobalChat)         // Need to tell clients new name, in case of delayed authentication
          {
-            const Vector<MasterServerConnection *> *clientList = mMaster->getClientList();
-
-            for(S32 i = 0; i < clientList->size(); i++)
-            {
-               MasterServerConnection *client = clientList->get(i);
-
-               if(client != this && client->isInGlobalChat)
-               {
-                  client->m2cPlayerLeftGlobalChat(mPlayerOrServerName);
-                  client->m2cPlayerJoinedGlobalChat(newName);
-               }
-            }
+            mMaster->broadcastToClients(TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(this, m2cPlayerLeftGlobalChat, (mPlayerOrServerName)), this, true);
+            mMaster->broadcastToClients(TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(this, m2cPlayerJoinedGlobalChat, (newName)), this, true);
          }
          mPlayerOrServerName = newName;
       }
@@ -911,12 +923,33 @@ void MasterServerConnection::writeLevelInfoToDb(const string &hash, const string
 }
 
 
+// Caches for data we pull from the database.  These are bounded; when full, the least recently used entry is dropped.
+// Entries are held by shared_ptr, so a database thread working on an entry that gets evicted can still finish safely.
+
+static const U32 DefaultHighScoresCacheSize        = 4;        // Keyed by scoresPerGroup, which is always 3 for now
+static const U32 DefaultTotalLevelRatingsCacheSize = 10000;
+static const U32 DefaultPlayerLevelRatingsCacheSize = 50000;
+
+typedef LruCache<S32, HighScores> HighScoresCache;
+static HighScoresCache highScoresCache(DefaultHighScoresCacheSize);
+
+typedef LruCache<U32, TotalLevelRating> TotalLevelRatingsCache;
+static TotalLevelRatingsCache totalLevelRatingsCache(DefaultTotalLevelRatingsCacheSize);
+
+typedef pair<U32, StringTableEntry> DbIdPlayerNamePair;
+typedef LruCache<DbIdPlayerNamePair, PlayerLevelRating> PlayerLevelRatingsCache;
+static PlayerLevelRatingsCache playerLevelRatingsCache(DefaultPlayerLevelRatingsCacheSize);
+
+
 struct HighScoresReader : public MasterThreadEntry
 {
    S32 scoresPerGroup;
+   shared_ptr<HighScores> highScores;
 
    // Constructor
-   HighScoresReader(const MasterSettings *settings, S32 scoresPerGroup) : MasterThreadEntry(settings)        
+   HighScoresReader(const MasterSettings *settings, const shared_ptr<HighScores> &highScores, S32 scoresPerGroup) : 
+         MasterThreadEntry(settings),
+         highScores(highScores)
    {
       this->scoresPerGroup = scoresPerGroup;
    }
@@ -927,49 +960,43 @@ struct HighScoresReader : public MasterThreadEntry
 
       // Client will display these in two columns, row by row
 
-      MasterServerConnection::highScores.groupNames.clear();
-      MasterServerConnection::highScores.names.clear();
-      MasterServerConnection::highScores.scores.clear();
+      highScores->groupNames.clear();
+      highScores->names.clear();
+      highScores->scores.clear();
 
-      MasterServerConnection::highScores.groupNames.push_back("Official Wins Last Week");
+      highScores->groupNames.push_back("Official Wins Last Week");
       databaseWriter.getTopPlayers("v_last_week_top_player_official_wins", "win_count",  
-                                    scoresPerGroup, MasterServerConnection::highScores.names, 
-                                    MasterServerConnection::highScores.scores);
+                                    scoresPerGroup, highScores->names, highScores->scores);
 
-      MasterServerConnection::highScores.groupNames.push_back("Official Wins This Week, So Far");
+      highScores->groupNames.push_back("Official Wins This Week, So Far");
       databaseWriter.getTopPlayers("v_current_week_top_player_official_wins", "win_count",  
-                                    scoresPerGroup, MasterServerConnection::highScores.names, 
-                                    MasterServerConnection::highScores.scores);
+                                    scoresPerGroup, highScores->names, highScores->scores);
 
-      MasterServerConnection::highScores.groupNames.push_back("Games Played Last Week");
+      highScores->groupNames.push_back("Games Played Last Week");
       databaseWriter.getTopPlayers("v_last_week_top_player_games", "game_count", 
-                                    scoresPerGroup, MasterServerConnection::highScores.names, 
-                                    MasterServerConnection::highScores.scores);
+                                    scoresPerGroup, highScores->names, highScores->scores);
 
-      MasterServerConnection::highScores.groupNames.push_back("Games Played This Week, So Far");
+      highScores->groupNames.push_back("Games Played This Week, So Far");
       databaseWriter.getTopPlayers("v_current_week_top_player_games", "game_count", 
-                                    scoresPerGroup, MasterServerConnection::highScores.names,
-                                    MasterServerConnection::highScores.scores);
+                                    scoresPerGroup, highScores->names, highScores->scores);
 
-      MasterServerConnection::highScores.groupNames.push_back("Latest BBB Winners");
+      highScores->groupNames.push_back("Latest BBB Winners");
       databaseWriter.getTopPlayers("v_latest_bbb_winners", "rank", 
-                                    scoresPerGroup, MasterServerConnection::highScores.names, 
-                                    MasterServerConnection::highScores.scores);
+                                    scoresPerGroup, highScores->names, highScores->scores);
 
-      MasterServerConnection::highScores.scoresPerGroup = scoresPerGroup;
+      highScores->scoresPerGroup = scoresPerGroup;
    }
 
 
    void finish()
    {
-      MasterServerConnection::highScores.isBusy = false;
-
-      for(S32 i = 0; i < MasterServerConnection::highScores.waitingClients.size(); i++)
-         if(MasterServerConnection::highScores.waitingClients[i])
-            MasterServerConnection::highScores.waitingClients[i]->m2cSendHighScores(MasterServerConnection::highScores.groupNames, 
-                                                                                    MasterServerConnection::highScores.names, 
-                                                                                    MasterServerConnection::highScores.scores);
-      MasterServerConnection::highScores.waitingClients.clear();
+      highScores->isBusy = false;
+
+      for(S32 i = 0; i < highScores->waitingClients.size(); i++)
+         if(highScores->waitingClients[i])
+            highScores->waitingClients[i]->m2cSendHighScores(highScores->groupNames, highScores->names, highScores->scores);
+
+      highScores->waitingClients.clear();
    }
 };
 
@@ -977,16 +1004,15 @@ struct HighScoresReader : public MasterThreadEntry
 ////////////////////////////////////////
 ////////////////////////////////////////
 
-typedef map<U32, shared_ptr<TotalLevelRating> > TotalLevelRatingsMap;
-static TotalLevelRatingsMap totalLevelRatingsCache;
-
-   
 struct TotalLevelRatingsReader : public MasterThreadEntry
 {
    U32 dbId;
    S16 rating;
+   shared_ptr<TotalLevelRating> totalRating;
 
-   TotalLevelRatingsReader(const MasterSettings *settings, U32 databaseId) : MasterThreadEntry(settings)    // Constructor
+   TotalLevelRatingsReader(const MasterSettings *settings, U32 databaseId, const shared_ptr<TotalLevelRating> &totalRating) : 
+         MasterThreadEntry(settings),
+         totalRating(totalRating)
    {
       dbId = databaseId;
    }
@@ -996,8 +1022,6 @@ struct TotalLevelRatingsReader : public MasterThreadEntry
    // the latest data.
    void run()
    {
-      TotalLevelRating *totalRating = totalLevelRatingsCache[dbId].get();
-      
       do 
       {
          totalRating->receivedUpdateByClientWhileBusy = false;
@@ -1009,8 +1033,6 @@ struct TotalLevelRatingsReader : public MasterThreadEntry
 
    void finish()
    {
-      TotalLevelRating *totalRating = totalLevelRatingsCache[dbId].get();
-
       totalRating->setRatingMagicValue(rating);  // Because, as noted above, rating could be a magic number
       totalRating->isBusy = false;
 
@@ -1018,7 +1040,7 @@ struct TotalLevelRatingsReader : public MasterThreadEntry
          if(totalRating->waitingClients[i])
             totalRating->waitingClients[i]->m2cSendTotalLevelRating(dbId, rating);
 
-         totalRating->waitingClients.clear();
+      totalRating->waitingClients.clear();
    }
 };
 
@@ -1026,21 +1048,19 @@ struct TotalLevelRatingsReader : public MasterThreadEntry
 ////////////////////////////////////////
 ////////////////////////////////////////
 
-typedef pair<U32, StringTableEntry> DbIdPlayerNamePair;
-typedef map<DbIdPlayerNamePair, shared_ptr<PlayerLevelRating> > PlayerLevelRatingsMap;
-static PlayerLevelRatingsMap playerLevelRatingsCache;
-
-
 struct PlayerLevelRatingsReader : public MasterThreadEntry
 {
    U32 dbId;
    StringTableEntry playerName;
    S32 rating;
+   shared_ptr<PlayerLevelRating> playerRating;
 
    // Constructor
-   PlayerLevelRatingsReader(const MasterSettings *settings, U32 databaseId, const StringTableEntry &playerName) : 
+   PlayerLevelRatingsReader(const MasterSettings *settings, U32 databaseId, const StringTableEntry &playerName, 
+                            const shared_ptr<PlayerLevelRating> &playerRating) : 
          MasterThreadEntry(settings), 
-         playerName(playerName)
+         playerName(playerName),
+         playerRating(playerRating)
    {
       dbId = databaseId;
    }
@@ -1052,10 +1072,6 @@ struct PlayerLevelRatingsReader : public MasterThreadEntry
 
    void finish()
    {
-      PlayerLevelRating *playerRating = playerLevelRatingsCache[DbIdPlayerNamePair(dbId, playerName)].get();
-
-      TNLAssert(playerRating, "playerRating should not be NULL!");
-
       // If this rating item was updated by the client while we were retrieving data fom the database,
       // we'll treat that as authoritative and not overwrite it with (likely) stale data from the database.
       if(!playerRating->receivedUpdateByClientWhileBusy)
@@ -1076,41 +1092,64 @@ struct PlayerLevelRatingsReader : public MasterThreadEntry
 ////////////////////////////////////////
 ////////////////////////////////////////
 
+// Concurrent requests for an entry that is being read will find it busy, and get added to its waitingClients 
+// list rather than triggering another query -- so each cache miss results in exactly one trip to the database
 HighScores *MasterServerConnection::getHighScores(S32 scoresPerGroup)
 {
-   // Remember... highScores is static!
-   if(!highScores.isValid || highScores.isExpired() || scoresPerGroup != highScores.scoresPerGroup)
-      if(!highScores.isBusy)
+   shared_ptr<HighScores> highScores = highScoresCache.find(scoresPerGroup);
+
+   if(!highScores)    // i.e. not in cache
+   {
+      highScores = shared_ptr<HighScores>(new HighScores());
+      highScoresCache.insert(scoresPerGroup, highScores);
+   }
+
+   if(!highScores->isValid || highScores->isExpired())
+      if(!highScores->isBusy)
       {
-         highScores.isBusy = true;
-         highScores.isValid = true;
-         highScores.resetClock();
+         highScores->isBusy = true;
+         highScores->isValid = true;
+         highScores->resetClock();
 
-         RefPtr<HighScoresReader> highScoreReader = new HighScoresReader(mMaster->getSettings(), scoresPerGroup);
+         RefPtr<HighScoresReader> highScoreReader = new HighScoresReader(mMaster->getSettings(), highScores, scoresPerGroup);
          mMaster->getDatabaseAccessThread()->addEntry(highScoreReader);
       }
       
-   return &highScores;
+   return highScores.get();
 }
 
 
-// Note: Will return NULL if databaseId == NOT_IN_DATABASE.  Otherwise, will not.
-TotalLevelRating *MasterServerConnection::getLevelRating(U32 databaseId)
+// Mark all cached high scores as stale, so they'll be reread next time they are requested -- static method
+void MasterServerConnection::invalidateHighScores()
 {
-   if(!LevelDatabase::isLevelInDatabase(databaseId))
-      return NULL;
+   for(HighScoresCache::const_iterator it = highScoresCache.begin(); it != highScoresCache.end(); ++it)
+      it->second->isValid = false;
+}
+
 
-   // Note that while map[xxx] will create an entry if it does not exist, in this case, it will create a shared_ptr
-   // wrapping a NULL object.  So rating, which points to that object, will also be NULL.  Viva la confusion!
-   TotalLevelRating *rating = totalLevelRatingsCache[databaseId].get();
+static shared_ptr<TotalLevelRating> findOrCreateTotalRating(U32 databaseId)
+{
+   shared_ptr<TotalLevelRating> rating = totalLevelRatingsCache.find(databaseId);
 
    if(!rating)    // i.e. not in cache
    {
-      shared_ptr<TotalLevelRating> newRating = shared_ptr<TotalLevelRating>(new TotalLevelRating());
-      totalLevelRatingsCache[databaseId] = newRating;
-      rating = newRating.get();
+      rating = shared_ptr<TotalLevelRating>(new TotalLevelRating());
+      rating->databaseId = databaseId;
+      totalLevelRatingsCache.insert(databaseId, rating);
    }
 
+   return rating;
+}
+
+
+// Note: Will return NULL if databaseId == NOT_IN_DATABASE.  Otherwise, will not.
+TotalLevelRating *MasterServerConnection::getLevelRating(U32 databaseId)
+{
+   if(!LevelDatabase::isLevelInDatabase(databaseId))
+      return NULL;
+
+   shared_ptr<TotalLevelRating> rating = findOrCreateTotalRating(databaseId);
+
    if(!rating->isValid || rating->isExpired() || rating->getRating() == UnknownRating)
       if(!rating->isBusy)
       {
@@ -1120,20 +1159,18 @@ TotalLevelRating *MasterServerConnection::getLevelRating(U32 databaseId)
 
          // Queue the request!
          RefPtr<TotalLevelRatingsReader> totalLevelRatingsReader = 
-                           new TotalLevelRatingsReader(mMaster->getSettings(), databaseId);
+                           new TotalLevelRatingsReader(mMaster->getSettings(), databaseId, rating);
          mMaster->getDatabaseAccessThread()->addEntry(totalLevelRatingsReader);
       }
 
-   return rating;
+   return rating.get();
 }
 
 
-static PlayerLevelRating *createNewPlayerRating(U32 databaseId, const StringTableEntry &playerName)
+static shared_ptr<PlayerLevelRating> createNewPlayerRating(U32 databaseId, const StringTableEntry &playerName)
 {
-   shared_ptr<PlayerLevelRating> newRating = shared_ptr<PlayerLevelRating>(new PlayerLevelRating());
-   playerLevelRatingsCache[DbIdPlayerNamePair(databaseId, playerName)] = newRating;
-
-   PlayerLevelRating *rating = newRating.get();
+   shared_ptr<PlayerLevelRating> rating = shared_ptr<PlayerLevelRating>(new PlayerLevelRating());
+   playerLevelRatingsCache.insert(DbIdPlayerNamePair(databaseId, playerName), rating);
 
    rating->databaseId = databaseId;
    rating->playerName = playerName;
@@ -1150,9 +1187,7 @@ PlayerLevelRating *MasterServerConnection::getLevelRating(U32 databaseId, const
    if(!LevelDatabase::isLevelInDatabase(databaseId))
       return NULL;
 
-   // Note that while map[xxx] will create an entry if it does not exist, in this case, it will create a shared_ptr
-   // wrapping a NULL object.  So rating, which points to that object, will also be NULL.  Viva la confusion!
-   PlayerLevelRating *rating = playerLevelRatingsCache[DbIdPlayerNamePair(databaseId, playerName)].get();
+   shared_ptr<PlayerLevelRating> rating = playerLevelRatingsCache.find(DbIdPlayerNamePair(databaseId, playerName));
 
    if(!rating)
       rating = createNewPlayerRating(databaseId, playerName);
@@ -1166,11 +1201,17 @@ PlayerLevelRating *MasterServerConnection::getLevelRating(U32 databaseId, const
 
          // Queue the request
          RefPtr<PlayerLevelRatingsReader> playerLevelRatingsReader =
-                        new PlayerLevelRatingsReader(mMaster->getSettings(), databaseId, playerName);
+                        new PlayerLevelRatingsReader(mMaster->getSettings(), databaseId, playerName, rating);
          mMaster->getDatabaseAccessThread()->addEntry(playerLevelRatingsReader);
       }
 
-   return rating;
+   return rating.get();
+}
+
+
+static bool isRemovable(ThreadingStruct *entry)
+{
+   return entry->isValid && !entry->isBusy && entry->isExpired();
 }
 
 
@@ -1178,39 +1219,241 @@ PlayerLevelRating *MasterServerConnection::getLevelRating(U32 databaseId, const
 // Items are deleted if they are expired and are not busy
 void MasterServerConnection::removeOldEntriesFromRatingsCache()
 {
-   // See here for how to remove an element while iterating over an associative
-   // container:   http://stackoverflow.com/a/4600592
+   totalLevelRatingsCache.eraseIf(isRemovable);
+   playerLevelRatingsCache.eraseIf(isRemovable);
+}
+
+
+// Static method
+void MasterServerConnection::setCacheSizes(U32 totalLevelRatingsSize, U32 playerLevelRatingsSize)
+{
+   totalLevelRatingsCache.setMaxSize(totalLevelRatingsSize);
+   playerLevelRatingsCache.setMaxSize(playerLevelRatingsSize);
+}
+
+
+// Static method
+void MasterServerConnection::clearCaches()
+{
+   highScoresCache.clear();
+   totalLevelRatingsCache.clear();
+   playerLevelRatingsCache.clear();
+}
+
+
+template <class Key, class Value>
+static string getCacheStats(const char *name, const LruCache<Key, Value> &cache)
+{
+   U32 lookups = cache.getHits() + cache.getMisses();
+
+   return string(name) + ": " + itos(cache.size()) + "/" + itos(cache.getMaxSize()) + " entries, " + 
+          itos(cache.getHits()) + " hits, " + itos(cache.getMisses()) + " misses (" + 
+          itos(lookups ? cache.getHits() * 100 / lookups : 0) + "% hit rate), " + 
+          itos(cache.getEvictions()) + " evictions";
+}
+
+
+// Returns one line per cache -- static method
+Vector<string> MasterServerConnection::getCacheStats()
+{
+   Vector<string> stats;
+
+   stats.push_back(Master::getCacheStats("High scores",         highScoresCache));
+   stats.push_back(Master::getCacheStats("Total level ratings", totalLevelRatingsCache));
+   stats.push_back(Master::getCacheStats("Player ratings",      playerLevelRatingsCache));
+
+   return stats;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Cache snapshots are plain text, one record per line (strings that might contain spaces always come last):
+//    T <databaseId> <rating>
+//    P <databaseId> <rating> <playerName>
+//    H <scoresPerGroup> <groupCount> <scoreCount>, followed by groupCount group names, then scoreCount name/score line pairs
+// We only save entries that hold usable data; entries being read or holding placeholder ratings are skipped.
+
+static const char *CacheSnapshotHeader = "# Bitfighter master cache snapshot v1";
+
+static bool hasSnapshotData(LevelRating *rating)
+{
+   return rating->isValid && !rating->isBusy && rating->getRating() != UnknownRating;
+}
+
+
+// Static method
+void MasterServerConnection::saveCacheSnapshot(const string &filename)
+{
+   // Nothing cached, probably because we never got going; don't clobber a snapshot from an earlier run
+   if(filename == "" || highScoresCache.size() + totalLevelRatingsCache.size() + playerLevelRatingsCache.size() == 0)
+      return;
+
+   // Write to a temporary file and move it into place once it's complete, so that being killed part way
+   // through leaves the last good snapshot behind rather than a truncated one
+   string tempFilename = filename + ".tmp";
+
+   FILE *f = fopen(tempFilename.c_str(), "w");
+   if(!f)
+   {
+      logprintf(LogConsumer::LogError, "Unable to open cache snapshot file \"%s\" for writing", tempFilename.c_str());
+      return;
+   }
+
+   fprintf(f, "%s\n", CacheSnapshotHeader);
+
+   S32 count = 0;
+
+   for(HighScoresCache::const_iterator it = highScoresCache.begin(); it != highScoresCache.end(); ++it)
    {
-      TotalLevelRatingsMap::iterator it = totalLevelRatingsCache.begin();
+      HighScores *highScores = it->second.get();
+
+      if(!highScores->isValid || highScores->isBusy || highScores->names.size() != highScores->scores.size())
+         continue;
+
+      fprintf(f, "H %d %d %d\n", highScores->scoresPerGroup, highScores->groupNames.size(), highScores->names.size());
+
+      for(S32 i = 0; i < highScores->groupNames.size(); i++)
+         fprintf(f, "%s\n", highScores->groupNames[i].getString());
+
+      for(S32 i = 0; i < highScores->names.size(); i++)
+         fprintf(f, "%s\n%s\n", highScores->names[i].c_str(), highScores->scores[i].c_str());
 
-      while(it != totalLevelRatingsCache.end())
+      count++;
+   }
+
+   for(TotalLevelRatingsCache::const_iterator it = totalLevelRatingsCache.begin(); it != totalLevelRatingsCache.end(); ++it)
+      if(hasSnapshotData(it->second.get()))
       {
-         if(it->second->isValid && !it->second->isBusy && it->second->isExpired())
-         {
-            TotalLevelRatingsMap::iterator tmp = it;
-            ++it;
-            totalLevelRatingsCache.erase(tmp);
-         }
-         else
-            ++it;
+         fprintf(f, "T %u %d\n", it->first, it->second->getRating());
+         count++;
+      }
+
+   for(PlayerLevelRatingsCache::const_iterator it = playerLevelRatingsCache.begin(); it != playerLevelRatingsCache.end(); ++it)
+      if(hasSnapshotData(it->second.get()))
+      {
+         fprintf(f, "P %u %d %s\n", it->first.first, it->second->getRating(), it->first.second.getString());
+         count++;
       }
+
+   bool ok = !ferror(f);
+
+   if(fclose(f) != 0 || !ok)
+   {
+      logprintf(LogConsumer::LogError, "Unable to write cache snapshot file \"%s\"", tempFilename.c_str());
+      remove(tempFilename.c_str());
+      return;
+   }
+
+   // Windows won't rename over an existing file
+   if(rename(tempFilename.c_str(), filename.c_str()) != 0)
+   {
+      remove(filename.c_str());
+
+      if(rename(tempFilename.c_str(), filename.c_str()) != 0)
+      {
+         logprintf(LogConsumer::LogError, "Unable to move cache snapshot into place at \"%s\"", filename.c_str());
+         remove(tempFilename.c_str());
+         return;
+      }
+   }
+
+   logprintf(LogConsumer::LogConnection, "Saved %d cache entries to %s", count, filename.c_str());
+}
+
+
+// Read a line, stripping the trailing newline; returns false at end of file
+static bool readSnapshotLine(FILE *f, char *line, S32 size)
+{
+   if(!fgets(line, size, f))
+      return false;
+
+   line[strcspn(line, "\r\n")] = 0;
+   return true;
+}
+
+
+// Populate caches from a snapshot written by saveCacheSnapshot().  Loaded entries are treated as freshly read,
+// so they will be served until they expire normally, rather than every client hitting the database at once.
+// Static method.
+void MasterServerConnection::loadCacheSnapshot(const string &filename)
+{
+   if(filename == "")
+      return;
+
+   FILE *f = fopen(filename.c_str(), "r");
+   if(!f)
+      return;     // No snapshot is normal on first run
+
+   char line[512];
+
+   if(!readSnapshotLine(f, line, sizeof(line)) || strcmp(line, CacheSnapshotHeader) != 0)
+   {
+      logprintf(LogConsumer::LogError, "Cache snapshot file \"%s\" has an unknown format -- ignoring", filename.c_str());
+      fclose(f);
+      return;
    }
 
+   S32 count = 0;
+
+   while(readSnapshotLine(f, line, sizeof(line)))
    {
-      PlayerLevelRatingsMap::iterator it = playerLevelRatingsCache.begin();
+      U32 databaseId;
+      S32 rating, scoresPerGroup, groupCount, scoreCount, nameOffset;
 
-      while(it != playerLevelRatingsCache.end())
+      if(sscanf(line, "T %u %d", &databaseId, &rating) == 2)
+      {
+         shared_ptr<TotalLevelRating> totalRating(new TotalLevelRating());
+         totalRating->databaseId = databaseId;
+         totalRating->setRatingMagicValue(rating);
+         totalRating->isValid = true;
+         totalRating->resetClock();
+         totalLevelRatingsCache.insert(databaseId, totalRating);
+      }
+      else if(sscanf(line, "P %u %d %n", &databaseId, &rating, &nameOffset) == 2 && line[nameOffset])
       {
-         if(it->second->isValid && !it->second->isBusy && it->second->isExpired())
+         shared_ptr<PlayerLevelRating> playerRating = createNewPlayerRating(databaseId, StringTableEntry(line + nameOffset));
+         playerRating->setRatingMagicValue(rating);
+         playerRating->isValid = true;
+         playerRating->resetClock();
+      }
+      else if(sscanf(line, "H %d %d %d", &scoresPerGroup, &groupCount, &scoreCount) == 3)
+      {
+         shared_ptr<HighScores> highScores(new HighScores());
+         highScores->scoresPerGroup = scoresPerGroup;
+
+         bool ok = true;
+         for(S32 i = 0; i < groupCount && ok; i++)
          {
-            PlayerLevelRatingsMap::iterator tmp = it;
-            ++it;
-            playerLevelRatingsCache.erase(tmp);
+            ok = readSnapshotLine(f, line, sizeof(line));
+            highScores->groupNames.push_back(line);
          }
-         else
-            ++it;
+
+         for(S32 i = 0; i < scoreCount && ok; i++)
+         {
+            ok = readSnapshotLine(f, line, sizeof(line));
+            highScores->names.push_back(line);
+            ok = ok && readSnapshotLine(f, line, sizeof(line));
+            highScores->scores.push_back(line);
+         }
+
+         if(!ok)
+            break;
+
+         highScores->isValid = true;
+         highScores->resetClock();
+         highScoresCache.insert(scoresPerGroup, highScores);
       }
+      else
+         continue;
+
+      count++;
    }
+
+   fclose(f);
+
+   logprintf(LogConsumer::LogConnection, "Loaded %d cache entries from %s", count, filename.c_str());
 }
 
 
@@ -1221,7 +1464,7 @@ void MasterServerConnection::removeOldEntriesFromRatingsCache()
 TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, s2mSendStatistics, (VersionedGameStats stats))
 {
    writeStatisticsToDb(stats);
-   highScores.isValid = false;
+   invalidateHighScores();
 }
 
 
@@ -1388,7 +1631,7 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSetLevelRating, (U32 datab
    // Update the cache -- there could be some weirdness if at the same time, the player were requesting a rating and the database
    // thread was busy... but that seems unlikely, as the player would have to be logged in multiple times.  In any event, this 
    // situation is handled by setting the receivedUpdateByClientWhileBusy flag
-   PlayerLevelRating *playerRating = playerLevelRatingsCache[DbIdPlayerNamePair(databaseId, mPlayerOrServerName)].get();
+   shared_ptr<PlayerLevelRating> playerRating = playerLevelRatingsCache.find(DbIdPlayerNamePair(databaseId, mPlayerOrServerName));
 
    // If item is not in the cache, we'll need to create an entry for it
    if(!playerRating)
@@ -1405,11 +1648,12 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSetLevelRating, (U32 datab
       playerRating->receivedUpdateByClientWhileBusy = true;
 
    // Adjust the total level rating while we're at it
-   totalLevelRatingsCache[databaseId]->setRating(
-         totalLevelRatingsCache[databaseId]->getRating() + denormalizedPlayerRating - oldRating);
+   shared_ptr<TotalLevelRating> totalRating = findOrCreateTotalRating(databaseId);
 
-   if(totalLevelRatingsCache[databaseId]->isBusy)
-      totalLevelRatingsCache[databaseId]->receivedUpdateByClientWhileBusy = true;
+   totalRating->setRating(totalRating->getRating() + denormalizedPlayerRating - oldRating);
+
+   if(totalRating->isBusy)
+      totalRating->receivedUpdateByClientWhileBusy = true;
 
    // If we wanted to alert the other players that the level has just been rated, this would be the place to do it
    // ==>  <== Right here
@@ -1718,10 +1962,8 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mJoinGlobalChat, ())
       return;
 
    isInGlobalChat = true;
-      
-   for(S32 i = 0; i < clientList->size(); i++)
-      if(clientList->get(i) != this && clientList->get(i)->isInGlobalChat)
-         clientList->get(i)->m2cPlayerJoinedGlobalChat(mPlayerOrServerName);
+
+   mMaster->broadcastToClients(TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(this, m2cPlayerJoinedGlobalChat, (mPlayerOrServerName)), this, true);
 }
 
 
@@ -1850,6 +2092,13 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
             gListAddressHide.clear();
             m2cSendChat(mPlayerOrServerName, true, "cleared IP hidden list");
          }
+         else if(command == "cachestats")
+         {
+            Vector<string> cacheStats = getCacheStats();
+
+            for(S32 i = 0; i < cacheStats.size(); i++)
+               m2cSendChat(mPlayerOrServerName, true, cacheStats[i].c_str());
+         }
          else
             adminCommand = false;  // Wasn't an admin command after all
 
@@ -1908,16 +2157,8 @@ TNL_IMPLEMENT_RPC_OVERRIDE(MasterServerConnection, c2mSendChat, (StringPtr messa
 
 
    // Now relay the chat to all connected clients
-   if(!badCommand && !isPrivate)
-   {
-      const  Vector<MasterServerConnection *> *clientList = mMaster->getClientList();
-
-      for(S32 i = 0; i < clientList->size(); i++)
-      {
-         if(clientList->get(i) != this)    // ...except self!
-            clientList->get(i)->m2cSendChat(mPlayerOrServerName, isPrivate, message);
-      }
-   }
+   if(!badCommand && !isPrivate)    // ...except self!
+      mMaster->broadcastToClients(TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(this, m2cSendChat, (mPlayerOrServerName, isPrivate, message)), this, false);
 
 
    // Log F5 chat messages
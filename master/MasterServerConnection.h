@@ -100,10 +100,6 @@ private:
 
    string mLoggingStatus;
 
-public:
-   static HighScores highScores;    // Cached high scores
-   static map<U32, TotalLevelRating> totalLevelRatings;
-
 private:
    Int<BADGE_COUNT> mBadges;
    Int<BADGE_COUNT> getBadges();
@@ -196,6 +192,7 @@ public:
 
    // Check username & password against database
    static PHPBB3AuthenticationStatus verifyCredentials(string &username, string password);
+   static void closeDatabaseConnections();
 
    PHPBB3AuthenticationStatus checkAuthentication(const char *password, bool doNotDelay = false);
    void processAutentication(StringTableEntry newName, PHPBB3AuthenticationStatus status, TNL::Int<32> badges,
@@ -271,6 +268,13 @@ public:
    PlayerLevelRating *getLevelRating(U32 databaseId, const StringTableEntry &mPlayerOrServerName);
 
    static void removeOldEntriesFromRatingsCache();          // Keep our caches from growing too large
+   static void invalidateHighScores();
+   static void setCacheSizes(U32 totalLevelRatingsSize, U32 playerLevelRatingsSize);
+   static void clearCaches();
+   static Vector<string> getCacheStats();
+
+   static void saveCacheSnapshot(const string &filename);   // Lets a restarted master start with warm caches
+   static void loadCacheSnapshot(const string &filename);
 
 
    void sendPlayerLevelRating(U32 databaseId, S32 rating);  // Helper that wraps m2cSendPlayerLevelRating
@@ -26,44 +26,98 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "authenticator.h"
 #include "phpbbhash.h"
-#include "../zap/stringUtils.h"     // For replaceString()
+#include "../zap/stringUtils.h"     // For trim()
 #include <string.h>
 #include <ctype.h>
 
 #include "mysql++.h"
 #include "tnlLog.h"
+#include "tnlPlatform.h"
 
 using namespace mysqlpp;
 using namespace std;
-using namespace Zap;  // for Zap::replaceString()
+using namespace Zap;  // for Zap::trim()
 
 Authenticator::Authenticator(){
 	connection = NULL;
+	userQuery = NULL;
+	lastUsedTime = 0;
 	securityLevel = 1;
 }
 
 Authenticator::Authenticator(string server, string username, string password, string database, string tablePrefix, int securityLevel){
 	connection = NULL;
+	userQuery = NULL;
+	lastUsedTime = 0;
 	initialize(server, username, password, database, tablePrefix, securityLevel);
 }
 
 Authenticator::~Authenticator(){
-	if (connection) delete connection;
+	disconnect();
 }
 
+// Can be called repeatedly on the same Authenticator; the connection is only dropped if the settings have changed
 void Authenticator::initialize(string server, string username, string password, string database, string tablePrefix, int securityLevel){
+	setSecurityLevel(securityLevel);
+
+	if (connection && server == sqlServer && username == sqlUsername && password == sqlPassword && 
+	    database == sqlDatabase && tablePrefix == prefix)
+		return;
+
+	disconnect();
+
 	sqlServer = server;
 	sqlUsername = username;
 	sqlPassword = password;
 	sqlDatabase = database;
 	prefix = tablePrefix;
-	setSecurityLevel(securityLevel);
+
 	try{
 		connection = new TCPConnection(server.c_str(),database.c_str(),username.c_str(),password.c_str());
 	}
 	catch (mysqlpp::ConnectionFailed e){
 		connection = new TCPConnection();
 	}
+	lastUsedTime = TNL::Platform::getRealMilliseconds();
+}
+
+void Authenticator::disconnect(){
+	delete userQuery;
+	userQuery = NULL;
+	delete connection;
+	connection = NULL;
+}
+
+// Makes sure we have a live connection and a parsed user query to run on it.  The server will close connections
+// that sit idle past its wait_timeout, so ping any that have been resting a while.
+bool Authenticator::ensureConnected(){
+	static const unsigned int IdlePingTime = 60 * 1000;
+
+	if (!connection)
+		connection = new TCPConnection();
+
+	unsigned int now = TNL::Platform::getRealMilliseconds();
+	if (connection->connected() && now - lastUsedTime > IdlePingTime && !connection->ping()){
+		delete userQuery;
+		userQuery = NULL;
+		connection->disconnect();
+	}
+	lastUsedTime = now;
+
+	if (!connection->connected()){
+		delete userQuery;
+		userQuery = NULL;
+		connection->connect(sqlServer.c_str(), sqlDatabase.c_str(), sqlUsername.c_str(), sqlPassword.c_str());
+		if (!connection->connected())
+			return false;
+	}
+
+	if (!userQuery){
+		// %0q has mysql++ quote and escape the username for us
+		userQuery = new Query(connection->query("SELECT username, user_password FROM " + prefix + "users WHERE UPPER(username) = UPPER(%0q)"));
+		userQuery->parse();
+	}
+	return true;
 }
 
 bool Authenticator::authenticate(string &username, string password){
@@ -91,20 +145,12 @@ bool Authenticator::authenticate(string &username, string password, int &errorCo
 			errorCode = 3; //invalid username, possible sql injection attempt.
 			return false;
 		}
-		if (!connection->connected()){
-			connection->connect(sqlServer.c_str(), sqlDatabase.c_str(), sqlUsername.c_str(), sqlPassword.c_str());
-			if (!connection->connected()){
-				errorCode = 0;	//unable to connect to mysql server
-				return false;
-			}
+		if (!ensureConnected()){
+			errorCode = 0;	//unable to connect to mysql server
+			return false;
 		}
-		Query qry = connection->query("");
-
-      // Provide some protection against injection attacks
-      string safeUsername = replaceString(replaceString(trim(username), "\\", "\\\\"), "'", "''");
 
-		string qryText = "SELECT username, user_password FROM " + prefix + "users WHERE UPPER(username) = UPPER('" + safeUsername + "')";
-		StoreQueryResult results = qry.store(qryText.c_str(),qryText.length());
+		StoreQueryResult results = userQuery->store(trim(username));
 
 		if (results.num_rows() == 0){
 			errorCode = 1; //username not found
@@ -125,11 +171,13 @@ bool Authenticator::authenticate(string &username, string password, int &errorCo
 	}
 	catch(mysqlpp::ConnectionFailed e){
 		logprintf("Authenticate error can't connect to mysql: %s", e.what());
+		disconnect();        // Start fresh next time
 		errorCode = 0;       // unable to connect to mysql server
 		return false;
 	}
 	catch (mysqlpp::BadQuery e){
 		logprintf("Authenticate error on mysql query: %s", e.what());
+		disconnect();
 		errorCode = 0;       // unable to connect to mysql server
 		return false;
 	}
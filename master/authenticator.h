@@ -32,6 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace mysqlpp{
 	class TCPConnection;
+	class Query;
 }
 
 class Authenticator
@@ -69,6 +70,8 @@ public:
 
 private:
 	bool isSqlSafe(std::string s);
+	bool ensureConnected();
+	void disconnect();
 
 	std::string sqlServer;
 	std::string sqlUsername;
@@ -76,6 +79,8 @@ private:
 	std::string sqlDatabase;
 	std::string prefix;
 	mysqlpp::TCPConnection *connection;
+	mysqlpp::Query *userQuery;		// Parsed once per connection, reused for every login
+	unsigned int lastUsedTime;
 	int securityLevel;
 };
 
@@ -7,6 +7,7 @@
 #include "database.h"
 #include "tnlTypes.h"
 #include "tnlLog.h"
+#include "tnlPlatform.h"
 
 #include "../zap/stringUtils.h"            // For replaceString() and itos()
 #include "../zap/WeaponInfo.h"
@@ -27,7 +28,7 @@ namespace DbWriter
 {
 
    
-// TODO: Should we be reusing these?
+// Writers are cheap -- the expensive part, the connection, is reused through DbConnectionPool
 DatabaseWriter getDatabaseWriter(const MasterSettings *settings)
 {
    if(settings->getVal<YesNo>("WriteStatsToMySql"))
@@ -64,7 +65,7 @@ DatabaseWriter::DatabaseWriter(const char *db, const char *user, const char *pas
 // Sqlite Constructor
 DatabaseWriter::DatabaseWriter(const char *db)
 {
-   strncpy(mDb, db, sizeof(mDb) - 1);
+   initialize("", db, "", "");
 
    if(!fileExists(mDb))
       createStatsDatabase();
@@ -276,7 +277,8 @@ U64 DatabaseWriter::getServerIDFromCache(const string &serverName, const string
 
 void DatabaseWriter::insertStats(const GameStats &gameStats) 
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   PooledDbQuery pooledQuery(mDb, mServer, mUser, mPassword);
+   const DbQuery &query = *pooledQuery;
 
    try
    {
@@ -289,13 +291,15 @@ void DatabaseWriter::insertStats(const GameStats &gameStats)
    catch(const Exception &ex) 
    {
       logprintf("[%s] Failure writing stats to database: %s", getTimeStamp().c_str(), ex.what());
+      pooledQuery.discard();
    }
 }
 
 
 void DatabaseWriter::insertAchievement(U8 achievementId, const StringTableEntry &playerNick, const string &serverName, const string &serverIP) 
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   PooledDbQuery pooledQuery(mDb, mServer, mUser, mPassword);
+   const DbQuery &query = *pooledQuery;
 
    try
    {
@@ -313,6 +317,7 @@ void DatabaseWriter::insertAchievement(U8 achievementId, const StringTableEntry
    catch(const Exception &ex) 
    {
       logprintf("[%s] Failure writing achievement to database: %s", getTimeStamp().c_str(), ex.what());
+      pooledQuery.discard();
    }
 }
 
@@ -320,7 +325,8 @@ void DatabaseWriter::insertAchievement(U8 achievementId, const StringTableEntry
 void DatabaseWriter::insertLevelInfo(const string &hash, const string &levelName, const string &creator, 
                                      const string &gameType, bool hasLevelGen, U8 teamCount, S32 winningScore, S32 gameDurationInSeconds)
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   PooledDbQuery pooledQuery(mDb, mServer, mUser, mPassword);
+   const DbQuery &query = *pooledQuery;
 
    try
    {
@@ -354,6 +360,7 @@ void DatabaseWriter::insertLevelInfo(const string &hash, const string &levelName
    catch(const Exception &ex) 
    {
       logprintf("[%s] Failure writing level info to database: %s", getTimeStamp().c_str(), ex.what());
+      pooledQuery.discard();
    }
 }
 
@@ -480,11 +487,12 @@ S32 DatabaseWriter::getLevelRating(U32 databaseId, const StringTableEntry &name)
 
 Int<BADGE_COUNT> DatabaseWriter::getAchievements(const char *name)
 {
-   string sql = "SELECT achievement_id FROM player_achievements WHERE player_name = '" + string(name) + "';";
+   Vector<string> params;
+   params.push_back(name);
 
    Vector<Vector<string> > results;
 
-   selectHandler(sql, 1, results);
+   selectHandler("SELECT achievement_id FROM player_achievements WHERE player_name = ?;", params, 1, results);
 
    S32 badges = 0;
 
@@ -497,11 +505,12 @@ Int<BADGE_COUNT> DatabaseWriter::getAchievements(const char *name)
 
 U16 DatabaseWriter::getGamesPlayed(const char *name)
 {
-   string sql = "SELECT count(*) FROM stats_player WHERE player_name = '" + string(name) + "';";
+   Vector<string> params;
+   params.push_back(name);
 
    Vector<Vector<string> > results;
 
-   selectHandler(sql, 1, results);
+   selectHandler("SELECT count(*) FROM stats_player WHERE player_name = ?;", params, 1, results);
 
    if(results.size() == 0)
       return 0;
@@ -512,7 +521,8 @@ U16 DatabaseWriter::getGamesPlayed(const char *name)
 
 void DatabaseWriter::selectHandler(const string &sql, S32 cols, Vector<Vector<string> > &values)
 {
-   DbQuery query(mDb, mServer, mUser, mPassword);
+   PooledDbQuery pooledQuery(mDb, mServer, mUser, mPassword);
+   const DbQuery &query = *pooledQuery;
 
    try
    {
@@ -549,7 +559,7 @@ void DatabaseWriter::selectHandler(const string &sql, S32 cols, Vector<Vector<st
             values.push_back(Vector<string>());     // Add another row
 
             for(S32 j = 0; j < cols; j++)
-               values[i].push_back(results[cols + i + j]);
+               values.last().push_back(results[cols + i + j]);
          }
 
          sqlite3_free_table(results);
@@ -560,7 +570,69 @@ void DatabaseWriter::selectHandler(const string &sql, S32 cols, Vector<Vector<st
    {
       logprintf(LogConsumer::LogError, "[%s]SQL Execution Error \"%s\"\n\trunning sql: %s", 
                 getTimeStamp().c_str(), ex.what(), sql.c_str());
+      pooledQuery.discard();
+   }
+}
+
+
+#ifdef BF_WRITE_TO_MYSQL
+// Replaces each ? in sql with the corresponding param, quoted and escaped
+static string bindParams(const string &sql, const Vector<string> &params)
+{
+   string bound;
+   S32 param = 0;
+
+   for(size_t i = 0; i < sql.length(); i++)
+   {
+      if(sql[i] == '?' && param < params.size())
+         bound += "'" + sanitizeForSql(params[param++]) + "'";
+      else
+         bound += sql[i];
+   }
+
+   return bound;
+}
+#endif
+
+
+// Like selectHandler above, but params are bound to the ? placeholders in sql.  On sqlite, the statement is prepared
+// once per connection and reused, so only use this with fixed sql text, never with values pasted into it.
+void DatabaseWriter::selectHandler(const string &sql, const Vector<string> &params, S32 cols, Vector<Vector<string> > &values)
+{
+#ifdef BF_WRITE_TO_MYSQL
+   if(mServer[0] != 0)     // MySQL -- fill in the params and let the server take it from there
+   {
+      selectHandler(bindParams(sql, params), cols, values);
+      return;
+   }
+#endif
+
+   PooledDbQuery pooledQuery(mDb, mServer, mUser, mPassword);
+   DbQuery &query = *pooledQuery;
+
+   if(DbQuery::dumpSql)
+      logprintf("SQL: %s", sql.c_str());
+
+   sqlite3_stmt *statement = query.getPreparedStatement(sql);
+
+   if(!statement)
+      return;
+
+   for(S32 i = 0; i < params.size(); i++)
+      sqlite3_bind_text(statement, i + 1, params[i].c_str(), -1, SQLITE_TRANSIENT);
+
+   while(sqlite3_step(statement) == SQLITE_ROW)
+   {
+      values.push_back(Vector<string>());     // Add another row
+
+      for(S32 j = 0; j < cols; j++)
+      {
+         const char *text = (const char *)sqlite3_column_text(statement, j);
+         values.last().push_back(text ? text : "");
+      }
    }
+
+   sqlite3_reset(statement);     // Releases any locks the statement holds until we need it again
 }
 
 
@@ -604,6 +676,12 @@ DbQuery::DbQuery(const char *db, const char *server, const char *user, const cha
    query = NULL;
    sqliteDb = NULL;
    isValid = true;
+   lastUsedTime = Platform::getRealMilliseconds();
+
+   mDb       = db       ? db       : "";
+   mServer   = server   ? server   : "";
+   mUser     = user     ? user     : "";
+   mPassword = password ? password : "";
 
    TNLAssert(db && db[0] != 0, "must have a database");
 
@@ -638,6 +716,9 @@ DbQuery::DbQuery(const char *db, const char *server, const char *user, const cha
 // Destructor
 DbQuery::~DbQuery()
 {
+   for(map<string, sqlite3_stmt *>::iterator it = mStatements.begin(); it != mStatements.end(); it++)
+      sqlite3_finalize(it->second);
+
    if(query)
       delete query;
 
@@ -680,6 +761,206 @@ U64 DbQuery::runQuery(const string &sql) const
 }
 
 
+bool DbQuery::matches(const char *db, const char *server, const char *user, const char *password) const
+{
+   return mDb       == (db       ? db       : "") &&
+          mServer   == (server   ? server   : "") &&
+          mUser     == (user     ? user     : "") &&
+          mPassword == (password ? password : "");
+}
+
+
+// MySQL drops connections that sit idle too long (wait_timeout), so make sure one that's been resting a while is
+// still there before handing it out.  Returns false if the connection is no good.
+bool DbQuery::checkConnection()
+{
+   if(!isValid)
+      return false;
+
+#ifdef BF_WRITE_TO_MYSQL
+   static const U32 IdlePingTime = 60 * 1000;
+
+   if(query && Platform::getRealMilliseconds() - lastUsedTime > IdlePingTime)
+      return conn.ping();
+#endif
+
+   return true;
+}
+
+
+// Returns a prepared statement for sql, preparing it on first use, or NULL if this isn't a sqlite connection or
+// the sql won't compile.  The statement is owned by this DbQuery.
+sqlite3_stmt *DbQuery::getPreparedStatement(const string &sql)
+{
+   // Callers are supposed to pass fixed sql, but don't let a mistake there grow the cache without bound
+   static const U32 MaxCachedStatements = 32;
+
+   if(!isValid || !sqliteDb)
+      return NULL;
+
+   map<string, sqlite3_stmt *>::iterator it = mStatements.find(sql);
+
+   if(it != mStatements.end())
+      return it->second;
+
+   if(mStatements.size() >= MaxCachedStatements)
+   {
+      for(it = mStatements.begin(); it != mStatements.end(); it++)
+         sqlite3_finalize(it->second);
+
+      mStatements.clear();
+   }
+
+   sqlite3_stmt *statement = NULL;
+
+   if(sqlite3_prepare_v2(sqliteDb, sql.c_str(), -1, &statement, NULL) != SQLITE_OK)
+   {
+      logprintf(LogConsumer::LogError, "[%s]SQL Prepare Error \"%s\"\n\trunning sql: %s", 
+                getTimeStamp().c_str(), sqlite3_errmsg(sqliteDb), sql.c_str());
+      sqlite3_finalize(statement);
+      return NULL;
+   }
+
+   mStatements[sql] = statement;
+   return statement;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+Mutex DbConnectionPool::mMutex;
+Vector<DbQuery *> DbConnectionPool::mIdleConnections;
+bool DbConnectionPool::mEnabled = true;
+
+// Enough for the database thread plus the occasional lookup from elsewhere; extras are closed when returned
+static const S32 MaxIdleConnections = 4;
+
+
+// Returns an open connection to the specified database, reusing an idle one if we have it.  Never returns NULL, but
+// the connection may not be valid if the database can't be reached.
+DbQuery *DbConnectionPool::acquire(const char *db, const char *server, const char *user, const char *password)
+{
+   while(true)
+   {
+      DbQuery *query = NULL;
+
+      mMutex.lock();
+
+      for(S32 i = mIdleConnections.size() - 1; i >= 0; i--)    // Most recently used are at the end
+         if(mIdleConnections[i]->matches(db, server, user, password))
+         {
+            query = mIdleConnections[i];
+            mIdleConnections.erase(i);
+            break;
+         }
+
+      mMutex.unlock();
+
+      if(!query)
+         return new DbQuery(db, server, user, password);
+
+      if(query->checkConnection())
+         return query;
+
+      delete query;     // Gone stale, try the next one
+   }
+}
+
+
+void DbConnectionPool::release(DbQuery *query)
+{
+   if(!query)
+      return;
+
+   if(!mEnabled || !query->isValid)
+   {
+      delete query;
+      return;
+   }
+
+   query->lastUsedTime = Platform::getRealMilliseconds();
+
+   mMutex.lock();
+
+   mIdleConnections.push_back(query);
+
+   if(mIdleConnections.size() > MaxIdleConnections)
+   {
+      query = mIdleConnections[0];        // Least recently used
+      mIdleConnections.erase(0);
+   }
+   else
+      query = NULL;
+
+   mMutex.unlock();
+
+   delete query;
+}
+
+
+void DbConnectionPool::closeAll()
+{
+   mMutex.lock();
+
+   for(S32 i = 0; i < mIdleConnections.size(); i++)
+      delete mIdleConnections[i];
+
+   mIdleConnections.clear();
+
+   mMutex.unlock();
+}
+
+
+// A forked child shares its parent's sockets and file handles; closing them would pull them out from under
+// the parent, so we just let go of them and open our own
+void DbConnectionPool::forgetAll()
+{
+   mIdleConnections.clear();
+}
+
+
+// Turning pooling off closes each connection once it's been used, which is how things worked before we had a pool
+void DbConnectionPool::setEnabled(bool enabled)
+{
+   mEnabled = enabled;
+
+   if(!enabled)
+      closeAll();
+}
+
+
+S32 DbConnectionPool::getIdleCount()
+{
+   mMutex.lock();
+   S32 count = mIdleConnections.size();
+   mMutex.unlock();
+
+   return count;
+}
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+PooledDbQuery::PooledDbQuery(const char *db, const char *server, const char *user, const char *password)
+{
+   mQuery = DbConnectionPool::acquire(db, server, user, password);
+}
+
+
+PooledDbQuery::~PooledDbQuery()
+{
+   DbConnectionPool::release(mQuery);
+}
+
+
+void PooledDbQuery::discard()
+{
+   mQuery->isValid = false;      // release() will close it
+}
+
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 
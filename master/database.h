@@ -13,8 +13,10 @@
 #include "tnlTypes.h"
 #include "tnlVector.h"
 #include "tnlNonce.h"
+#include "tnlThread.h"
 #include <sqlite3.h>
 #include <string>
+#include <map>
 
 
 #ifdef BF_WRITE_TO_MYSQL
@@ -64,17 +66,71 @@ class DbQuery
    Connection conn;
 #endif
 
+   string mDb;          // Remember what we're connected to so the pool can match us up with later requests
+   string mServer;
+   string mUser;
+   string mPassword;
+
+   map<string, sqlite3_stmt *> mStatements;     // Prepared sqlite statements, keyed by their sql
+
 public:
    Query *query;
    sqlite3 *sqliteDb;
 
    bool isValid;
+   U32 lastUsedTime;
    static bool dumpSql;
    
    DbQuery(const char *db, const char *server = NULL, const char *user = NULL, const char *password = NULL);     // Constructor
    ~DbQuery();                      // Destructor
 
    U64 runQuery(const string &sql) const;
+
+   bool matches(const char *db, const char *server, const char *user, const char *password) const;
+   bool checkConnection();
+
+   sqlite3_stmt *getPreparedStatement(const string &sql);
+};
+
+
+////////////////////////////////////////
+////////////////////////////////////////
+
+// Keeps database connections open between queries.  Opening a MySQL connection costs a TCP handshake and a login,
+// and opening sqlite means reparsing the schema, so handing the same connection to each lookup is much cheaper when
+// every player login fans out into several queries.  Connections are only ever used by one thread at a time.
+class DbConnectionPool
+{
+private:
+   static Mutex mMutex;
+   static Vector<DbQuery *> mIdleConnections;
+   static bool mEnabled;
+
+public:
+   static DbQuery *acquire(const char *db, const char *server, const char *user, const char *password);
+   static void release(DbQuery *query);
+
+   static void closeAll();
+   static void forgetAll();      // For forked children -- drop the parent's connections without closing them
+
+   static void setEnabled(bool enabled);
+   static S32 getIdleCount();
+};
+
+
+// Borrows a connection from the pool for the life of the object
+class PooledDbQuery
+{
+private:
+   DbQuery *mQuery;
+
+public:
+   PooledDbQuery(const char *db, const char *server, const char *user, const char *password);
+   ~PooledDbQuery();
+
+   DbQuery &operator*() const { return *mQuery; }
+
+   void discard();      // Close the connection rather than returning it to the pool, e.g. after an error
 };
 
 
@@ -115,6 +171,7 @@ public:
    DatabaseWriter(const char *db);
 
    void selectHandler(const string &sql, S32 cols, Vector<Vector<string> > &values);
+   void selectHandler(const string &sql, const Vector<string> &params, S32 cols, Vector<Vector<string> > &values);
 
    void setDumpSql(bool dump);
 
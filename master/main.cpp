@@ -23,10 +23,7 @@
 #include <stdarg.h>     
 #include <time.h>
 #include <map>
-
-#ifdef GAME_JOLT
-#  include <signal.h>
-#endif
+#include <signal.h>
 
 using namespace TNL;
 using namespace std;
@@ -136,6 +133,15 @@ void seedRandomNumberGenerator()
    Random::addEntropy(buf, 16);
 }
 
+
+static volatile sig_atomic_t gShutdownRequested = 0;
+
+// Let the main loop exit cleanly, so the MasterServer destructor gets a chance to save its caches
+static void handleShutdownSignal(int signal)
+{
+   gShutdownRequested = 1;
+}
+
 }
 
 using namespace Master;
@@ -174,9 +180,12 @@ int main(int argc, const char **argv)
    signal(SIGCHLD, SIG_IGN);     // Allow zombie children to die quietly
 #endif
 
+   signal(SIGINT,  handleShutdownSignal);
+   signal(SIGTERM, handleShutdownSignal);
+
    U32 lastTime = Platform::getRealMilliseconds();
 
-   while(true)
+   while(!gShutdownRequested)
    {
       U32 currentTime = Platform::getRealMilliseconds();
 
@@ -191,5 +200,7 @@ int main(int argc, const char **argv)
       Platform::sleep(5);
    }
 
+   logprintf("[%s] Master Server shutting down", getTimeStamp().c_str());
+
    return 0;
 }
@@ -34,6 +34,11 @@ MasterSettings::MasterSettings(const string &iniFile)
    mSettings.add(new Setting<U32>   ("Port",                                 25955,            "port",                                 "host"));
    mSettings.add(new Setting<U32>   ("LatestReleasedCSProtocol",               0,              "latest_released_cs_protocol",          "host"));
    mSettings.add(new Setting<U32>   ("LatestReleasedBuildVersion",             0,              "latest_released_client_build_version", "host"));
+
+   // Caches of data from the stats database; they are saved on shutdown and reloaded at startup
+   mSettings.add(new Setting<string>("CacheSnapshotFile",               "master_cache.txt",     "cache_snapshot_file",                  "host"));
+   mSettings.add(new Setting<U32>   ("LevelRatingsCacheSize",                10000,            "level_ratings_cache_size",             "host"));
+   mSettings.add(new Setting<U32>   ("PlayerRatingsCacheSize",               50000,            "player_ratings_cache_size",            "host"));
                                                                                                
    // Variables for managing access to MySQL                                                   
    mSettings.add(new Setting<string>("MySqlAddress",                           "",             "phpbb_database_address",               "phpbb"));
@@ -197,15 +202,22 @@ MasterServer::MasterServer(MasterSettings *settings)
    mDatabaseAccessThread = new DatabaseAccessThread();    // Deleted in destructor
 
    MasterServerConnection::setMasterServer(this);
+
+   applyCacheSizes();
+   MasterServerConnection::loadCacheSnapshot(getSetting<string>("CacheSnapshotFile"));
 }
 
 
 // Destructor
 MasterServer::~MasterServer()
 {
+   MasterServerConnection::saveCacheSnapshot(getSetting<string>("CacheSnapshotFile"));
+
    delete mNetInterface;
 
    delete mDatabaseAccessThread;
+
+   MasterServerConnection::closeDatabaseConnections();
 }
 
 
@@ -288,6 +300,28 @@ void MasterServer::removeClient(S32 index)
 }
 
 
+// Post a single event to every client except the specified one, optionally restricting to those in global chat.
+// The event is shared by all recipients; create it with TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT so its
+// arguments are only marshaled once, rather than once per client.
+void MasterServer::broadcastToClients(NetEvent *event, const MasterServerConnection *except, bool globalChatOnly) const
+{
+   Vector<EventConnection *> recipients;
+   recipients.reserve(mClientList.size());
+
+   for(S32 i = 0; i < mClientList.size(); i++)
+      if(mClientList[i] != except && (!globalChatOnly || mClientList[i]->isInGlobalChat))
+         recipients.push_back(mClientList[i]);
+
+   EventConnection::postNetEventToAll(event, recipients);
+}
+
+
+void MasterServer::applyCacheSizes() const
+{
+   MasterServerConnection::setCacheSizes(getSetting<U32>("LevelRatingsCacheSize"), getSetting<U32>("PlayerRatingsCacheSize"));
+}
+
+
 NetInterface *MasterServer::getNetInterface() const
 {
    return mNetInterface;
@@ -303,6 +337,7 @@ void MasterServer::idle(const U32 timeDelta)
    if(mReadConfigTimer.update(timeDelta))
    {
       mSettings->readConfigFile();
+      applyCacheSizes();
       mReadConfigTimer.reset();
    }
 
@@ -310,6 +345,14 @@ void MasterServer::idle(const U32 timeDelta)
    if(mCleanupTimer.update(timeDelta))
    {
       MasterServerConnection::removeOldEntriesFromRatingsCache();    //<== need non-static access
+
+      // Save a snapshot now and then, so we still have something to warm up from after a crash
+      MasterServerConnection::saveCacheSnapshot(getSetting<string>("CacheSnapshotFile"));
+
+      Vector<string> cacheStats = MasterServerConnection::getCacheStats();
+      for(S32 i = 0; i < cacheStats.size(); i++)
+         logprintf(LogConsumer::LogConnection, "Cache stats -- %s", cacheStats[i].c_str());
+
       mCleanupTimer.reset();
    }
 
@@ -371,11 +414,7 @@ void MasterServer::idle(const U32 timeDelta)
          {
             c->isInGlobalChat = false;
 
-            const Vector<MasterServerConnection *> *clientList = getClientList();
-
-            for(S32 j = 0; j < clientList->size(); j++)
-               if(clientList->get(j) != c && clientList->get(j)->isInGlobalChat)
-                  clientList->get(j)->m2cPlayerLeftGlobalChat(c->mPlayerOrServerName);
+            broadcastToClients(TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(c, m2cPlayerLeftGlobalChat, (c->mPlayerOrServerName)), c, true);
 
             MasterServerConnection::gLeaveChatTimerList.erase(i);
          }
@@ -84,6 +84,7 @@ private:
    Vector<MasterServerConnection *> mClientList;
 
    NetInterface *createNetInterface() const;
+   void applyCacheSizes() const;
 
 public:
    MasterServer(MasterSettings *settings);      // Constructor
@@ -114,6 +115,8 @@ public:
    void removeServer(S32 index);
    void removeClient(S32 index);
 
+   void broadcastToClients(NetEvent *event, const MasterServerConnection *except, bool globalChatOnly) const;
+
    void idle(const U32 timeDelta);
 };
 
@@ -20,6 +20,7 @@ LOCAL_SRC_FILES := assert.cpp \
 	certificate.cpp \
 	clientPuzzle.cpp \
 	connectionStringTable.cpp \
+	cryptoBackend.cpp \
 	dataChunker.cpp \
 	eventConnection.cpp \
 	ghostConnection.cpp \
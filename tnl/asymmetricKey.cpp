@@ -146,16 +146,18 @@ ByteBufferPtr AsymmetricKey::computeSharedSecretKey(AsymmetricKey *publicKey)
    if(publicKey->getKeySize() != getKeySize() || !mHasPrivateKey)
       return NULL;
 
+   // NetInterface calls this from its handshake worker threads, so use our own buffer rather than
+   // staticCryptoBuffer, and don't log (logprintf isn't thread safe)
+   U8 secret[StaticCryptoBufferSize];
    U8 hash[32];
-   unsigned long outLen = sizeof(staticCryptoBuffer);
+   unsigned long outLen = sizeof(secret);
 
-   TIME_BLOCK(secretSubKeyGen,
    crypto_shared_secret((crypto_key *) mKeyData, (crypto_key *) publicKey->mKeyData,
-      staticCryptoBuffer, &outLen);
-   )
+      secret, &outLen);
+
    hash_state hashState;
    sha256_init(&hashState);
-   sha256_process(&hashState, staticCryptoBuffer, outLen);
+   sha256_process(&hashState, secret, outLen);
    sha256_done(&hashState, hash);
    ByteBuffer *ret = new ByteBuffer(hash, 32);
    ret->takeOwnership();
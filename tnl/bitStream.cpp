@@ -32,6 +32,7 @@
 #include <tomcrypt.h>
 
 #include <math.h>
+#include <string.h>
 
 namespace TNL {
 
@@ -90,11 +91,53 @@ bool BitStream::resizeBits(U32 newBits)
    return true;
 }
 
+// Loads the 8 bytes at the current byte position, replaces the bitCount bits starting at the current bit with
+// value, and stores them back -- the same bits the byte loop in writeBits would produce.  Callers must check
+// fitsWord() first.
+inline void BitStream::writeWord(U64 value, U32 bitCount)
+{
+   U8 *ptr = getBuffer() + (bitNum >> 3);
+   U32 shift = bitNum & 0x7;
+   U64 mask = ((U64(1) << bitCount) - 1) << shift;
+
+   U64 word;
+   memcpy(&word, ptr, sizeof(word));
+   word = convertLEndianToHost(word);
+
+   word = (word & ~mask) | ((value << shift) & mask);
+
+   word = convertHostToLEndian(word);
+   memcpy(ptr, &word, sizeof(word));
+
+   bitNum += bitCount;
+}
+
+// Counterpart of writeWord; unread high bits come back cleared.  Callers must check fitsWord() first.
+inline U64 BitStream::readWord(U32 bitCount)
+{
+   U64 word;
+   memcpy(&word, getBuffer() + (bitNum >> 3), sizeof(word));
+   word = convertLEndianToHost(word);
+
+   U64 value = (word >> (bitNum & 0x7)) & ((U64(1) << bitCount) - 1);
+   bitNum += bitCount;
+
+   return value;
+}
+
 bool BitStream::writeBits(U32 bitCount, const void *bitPtr)
 {
    if(!bitCount)
       return true;
 
+   if(fitsWord(bitCount, maxWriteBitNum))
+   {
+      U64 value = 0;
+      memcpy(&value, bitPtr, (bitCount + 7) >> 3);
+      writeWord(convertLEndianToHost(value), bitCount);
+      return true;
+   }
+
    if(bitCount + bitNum > maxWriteBitNum)
       if(!resizeBits(bitCount + bitNum - maxWriteBitNum))
          return false;
@@ -170,6 +213,13 @@ bool BitStream::readBits(U32 bitCount, void *bitPtr)
       return false;
    }
 
+   if(fitsWord(bitCount, maxReadBitNum))
+   {
+      U64 value = convertHostToLEndian(readWord(bitCount));
+      memcpy(bitPtr, &value, (bitCount + 7) >> 3);
+      return true;
+   }
+
    U8 *sourcePtr = getBuffer() + (bitNum >> 3);
    U32 byteCount = (bitCount + 7) >> 3;
 
@@ -258,6 +308,10 @@ bool BitStream::read(ByteBuffer *theBuffer)
 U32 BitStream::readInt(U8 bitCount)
 {
    TNLAssert(bitCount <= 32, "bitCount must be less then 32, for 64 bit, use readInt64");
+
+   if(fitsWord(bitCount, maxReadBitNum))
+      return U32(readWord(bitCount));
+
    U32 ret = 0;
    readBits(bitCount, &ret);
    ret = convertLEndianToHost(ret);
@@ -273,6 +327,9 @@ U32 BitStream::readInt(U8 bitCount)
 
 U64 BitStream::readInt64(U8 bitCount)
 {
+   if(fitsWord(bitCount, maxReadBitNum))
+      return readWord(bitCount);
+
    U64 ret = 0;
    readBits(bitCount, &ret);
    ret = convertLEndianToHost(ret);
@@ -290,12 +347,25 @@ U64 BitStream::readInt64(U8 bitCount)
 void BitStream::writeInt(U32 val, U8 bitCount)
 {
    TNLAssert(bitCount <= 32, "bitCount must be less then 32, for 64 bit, use writeInt64");
+
+   if(fitsWord(bitCount, maxWriteBitNum))
+   {
+      writeWord(val, bitCount);
+      return;
+   }
+
    val = convertHostToLEndian(val);
    writeBits(bitCount, &val);
 }
 
 void BitStream::writeInt64(U64 val, U8 bitCount)
 {
+   if(fitsWord(bitCount, maxWriteBitNum))
+   {
+      writeWord(val, bitCount);
+      return;
+   }
+
    val = convertHostToLEndian(val);
    writeBits(bitCount, &val);
 }
@@ -554,14 +624,11 @@ void BitStream::hashAndEncrypt(U32 hashDigestSize, U32 encryptStartOffset, Symme
 {
    U32 digestStart = getBytePosition();
    setBytePosition(digestStart);
-   hash_state hashState;
 
-   U8 hash[32];
+   U8 hash[CryptoBackend::Sha256Size];
 
    // do a sha256 hash of the BitStream:
-   sha256_init(&hashState);
-   sha256_process(&hashState, getBuffer(), digestStart);
-   sha256_done(&hashState, hash);
+   theCipher->getBackend()->sha256(getBuffer(), digestStart, hash);
 
    // write the hash into the BitStream:
    write(hashDigestSize, hash);
@@ -583,12 +650,8 @@ bool BitStream::decryptAndCheckHash(U32 hashDigestSize, U32 decryptStartOffset,
                       buffer + decryptStartOffset,
                       bufferSize - decryptStartOffset);
 
-   hash_state hashState;
-   U8 hash[32];
-
-   sha256_init(&hashState);
-   sha256_process(&hashState, buffer, bufferSize - hashDigestSize);
-   sha256_done(&hashState, hash);
+   U8 hash[CryptoBackend::Sha256Size];
+   theCipher->getBackend()->sha256(buffer, bufferSize - hashDigestSize, hash);
 
    bool ret = !memcmp(buffer + bufferSize - hashDigestSize, hash, hashDigestSize);
    if(ret)
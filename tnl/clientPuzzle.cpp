@@ -26,6 +26,7 @@
 
 #include "tnl.h"
 #include "tnlClientPuzzle.h"
+#include "tnlLog.h"
 #include "tnlRandom.h"
 
 #include <tomcrypt.h>
@@ -59,11 +60,34 @@ bool ClientPuzzleManager::NonceTable::checkAdd(Nonce &theNonce)
    return true;
 }
 
+bool ClientPuzzleManager::NonceTable::contains(Nonce &theNonce)
+{
+   U32 nonce1 = readU32FromBuffer(theNonce.data);
+   U32 nonce2 = readU32FromBuffer(theNonce.data + 4);
+
+   U64 fullNonce = (U64(nonce1) << 32) | nonce2;
+
+   U32 hashIndex = U32(fullNonce % mHashTableSize);
+   for(Entry *walk = mHashTable[hashIndex]; walk; walk = walk->mHashNext)
+      if(walk->mNonce == theNonce)
+         return true;
+   return false;
+}
+
 ClientPuzzleManager::ClientPuzzleManager()
 {
    mCurrentDifficulty = InitialPuzzleDifficulty;
    mLastUpdateTime = 0;
    mLastTickTime = 0;
+
+   mAdaptiveDifficulty = true;
+   mPreviousDifficulty = InitialPuzzleDifficulty;
+   mDifficultyChangeTime = 0;
+   mLastAdjustTime = 0;
+   mRequestCount = 0;
+   mHandshakeTime = 0;
+   mRequestRate = 0;
+   mHandshakeLoad = 0;
    //Random::read(mCurrentNonce.data, Nonce::NonceSize);
    //Random::read(mLastNonce.data, Nonce::NonceSize);
    mCurrentNonce.getRandom();
@@ -82,13 +106,12 @@ ClientPuzzleManager::~ClientPuzzleManager()
 void ClientPuzzleManager::tick(U32 currentTime)
 {
    if(!mLastTickTime)
-      mLastTickTime = currentTime;
+      mLastAdjustTime = currentTime;
 
-   // use delta of last tick time and current time to manage puzzle
-   // difficulty.
-
-   // not yet implemented.
+   mLastTickTime = currentTime;
 
+   if(currentTime - mLastAdjustTime >= DifficultyAdjustInterval)
+      adjustDifficulty(currentTime);
 
    // see if it's time to refresh the current puzzle:
    U32 timeDelta = currentTime - mLastUpdateTime;
@@ -134,15 +157,84 @@ bool ClientPuzzleManager::checkOneSolution(U32 solution, Nonce &clientNonce, Non
    return (mask & hash[index]) == 0;
 }
 
-ClientPuzzleManager::ErrorCode ClientPuzzleManager::checkSolution(U32 solution, Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty, U32 clientIdentity)
+void ClientPuzzleManager::adjustDifficulty(U32 currentTime)
+{
+   F32 seconds = (currentTime - mLastAdjustTime) * 0.001f;
+
+   // Smooth over a couple of intervals so one burst doesn't bounce the difficulty around
+   mRequestRate   = (mRequestRate   + mRequestCount  / seconds) * 0.5f;
+   mHandshakeLoad = (mHandshakeLoad + F32(mHandshakeTime) / seconds) * 0.5f;
+
+   mLastAdjustTime = currentTime;
+   mRequestCount = 0;
+   mHandshakeTime = 0;
+
+   if(!mAdaptiveDifficulty)
+      return;
+
+   U32 newDifficulty = mCurrentDifficulty;
+
+   if(mRequestRate > HighRequestRate || mHandshakeLoad > HighHandshakeLoad)
+   {
+      if(newDifficulty < MaxPuzzleDifficulty)
+         newDifficulty++;
+   }
+   else if(mRequestRate < LowRequestRate && mHandshakeLoad < LowHandshakeLoad)
+   {
+      if(newDifficulty > MinPuzzleDifficulty)
+         newDifficulty--;
+   }
+
+   if(newDifficulty == mCurrentDifficulty)
+      return;
+
+   logprintf(LogConsumer::LogNetInterface, "Client puzzle difficulty %d -> %d (%.1f requests/s, %.1f ms/s handshaking)",
+             mCurrentDifficulty, newDifficulty, mRequestRate, mHandshakeLoad);
+
+   mPreviousDifficulty = mCurrentDifficulty;
+   mCurrentDifficulty = newDifficulty;
+   mDifficultyChangeTime = currentTime;
+}
+
+void ClientPuzzleManager::setAdaptiveDifficulty(bool adaptive)
+{
+   mAdaptiveDifficulty = adaptive;
+
+   if(!adaptive && mCurrentDifficulty != InitialPuzzleDifficulty)
+   {
+      mPreviousDifficulty = mCurrentDifficulty;
+      mCurrentDifficulty = InitialPuzzleDifficulty;
+      mDifficultyChangeTime = mLastTickTime;
+   }
+}
+
+bool ClientPuzzleManager::isAcceptedDifficulty(U32 puzzleDifficulty)
+{
+   if(puzzleDifficulty > MaxPuzzleDifficulty)
+      return false;
+
+   // A harder puzzle than we asked for is fine -- we may have lowered the difficulty while the client was solving
+   if(puzzleDifficulty >= mCurrentDifficulty)
+      return true;
+
+   // Clients that got their puzzle just before we raised the difficulty
+   return puzzleDifficulty >= mPreviousDifficulty && mLastTickTime - mDifficultyChangeTime < DifficultyGracePeriod;
+}
+
+ClientPuzzleManager::NonceTable *ClientPuzzleManager::findNonceTable(Nonce &serverNonce)
 {
-   if(puzzleDifficulty != mCurrentDifficulty)
-      return InvalidPuzzleDifficulty;
-   NonceTable *theTable = NULL;
    if(serverNonce == mCurrentNonce)
-      theTable = mCurrentNonceTable;
+      return mCurrentNonceTable;
    else if(serverNonce == mLastNonce)
-      theTable = mLastNonceTable;
+      return mLastNonceTable;
+   return NULL;
+}
+
+ClientPuzzleManager::ErrorCode ClientPuzzleManager::checkSolution(U32 solution, Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty, U32 clientIdentity)
+{
+   if(!isAcceptedDifficulty(puzzleDifficulty))
+      return InvalidPuzzleDifficulty;
+   NonceTable *theTable = findNonceTable(serverNonce);
    if(!theTable)
       return InvalidServerNonce;
    if(!checkOneSolution(solution, clientNonce, serverNonce, puzzleDifficulty, clientIdentity))
@@ -152,6 +244,29 @@ ClientPuzzleManager::ErrorCode ClientPuzzleManager::checkSolution(U32 solution,
    return Success;
 }
 
+ClientPuzzleManager::ErrorCode ClientPuzzleManager::checkParameters(Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty)
+{
+   if(!isAcceptedDifficulty(puzzleDifficulty))
+      return InvalidPuzzleDifficulty;
+   NonceTable *theTable = findNonceTable(serverNonce);
+   if(!theTable)
+      return InvalidServerNonce;
+   if(theTable->contains(clientNonce))
+      return InvalidClientNonce;
+   return Success;
+}
+
+ClientPuzzleManager::ErrorCode ClientPuzzleManager::recordSolution(Nonce &clientNonce, Nonce &serverNonce)
+{
+   // The server nonce may have expired while the solution was being checked
+   NonceTable *theTable = findNonceTable(serverNonce);
+   if(!theTable)
+      return InvalidServerNonce;
+   if(!theTable->checkAdd(clientNonce))
+      return InvalidClientNonce;
+   return Success;
+}
+
 bool ClientPuzzleManager::solvePuzzle(U32 *solution, Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty, U32 clientIdentity)
 {
    U32 startTime = Platform::getRealMilliseconds();
@@ -0,0 +1,364 @@
+//-----------------------------------------------------------------------------------
+//
+//   Torque Network Library
+//   Copyright (C) 2004 GarageGames.com, Inc.
+//   For more information see http://www.opentnl.org
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   For use in products that are not compatible with the terms of the GNU 
+//   General Public License, alternative licensing options are available 
+//   from GarageGames.com.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//------------------------------------------------------------------------------------
+
+#include "tnl.h"
+#include "tnlCryptoBackend.h"
+
+#include <string.h>
+
+// The hardware backend needs compiler support for the AES and SHA intrinsics
+#if defined(TNL_CPU_X86) && (defined(__GNUC__) || defined(TNL_COMPILER_VISUALC))
+#  define TNL_HARDWARE_CRYPTO
+#endif
+
+#ifdef TNL_HARDWARE_CRYPTO
+#  ifdef TNL_COMPILER_VISUALC
+#     include <intrin.h>
+#     define TNL_TARGET_AES
+#     define TNL_TARGET_SHA
+#  else
+#     include <cpuid.h>
+#     include <immintrin.h>
+      // Compile just these functions for the newer instructions; they're only called if the CPU has them
+#     define TNL_TARGET_AES __attribute__((target("aes,sse2")))
+#     define TNL_TARGET_SHA __attribute__((target("sha,sse4.1,ssse3")))
+#  endif
+#endif
+
+namespace TNL {
+
+//------------------------------------------------------------------------------
+// Portable backend
+//------------------------------------------------------------------------------
+
+class TomCryptBackend : public CryptoBackend
+{
+public:
+   const char *getName()
+   {
+      return "libtomcrypt";
+   }
+
+   void aesSetup(const U8 key[AesKeySize], AesKey *expandedKey)
+   {
+      rijndael_setup(key, AesKeySize, 0, &expandedKey->tomcrypt);
+   }
+
+   void aesEncryptBlock(const AesKey *expandedKey, const U8 in[AesBlockSize], U8 out[AesBlockSize])
+   {
+      rijndael_ecb_encrypt(in, out, const_cast<symmetric_key *>(&expandedKey->tomcrypt));   // tomcrypt isn't const-correct
+   }
+
+   void sha256(const U8 *data, U32 len, U8 hash[Sha256Size])
+   {
+      hash_state hashState;
+      sha256_init(&hashState);
+      sha256_process(&hashState, data, len);
+      sha256_done(&hashState, hash);
+   }
+};
+
+static TomCryptBackend gTomCryptBackend;
+
+//------------------------------------------------------------------------------
+// x86 AES-NI / SHA-NI backend
+//------------------------------------------------------------------------------
+
+#ifdef TNL_HARDWARE_CRYPTO
+
+TNL_TARGET_AES static inline __m128i aesExpandStep(__m128i key, __m128i keyGen)
+{
+   keyGen = _mm_shuffle_epi32(keyGen, _MM_SHUFFLE(3, 3, 3, 3));
+   key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+   key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+   key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+   return _mm_xor_si128(key, keyGen);
+}
+
+// _mm_aeskeygenassist_si128 needs its round constant as an immediate
+#define AES_EXPAND(i, rcon) \
+   roundKeys[i] = aesExpandStep(roundKeys[i - 1], _mm_aeskeygenassist_si128(roundKeys[i - 1], rcon))
+
+TNL_TARGET_AES static void aesNiSetup(const U8 key[CryptoBackend::AesKeySize], U8 *expandedKey)
+{
+   __m128i roundKeys[11];
+
+   roundKeys[0] = _mm_loadu_si128((const __m128i *) key);
+   AES_EXPAND(1,  0x01);
+   AES_EXPAND(2,  0x02);
+   AES_EXPAND(3,  0x04);
+   AES_EXPAND(4,  0x08);
+   AES_EXPAND(5,  0x10);
+   AES_EXPAND(6,  0x20);
+   AES_EXPAND(7,  0x40);
+   AES_EXPAND(8,  0x80);
+   AES_EXPAND(9,  0x1B);
+   AES_EXPAND(10, 0x36);
+
+   for(S32 i = 0; i < 11; i++)
+      _mm_storeu_si128((__m128i *) (expandedKey + i * CryptoBackend::AesBlockSize), roundKeys[i]);
+}
+
+#undef AES_EXPAND
+
+TNL_TARGET_AES static void aesNiEncryptBlock(const U8 *expandedKey, const U8 *in, U8 *out)
+{
+   const __m128i *roundKeys = (const __m128i *) expandedKey;
+
+   __m128i block = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), _mm_loadu_si128(roundKeys));
+
+   for(S32 i = 1; i < 10; i++)
+      block = _mm_aesenc_si128(block, _mm_loadu_si128(roundKeys + i));
+
+   block = _mm_aesenclast_si128(block, _mm_loadu_si128(roundKeys + 10));
+   _mm_storeu_si128((__m128i *) out, block);
+}
+
+
+static const U32 gSha256RoundConstants[64] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// Runs the SHA-256 compression function over len bytes, which must be a multiple of 64
+TNL_TARGET_SHA static void shaNiProcessBlocks(U32 state[8], const U8 *data, U32 len)
+{
+   const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+   // The SHA instructions want the state as ABEF and CDGH
+   __m128i tmp    = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[0]), 0xB1);   // CDAB
+   __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[4]), 0x1B);   // EFGH
+   __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);                                         // ABEF
+   state1 = _mm_blend_epi16(state1, tmp, 0xF0);                                              // CDGH
+
+   for(; len >= 64; len -= 64, data += 64)
+   {
+      __m128i abefSave = state0;
+      __m128i cdghSave = state1;
+      __m128i msg[4];
+
+      for(S32 i = 0; i < 4; i++)
+         msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + i * 16)), byteSwap);
+
+      // 16 groups of 4 rounds.  Each group also works on the message schedule for the groups to come.
+      for(S32 i = 0; i < 16; i++)
+      {
+         __m128i current = msg[i & 3];
+         __m128i roundInput = _mm_add_epi32(current, _mm_loadu_si128((const __m128i *) &gSha256RoundConstants[i * 4]));
+
+         state1 = _mm_sha256rnds2_epu32(state1, state0, roundInput);
+
+         if(i >= 3 && i < 15)
+         {
+            __m128i &next = msg[(i + 1) & 3];
+            next = _mm_add_epi32(next, _mm_alignr_epi8(current, msg[(i + 3) & 3], 4));
+            next = _mm_sha256msg2_epu32(next, current);
+         }
+
+         state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(roundInput, 0x0E));
+
+         if(i >= 1 && i < 13)
+            msg[(i + 3) & 3] = _mm_sha256msg1_epu32(msg[(i + 3) & 3], current);
+      }
+
+      state0 = _mm_add_epi32(state0, abefSave);
+      state1 = _mm_add_epi32(state1, cdghSave);
+   }
+
+   // Back to ABCD and EFGH
+   tmp    = _mm_shuffle_epi32(state0, 0x1B);     // FEBA
+   state1 = _mm_shuffle_epi32(state1, 0xB1);     // DCHG
+   state0 = _mm_blend_epi16(tmp, state1, 0xF0);  // DCBA
+   state1 = _mm_alignr_epi8(state1, tmp, 8);     // HGFE
+
+   _mm_storeu_si128((__m128i *) &state[0], state0);
+   _mm_storeu_si128((__m128i *) &state[4], state1);
+}
+
+
+class X86CryptoBackend : public CryptoBackend
+{
+   bool mHasAes;
+   bool mHasSha;
+   char mName[32];
+
+public:
+   X86CryptoBackend()
+   {
+      mHasAes = false;
+      mHasSha = false;
+
+      bool ssse3 = false, sse41 = false;
+
+#ifdef TNL_COMPILER_VISUALC
+      int regs[4];
+      __cpuid(regs, 0);
+      int maxLeaf = regs[0];
+
+      __cpuid(regs, 1);
+      ssse3   = (regs[2] & (1 << 9))  != 0;
+      sse41   = (regs[2] & (1 << 19)) != 0;
+      mHasAes = (regs[2] & (1 << 25)) != 0;
+
+      if(maxLeaf >= 7)
+      {
+         __cpuidex(regs, 7, 0);
+         mHasSha = (regs[1] & (1 << 29)) != 0;
+      }
+#else
+      unsigned int eax, ebx, ecx, edx;
+      unsigned int maxLeaf = __get_cpuid_max(0, NULL);
+
+      if(maxLeaf >= 1)
+      {
+         __cpuid(1, eax, ebx, ecx, edx);
+         ssse3   = (ecx & (1 << 9))  != 0;
+         sse41   = (ecx & (1 << 19)) != 0;
+         mHasAes = (ecx & (1 << 25)) != 0;
+      }
+
+      if(maxLeaf >= 7)
+      {
+         __cpuid_count(7, 0, eax, ebx, ecx, edx);
+         mHasSha = (ebx & (1 << 29)) != 0;
+      }
+#endif
+
+      mHasSha = mHasSha && ssse3 && sse41;
+
+      strcpy(mName, mHasAes ? (mHasSha ? "x86 AES-NI + SHA-NI" : "x86 AES-NI") : "x86 SHA-NI");
+   }
+
+   bool isSupported()
+   {
+      return mHasAes || mHasSha;
+   }
+
+   const char *getName()
+   {
+      return mName;
+   }
+
+   void aesSetup(const U8 key[AesKeySize], AesKey *expandedKey)
+   {
+      if(mHasAes)
+         aesNiSetup(key, expandedKey->roundKeys);
+      else
+         gTomCryptBackend.aesSetup(key, expandedKey);
+   }
+
+   void aesEncryptBlock(const AesKey *expandedKey, const U8 in[AesBlockSize], U8 out[AesBlockSize])
+   {
+      if(mHasAes)
+         aesNiEncryptBlock(expandedKey->roundKeys, in, out);
+      else
+         gTomCryptBackend.aesEncryptBlock(expandedKey, in, out);
+   }
+
+   void sha256(const U8 *data, U32 len, U8 hash[Sha256Size])
+   {
+      if(!mHasSha)
+      {
+         gTomCryptBackend.sha256(data, len, hash);
+         return;
+      }
+
+      U32 state[8] = {
+         0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+      };
+
+      U32 wholeBlocks = len & ~63;
+      shaNiProcessBlocks(state, data, wholeBlocks);
+
+      // Pad the rest: a 1 bit, zeros, then the length in bits, filling out one or two blocks
+      U8 tail[128];
+      U32 remaining = len - wholeBlocks;
+      U32 tailLen = remaining + 9 <= 64 ? 64 : 128;
+
+      memcpy(tail, data + wholeBlocks, remaining);
+      tail[remaining] = 0x80;
+      memset(tail + remaining + 1, 0, tailLen - remaining - 1);
+
+      U64 bitLen = U64(len) << 3;
+      for(S32 i = 0; i < 8; i++)
+         tail[tailLen - 1 - i] = U8(bitLen >> (i * 8));
+
+      shaNiProcessBlocks(state, tail, tailLen);
+
+      for(S32 i = 0; i < 8; i++)
+      {
+         hash[i * 4]     = U8(state[i] >> 24);
+         hash[i * 4 + 1] = U8(state[i] >> 16);
+         hash[i * 4 + 2] = U8(state[i] >> 8);
+         hash[i * 4 + 3] = U8(state[i]);
+      }
+   }
+};
+
+#endif   // TNL_HARDWARE_CRYPTO
+
+//------------------------------------------------------------------------------
+
+static CryptoBackend *gOverrideBackend = NULL;
+
+CryptoBackend *CryptoBackend::getPortable()
+{
+   return &gTomCryptBackend;
+}
+
+CryptoBackend *CryptoBackend::getHardware()
+{
+#ifdef TNL_HARDWARE_CRYPTO
+   static X86CryptoBackend hardwareBackend;
+
+   if(hardwareBackend.isSupported())
+      return &hardwareBackend;
+#endif
+
+   return NULL;
+}
+
+CryptoBackend *CryptoBackend::get()
+{
+   if(gOverrideBackend)
+      return gOverrideBackend;
+
+   static CryptoBackend *defaultBackend = getHardware() ? getHardware() : getPortable();
+   return defaultBackend;
+}
+
+void CryptoBackend::set(CryptoBackend *backend)
+{
+   gOverrideBackend = backend;
+}
+
+};
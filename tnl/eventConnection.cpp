@@ -29,6 +29,7 @@
 #include "tnlBitStream.h"
 #include "tnlLog.h"
 #include "tnlNetInterface.h"
+#include "tnlPlatform.h"
 
 namespace TNL {
 
@@ -314,7 +315,10 @@ void EventConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
       S32 classId = ev->mEvent->getClassId(getNetClassGroup());
       bstream->writeInt(classId, mEventClassBitSize);
 
+      S64 packStart = Platform::getHighPrecisionTimerValue();
       ev->mEvent->pack(this, bstream);
+      S64 packTime = Platform::getHighPrecisionTimerValue() - packStart;
+      U32 eventBits = bstream->getBitPosition() - start;
       logprintf(LogConsumer::LogEventConnection, "EventConnection %s: WroteEvent %s - %d bits", getNetAddressString(), ev->mEvent->getDebugName(), bstream->getBitPosition() - start);
 
       if(mConnectionParameters.mDebugObjectSizes)
@@ -346,6 +350,7 @@ void EventConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
          }
       }
       have_something_to_send = true;
+      ev->mEvent->getClassRep()->addInitialUpdate(eventBits, packTime);
 
       // dequeue the event and add this event onto the packet queue
       mUnorderedSendEventQueueHead = ev->mNextEvent;
@@ -388,9 +393,12 @@ void EventConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
 
       S32 classId = ev->mEvent->getClassId(getNetClassGroup());
       bstream->writeInt(classId, mEventClassBitSize);
+
+      S64 packStart = Platform::getHighPrecisionTimerValue();
       ev->mEvent->pack(this, bstream);
+      S64 packTime = Platform::getHighPrecisionTimerValue() - packStart;
+      U32 eventBits = bstream->getBitPosition() - start;
 
-      ev->mEvent->getClassRep()->addInitialUpdate(bstream->getBitPosition() - start);
       logprintf(LogConsumer::LogEventConnection, "EventConnection %s: WroteEvent %s - %d bits", getNetAddressString(), ev->mEvent->getDebugName(), bstream->getBitPosition() - start);
 
       if(mConnectionParameters.mDebugObjectSizes)
@@ -425,6 +433,7 @@ void EventConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
          }
       }
       have_something_to_send = true;
+      ev->mEvent->getClassRep()->addInitialUpdate(eventBits, packTime);
 
       // dequeue the event:
       mSendEventQueueHead = ev->mNextEvent;      
@@ -600,6 +609,19 @@ bool EventConnection::postNetEvent(NetEvent *theEvent)
    return true;
 }
 
+S32 EventConnection::postNetEventToAll(NetEvent *theEvent, const Vector<EventConnection *> &connections)
+{
+   // Hold a reference for the duration, otherwise a rejected post on the first connection would delete the event
+   RefPtr<NetEvent> eventRef = theEvent;
+   S32 posted = 0;
+
+   for(S32 i = 0; i < connections.size(); i++)
+      if(connections[i]->canPostNetEvent() && connections[i]->postNetEvent(theEvent))
+         posted++;
+
+   return posted;
+}
+
 bool EventConnection::isDataToTransmit()
 {
    return mUnorderedSendEventQueueHead || mSendEventQueueHead || Parent::isDataToTransmit();
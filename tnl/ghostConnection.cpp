@@ -30,6 +30,7 @@
 #include "tnlNetBase.h"
 #include "tnlNetObject.h"
 #include "tnlNetInterface.h"
+#include "tnlPlatform.h"
 
 namespace TNL {
 
@@ -45,6 +46,11 @@ GhostConnection::GhostConnection()
 
    mGhostFrom = false;
    mGhostTo = false;
+
+   mGhostDeltaCompression = false;
+   mPackingGhost = NULL;
+   mHasPendingDelta = false;
+   mUnpackingGhostIndex = -1;
 }
 
 GhostConnection::~GhostConnection()
@@ -55,6 +61,9 @@ GhostConnection::~GhostConnection()
    clearGhostInfo();
    deleteLocalGhosts();
    delete[] mGhostLookupTable;
+
+   for(S32 i = 0; i < mReceivedDeltas.size(); i++)
+      delete[] mReceivedDeltas[i];
 }
 
 void GhostConnection::setGhostTo(bool ghostTo)
@@ -165,6 +174,17 @@ void GhostConnection::packetReceived(PacketNotify *pnotify)
 
       GhostRef *temp = packRef->nextRef;      
 
+      // The remote host now has these values, so later updates can be deltas against them
+      if(packRef->hasDeltaSnapshot)
+      {
+         GhostInfo *ghost = packRef->ghost;
+         if(!ghost->hasDeltaBaseline || S32(packRef->deltaSnapshot.id - ghost->deltaBaseline.id) > 0)
+         {
+            ghost->deltaBaseline = packRef->deltaSnapshot;
+            ghost->hasDeltaBaseline = true;
+         }
+      }
+
       // If this object was ghosting, it is now ghosted...
       if(packRef->ghostInfoFlags & GhostInfo::Ghosting)
       {
@@ -198,7 +218,7 @@ void GhostConnection::prepareWritePacket()
    if(!doesGhostFrom() && !mGhosting)
       return;
 
-   if(mGhostFreeIndex > MaxGhostCount - 10)  // almost running out of GhostFreeIndex, free some objects not in scope.
+   if(isGhostSpaceLow())  // almost running out of GhostFreeIndex, free some objects not in scope.
    {
       for(S32 i = mGhostZeroUpdateIndex; i < mGhostFreeIndex; i++)
       {
@@ -237,6 +257,12 @@ void GhostConnection::prepareWritePacket()
       mScopeObject->performScopeQuery(this);
 }
 
+NetObject *GhostConnection::getUpdatingGhost(S32 index)
+{
+   TNLAssert(index >= 0 && index < mGhostZeroUpdateIndex, "Ghost index out of range!");
+   return mGhostArray[index]->obj;
+}
+
 bool GhostConnection::isDataToTransmit()
 {
    // Once we've run the scope query - if there are no objects that need to be updated,
@@ -332,6 +358,11 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
       U32 retMask = 0;
       ConnectionStringTable::PacketEntry *strEntry = getCurrentWritePacketNotify()->stringList.stringTail;;
 
+      bool packed = false;          // For bit usage stats, recorded once we know the update fits
+      bool initialUpdate = false;
+      U32 updateBits = 0;
+      S64 packTime = 0;
+
       bstream->writeFlag(true);
       if(!BitSizeWritten)
       {
@@ -356,15 +387,17 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
             NetObject::mIsInitialUpdate = true;
          }
          // update the object
+         mPackingGhost = walk;
+         mHasPendingDelta = false;
+         S64 packStart = Platform::getHighPrecisionTimerValue();
          retMask = walk->obj->packUpdate(this, updateMask, bstream);
+         packTime = Platform::getHighPrecisionTimerValue() - packStart;
+         mPackingGhost = NULL;
 
-         if(NetObject::mIsInitialUpdate)
-         {
-            NetObject::mIsInitialUpdate = false;
-            walk->obj->getClassRep()->addInitialUpdate(bstream->getBitPosition() - startPos);
-         }
-         else
-            walk->obj->getClassRep()->addPartialUpdate(bstream->getBitPosition() - startPos);
+         packed = true;
+         initialUpdate = NetObject::mIsInitialUpdate;
+         updateBits = bstream->getBitPosition() - startPos;
+         NetObject::mIsInitialUpdate = false;
 
          if(mConnectionParameters.mDebugObjectSizes)
             bstream->writeIntAt(bstream->getBitPosition(), BitStreamPosBitSize, startPos - BitStreamPosBitSize);
@@ -389,6 +422,14 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
       }
       have_something_to_send = true;
 
+      if(packed)
+      {
+         if(initialUpdate)
+            walk->obj->getClassRep()->addInitialUpdate(updateBits, packTime);
+         else
+            walk->obj->getClassRep()->addPartialUpdate(updateBits, packTime);
+      }
+
       // otherwise, create a record of this ghost update and
       // attach it to the packet.
       GhostRef *upd = new GhostRef;
@@ -403,6 +444,7 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
       upd->ghost = walk;
       upd->ghostInfoFlags = 0;
       upd->updateChain = NULL;
+      upd->hasDeltaSnapshot = false;
 
       if(walk->flags & GhostInfo::KillGhost)
       {
@@ -421,6 +463,13 @@ void GhostConnection::writePacket(BitStream *bstream, PacketNotify *pnotify)
             walk->flags |= GhostInfo::Ghosting;
             upd->ghostInfoFlags = GhostInfo::Ghosting;
          }
+         if(mHasPendingDelta)
+         {
+            upd->hasDeltaSnapshot = true;
+            upd->deltaSnapshot = mPendingDelta;
+            walk->deltaSequence = mPendingDelta.id + 1;
+            mHasPendingDelta = false;
+         }
          walk->updateMask = retMask;
          if(!retMask)
             ghostPushToZero(walk);
@@ -469,6 +518,7 @@ void GhostConnection::readPacket(BitStream *bstream)
             mLocalGhosts[index]->onGhostRemove();
             mLocalGhosts[index]->decRef();  // This deletes the object if needed
             mLocalGhosts[index] = NULL;
+            clearReceivedDeltas(index);
          }
       }
       else
@@ -506,9 +556,12 @@ void GhostConnection::readPacket(BitStream *bstream)
 
             obj->onGhostAddBeforeUpdate(this);
 
+            clearReceivedDeltas(index);
+            mUnpackingGhostIndex = index;
             NetObject::mIsInitialUpdate = true;
             mLocalGhosts[index]->unpackUpdate(this, bstream);
             NetObject::mIsInitialUpdate = false;
+            mUnpackingGhostIndex = -1;
             
             if(!obj->onGhostAdd(this))    // Runs addToGame() on some objects
             {
@@ -524,7 +577,9 @@ void GhostConnection::readPacket(BitStream *bstream)
          }
          else
          {
+            mUnpackingGhostIndex = index;
             mLocalGhosts[index]->unpackUpdate(this, bstream);
+            mUnpackingGhostIndex = -1;
          }
 
          if(mConnectionParameters.mDebugObjectSizes)
@@ -543,6 +598,124 @@ void GhostConnection::readPacket(BitStream *bstream)
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+
+// Deltas are sent in one of four sizes, with a single bit for no change
+static const U8 DeltaValueBitSizes[] = { 5, 9, 14, 32 };
+
+static void writeDeltaValue(BitStream *stream, S32 delta)
+{
+   if(stream->writeFlag(delta == 0))
+      return;
+
+   U32 size = 0;
+   while(size < ARRAYSIZE(DeltaValueBitSizes) - 1)
+   {
+      S32 limit = 1 << (DeltaValueBitSizes[size] - 1);
+      if(delta >= -limit && delta < limit)
+         break;
+      size++;
+   }
+
+   stream->writeInt(size, 2);
+   stream->writeSignedInt(delta, DeltaValueBitSizes[size]);
+}
+
+static S32 readDeltaValue(BitStream *stream)
+{
+   if(stream->readFlag())
+      return 0;
+
+   return stream->readSignedInt(DeltaValueBitSizes[stream->readInt(2)]);
+}
+
+void GhostConnection::writeGhostDelta(BitStream *stream, const S32 *values, U32 count)
+{
+   TNLAssert(mPackingGhost, "writeGhostDelta can only be called from packUpdate.");
+   TNLAssert(!mHasPendingDelta, "Only one set of delta values per update.");
+   TNLAssert(count <= MaxDeltaValues, "Too many delta values.");
+
+   GhostInfo *ghost = mPackingGhost;
+
+   mPendingDelta.id = ghost->deltaSequence;
+   for(U32 i = 0; i < count; i++)
+      mPendingDelta.values[i] = values[i];
+   mHasPendingDelta = true;
+
+   stream->writeInt(mPendingDelta.id & DeltaHistoryMask, DeltaIdBitSize);
+
+   // Only use a baseline the remote host is sure to still have in its history.  If more than a
+   // history's worth of updates have been lost since the last ack, send the values whole.
+   const S32 *baseline = NULL;
+   if(stream->writeFlag(ghost->hasDeltaBaseline && !(ghost->flags & GhostInfo::NotYetGhosted) &&
+                        mPendingDelta.id - ghost->deltaBaseline.id < DeltaHistorySize))
+   {
+      stream->writeInt(ghost->deltaBaseline.id & DeltaHistoryMask, DeltaIdBitSize);
+      baseline = ghost->deltaBaseline.values;
+   }
+
+   // Unsigned math so the deltas wrap instead of overflowing; both sides wrap the same way
+   for(U32 i = 0; i < count; i++)
+      writeDeltaValue(stream, S32(U32(values[i]) - (baseline ? U32(baseline[i]) : 0)));
+}
+
+void GhostConnection::readGhostDelta(BitStream *stream, S32 *values, U32 count)
+{
+   TNLAssert(count <= MaxDeltaValues, "Too many delta values.");
+
+   for(U32 i = 0; i < count; i++)
+      values[i] = 0;
+
+   if(mUnpackingGhostIndex < 0 || count > MaxDeltaValues)
+   {
+      setLastError("Invalid packet.");
+      return;
+   }
+
+   while(mReceivedDeltas.size() <= mUnpackingGhostIndex)
+      mReceivedDeltas.push_back(NULL);
+
+   DeltaSnapshot *history = mReceivedDeltas[mUnpackingGhostIndex];
+   if(!history)
+   {
+      history = new DeltaSnapshot[DeltaHistorySize];
+      for(S32 i = 0; i < DeltaHistorySize; i++)
+         history[i].id = U32_MAX;
+      mReceivedDeltas[mUnpackingGhostIndex] = history;
+   }
+
+   U32 id = stream->readInt(DeltaIdBitSize);
+
+   const DeltaSnapshot *baseline = NULL;
+   if(stream->readFlag())
+   {
+      U32 baselineId = stream->readInt(DeltaIdBitSize);
+      baseline = &history[baselineId];
+
+      if(baseline->id != baselineId)
+      {
+         setLastError("Invalid packet.");
+         return;
+      }
+   }
+
+   for(U32 i = 0; i < count; i++)
+      values[i] = S32((baseline ? U32(baseline->values[i]) : 0) + U32(readDeltaValue(stream)));
+
+   history[id].id = id;
+   for(U32 i = 0; i < count; i++)
+      history[id].values[i] = values[i];
+}
+
+void GhostConnection::clearReceivedDeltas(S32 index)
+{
+   if(index >= mReceivedDeltas.size())
+      return;
+
+   delete[] mReceivedDeltas[index];
+   mReceivedDeltas[index] = NULL;
+}
+
 //-----------------------------------------------------------------------------
 
 void GhostConnection::setScopeObject(NetObject *obj)
@@ -693,6 +866,7 @@ void GhostConnection::objectInScope(NetObject *obj)
       info->index = i;
       info->arrayIndex = i;
       info->updateMask = 0;
+      info->deltaSequence = 0;
    }
 
    GhostInfo *giptr = mGhostArray[mGhostFreeIndex];
@@ -705,6 +879,7 @@ void GhostConnection::objectInScope(NetObject *obj)
    giptr->obj = obj;
    giptr->lastUpdateChain = NULL;
    giptr->updateSkipCount = 0;
+   giptr->hasDeltaBaseline = false;
 
    giptr->connection = this;
 
@@ -795,6 +970,9 @@ void GhostConnection::deleteLocalGhosts()
          mLocalGhosts[i] = NULL;
       }
    }
+
+   for(S32 i = 0; i < mReceivedDeltas.size(); i++)
+      clearReceivedDeltas(i);
 }
 
 void GhostConnection::clearGhostInfo()
@@ -46,12 +46,31 @@ namespace HuffmanStringProcessor {
 
       U8  numBits;
       U8  symbol;
-      U32 code;   // no code should be longer than 32 bits.
+      U32 code;   // no code should be longer than 32 bits.  First bit is the lowest.
    };
 
    Vector<HuffNode> mHuffNodes;
    Vector<HuffLeaf> mHuffLeaves;
 
+   // Decoding looks up the next LookupBits bits of the stream in mDecodeTable, rather than walking the tree one
+   // bit at a time.  Most characters in chat have codes shorter than that, so one probe usually decodes one
+   // character; the rest pick up the tree walk from the node the probe got to.
+   enum {
+      LookupBits = 10,
+      LookupSize = 1 << LookupBits,
+      MaxBatchBits = 57,      // Most bits we can write at once -- see BitStream::MaxWordBits
+   };
+
+   struct DecodeEntry {
+      U8  numBits;            // Length of the code found, or 0 if the code is longer than LookupBits
+      U8  symbol;
+      S16 node;               // If numBits is 0, where we are in the tree after LookupBits bits
+   };
+
+   DecodeEntry mDecodeTable[LookupSize];
+
+   void buildDecodeTable();
+
    void buildTables();
 
    // We have to be a bit careful with these, since they are pointers...
@@ -153,6 +172,32 @@ void HuffmanStringProcessor::buildTables()
    BitStream bs((U8 *) &code, 4);
 
    generateCodes(bs, 0, 0);
+
+   buildDecodeTable();
+}
+
+void HuffmanStringProcessor::buildDecodeTable()
+{
+   // Stream bits come out least significant first, in the same order as the bits in a leaf's code, so entry i
+   // is what we get by walking the tree with the bits of i, starting from the bottom
+   for (U32 i = 0; i < LookupSize; i++) {
+      S32 index = 0;
+      U32 bits;
+
+      for (bits = 0; bits < LookupBits && index >= 0; bits++)
+         index = (i & (1 << bits)) ? mHuffNodes[index].index1 : mHuffNodes[index].index0;
+
+      DecodeEntry& rEntry = mDecodeTable[i];
+      if (index < 0) {
+         rEntry.numBits = U8(bits);
+         rEntry.symbol  = mHuffLeaves[-(index + 1)].symbol;
+         rEntry.node    = 0;
+      } else {
+         rEntry.numBits = 0;
+         rEntry.symbol  = 0;
+         rEntry.node    = S16(index);
+      }
+   }
 }
 
 void HuffmanStringProcessor::generateCodes(BitStream& rBS, S32 index, S32 depth)
@@ -163,6 +208,11 @@ void HuffmanStringProcessor::generateCodes(BitStream& rBS, S32 index, S32 depth)
 
       memcpy(&rLeaf.code, rBS.getBuffer(), sizeof(rLeaf.code));
       rLeaf.numBits = depth;
+
+      // Keep the code as a number, first bit lowest, without the bits left over from deeper branches
+      rLeaf.code = convertLEndianToHost(rLeaf.code);
+      if (depth < 32)
+         rLeaf.code &= (1 << depth) - 1;
    } else {
       HuffNode& rNode = mHuffNodes[index];
 
@@ -201,6 +251,21 @@ bool HuffmanStringProcessor::readHuffBuffer(BitStream* pStream, char* out_pBuffe
       U32 len = pStream->readInt(8);
       for (U32 i = 0; i < len; i++) {
          S32 index = 0;
+
+         // Peek at the next LookupBits bits, and give back the ones the code didn't use.  Too close to the end
+         // of the stream to peek, we just walk the tree.
+         if (pStream->getBitPosition() + LookupBits <= pStream->getMaxReadBitPosition()) {
+            U32 pos = pStream->getBitPosition();
+            const DecodeEntry& rEntry = mDecodeTable[pStream->readInt(LookupBits)];
+
+            if (rEntry.numBits) {
+               out_pBuffer[i] = rEntry.symbol;
+               pStream->setBitPosition(pos + rEntry.numBits);
+               continue;
+            }
+            index = rEntry.node;
+         }
+
          while (true) {
             if (index >= 0) {
                if (pStream->readFlag() == true) {
@@ -253,10 +318,26 @@ bool HuffmanStringProcessor::writeHuffBuffer(BitStream* pStream, const char* out
    } else {
       pStream->writeFlag(true);
       pStream->writeInt(len, 8);
+
+      // Pack codes into a word and write them out together, rather than one writeBits per character
+      U64 batch = 0;
+      U32 batchBits = 0;
+
       for (i = 0; i < len; i++) {
          HuffLeaf& rLeaf = mHuffLeaves[((unsigned char)out_pBuffer[i])];
-         pStream->writeBits(rLeaf.numBits, &rLeaf.code);
+
+         if (batchBits + rLeaf.numBits > MaxBatchBits) {
+            pStream->writeInt64(batch, U8(batchBits));
+            batch = 0;
+            batchBits = 0;
+         }
+
+         batch |= U64(rLeaf.code) << batchBits;
+         batchBits += rLeaf.numBits;
       }
+
+      if (batchBits)
+         pStream->writeInt64(batch, U8(batchBits));
    }
 
    return true;
@@ -47,6 +47,7 @@ NetClassRep::NetClassRep()
    mInitialUpdateBitsUsed = 0;
    mPartialUpdateCount = 0;
    mPartialUpdateBitsUsed = 0;
+   mPackTime = 0;
 }
 
 Object* NetClassRep::create(const char* className)
@@ -149,7 +150,7 @@ void NetClassRep::logBitUsage()
    {
       if(walk->mInitialUpdateCount)
       {
-         logprintf(LogConsumer::LogNetBase, "%s (Initialized) - Count: %d   Total: %d   Avg Size: %g", 
+         logprintf(LogConsumer::LogNetBase, "%s (Initialized) - Count: %llu   Total: %llu   Avg Size: %g", 
                walk->mClassName, walk->mInitialUpdateCount, walk->mInitialUpdateBitsUsed, 
                walk->mInitialUpdateBitsUsed / F32(walk->mInitialUpdateCount));
          atLeastOne = true;
@@ -157,7 +158,7 @@ void NetClassRep::logBitUsage()
 
       if(walk->mPartialUpdateCount)
       {
-         logprintf(LogConsumer::LogNetBase, "%s (Updated) - Count: %d   Total: %d   Avg Size: %g", 
+         logprintf(LogConsumer::LogNetBase, "%s (Updated) - Count: %llu   Total: %llu   Avg Size: %g", 
                walk->mClassName, walk->mPartialUpdateCount, walk->mPartialUpdateBitsUsed, 
                walk->mPartialUpdateBitsUsed / F32(walk->mPartialUpdateCount));
          atLeastOne = true;
@@ -169,6 +170,19 @@ void NetClassRep::logBitUsage()
 }
 
 
+void NetClassRep::resetBitUsage()
+{
+   for(NetClassRep *walk = mClassLinkList; walk; walk = walk->mNextClass)
+   {
+      walk->mInitialUpdateCount = 0;
+      walk->mInitialUpdateBitsUsed = 0;
+      walk->mPartialUpdateCount = 0;
+      walk->mPartialUpdateBitsUsed = 0;
+      walk->mPackTime = 0;
+   }
+}
+
+
 
 
 SafePtrData::~SafePtrData()
@@ -33,10 +33,179 @@
 #include "tnlNetObject.h"
 #include "tnlClientPuzzle.h"
 #include "tnlCertificate.h"
+#include "tnlThread.h"
 #include <tomcrypt.h>
 
+#include <string.h>
+
 namespace TNL {
 
+//-----------------------------------------------------------------------------
+// HandshakeQueue
+//-----------------------------------------------------------------------------
+
+/// Worker threads for checking incoming connect requests.  The main thread reads the unencrypted
+/// header of a request and queues a copy of the packet; a worker checks the puzzle solution and does
+/// the key exchange, and then the main thread creates the connection from where the worker left off.
+class HandshakeQueue : public ThreadQueue
+{
+public:
+   struct Job
+   {
+      U32 id;
+      Address address;
+      ConnectionParameters params;
+      RefPtr<AsymmetricKey> privateKey;   // Only touched on the main thread; RefPtr counting isn't thread safe
+      AsymmetricKey *privateKeyPtr;       // What the worker uses
+      bool puzzleValid;
+      bool keyValid;
+      F64 checkTime;                      // Milliseconds the worker spent on the request
+      U8 data[MaxPacketDataSize];
+      BitStream stream;
+
+      Job(const Address &theAddress, BitStream *packet) : address(theAddress), stream(data, packet->getBufferSize())
+      {
+         id = 0;
+         privateKeyPtr = NULL;
+         puzzleValid = false;
+         keyValid = false;
+         checkTime = 0;
+         memcpy(data, packet->getBuffer(), packet->getBufferSize());
+         stream.setBitPosition(packet->getBitPosition());
+      }
+   };
+
+private:
+   NetInterface *mInterface;
+   Vector<Job *> mJobs;    // Guarded by lock()
+   U32 mNextJobId;
+
+   Job *findJob(U32 id)
+   {
+      Job *job = NULL;
+
+      lock();
+      for(S32 i = 0; i < mJobs.size(); i++)
+         if(mJobs[i]->id == id)
+         {
+            job = mJobs[i];
+            break;
+         }
+      unlock();
+
+      return job;
+   }
+
+public:
+   HandshakeQueue(NetInterface *theInterface, U32 threadCount) : ThreadQueue(threadCount)
+   {
+      mInterface = theInterface;
+      mNextJobId = 0;
+   }
+
+   ~HandshakeQueue()
+   {
+      shutdown();
+
+      for(S32 i = 0; i < mJobs.size(); i++)
+         delete mJobs[i];
+   }
+
+   U32 getPendingCount()
+   {
+      lock();
+      U32 count = mJobs.size();
+      unlock();
+
+      return count;
+   }
+
+   /// Clients resend their connect request until they hear back, so we'll see copies of a
+   /// request that's still being checked
+   bool isPending(const Address &address, const Nonce &nonce)
+   {
+      bool found = false;
+
+      lock();
+      for(S32 i = 0; i < mJobs.size(); i++)
+         if(mJobs[i]->params.mNonce == nonce && mJobs[i]->address == address)
+         {
+            found = true;
+            break;
+         }
+      unlock();
+
+      return found;
+   }
+
+   void submit(Job *job)
+   {
+      lock();
+      job->id = ++mNextJobId;
+      mJobs.push_back(job);
+      unlock();
+
+      checkRequest(job->id);
+   }
+
+   TNL_DECLARE_THREADQ_METHOD(checkRequest, (U32 jobId));
+   TNL_DECLARE_THREADQ_METHOD(requestChecked, (U32 jobId));
+};
+
+// Runs on a worker thread
+TNL_IMPLEMENT_THREADQ_METHOD(HandshakeQueue, checkRequest, (U32 jobId), (jobId))
+{
+   Job *job = findJob(jobId);
+   if(!job)
+      return;
+
+   ConnectionParameters &theParams = job->params;
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   job->puzzleValid = ClientPuzzleManager::checkOneSolution(theParams.mPuzzleSolution, theParams.mNonce,
+         theParams.mServerNonce, theParams.mPuzzleDifficulty, theParams.mClientIdentity);
+
+   if(job->puzzleValid)
+      job->keyValid = NetInterface::readConnectRequestKey(theParams, job->privateKeyPtr, &job->stream);
+
+   job->checkTime = Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime);
+
+   requestChecked(jobId);
+}
+
+// Runs on the main thread, from NetInterface::processConnections
+TNL_IMPLEMENT_THREADQ_METHOD(HandshakeQueue, requestChecked, (U32 jobId), (jobId))
+{
+   Job *job = findJob(jobId);
+   if(!job)
+      return;
+
+   lock();
+   mJobs.erase(mJobs.getIndex(job));
+   unlock();
+
+   ConnectionParameters &theParams = job->params;
+
+   mInterface->mPuzzleManager.recordHandshakeTime(job->checkTime);
+
+   if(!job->puzzleValid ||
+      mInterface->mPuzzleManager.recordSolution(theParams.mNonce, theParams.mServerNonce) != ClientPuzzleManager::Success)
+      mInterface->sendConnectReject(&theParams, job->address, NetConnection::ReasonPuzzle);
+
+   else if(job->keyValid && mInterface->doesAllowConnections())
+   {
+      if(theParams.mUsingCrypto)
+      {
+         theParams.mPrivateKey = job->privateKey;
+         Random::read(theParams.mInitVector, SymmetricCipher::KeySize);
+      }
+
+      mInterface->finishConnectRequest(job->address, theParams, &job->stream);
+   }
+
+   delete job;
+}
+
 //-----------------------------------------------------------------------------
 // NetInterface initialization/destruction
 //-----------------------------------------------------------------------------
@@ -56,10 +225,14 @@ NetInterface::NetInterface(const Address &bindAddress) : mSocket(bindAddress)
       mConnectionHashTable[i] = NULL;
    mSendPacketList = NULL;
    mCurrentTime = Platform::getRealMilliseconds();
+   mHandshakeQueue = NULL;
 }
 
 NetInterface::~NetInterface()
 {
+   // Stop the handshake threads before anything they might be using goes away
+   delete mHandshakeQueue;
+
    // gracefully close all the connections on this NetInterface:
    while(mConnectionList.size())
    {
@@ -75,6 +248,23 @@ NetInterface::~NetInterface()
    }
 }
 
+void NetInterface::setHandshakeThreadCount(U32 threadCount)
+{
+   // Any requests being checked are dropped; clients will resend them
+   delete mHandshakeQueue;
+   mHandshakeQueue = NULL;
+
+#ifndef TNL_NO_THREADS
+   if(threadCount > 0)
+      mHandshakeQueue = new HandshakeQueue(this, threadCount);
+#endif
+}
+
+U32 NetInterface::getPendingHandshakeCount()
+{
+   return mHandshakeQueue ? mHandshakeQueue->getPendingCount() : 0;
+}
+
 Address NetInterface::getFirstBoundInterfaceAddress()
 {
    Address theAddress = mSocket.getBoundAddress();
@@ -326,6 +516,10 @@ void NetInterface::processConnections()
    mCurrentTime = Platform::getRealMilliseconds();
    mPuzzleManager.tick(mCurrentTime);
 
+   // Create connections for any connect requests the handshake threads have finished with
+   if(mHandshakeQueue)
+      mHandshakeQueue->dispatchResponseCalls();
+
    // first see if there are any delayed packets that need to be sent...
    while(mSendPacketList && S32(mSendPacketList->sendTime - getCurrentTime()) < 0)
    {
@@ -564,6 +758,8 @@ void NetInterface::handleConnectChallengeRequest(const Address &addr, BitStream
    if(!mAllowConnections)
       return;
 
+   mPuzzleManager.recordChallengeRequest();
+
    Nonce clientNonce;
    clientNonce.read(stream);
    bool wantsKeyExchange = stream->readFlag();
@@ -767,46 +963,94 @@ void NetInterface::handleConnectRequest(const Address &address, BitStream *strea
       }
    }
 
+   if(mHandshakeQueue)
+   {
+      // Leave the puzzle solution and key exchange to the handshake threads
+      if(mHandshakeQueue->isPending(address, theParams.mNonce) || mHandshakeQueue->getPendingCount() >= MaxPendingHandshakes)
+         return;
+
+      ClientPuzzleManager::ErrorCode result = mPuzzleManager.checkParameters(
+         theParams.mNonce, theParams.mServerNonce, theParams.mPuzzleDifficulty);
+
+      if(result != ClientPuzzleManager::Success)
+      {
+         sendConnectReject(&theParams, address, NetConnection::ReasonPuzzle);
+         return;
+      }
+
+      HandshakeQueue::Job *job = new HandshakeQueue::Job(address, stream);
+      job->params = theParams;
+      job->privateKey = mPrivateKey;
+      job->privateKeyPtr = mPrivateKey;
+
+      mHandshakeQueue->submit(job);
+      return;
+   }
+
+   S64 startTime = Platform::getHighPrecisionTimerValue();
+
    // Check the puzzle solution
    ClientPuzzleManager::ErrorCode result = mPuzzleManager.checkSolution(
       theParams.mPuzzleSolution, theParams.mNonce, theParams.mServerNonce,
       theParams.mPuzzleDifficulty, theParams.mClientIdentity);
 
+   bool keyValid = result == ClientPuzzleManager::Success && readConnectRequestKey(theParams, mPrivateKey, stream);
+
+   mPuzzleManager.recordHandshakeTime(Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime));
+
    if(result != ClientPuzzleManager::Success)      // Wrong answer!
    {
       sendConnectReject(&theParams, address, NetConnection::ReasonPuzzle);
       return;
    }
 
+   if(!keyValid)
+      return;
+
+   if(theParams.mUsingCrypto)
+   {
+      theParams.mPrivateKey = mPrivateKey;
+      Random::read(theParams.mInitVector, SymmetricCipher::KeySize);
+   }
+
+   finishConnectRequest(address, theParams, stream);
+}
+
+bool NetInterface::readConnectRequestKey(ConnectionParameters &theParams, AsymmetricKey *privateKey, BitStream *stream)
+{
    if(stream->readFlag())
    {
-      if(mPrivateKey.isNull())
-         return;
+      if(!privateKey)
+         return false;
 
       theParams.mUsingCrypto = true;
       theParams.mPublicKey = new AsymmetricKey(stream);
-      theParams.mPrivateKey = mPrivateKey;
 
       U32 decryptPos = stream->getBytePosition();
 
       stream->setBytePosition(decryptPos);
-      theParams.mSharedSecret = theParams.mPrivateKey->computeSharedSecretKey(theParams.mPublicKey);
+      theParams.mSharedSecret = privateKey->computeSharedSecretKey(theParams.mPublicKey);
 
       SymmetricCipher theCipher(theParams.mSharedSecret);
 
       if(!stream->decryptAndCheckHash(NetConnection::MessageSignatureBytes, decryptPos, &theCipher))
-         return;
+         return false;
 
       // Read the first part of the connection's symmetric key
       stream->read(SymmetricCipher::KeySize, theParams.mSymmetricKey);
-      Random::read(theParams.mInitVector, SymmetricCipher::KeySize);
    }
 
+   return true;
+}
+
+void NetInterface::finishConnectRequest(const Address &address, ConnectionParameters &theParams, BitStream *stream)
+{
    U32 connectSequence;
    theParams.mDebugObjectSizes = stream->readFlag();
    stream->read(&connectSequence);
    logprintf(LogConsumer::LogNetInterface, "Received Connect Request %8x", theParams.mClientIdentity);
 
+   NetConnection *connect = findConnection(address);
    if(connect)
       disconnect(connect, NetConnection::ReasonSelfDisconnect, "NewConnection");
 
@@ -170,6 +170,10 @@ void Platform::sleep(U32 msCount)
    // no need to sleep on the xbox...
 }
 
+void Platform::sleepMicroseconds(U32 usCount)
+{
+}
+
 #elif defined (TNL_OS_WIN32)
 
 bool Platform::checkHeap()
@@ -307,6 +311,12 @@ void Platform::sleep(U32 msCount)
    Sleep(msCount);
 }
 
+// Sleep() only counts in whole ms, so round down; the caller can wait out the remainder
+void Platform::sleepMicroseconds(U32 usCount)
+{
+   Sleep(usCount / 1000);
+}
+
 //--------------------------------------
 void Platform::AlertOK(const char *windowTitle, const char *message)
 {
@@ -420,13 +430,16 @@ class UnixTimer
       UnixTimer()
       {
       }
+      // In microseconds; x86UNIXGetTickCount only has millisecond resolution
       S64 getCurrentTime()
       {
-         return x86UNIXGetTickCount();
+         timeval t;
+         ::gettimeofday(&t, NULL);
+         return S64(t.tv_sec) * 1000000 + t.tv_usec;
       }
       F64 convertToMS(S64 delta)
       {
-         return F64(delta);
+         return F64(delta) * 0.001;
       }
 };
 
@@ -447,6 +460,11 @@ void Platform::sleep(U32 msCount)
    usleep(msCount * 1000);
 }
 
+void Platform::sleepMicroseconds(U32 usCount)
+{
+   usleep(usCount);
+}
+
 //--------------------------------------
 void Platform::AlertOK(const char *windowTitle, const char *message)
 {
@@ -68,6 +68,18 @@ void addEntropy(const U8 *randomData, U32 dataLen)
    }
 }
 
+void setSeed(U32 seed)
+{
+   U8 seedData[4] = { U8(seed >> 24), U8(seed >> 16), U8(seed >> 8), U8(seed) };
+
+   yarrow_start(&prng);
+   yarrow_add_entropy(seedData, sizeof(seedData), &prng);
+   yarrow_ready(&prng);
+
+   initialized = true;
+   entropyAdded = 0;
+}
+
 void read(U8 *outBuffer, U32 randomLen)
 {
    if(!initialized)
@@ -36,11 +36,50 @@ namespace TNL {
 RPCEvent::RPCEvent(RPCGuaranteeType gType, RPCDirection dir) :
       NetEvent((NetEvent::GuaranteeType) gType, (NetEvent::EventDirection) dir)
 {
+   mMarshaledArgs = NULL;
+   mMarshaledBitCount = 0;
+   mShareMarshaledArgs = false;
+}
+
+RPCEvent::~RPCEvent()
+{
+   delete mMarshaledArgs;
+}
+
+NetEvent *RPCEvent::makeBroadcast(NetEvent *theEvent)
+{
+   RPCEvent *rpcEvent = dynamic_cast<RPCEvent *>(theEvent);
+   TNLAssert(rpcEvent, "Only RPC events can be broadcast!");
+
+   if(rpcEvent)
+      rpcEvent->mShareMarshaledArgs = true;
+
+   return theEvent;
 }
 
 void RPCEvent::pack(EventConnection *ps, BitStream *bstream)
 {
-   mFunctor->write(*bstream);
+   // StringTableEntries written through a connection's string table depend on that
+   // connection's state, so those streams always get their own copy of the arguments
+   if(!mShareMarshaledArgs || bstream->getStringTable())
+   {
+      mFunctor->write(*bstream);
+      return;
+   }
+
+   // Marshal into a clean stream so the result doesn't depend on what was written before it
+   if(!mMarshaledArgs)
+   {
+      mMarshaledArgs = new BitStream();
+      mFunctor->write(*mMarshaledArgs);
+      mMarshaledBitCount = mMarshaledArgs->getBitPosition();
+   }
+
+   bstream->writeBits(mMarshaledBitCount, mMarshaledArgs->getBuffer());
+
+   // The remote string buffer now holds whatever our copied args left there, which we
+   // don't track -- clearing ours just means the next string is sent without prefix compression
+   bstream->clearStringBuffer();
 }
 
 void RPCEvent::unpack(EventConnection *ps, BitStream *bstream)
@@ -32,29 +32,32 @@ namespace TNL {
 
 SymmetricCipher::SymmetricCipher(const U8 symmetricKey[SymmetricCipher::KeySize], const U8 initVector[SymmetricCipher::BlockSize])
 {
-   rijndael_setup(symmetricKey, KeySize, 0, &mSymmetricKey);
+   mBackend = CryptoBackend::get();
+   mBackend->aesSetup(symmetricKey, &mSymmetricKey);
    memcpy(mInitVector, initVector, BlockSize);
    memcpy(mCounter, initVector, BlockSize);
-   rijndael_ecb_encrypt((U8 *) mCounter, mPad, &mSymmetricKey);
+   mBackend->aesEncryptBlock(&mSymmetricKey, (U8 *) mCounter, mPad);
    mPadLen = 0;
 }
 
 SymmetricCipher::SymmetricCipher(const ByteBuffer *theByteBuffer)
 {
+   mBackend = CryptoBackend::get();
+
    if(theByteBuffer->getBufferSize() != KeySize * 2)
    {
       U8 buffer[KeySize];
       memset(buffer, 0, KeySize);
-      rijndael_setup(buffer, KeySize, 0, &mSymmetricKey);
+      mBackend->aesSetup(buffer, &mSymmetricKey);
       memcpy(mInitVector, buffer, BlockSize);
    }
    else
    {
-      rijndael_setup(theByteBuffer->getBuffer(), KeySize, 0, &mSymmetricKey);
+      mBackend->aesSetup(theByteBuffer->getBuffer(), &mSymmetricKey);
       memcpy(mInitVector, theByteBuffer->getBuffer() + KeySize, BlockSize);
    }
    memcpy(mCounter, mInitVector, BlockSize);
-   rijndael_ecb_encrypt((U8 *) mCounter, mPad, &mSymmetricKey);
+   mBackend->aesEncryptBlock(&mSymmetricKey, (U8 *) mCounter, mPad);
    mPadLen = 0;
 }
 
@@ -65,37 +68,71 @@ void SymmetricCipher::setupCounter(U32 counterValue1, U32 counterValue2, U32 cou
    mCounter[2] = convertHostToLEndian(convertLEndianToHost(mInitVector[2]) + counterValue3);
    mCounter[3] = convertHostToLEndian(convertLEndianToHost(mInitVector[3]) + counterValue4);
 
-   rijndael_ecb_encrypt((U8 *) mCounter, mPad, &mSymmetricKey);
+   mBackend->aesEncryptBlock(&mSymmetricKey, (U8 *) mCounter, mPad);
    mPadLen = 0;
 }
 
+// This is CFB mode: each new pad is the encryption of the previous block of ciphertext.  Whole
+// blocks are done a block at a time rather than a byte at a time.
 void SymmetricCipher::encrypt(const U8 *plainText, U8 *cipherText, U32 len)
 {
-   while(len-- > 0)
+   while(len > 0)
    {
       if(mPadLen == BlockSize)
       {
          // we've reached the end of the pad, so compute a new pad
-         rijndael_ecb_encrypt(mPad, mPad, &mSymmetricKey);
+         mBackend->aesEncryptBlock(&mSymmetricKey, mPad, mPad);
          mPadLen = 0;
       }
+
+      if(mPadLen == 0 && len >= BlockSize)
+      {
+         for(U32 i = 0; i < BlockSize; i++)
+            mPad[i] = cipherText[i] = plainText[i] ^ mPad[i];
+
+         plainText += BlockSize;
+         cipherText += BlockSize;
+         len -= BlockSize;
+         mPadLen = BlockSize;
+         continue;
+      }
+
       U8 encryptedChar = *plainText++ ^ mPad[mPadLen];
       mPad[mPadLen++] = *cipherText++ = encryptedChar;
+      len--;
    }
 }
 
 void SymmetricCipher::decrypt(const U8 *cipherText, U8 *plainText, U32 len)
 {
-   while(len-- > 0)
+   while(len > 0)
    {
       if(mPadLen == BlockSize)
       {
-         rijndael_ecb_encrypt(mPad, mPad, &mSymmetricKey);
+         mBackend->aesEncryptBlock(&mSymmetricKey, mPad, mPad);
          mPadLen = 0;
       }
+
+      if(mPadLen == 0 && len >= BlockSize)
+      {
+         for(U32 i = 0; i < BlockSize; i++)
+         {
+            U8 encryptedChar = cipherText[i];
+            plainText[i] = encryptedChar ^ mPad[i];
+            mPad[i] = encryptedChar;
+         }
+
+         cipherText += BlockSize;
+         plainText += BlockSize;
+         len -= BlockSize;
+         mPadLen = BlockSize;
+         continue;
+      }
+
       U8 encryptedChar = *cipherText++;
       *plainText++ = encryptedChar ^ mPad[mPadLen];
       mPad[mPadLen++] = encryptedChar;
+      len--;
    }
 }
 
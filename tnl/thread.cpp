@@ -270,15 +270,26 @@ U32 ThreadQueue::ThreadQueueThread::run()
    sto.set((void *) 0);
    mThreadQueue->unlock();
 
-   for(;;)
-      mThreadQueue->dispatchNextCall();
+   while(mThreadQueue->dispatchNextCall())
+      ;
+
+   // Don't touch the queue after this, it may be deleted as soon as we signal
+   mThreadQueue->mExitSemaphore.increment();
    return 0;
 }
 
 ThreadQueue::ThreadQueue(U32 threadCount)
 {
+   mShuttingDown = false;
+   mThreadCount = threadCount;
    mStorage.set((void *) 1);
-   for(U32 i = 0; i < threadCount; i++)
+}
+
+void ThreadQueue::startThreads()
+{
+   // Done on the first call rather than in the constructor, so the workers never see a partly
+   // constructed subclass
+   for(U32 i = 0; i < mThreadCount; i++)
    {
       Thread *theThread = new ThreadQueueThread(this);
       mThreads.push_back(theThread);
@@ -288,22 +299,56 @@ ThreadQueue::ThreadQueue(U32 threadCount)
 
 ThreadQueue::~ThreadQueue()
 {
+   shutdown();
+
+   for(S32 i = 0; i < mThreadCalls.size(); i++)
+      delete mThreadCalls[i];
+
+   for(S32 i = 0; i < mResponseCalls.size(); i++)
+      delete mResponseCalls[i];
 }
 
-void ThreadQueue::dispatchNextCall()
+void ThreadQueue::shutdown()
+{
+   lock();
+   if(mShuttingDown)
+   {
+      unlock();
+      return;
+   }
+   mShuttingDown = true;
+   unlock();
+
+   // Wake every worker so it notices we're shutting down, then wait for them all to exit
+   mSemaphore.increment(mThreads.size());
+   for(S32 i = 0; i < mThreads.size(); i++)
+      mExitSemaphore.wait();
+
+   for(S32 i = 0; i < mThreads.size(); i++)
+      delete mThreads[i];
+   mThreads.clear();
+}
+
+bool ThreadQueue::dispatchNextCall()
 {
    mSemaphore.wait();
    lock();
+   if(mShuttingDown)
+   {
+      unlock();
+      return false;
+   }
    if(mThreadCalls.size() == 0)
    {
       unlock();
-      return;
+      return true;
    }
    Functor *c = mThreadCalls.first();
    mThreadCalls.pop_front();
    unlock();
    c->dispatch(this);
    delete c;
+   return true;
 }
 
 void ThreadQueue::postCall(Functor *theCall)
@@ -311,6 +356,9 @@ void ThreadQueue::postCall(Functor *theCall)
    lock();
    if(isMainThread())
    {
+      if(mThreads.size() == 0)
+         startThreads();
+
       mThreadCalls.push_back(theCall);
       unlock();
       mSemaphore.increment();
@@ -69,6 +69,7 @@ class BitStream : public ByteBuffer
 protected:
    enum {
       ResizePad = 1500,
+      MaxWordBits = 57,       ///< Largest write that still fits in a 64-bit word when it doesn't start on a byte boundary.
    };
    U32  bitNum;               ///< The current bit position for reading/writing in the bit stream.
    bool error;                ///< Flag set if a user operation attempts to read or write past the max read/write sizes.
@@ -81,6 +82,17 @@ protected:
    char mStringBuffer[256];
 
    bool resizeBits(U32 numBitsNeeded);
+
+   /// Returns true if a read or write of bitCount bits can be done as a single 64-bit access, rather than
+   /// byte-by-byte.  That takes 8 bytes of buffer from the current byte on, so accesses near the end of
+   /// the buffer can't use it.
+   bool fitsWord(U32 bitCount, U32 maxBitNum) const
+   {
+      return bitCount <= MaxWordBits && bitNum + bitCount <= maxBitNum && (bitNum >> 3) + 8 <= getBufferSize();
+   }
+
+   void writeWord(U64 value, U32 bitCount);
+   U64  readWord(U32 bitCount);
 public:
 
    /// @name Constructors
@@ -116,6 +128,9 @@ public:
    /// sets the ConnectionStringTable for compressing string table entries across the network
    void setStringTable(ConnectionStringTable *table) { mStringTable = table; }
 
+   /// returns the ConnectionStringTable used for compressing string table entries, or NULL if there is none
+   ConnectionStringTable *getStringTable() const { return mStringTable; }
+
    /// clears the error state from an attempted read or write overrun
    void clearError() { error = false; }
 
@@ -74,18 +74,38 @@ private:
       /// if it is not.  Returns true if the nonce was not in the table
       /// when the function was called.
       bool checkAdd(Nonce &theNonce);
+
+      /// Returns true if the given nonce is already in the table.
+      bool contains(Nonce &theNonce);
    };
 
    U32 mCurrentDifficulty;
    U32 mLastUpdateTime;
    U32 mLastTickTime;
 
+   bool mAdaptiveDifficulty;
+   U32 mPreviousDifficulty;      ///< Difficulty before the last change, still accepted for DifficultyGracePeriod
+   U32 mDifficultyChangeTime;
+   U32 mLastAdjustTime;
+   U32 mRequestCount;            ///< Challenge requests since mLastAdjustTime
+   F64 mHandshakeTime;           ///< Milliseconds spent checking connect requests since mLastAdjustTime
+   F32 mRequestRate;             ///< Smoothed challenge requests per second
+   F32 mHandshakeLoad;           ///< Smoothed milliseconds of handshake work per second
+
    Nonce mCurrentNonce;
    Nonce mLastNonce;
 
    NonceTable *mCurrentNonceTable;
    NonceTable *mLastNonceTable;
-   static bool checkOneSolution(U32 solution, Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty, U32 clientIdentity);
+
+   /// Returns the nonce table for the given server nonce, or NULL if the nonce has expired.
+   NonceTable *findNonceTable(Nonce &serverNonce);
+
+   /// Returns true if a solution at the given difficulty is hard enough to accept
+   bool isAcceptedDifficulty(U32 puzzleDifficulty);
+
+   /// Raises or lowers the puzzle difficulty based on the load measured since the last adjustment
+   void adjustDifficulty(U32 currentTime);
 public:
    ClientPuzzleManager();
    ~ClientPuzzleManager();
@@ -110,6 +130,7 @@ public:
       InitialPuzzleDifficulty    = 17, ///< Initial puzzle difficulty is set so clients do approx 2-3x the shared secret
                                        ///  generation of the server
       MaxPuzzleDifficulty        = 26, ///< Maximum puzzle difficulty is approx 1 minute to solve on ~2004 hardware.
+      MinPuzzleDifficulty        = 12, ///< Difficulty we drop to when idle, so clients connect quickly.
       MaxSolutionComputeFragment = 30, ///< Number of milliseconds spent computing solution per call to solvePuzzle.
       SolutionFragmentIterations = 50000, ///< Number of attempts to spend on the client puzzle per call to solvePuzzle.
    };
@@ -117,6 +138,25 @@ public:
    /// Checks a puzzle solution submitted by a client to see if it is a valid solution for the current or previous puzzle nonces
    ErrorCode checkSolution(U32 solution, Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty, U32 clientIdentity);
 
+   /// @name Deferred solution checking
+   ///
+   /// checkSolution split into its parts, so the hash can be checked off the main thread.  Call
+   /// checkParameters when the request arrives, checkOneSolution on any thread, then recordSolution
+   /// once the solution is known to be good.  Only checkOneSolution is safe to call from a worker thread.
+   ///
+   /// @{
+
+   /// Checks everything about a solution except the solution itself
+   ErrorCode checkParameters(Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty);
+
+   /// Checks the solution hash, without looking at or changing any puzzle state
+   static bool checkOneSolution(U32 solution, Nonce &clientNonce, Nonce &serverNonce, U32 puzzleDifficulty, U32 clientIdentity);
+
+   /// Marks the client nonce as used, so the same solution can't be replayed
+   ErrorCode recordSolution(Nonce &clientNonce, Nonce &serverNonce);
+
+   /// @}
+
    /// Computes a puzzle solution value for the given puzzle difficulty and server nonce.  If the execution time of this function
    /// exceeds MaxSolutionComputeFragment milliseconds, it will return the current trail solution in the solution variable and a
    /// return value of false.
@@ -137,6 +177,42 @@ public:
 
    /// Returns the current client puzzle difficulty
    U32 getCurrentDifficulty() { return mCurrentDifficulty; }
+
+   /// @name Adaptive difficulty
+   ///
+   /// Every DifficultyAdjustInterval, the difficulty goes up a step if connect challenges are arriving
+   /// faster than HighRequestRate or checking connect requests is taking more than HighHandshakeLoad,
+   /// and down a step if both are below their Low thresholds.  Each step doubles or halves the work
+   /// a client has to do.
+   ///
+   /// @{
+
+   enum {
+      DifficultyAdjustInterval   = 1000,  ///< Milliseconds between difficulty adjustments.
+      DifficultyGracePeriod      = 5000,  ///< How long solutions at the previous difficulty are still accepted after a raise.
+      HighRequestRate            = 20,    ///< Challenge requests per second above which the difficulty goes up.
+      LowRequestRate             = 4,     ///< Challenge requests per second below which the difficulty may come down.
+      HighHandshakeLoad          = 20,    ///< Milliseconds of handshake work per second above which the difficulty goes up.
+      LowHandshakeLoad           = 5,     ///< Milliseconds of handshake work per second below which the difficulty may come down.
+   };
+
+   /// Turns adaptive difficulty on or off; when off, the difficulty stays at InitialPuzzleDifficulty
+   void setAdaptiveDifficulty(bool adaptive);
+   bool isAdaptiveDifficulty() { return mAdaptiveDifficulty; }
+
+   /// Counts a connect challenge request toward the request rate
+   void recordChallengeRequest() { mRequestCount++; }
+
+   /// Counts time spent checking a connect request toward the handshake load
+   void recordHandshakeTime(F64 milliseconds) { mHandshakeTime += milliseconds; }
+
+   /// Smoothed challenge requests per second
+   F32 getRequestRate() { return mRequestRate; }
+
+   /// Smoothed milliseconds spent checking connect requests per second
+   F32 getHandshakeLoad() { return mHandshakeLoad; }
+
+   /// @}
 };
 
 };
@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------------
+//
+//   Torque Network Library
+//   Copyright (C) 2004 GarageGames.com, Inc.
+//   For more information see http://www.opentnl.org
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   For use in products that are not compatible with the terms of the GNU 
+//   General Public License, alternative licensing options are available 
+//   from GarageGames.com.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//------------------------------------------------------------------------------------
+
+#ifndef _TNL_CRYPTOBACKEND_H_
+#define _TNL_CRYPTOBACKEND_H_
+
+#ifndef _TNL_TYPES_H_
+#include "tnlTypes.h"
+#endif
+
+#include <tomcrypt.h>
+#undef MD5 // mycrypt_custom.h defines this, clashing with the MD5 class
+
+namespace TNL
+{
+
+/// The AES and SHA-256 primitives behind SymmetricCipher and the packet hashes in BitStream.
+///
+/// There are two backends: a portable one built on libtomcrypt, and one using the x86 AES and SHA
+/// instructions, which is picked at startup if the CPU has them.  Both produce identical output, so
+/// the two ends of a connection don't need to agree on which one they use.
+class CryptoBackend
+{
+public:
+   enum {
+      AesBlockSize = 16,
+      AesKeySize = 16,
+      Sha256Size = 32,
+   };
+
+   /// Expanded AES-128 key, in whatever form the backend that set it up wants.
+   union AesKey
+   {
+      symmetric_key tomcrypt;
+      U8 roundKeys[11 * AesBlockSize];
+   };
+
+   virtual ~CryptoBackend() {}
+
+   /// Name for diagnostics and benchmarks.
+   virtual const char *getName() = 0;
+
+   /// Expands an AES-128 key for use with aesEncryptBlock.
+   virtual void aesSetup(const U8 key[AesKeySize], AesKey *expandedKey) = 0;
+
+   /// Encrypts one block.  in and out may be the same buffer.
+   virtual void aesEncryptBlock(const AesKey *expandedKey, const U8 in[AesBlockSize], U8 out[AesBlockSize]) = 0;
+
+   /// Computes the SHA-256 hash of len bytes of data.
+   virtual void sha256(const U8 *data, U32 len, U8 hash[Sha256Size]) = 0;
+
+   /// Returns the backend used by SymmetricCipher and BitStream: the hardware one if the CPU
+   /// supports it, otherwise the portable one.
+   static CryptoBackend *get();
+
+   /// Returns the libtomcrypt backend, which is always available.
+   static CryptoBackend *getPortable();
+
+   /// Returns the x86 AES/SHA instruction backend, or NULL if this CPU or build doesn't support it.
+   static CryptoBackend *getHardware();
+
+   /// Overrides the backend returned by get(); pass NULL to go back to the default.  Ciphers that
+   /// already exist keep the backend they were created with.
+   static void set(CryptoBackend *backend);
+};
+
+};
+
+#endif
@@ -161,6 +161,11 @@ public:
    /// Posts a NetEvent for processing on the remote host
    bool postNetEvent(NetEvent *event);
 
+   /// Posts the same NetEvent to each connection in the list, skipping any that can't accept events.
+   /// Construct RPCs with TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT so their arguments are only marshaled once.
+   /// Returns the number of connections the event was posted to.
+   static S32 postNetEventToAll(NetEvent *event, const Vector<EventConnection *> &connections);
+
    /// For fake connections (AI for instance)
    virtual bool canPostNetEvent() const { return true; }
 
@@ -79,6 +79,24 @@ class GhostConnection : public EventConnection
    typedef EventConnection Parent;
    friend class ConnectionMessageEvent;
 public:
+   enum DeltaConstants {
+      MaxDeltaValues = 8,       ///< Most values an object can delta-compress in one update
+      DeltaIdBitSize = 4,       ///< Size, in bits, of the snapshot ids sent with delta-compressed values
+      DeltaHistorySize = (1 << DeltaIdBitSize),  ///< Number of snapshots the receiving side keeps for each ghost, and so how far back a delta can refer
+      DeltaHistoryMask = DeltaHistorySize - 1,
+   };
+
+   /// Quantized values (positions, velocities and the like) written by an object with writeGhostDelta().
+   ///
+   /// The sending side keeps the last snapshot the remote host acknowledged for each ghost, and encodes
+   /// new values as deltas against it; the receiving side keeps the last few snapshots it received,
+   /// so it can rebuild the values from whichever one the delta refers to.
+   struct DeltaSnapshot
+   {
+      U32 id;                       ///< Sequence number of this snapshot for its ghost
+      S32 values[MaxDeltaValues];
+   };
+
    /// GhostRef tracks an update sent in one packet for the ghost of one NetObject.
    ///
    /// When we are notified that a pack is sent/lost, this is used to determine what
@@ -93,6 +111,8 @@ public:
       GhostRef *nextRef;     ///< The next ghost updated in this packet
       GhostRef *updateChain; ///< A pointer to the GhostRef on the least previous packet that
                              ///  updated this ghost, or NULL, if no prior packet updated this ghost
+      bool hasDeltaSnapshot;     ///< True if this update included delta-compressed values
+      DeltaSnapshot deltaSnapshot; ///< The values sent, which become the ghost's baseline once this packet is acknowledged
    };
 
    /// Notify structure attached to each packet with information about the ghost updates in the packet
@@ -168,6 +188,15 @@ protected:
 
    U32 mGhostClassCount;
    U32 mGhostClassBitSize;
+
+   bool mGhostDeltaCompression;      ///< Are objects allowed to delta-compress their updates on this connection?
+   GhostInfo *mPackingGhost;         ///< Ghost whose update writePacket is currently writing, for writeGhostDelta()
+   bool mHasPendingDelta;            ///< Did the update being written include delta-compressed values?
+   DeltaSnapshot mPendingDelta;      ///< Values written by the update being written
+   S32 mUnpackingGhostIndex;         ///< Index of the ghost whose update readPacket is currently reading, for readGhostDelta()
+   Vector<DeltaSnapshot *> mReceivedDeltas; ///< DeltaHistorySize snapshots for each local ghost, indexed by id, allocated on first use
+
+   void clearReceivedDeltas(S32 index);
 public:
    GhostConnection();
    ~GhostConnection();
@@ -224,6 +253,49 @@ public:
 
    void detachObject(GhostInfo *info);                      ///< Notifies the GhostConnection that the specified GhostInfo should no longer be scoped to the client.
 
+   /// @name Incremental scoping
+   ///
+   /// Only ghosts with pending updates have their scope re-checked each packet; a ghost with nothing to
+   /// send stays in scope until it changes.  A scope object that remembers what it scoped last time can
+   /// use these to re-mark just the ghosts that will be re-checked, rather than finding everything again.
+   /// @{
+
+   /// Returns the number of ghosts that have pending updates, and so need to be re-marked as in scope this packet.
+   S32 getUpdatingGhostCount() { return mGhostZeroUpdateIndex; }
+
+   /// Returns the object for one of the ghosts counted by getUpdatingGhostCount(); may be NULL.
+   NetObject *getUpdatingGhost(S32 index);
+
+   /// Returns true if we're running out of ghost ids; ghosts without updates get their scope re-checked too in that case.
+   bool isGhostSpaceLow() { return mGhostFreeIndex > MaxGhostCount - 10; }
+
+   /// @}
+
+   /// @name Delta-compressed updates
+   ///
+   /// Objects can send their positions, velocities and so on as small deltas against the last values
+   /// the remote host acknowledged, instead of resending them whole.  Both ends of the connection have to
+   /// enable it, and each object decides for itself whether to use it: in packUpdate, an object checks
+   /// isGhostDeltaCompression() and, if it's on, quantizes its values to S32s and passes them to
+   /// writeGhostDelta(); unpackUpdate reads them back with readGhostDelta().  When there is no acknowledged
+   /// baseline yet, or it's too old because packets were lost, the values go out whole.
+   ///
+   /// Each ghost update can include at most one set of delta-compressed values.
+   ///
+   /// @{
+
+   /// Turns delta-compressed updates on or off.  Both sides must agree before ghosting starts.
+   void setGhostDeltaCompression(bool enabled) { mGhostDeltaCompression = enabled; }
+   bool isGhostDeltaCompression() { return mGhostDeltaCompression; }
+
+   /// Writes count values for the object whose update is being packed.
+   void writeGhostDelta(BitStream *stream, const S32 *values, U32 count);
+
+   /// Reads count values written by writeGhostDelta().
+   void readGhostDelta(BitStream *stream, S32 *values, U32 count);
+
+   /// @}
+
    /// RPC from server to client before the GhostAlwaysObjects are transmitted
    TNL_DECLARE_RPC(rpcStartGhosting, (U32 sequence));
 
@@ -268,6 +340,10 @@ struct GhostInfo
    U32 index;      ///< Fixed index of the object in the mGhostRefs array for the connection, and the ghostId of the object on the client.
    S32 arrayIndex; ///< Position of the object in the mGhostArray for the connection, which changes as the object is pushed to zero, non-zero and free.
 
+   U32 deltaSequence;     ///< Id of the next delta snapshot for this ghost
+   bool hasDeltaBaseline; ///< True once the remote host has acknowledged one of this ghost's delta snapshots
+   GhostConnection::DeltaSnapshot deltaBaseline; ///< The latest delta snapshot the remote host has acknowledged
+
     enum Flags
     {
       InScope = BIT(0),             ///< This GhostInfo's NetObject is currently in scope for this connection.
@@ -205,10 +205,11 @@ protected:
    U32 mClassId[NetClassGroupCount];   ///< The id for this class in each class group.
    char *mClassName;                   ///< The unmangled name of the class.
 
-   U32 mInitialUpdateBitsUsed; ///< Number of bits used on initial updates of objects of this class.
-   U32 mPartialUpdateBitsUsed; ///< Number of bits used on partial updates of objects of this class.
-   U32 mInitialUpdateCount;    ///< Number of objects of this class constructed over a connection.
-   U32 mPartialUpdateCount;    ///< Number of objects of this class updated over a connection.
+   U64 mInitialUpdateBitsUsed; ///< Number of bits used on initial updates of objects of this class, or by events of this class.
+   U64 mPartialUpdateBitsUsed; ///< Number of bits used on partial updates of objects of this class.
+   U64 mInitialUpdateCount;    ///< Number of objects of this class constructed over a connection, or events of this class sent.
+   U64 mPartialUpdateCount;    ///< Number of objects of this class updated over a connection.
+   S64 mPackTime;              ///< Time spent packing updates or events of this class, in high precision timer ticks.
 
    /// Next declared NetClassRep.
    ///
@@ -241,20 +242,40 @@ public:
    S32 getClassVersion() const;                    ///< Returns the version of this class.
    const char *getClassName() const;               ///< Returns the string class name.
 
-   /// Records bits used in the initial update of objects of this class.
-   void addInitialUpdate(U32 bitCount)
+   /// Records bits used, and time spent packing, in the initial update of an object of this class.  Events
+   /// are recorded here too.
+   void addInitialUpdate(U32 bitCount, S64 packTime = 0)
    {
       mInitialUpdateCount++;
       mInitialUpdateBitsUsed += bitCount;
+      mPackTime += packTime;
    }
 
-   /// Records bits used in a partial update of an object of this class.
-   void addPartialUpdate(U32 bitCount)
+   /// Records bits used, and time spent packing, in a partial update of an object of this class.
+   void addPartialUpdate(U32 bitCount, S64 packTime = 0)
    {
       mPartialUpdateCount++;
       mPartialUpdateBitsUsed += bitCount;
+      mPackTime += packTime;
    }
 
+   /// @name Bit usage
+   ///
+   /// Totals for everything sent over any connection since startup, or since the last resetBitUsage().
+   /// @{
+
+   U64 getInitialUpdateCount()    const { return mInitialUpdateCount;    }
+   U64 getInitialUpdateBitsUsed() const { return mInitialUpdateBitsUsed; }
+   U64 getPartialUpdateCount()    const { return mPartialUpdateCount;    }
+   U64 getPartialUpdateBitsUsed() const { return mPartialUpdateBitsUsed; }
+   S64 getPackTime()              const { return mPackTime;              } ///< In high precision timer ticks
+
+   /// @}
+
+   /// Returns the first of the linked list of every declared NetClassRep; walk it with getNextClass().
+   static NetClassRep *getFirstClass() { return mClassLinkList; }
+   NetClassRep *getNextClass() const { return mNextClass; }
+
    virtual Object *create() const = 0;             ///< Creates an instance of the class this represents.
 
    /// Returns the number of classes registered under classGroup and classType.
@@ -283,6 +304,9 @@ public:
 
    /// Logs the bit usage information of all the NetClassReps
    static void logBitUsage();
+
+   /// Zeroes the bit usage information of all the NetClassReps
+   static void resetBitUsage();
 };
 
 inline U32 NetClassRep::getClassId(NetClassGroup classGroup) const
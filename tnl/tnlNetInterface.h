@@ -49,6 +49,7 @@ namespace TNL {
 
 class AsymmetricKey;
 class Certificate;
+class HandshakeQueue;
 struct ConnectionParameters;
 
 /// NetInterface class.
@@ -143,6 +144,7 @@ struct ConnectionParameters;
 class NetInterface : public Object
 {
    friend class NetConnection;
+   friend class HandshakeQueue;
 public:
    /// PacketType is encoded as the first byte of each packet.
    ///
@@ -178,6 +180,7 @@ protected:
    RefPtr<AsymmetricKey> mPrivateKey;  /// The private key used by this NetInterface for secure key exchange.
    RefPtr<Certificate> mCertificate;   /// A certificate, signed by some Certificate Authority, to authenticate this host.
    ClientPuzzleManager mPuzzleManager; /// The object that tracks the current client puzzle difficulty, current puzzle and solutions for this NetInterface.
+   HandshakeQueue *mHandshakeQueue;    /// Worker threads that check connect requests off the main thread, or NULL to check them inline.
 
    /// @name NetInterfaceSocket Socket
    ///
@@ -223,6 +226,8 @@ protected:
 
       TimeoutCheckInterval = 1500,     /// Interval in milliseconds between checking for connection timeouts.
       PuzzleSolutionTimeout = 30000,   /// If the server gives us a puzzle that takes more than 30 seconds, time out.
+
+      MaxPendingHandshakes = 256,      /// Connect requests arriving while this many are queued for the handshake threads are dropped.
    };
 
    /// Computes an identity token for the connecting client based on the address of the client and the
@@ -282,6 +287,14 @@ protected:
    /// connection negotiation.
    void handleConnectRequest(const Address &address, BitStream *stream);
 
+   /// Reads the key exchange part of a connect request: the client's public key, then the encrypted
+   /// remainder of the request, which is decrypted in place.  This is the expensive part of the
+   /// handshake, and is safe to call from a handshake thread.  Returns false if the request should be dropped.
+   static bool readConnectRequestKey(ConnectionParameters &theParams, AsymmetricKey *privateKey, BitStream *stream);
+
+   /// Creates the connection for a connect request whose puzzle and key exchange have been checked.
+   void finishConnectRequest(const Address &address, ConnectionParameters &theParams, BitStream *stream);
+
    /// Sends a connect accept packet to acknowledge the successful acceptance of a connect request.
    void sendConnectAccept(NetConnection *conn);
 
@@ -332,6 +345,17 @@ public:
    /// Sets the private key this NetInterface will use for authentication and key exchange
    void setPrivateKey(AsymmetricKey *theKey);
 
+   /// Sets the number of worker threads used to check client puzzles and do key exchange for incoming
+   /// connect requests.  With no threads (the default) that's done on the calling thread as each request
+   /// arrives; with threads, the connection is created in processConnections once the checks finish.
+   void setHandshakeThreadCount(U32 threadCount);
+
+   /// Returns the number of connect requests waiting on the handshake threads.
+   U32 getPendingHandshakeCount();
+
+   /// Returns the client puzzle manager, for its difficulty and load figures.
+   ClientPuzzleManager &getPuzzleManager() { return mPuzzleManager; }
+
    /// Requires that all connections use encryption and key exchange
    void setRequiresKeyExchange(bool requires) { mRequiresKeyExchange = requires; }
 
@@ -80,6 +80,10 @@ namespace Platform
    /// Put the process to sleep for the specified millisecond interva.
    void sleep(U32 msCount);
 
+   /// Put the process to sleep for the specified microsecond interval, or as close to it as the
+   /// OS allows without oversleeping.
+   void sleepMicroseconds(U32 usCount);
+
    /// checks the status of the memory allocation heap
    bool checkHeap();
 };
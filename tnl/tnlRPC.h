@@ -172,10 +172,21 @@ public: \
 /// All declared RPC methods create subclasses of RPCEvent to send data across the wire
 class RPCEvent : public NetEvent
 {
+   BitStream *mMarshaledArgs;    ///< Arguments written once for a broadcast event, NULL until first packed
+   U32 mMarshaledBitCount;       ///< Number of valid bits in mMarshaledArgs
+
 public:
    Functor *mFunctor;
+   bool mShareMarshaledArgs;     ///< If true, arguments are marshaled once and copied into every connection's packet
+
    /// Constructor call from within the rpc<i>Something</i> method generated by the TNL_IMPLEMENT_RPC macro.
    RPCEvent(RPCGuaranteeType gType, RPCDirection dir);
+   ~RPCEvent();
+
+   /// Marks an RPC event for posting to many connections, so that its arguments only get marshaled once.
+   /// Returns the event to allow wrapping a _construct call.
+   static NetEvent *makeBroadcast(NetEvent *theEvent);
+
    void pack(EventConnection *ps, BitStream *bstream);
    void unpack(EventConnection *ps, BitStream *bstream);
    virtual bool checkClassType(Object *theObject) = 0;
@@ -201,6 +212,11 @@ public:
 /// connections, instead of allocating an RPCEvent for each connection.
 #define TNL_RPC_CONSTRUCT_NETEVENT(object, rpcMethod, args) (object)->rpcMethod##_construct args
 
+/// Like TNL_RPC_CONSTRUCT_NETEVENT, but the arguments of the resulting event are marshaled
+/// only once, no matter how many connections it is posted to.  Use with
+/// EventConnection::postNetEventToAll() for fanning a message out to large numbers of clients.
+#define TNL_RPC_CONSTRUCT_BROADCAST_NETEVENT(object, rpcMethod, args) TNL::RPCEvent::makeBroadcast((object)->rpcMethod##_construct args)
+
 };
 
 #endif
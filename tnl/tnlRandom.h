@@ -42,6 +42,10 @@ namespace Random {
 /// Adds random "seed" data to the random number generator
 void addEntropy(const U8 *randomData, U32 dataLen);
 
+/// Throws away all state and restarts the generator from the given seed, so that
+/// the same sequence of numbers comes out every time.  For tests and benchmarks only!
+void setSeed(U32 seed);
+
 /// Reads random byte data from the random number generator
 void read(U8 *outBuffer, U32 randomLen);
 
@@ -31,8 +31,9 @@
 #include "tnlNetBase.h"
 #endif
 
-#include <tomcrypt.h>
-#undef MD5 // mycrypt_custom.h defines this, clashing with the MD5 class
+#ifndef _TNL_CRYPTOBACKEND_H_
+#include "tnlCryptoBackend.h"
+#endif
 
 namespace TNL
 {
@@ -40,7 +41,7 @@ namespace TNL
 class ByteBuffer;
 
 /// Class for symmetric encryption of data across a connection.  Internally it uses
-/// the libtomcrypt AES algorithm to encrypt the data.
+/// AES in CFB mode, through whichever CryptoBackend was current when it was created.
 class SymmetricCipher : public Object
 {
 public:
@@ -52,7 +53,8 @@ private:
    U32 mCounter[BlockSize >> 2];
    U32 mInitVector[BlockSize];
    U8 mPad[BlockSize];
-   symmetric_key mSymmetricKey;
+   CryptoBackend *mBackend;
+   CryptoBackend::AesKey mSymmetricKey;
    U32 mPadLen;
 public:
    SymmetricCipher(const U8 symmetricKey[KeySize], const U8 initVector[BlockSize]);
@@ -61,6 +63,9 @@ public:
    void setupCounter(U32 counterValue1, U32 counterValue2, U32 counterValue3, U32 counterValue4);
    void encrypt(const U8 *plainText, U8 *cipherText, U32 len);
    void decrypt(const U8 *cipherText, U8 *plainText, U32 len);
+
+   /// Returns the backend doing the work, which BitStream also uses for its packet hashes.
+   CryptoBackend *getBackend() { return mBackend; }
 };
 
 };
@@ -166,6 +166,8 @@ class ThreadQueue : public Object
    friend class ThreadQueueThread;
    /// list of worker threads on this ThreadQueue
    Vector<Thread *> mThreads;
+   /// number of worker threads to start
+   U32 mThreadCount;
    /// list of calls to be processed by the worker threads
    Vector<Functor *> mThreadCalls;
    /// list of calls to be processed by the main thread
@@ -176,24 +178,37 @@ class ThreadQueue : public Object
    Mutex mLock;
    /// Storage variable that tracks whether this is the main thread or a worker thread.
    ThreadStorage mStorage;
+   /// Set by the destructor to tell the worker threads to exit.
+   bool mShuttingDown;
+   /// Incremented by each worker thread as it exits, so the destructor can wait for them.
+   Semaphore mExitSemaphore;
 protected:
    /// Locks the ThreadQueue for access to member variables.
    void lock() { mLock.lock(); }
    /// Unlocks the ThreadQueue.
    void unlock() { mLock.unlock(); }
+   /// Starts the worker threads.  Called on the first call posted from the main thread.
+   void startThreads();
    /// Posts a marshalled call onto either the worker thread call list or the response call list.
    void postCall(Functor *theCall);
    /// Dispatches the next available worker thread call.  Called internally by the worker threads when they awaken from the semaphore.
-   void dispatchNextCall();
+   /// Returns false once the ThreadQueue is shutting down and the worker thread should exit.
+   bool dispatchNextCall();
    /// helper function to determine if the currently executing thread is a worker thread or the main thread.
    bool isMainThread() { return (bool) mStorage.get(); }
    ThreadStorage &getStorage() { return mStorage; }
+   /// Stops the worker threads, waiting for any calls in progress to finish.  Subclasses whose worker
+   /// methods use subclass members should call this from their own destructor.
+   void shutdown();
    /// called by each worker thread when it starts for subclass initialization of worker threads.
    virtual void threadStart() { }
 public:
-   /// ThreadQueue constructor.  threadCount specifies the number of worker threads that will be created.
+   /// ThreadQueue constructor.  threadCount specifies the number of worker threads that will be created
+   /// when the first call is posted.
    ThreadQueue(U32 threadCount);
-   ~ThreadQueue();
+   /// ThreadQueue destructor.  Waits for any calls in progress on the worker threads to finish, then
+   /// discards calls that haven't been dispatched yet.
+   virtual ~ThreadQueue();
 
    /// Dispatches all ThreadQueue calls queued by worker threads.  This should
    /// be called periodically from a main loop.
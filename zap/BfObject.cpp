@@ -235,6 +235,26 @@ bool isMountableItemType(U8 x)
 }
 
 
+// Objects that stay put for the life of the level, unless they're created or destroyed (e.g. by engineering).
+// These are the ones incremental ghost scoping can skip re-finding every packet.
+bool isStaticObjectType(U8 x)
+{
+   return
+         x == BarrierTypeNumber     || x == PolyWallTypeNumber            || x == WallItemTypeNumber  ||
+         x == WallEdgeTypeNumber    || x == WallSegmentTypeNumber         || x == LineTypeNumber      ||
+         x == TextItemTypeNumber    || x == ForceFieldProjectorTypeNumber || x == ForceFieldTypeNumber ||
+         x == TurretTypeNumber      || x == CoreTypeNumber                || x == TeleporterTypeNumber ||
+         x == LoadoutZoneTypeNumber || x == GoalZoneTypeNumber            || x == NexusTypeNumber      ||
+         x == SpeedZoneTypeNumber   || x == SlipZoneTypeNumber            || x == ZoneTypeNumber;
+}
+
+
+bool isNonStaticObjectType(U8 x)
+{
+   return !isStaticObjectType(x);
+}
+
+
 bool isAnyObjectType(U8 x)
 {
    return true;
@@ -1293,6 +1313,46 @@ void BfObject::readCompressedVelocity(Point &vel, U32 max, BitStream *stream)
 }
 
 
+// When the connection does delta compression and writeCompressedPoint would round this position to whole units
+// anyway (i.e. it's near the player's ship), position and velocity are rounded to whole units and sent as changes
+// since the last update the client acknowledged.  Otherwise -- spectators, or objects out past the relative range --
+// we fall back on writeCompressedPoint and writeCompressedVelocity, which keep full precision there.
+void BfObject::writePositionAndVelocity(GhostConnection *connection, const Point &pos, const Point &vel, U32 maxVel, BitStream *stream)
+{
+   if(connection->isGhostDeltaCompression() &&
+         stream->writeFlag(((GameConnection *) connection)->canCompressPointRelative(pos)))
+   {
+      S32 values[4] = {
+         S32(floor(pos.x + 0.5f)), S32(floor(pos.y + 0.5f)),
+         S32(floor(vel.x + 0.5f)), S32(floor(vel.y + 0.5f))
+      };
+
+      connection->writeGhostDelta(stream, values, ARRAYSIZE(values));
+      return;
+   }
+
+   ((GameConnection *) connection)->writeCompressedPoint(pos, stream);
+   writeCompressedVelocity(vel, maxVel, stream);
+}
+
+
+void BfObject::readPositionAndVelocity(GhostConnection *connection, Point &pos, Point &vel, U32 maxVel, BitStream *stream)
+{
+   if(connection->isGhostDeltaCompression() && stream->readFlag())
+   {
+      S32 values[4];
+      connection->readGhostDelta(stream, values, ARRAYSIZE(values));
+
+      pos.set(F32(values[0]), F32(values[1]));
+      vel.set(F32(values[2]), F32(values[3]));
+      return;
+   }
+
+   ((GameConnection *) connection)->readCompressedPoint(pos, stream);
+   readCompressedVelocity(vel, maxVel, stream);
+}
+
+
 void BfObject::onGhostAddBeforeUpdate(GhostConnection *theConnection)
 {
 #ifndef ZAP_DEDICATED
@@ -113,6 +113,8 @@ bool isVisibleOnCmdrsMapWithSensorType(U8 x);
 bool isZoneType(U8 x);
 bool isSeekerTarget(U8 x);
 bool isMountableItemType(U8 x);
+bool isStaticObjectType(U8 x);                 // Never move once placed
+bool isNonStaticObjectType(U8 x);
 
 bool isAnyObjectType(U8 x);
 // END GAME OBJECT TYPES
@@ -325,6 +327,10 @@ public:
    void writeCompressedVelocity(const Point &vel, U32 max, BitStream *stream);
    void readCompressedVelocity(Point &vel, U32 max, BitStream *stream);
 
+   // Position and velocity together, sent as deltas on connections that support them
+   void writePositionAndVelocity(GhostConnection *connection, const Point &pos, const Point &vel, U32 maxVel, BitStream *stream);
+   void readPositionAndVelocity(GhostConnection *connection, Point &pos, Point &vel, U32 maxVel, BitStream *stream);
+
    virtual bool collide(BfObject *hitObject);
    virtual bool collided(BfObject *otherObject, U32 stateIndex);
 
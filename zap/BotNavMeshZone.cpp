@@ -38,7 +38,7 @@ namespace Zap
 {
 
 // Declare our statics
-static const S32 MAX_ZONES = 10000;                              // Don't make this go above S16 max - 1 (32,766), AStar::findPath is limited
+static const S32 MAX_ZONES = 10000;                              // Don't make this go above S16 max - 1 (32,766), AStar::findZonePath is limited
 const S32 BotNavMeshZone::BufferRadius = Ship::CollisionRadius;  // Radius to buffer objects when creating the holes for zones
 
 // Extra padding around the game extents to allow outsize zones to be created.
@@ -403,6 +403,7 @@ static void linkTeleportersBotNavMeshZoneConnections(const GridDatabase *botZone
             // This should be the average of the costs of traveling from each dest zone to the target zone
             neighbor.distTo = 0;
             neighbor.center.set(origin);
+            neighbor.isTeleporter = true;
 
             origZone->mNeighbors.push_back(neighbor);
          }
@@ -659,6 +660,7 @@ NeighboringZone::NeighboringZone()
 {
    zoneID = 0;
    distTo = 0;
+   isTeleporter = false;
 }
 
 
@@ -674,7 +676,7 @@ F32 AStar::heuristic(const Vector<BotNavMeshZone *> *zones, S32 fromZone, S32 to
 
 
 // Returns a path, including the startZone and targetZone 
-Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, const Point &target)
+Vector<U16> AStar::findZonePath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone)
 {
    // Because of these variables...
    static U16 onClosedList = 0;
@@ -695,7 +697,7 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
 
    S32 newOpenListItemID = 0;         // Used for creating new IDs for zones to make heap work
 
-   Vector<Point> path;
+   Vector<U16> path;
 
    // This block here lets us repeatedly reuse the whichList array without resetting it or recreating it
    // which, for larger numbers of zones should be a real time saver.  It's not clear if it is particularly
@@ -890,42 +892,162 @@ Vector<Point> AStar::findPath(const Vector<BotNavMeshZone *> *zones, S32 startZo
    }
 
    // Working backwards from the target to the starting location by checking
-   // each cell's parent, figure out the length of the path.
-   //
-   // Fortunately, we want our list to have the closest zone last (see getWaypoint),
-   // so it all works out nicely.
-   //
-   // We'll store both the zone center and the gateway to the neighboring zone.  This
-   // will help keep the robot from getting hung up on blocked but technically visible
-   // paths, such as when we are trying to fly around a protruding wall stub.
-
-   path.push_back(target);                               // First point is the actual target itself
-   path.push_back(zones->get(targetZone)->getCenter());  // Second is the center of the target's zone
-      
+   // each cell's parent, figure out the length of the path; then turn it around
+   // so it runs from where we are to where we're going.
    S32 zone = targetZone;
+   path.push_back(zone);
 
    while(zone != startZone)
    {
-      path.push_back(findGateway(zones, parentZones[zone], zone));   // Don't switch findGateway arguments, some path is one way (teleporters).
       zone = parentZones[zone];                                      // Find the parent of the current cell
-      path.push_back(zones->get(zone)->getCenter());
+      path.push_back(zone);
    }
 
-   path.push_back(zones->get(startZone)->getCenter());
+   path.reverse();
    return path;
 }
 
 
-// Return a point representing gateway between zones
-Point AStar::findGateway(const Vector<BotNavMeshZone *> *zones, S32 zone1, S32 zone2)
+// Keep corners this far in from the ends of the borders between zones.  The zones already stand a ship's radius off
+// the walls, but bots don't steer precisely, and rounding a corner with a little room to spare stops them scraping
+// along it.  Aiming inside the border also means that flying through a corner takes us on into the next zone.
+static const F32 CornerMargin = Ship::CollisionRadius / 2;
+
+// Twice the signed area of triangle abc: positive when c is to one side of the line from a to b (the side we'll call
+// left), negative when it's to the other.  Which side is which in screen terms doesn't matter, so long as we agree.
+static F32 triArea2(const Point &a, const Point &b, const Point &c)
+{
+   return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+
+// The "simple stupid funnel algorithm": pulls a string taut through a series of portals, given as the left and right
+// ends of each.  The first portal is the starting point and the last is the destination, each squashed to a point.
+// Appends each point the string bends around, then the destination, to corners.
+void AStar::pullString(const Vector<Point> &lefts, const Vector<Point> &rights, Vector<Point> &corners)
 {
-   S32 neighborIndex = zones->get(zone1)->getNeighborIndex(zone2);
-   TNLAssert(neighborIndex >= 0, "Invalid neighbor index!!");
+   Point apex = lefts[0];
+   Point left = lefts[0];
+   Point right = rights[0];
+
+   S32 leftIndex = 0;
+   S32 rightIndex = 0;
+
+   for(S32 i = 1; i < lefts.size(); i++)
+   {
+      // Narrow the funnel from the right, unless that would cross over the left side -- in which case the left side
+      // is a corner we must go around, and we start a new funnel there
+      if(triArea2(apex, right, rights[i]) >= 0)
+      {
+         if(apex == right || triArea2(apex, left, rights[i]) < 0)
+         {
+            right = rights[i];
+            rightIndex = i;
+         }
+         else
+         {
+            corners.push_back(left);
+            apex = right = left;
+            rightIndex = leftIndex;
+            i = leftIndex;
+            continue;
+         }
+      }
+
+      // And the same from the left
+      if(triArea2(apex, left, lefts[i]) <= 0)
+      {
+         if(apex == left || triArea2(apex, right, lefts[i]) > 0)
+         {
+            left = lefts[i];
+            leftIndex = i;
+         }
+         else
+         {
+            corners.push_back(right);
+            apex = left = right;
+            leftIndex = rightIndex;
+            i = rightIndex;
+            continue;
+         }
+      }
+   }
 
-   return zones->get(zone1)->mNeighbors[neighborIndex].borderCenter;
+   if(corners.size() == 0 || corners.last() != lefts.last())
+      corners.push_back(lefts.last());
 }
 
 
+// Corners come back in the order we'll fly them, ending with to; from is not included.  A path through a teleporter
+// has the teleporter as one of its corners, and picks up again from wherever the teleporter drops us.
+void AStar::findCorners(const Vector<BotNavMeshZone *> *zones, const Vector<U16> &zonePath,
+                        const Point &from, const Point &to, Vector<Point> &corners)
+{
+   static Vector<Point> lefts;      // Reused to save allocations
+   static Vector<Point> rights;
+
+   corners.clear();
+   lefts.clear();
+   rights.clear();
+
+   lefts.push_back(from);
+   rights.push_back(from);
+
+   for(S32 i = 0; i < zonePath.size() - 1; i++)
+   {
+      BotNavMeshZone *zone = zones->get(zonePath[i]);
+      S32 neighborIndex = zone->getNeighborIndex(zonePath[i + 1]);
+      TNLAssert(neighborIndex >= 0, "Invalid neighbor index!!");
+
+      const NeighboringZone &neighbor = zone->mNeighbors[neighborIndex];
+
+      if(neighbor.isTeleporter)
+      {
+         lefts.push_back(neighbor.borderStart);
+         rights.push_back(neighbor.borderStart);
+         pullString(lefts, rights, corners);
+
+         lefts.clear();
+         rights.clear();
+
+         lefts.push_back(neighbor.borderEnd);
+         rights.push_back(neighbor.borderEnd);
+         continue;
+      }
+
+      // Pull the ends of the border in a bit, but never so far that they pass each other
+      Point dir = neighbor.borderEnd - neighbor.borderStart;
+      F32 len = dir.len();
+      dir.normalize(min(CornerMargin, len / 2));
+
+      Point start = neighbor.borderStart + dir;
+      Point end = neighbor.borderEnd - dir;
+
+      // The next zone is on one side of the border; facing that way tells us which end is on our left.  Zones are
+      // convex, so any of their corners that aren't on the border are all on the same side of it.
+      const Vector<Point> *outline = zones->get(zonePath[i + 1])->getOutline();
+      F32 side = 0;
+
+      for(S32 j = 0; j < outline->size(); j++)
+         side += triArea2(start, end, outline->get(j));
+
+      if(side > 0)
+      {
+         lefts.push_back(start);
+         rights.push_back(end);
+      }
+      else
+      {
+         lefts.push_back(end);
+         rights.push_back(start);
+      }
+   }
+
+   lefts.push_back(to);
+   rights.push_back(to);
+   pullString(lefts, rights, corners);
+}
+
 };
 
 
@@ -36,6 +36,7 @@ public:
    Point borderCenter;     // Simply a point half way between borderStart and borderEnd
    Point center;           // Center of zone
    F32 distTo;
+   bool isTeleporter;      // One-way link through a teleporter; borderStart is its origin, borderEnd where it drops us
 };
 
 
@@ -97,11 +98,15 @@ class AStar
 {
 private:
    static F32 heuristic(const Vector<BotNavMeshZone *> *zones, S32 fromZone, S32 toZone);
-   static Point findGateway(const Vector<BotNavMeshZone *> *zones, S32 zone1, S32 zone2);
+   static void pullString(const Vector<Point> &lefts, const Vector<Point> &rights, Vector<Point> &corners);
 
 public:
-   static Vector<Point> findPath (const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone, const Point &target);
-   
+   // Zones to fly through to get from startZone to targetZone, both included; empty if there's no way there
+   static Vector<U16> findZonePath(const Vector<BotNavMeshZone *> *zones, S32 startZone, S32 targetZone);
+
+   // Shortest line from one point to another through the zones of a zone path, as the list of corners it turns at
+   static void findCorners(const Vector<BotNavMeshZone *> *zones, const Vector<U16> &zonePath,
+                           const Point &from, const Point &to, Vector<Point> &corners);
 };
 
 
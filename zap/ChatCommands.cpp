@@ -11,6 +11,7 @@
 #include "LevelDatabaseRateThread.h"
 #include "LevelSource.h"
 #include "LevelSpecifierEnum.h"
+#include "ServerGame.h"
 
 #include "UIManager.h"
 #include "UIGame.h"
@@ -379,7 +380,7 @@ void showPathsHandler(ClientGame *game, const Vector<string> &words)
 void pauseBotsHandler(ClientGame *game, const Vector<string> &words)
 {
    if(isLocalTestServer(game, "!!! Robots can only be frozen on a test server")) 
-      EventManager::get()->togglePauseStatus();
+      game->getServerGame()->getEventManager()->togglePauseStatus();
 }
 
 
@@ -389,7 +390,7 @@ void stepBotsHandler(ClientGame *game, const Vector<string> &words)
    if(isLocalTestServer(game, "!!! Robots can only be stepped on a test server")) 
    {
       S32 steps = words.size() > 1 ? atoi(words[1].c_str()) : 1;
-      EventManager::get()->addSteps(steps);
+      game->getServerGame()->getEventManager()->addSteps(steps);
    }
 }
 
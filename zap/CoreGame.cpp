@@ -799,7 +799,7 @@ void CoreItem::damageObject(DamageInfo *theInfo)
    if(coreDestroyed)
    {
       // Send Lua event
-      EventManager::get()->fireEvent(EventManager::CoreDestroyedEvent, this);
+      getGame()->getEventManager()->fireEvent(EventManager::CoreDestroyedEvent, this);
 
       // We've scored!
       GameType *gameType = getGame()->getGameType();
@@ -2207,8 +2207,10 @@ void Turret::idle(IdleCallPath path)
    queryRect.unionPoint(aimPos + cross * TurretPerceptionDistance);
    queryRect.unionPoint(aimPos - cross * TurretPerceptionDistance);
    queryRect.unionPoint(aimPos + mAnchorNormal * TurretPerceptionDistance);
+   TargetIndex *targetIndex = static_cast<ServerGame *>(getGame())->getTargetIndex();
+
    fillVector.clear();
-   findObjects((TestFunc)isTurretTargetType, fillVector, queryRect);    // Get all potential targets
+   targetIndex->findEnemyTargets(getTeam(), (TestFunc)isTurretTargetType, queryRect, fillVector);    // Get all potential targets
 
    BfObject *bestTarget = NULL;
    F32 bestRange = F32_MAX;
@@ -2231,9 +2233,7 @@ void Turret::idle(IdleCallPath path)
          if(static_cast<MountableItem *>(fillVector[i])->isMounted())
             continue;
       
-      BfObject *potential = static_cast<BfObject *>(fillVector[i]);
-      if(potential->getTeam() == getTeam())     // Is target on our team?
-         continue;                              // ...if so, skip it!
+      BfObject *potential = static_cast<BfObject *>(fillVector[i]);    // Never on our team, see findEnemyTargets()
 
       // Calculate where we have to shoot to hit this...
       Point Vs = potential->getVel();
@@ -2258,11 +2258,11 @@ void Turret::idle(IdleCallPath path)
          continue;
 
       // See if we can see it...
-      Point n;
-      if(findObjectLOS((TestFunc)isWallType, ActualState, aimPos, potential->getPos(), t, n))
+      if(!targetIndex->canSee(this, aimPos, potential, TargetIndex::BlockedByWalls))
          continue;
 
       // See if we're gonna clobber our own stuff...
+      Point n;
       disableCollision();
       Point delta2 = delta;
       delta2.normalize(WeaponInfo::getWeaponInfo(mWeaponFireType).projLiveTime * (F32)WeaponInfo::getWeaponInfo(mWeaponFireType).projVelocity / 1000.f);
@@ -25,21 +25,6 @@ namespace Zap
 {
 
 
-struct Subscription {
-   LuaScriptRunner *subscriber;
-   ScriptContext context;
-};
-
-
-// Statics:
-bool EventManager::anyPending = false; 
-static Vector<Subscription>      subscriptions         [EventManager::EventTypes];
-static Vector<Subscription>      pendingSubscriptions  [EventManager::EventTypes];
-static Vector<LuaScriptRunner *> pendingUnsubscriptions[EventManager::EventTypes];
-
-bool EventManager::mConstructed = false;  // Prevent duplicate instantiation
-
-
 struct EventDef {
    const char *name;
    const char *function;
@@ -54,17 +39,13 @@ static const EventDef eventDefs[] = {
 #undef EVENT
 };
 
-static EventManager *eventManager = NULL;   // Singleton event manager, one copy is used by all listeners
-
 
 // C++ constructor
 EventManager::EventManager()
 {
-   TNLAssert(!mConstructed, "There is only one EventManager to rule them all!");
-
+   mAnyPending = false;
    mIsPaused = false;
    mStepCount = -1;
-   mConstructed = true;
 }
 
 
@@ -81,26 +62,6 @@ EventManager::~EventManager()
 }
 
 
-void EventManager::shutdown()
-{
-   if(eventManager)
-   {
-      delete eventManager;
-      eventManager = NULL;
-   }
-}
-
-
-// Provide access to the single EventManager instance; lazily initialized
-EventManager *EventManager::get()
-{
-   if(!eventManager)
-      eventManager = new EventManager();      // Deleted in shutdown(), which is called from Game destuctor
-
-   return eventManager;
-}
-
-
 void EventManager::subscribe(LuaScriptRunner *subscriber, EventType eventType, ScriptContext context, bool failSilently)
 {
    // First, see if we're already subscribed
@@ -128,8 +89,8 @@ void EventManager::subscribe(LuaScriptRunner *subscriber, EventType eventType, S
    s.subscriber = subscriber;
    s.context = context;
 
-   pendingSubscriptions[eventType].push_back(s);
-   anyPending = true;
+   mPendingSubscriptions[eventType].push_back(s);
+   mAnyPending = true;
 
    lua_pop(L, -1);    // Remove function from stack                                  -- <<empty stack>>
 }
@@ -141,18 +102,18 @@ void EventManager::unsubscribe(LuaScriptRunner *subscriber, EventType eventType)
    {
       removeFromPendingSubscribeList(subscriber, eventType);
 
-      pendingUnsubscriptions[eventType].push_back(subscriber);
-      anyPending = true;
+      mPendingUnsubscriptions[eventType].push_back(subscriber);
+      mAnyPending = true;
    }
 }
 
 
 void EventManager::removeFromPendingSubscribeList(LuaScriptRunner *subscriber, EventType eventType)
 {
-   for(S32 i = 0; i < pendingSubscriptions[eventType].size(); i++)
-      if(pendingSubscriptions[eventType][i].subscriber == subscriber)
+   for(S32 i = 0; i < mPendingSubscriptions[eventType].size(); i++)
+      if(mPendingSubscriptions[eventType][i].subscriber == subscriber)
       {
-         pendingSubscriptions[eventType].erase_fast(i);
+         mPendingSubscriptions[eventType].erase_fast(i);
          return;
       }
 }
@@ -160,10 +121,10 @@ void EventManager::removeFromPendingSubscribeList(LuaScriptRunner *subscriber, E
 
 void EventManager::removeFromPendingUnsubscribeList(LuaScriptRunner *subscriber, EventType eventType)
 {
-   for(S32 i = 0; i < pendingUnsubscriptions[eventType].size(); i++)
-      if(pendingUnsubscriptions[eventType][i] == subscriber)
+   for(S32 i = 0; i < mPendingUnsubscriptions[eventType].size(); i++)
+      if(mPendingUnsubscriptions[eventType][i] == subscriber)
       {
-         pendingUnsubscriptions[eventType].erase_fast(i);
+         mPendingUnsubscriptions[eventType].erase_fast(i);
          return;
       }
 }
@@ -171,10 +132,10 @@ void EventManager::removeFromPendingUnsubscribeList(LuaScriptRunner *subscriber,
 
 void EventManager::removeFromSubscribedList(LuaScriptRunner *subscriber, EventType eventType)
 {
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-      if(subscriptions[eventType][i].subscriber == subscriber)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
+      if(mSubscriptions[eventType][i].subscriber == subscriber)
       {
-         subscriptions[eventType].erase_fast(i);
+         mSubscriptions[eventType].erase_fast(i);
          return;
       }
 }
@@ -192,8 +153,8 @@ void EventManager::unsubscribeImmediate(LuaScriptRunner *subscriber, EventType e
 // Check if we're subscribed to an event
 bool EventManager::isSubscribed(LuaScriptRunner *subscriber, EventType eventType)
 {
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-      if(subscriptions[eventType][i].subscriber == subscriber)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
+      if(mSubscriptions[eventType][i].subscriber == subscriber)
          return true;
 
    return false;
@@ -202,8 +163,8 @@ bool EventManager::isSubscribed(LuaScriptRunner *subscriber, EventType eventType
 
 bool EventManager::isPendingSubscribed(LuaScriptRunner *subscriber, EventType eventType)
 {
-   for(S32 i = 0; i < pendingSubscriptions[eventType].size(); i++)
-      if(pendingSubscriptions[eventType][i].subscriber == subscriber)
+   for(S32 i = 0; i < mPendingSubscriptions[eventType].size(); i++)
+      if(mPendingSubscriptions[eventType][i].subscriber == subscriber)
          return true;
 
    return false;
@@ -212,8 +173,8 @@ bool EventManager::isPendingSubscribed(LuaScriptRunner *subscriber, EventType ev
 
 bool EventManager::isPendingUnsubscribed(LuaScriptRunner *subscriber, EventType eventType)
 {
-   for(S32 i = 0; i < pendingUnsubscriptions[eventType].size(); i++)
-      if(pendingUnsubscriptions[eventType][i] == subscriber)
+   for(S32 i = 0; i < mPendingUnsubscriptions[eventType].size(); i++)
+      if(mPendingUnsubscriptions[eventType][i] == subscriber)
          return true;
 
    return false;
@@ -223,23 +184,23 @@ bool EventManager::isPendingUnsubscribed(LuaScriptRunner *subscriber, EventType
 // Process all pending subscriptions and unsubscriptions
 void EventManager::update()
 {
-   if(anyPending)
+   if(mAnyPending)
    {
       for(S32 i = 0; i < EventTypes; i++)
-         for(S32 j = 0; j < pendingUnsubscriptions[i].size(); j++)     // Unsubscribing first means less searching!
-            removeFromSubscribedList(pendingUnsubscriptions[i][j], (EventType) i);
+         for(S32 j = 0; j < mPendingUnsubscriptions[i].size(); j++)     // Unsubscribing first means less searching!
+            removeFromSubscribedList(mPendingUnsubscriptions[i][j], (EventType) i);
 
       for(S32 i = 0; i < EventTypes; i++)
-         for(S32 j = 0; j < pendingSubscriptions[i].size(); j++)     
-            subscriptions[i].push_back(pendingSubscriptions[i][j]);
+         for(S32 j = 0; j < mPendingSubscriptions[i].size(); j++)     
+            mSubscriptions[i].push_back(mPendingSubscriptions[i][j]);
 
       for(S32 i = 0; i < EventTypes; i++)
       {
-         pendingSubscriptions[i].clear();
-         pendingUnsubscriptions[i].clear();
+         mPendingSubscriptions[i].clear();
+         mPendingUnsubscriptions[i].clear();
       }
 
-      anyPending = false;
+      mAnyPending = false;
    }
 }
 
@@ -254,8 +215,8 @@ void EventManager::fireEvent(EventType eventType)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
 }
 
 
@@ -272,10 +233,10 @@ void EventManager::fireEvent(EventType eventType, U32 deltaT)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       lua_pushinteger(L, deltaT);   // -- deltaT
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -290,10 +251,10 @@ void EventManager::fireEvent(EventType eventType, CoreItem *core)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       core->push(L);                // -- core
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -308,10 +269,10 @@ void EventManager::fireEvent(EventType eventType, Ship *ship)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       ship->push(L);                // -- ship
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -326,7 +287,7 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, BfObject *damaging
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       ship->push(L);                // -- ship
 
@@ -340,7 +301,7 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, BfObject *damaging
       else
          lua_pushnil(L);
 
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -356,9 +317,9 @@ void EventManager::fireEvent(LuaScriptRunner *sender, EventType eventType, const
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
-      if(sender == subscriptions[eventType][i].subscriber)    // Don't alert sender about own message!
+      if(sender == mSubscriptions[eventType][i].subscriber)    // Don't alert sender about own message!
          continue;
 
       lua_pushstring(L, message);   // -- message
@@ -370,7 +331,7 @@ void EventManager::fireEvent(LuaScriptRunner *sender, EventType eventType, const
 
       lua_pushboolean(L, global);   // -- message, player, isGlobal
 
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -385,13 +346,13 @@ void EventManager::fireEvent(LuaScriptRunner *player, EventType eventType, LuaPl
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
-      if(player == subscriptions[eventType][i].subscriber)    // Don't trouble player with own joinage or leavage!
+      if(player == mSubscriptions[eventType][i].subscriber)    // Don't trouble player with own joinage or leavage!
          continue;
 
       playerInfo->push(L);          // -- playerInfo
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -406,7 +367,7 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, Zone *zone)
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       try   
       {
@@ -416,11 +377,11 @@ void EventManager::fireEvent(EventType eventType, Ship *ship, Zone *zone)
          lua_pushinteger(L, zone->getObjectTypeNumber());   // -- ship, zone, zone->objTypeNumber
          lua_pushinteger(L, zone->getUserAssignedId());     // -- ship, zone, zone->objTypeNumber, zone->id
 
-         fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+         fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
       }
       catch(LuaException &e)
       {
-         handleEventFiringError(L, subscriptions[eventType][i], eventType, e.what());
+         handleEventFiringError(L, mSubscriptions[eventType][i], eventType, e.what());
          clearStack(L);
          return;
       }
@@ -438,7 +399,7 @@ void EventManager::fireEvent(EventType eventType, MoveObject *object, Zone *zone
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       try   
       {
@@ -448,11 +409,11 @@ void EventManager::fireEvent(EventType eventType, MoveObject *object, Zone *zone
          lua_pushinteger(L, zone->getObjectTypeNumber());   // -- object, zone, zone->objTypeNumber
          lua_pushinteger(L, zone->getUserAssignedId());     // -- object, zone, zone->objTypeNumber, zone->id
 
-         fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+         fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
       }
       catch(LuaException &e)
       {
-         handleEventFiringError(L, subscriptions[eventType][i], eventType, e.what());
+         handleEventFiringError(L, mSubscriptions[eventType][i], eventType, e.what());
          clearStack(L);
          return;
       }
@@ -470,7 +431,7 @@ void EventManager::fireEvent(EventType eventType, S32 score, S32 team, LuaPlayer
 
    TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack dirty!");
 
-   for(S32 i = 0; i < subscriptions[eventType].size(); i++)
+   for(S32 i = 0; i < mSubscriptions[eventType].size(); i++)
    {
       lua_pushinteger(L, score);   // -- score
       lua_pushinteger(L, team);    // -- score, team
@@ -480,7 +441,7 @@ void EventManager::fireEvent(EventType eventType, S32 score, S32 team, LuaPlayer
       else
          lua_pushnil(L);
 
-      fire(L, subscriptions[eventType][i].subscriber, eventDefs[eventType].function, subscriptions[eventType][i].context);
+      fire(L, mSubscriptions[eventType][i].subscriber, eventDefs[eventType].function, mSubscriptions[eventType][i].context);
    }
 }
 
@@ -514,7 +475,7 @@ void EventManager::handleEventFiringError(lua_State *L, const Subscription &subs
 // If true, events will not fire!
 bool EventManager::suppressEvents(EventType eventType)
 {
-   if(subscriptions[eventType].size() == 0)
+   if(mSubscriptions[eventType].size() == 0)
       return true;
 
    return mIsPaused && mStepCount <= 0;    // Paused bots should still respond to events as long as stepCount > 0
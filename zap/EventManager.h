@@ -25,8 +25,13 @@ class Robot;
 class Ship;
 class Zone;
 
-struct Subscription; 
+struct Subscription {
+   LuaScriptRunner *subscriber;
+   ScriptContext context;
+};
+
 
+// Each Game has its own EventManager, so scripts only hear about what happens in the game they're running in
 class EventManager
 {
 /**
@@ -83,25 +88,21 @@ private:
    void handleEventFiringError(lua_State *L, const Subscription &subscriber, EventType eventType, const char *errorMsg);
    bool fire(lua_State *L, LuaScriptRunner *scriptRunner, const char *function, ScriptContext context);
       
+   Vector<Subscription>      mSubscriptions         [EventTypes];
+   Vector<Subscription>      mPendingSubscriptions  [EventTypes];
+   Vector<LuaScriptRunner *> mPendingUnsubscriptions[EventTypes];
+   bool mAnyPending;
+
    bool mIsPaused;
    S32 mStepCount;           // If running for a certain number of steps, this will be > 0, while mIsPaused will be true
-   static bool mConstructed;
 
 public:
    EventManager();                       // C++ constructor
    explicit EventManager(lua_State *L);  // Lua Constructor
    virtual ~EventManager();
 
-   static void shutdown();
-
-   static EventManager *get();         // Provide access to the single EventManager instance
    bool suppressEvents(EventType eventType);
 
-   //static Vector<Subscription> subscriptions[EventTypes];
-   //static Vector<Subscription> pendingSubscriptions[EventTypes];
-   //static Vector<pendingUnsubscriptions *> pendingUnsubscriptions[EventTypes];
-   static bool anyPending;
-
    void subscribe  (LuaScriptRunner *subscriber, EventType eventType, ScriptContext context, bool failSilently = false);
    void unsubscribe(LuaScriptRunner *subscriber, EventType eventType);
 
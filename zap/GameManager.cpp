@@ -18,11 +18,10 @@ namespace Zap
 {
 
 // Declare statics
-ServerGame *GameManager::mServerGame = NULL;
+Vector<ServerGame *> GameManager::mServerGames;
 #ifndef ZAP_DEDICATED
    Vector<ClientGame *> GameManager::mClientGames;
 #endif
-GameManager::HostingModePhase GameManager::mHostingModePhase = GameManager::NotHosting;
 
 
 // Constructor
@@ -41,31 +40,56 @@ GameManager::~GameManager()
 
 ServerGame *GameManager::getServerGame()
 {
-   return mServerGame;
+   return mServerGames.size() > 0 ? mServerGames[0] : NULL;
 }
 
 
 void GameManager::setServerGame(ServerGame *serverGame)
 {
    TNLAssert(serverGame, "Expect a valid serverGame here!");
-   TNLAssert(!mServerGame, "Already have a ServerGame!");
+   TNLAssert(mServerGames.size() == 0, "Already have a ServerGame!");
 
-   mServerGame = serverGame;
+   mServerGames.push_back(serverGame);
+}
+
+
+// Extra games each have their own port, settings and levels, but share everything that doesn't change, like the
+// Lua interpreter and the class tables, with the main game
+void GameManager::addServerGame(ServerGame *serverGame)
+{
+   TNLAssert(serverGame, "Expect a valid serverGame here!");
+   TNLAssert(mServerGames.size() > 0, "Need a main game before adding others!");
+
+   mServerGames.push_back(serverGame);
+}
+
+
+const Vector<ServerGame *> *GameManager::getServerGames()
+{
+   return &mServerGames;
 }
 
 
 void GameManager::deleteServerGame()
 {
-   // mServerGame might be NULL here; for example when quitting after losing a connection to the game server
-   delete mServerGame;     // Kill the serverGame (leaving the clients running)
-   mServerGame = NULL;
+   // There might not be any games here; for example when quitting after losing a connection to the game server
+   mServerGames.deleteAndClear();      // Kill the serverGames (leaving the clients running)
+}
+
+
+void GameManager::deleteServerGame(ServerGame *serverGame)
+{
+   S32 index = mServerGames.getIndex(serverGame);
+   TNLAssert(index >= 0, "Not one of our games!");
+
+   mServerGames.deleteAndErase(index);
 }
 
 
 void GameManager::idleServerGame(U32 timeDelta)
 {
-   if(mServerGame)
-      mServerGame->idle(timeDelta);
+   for(S32 i = 0; i < mServerGames.size(); i++)
+      mServerGames[i]->idle(timeDelta);
 }
 
 
@@ -114,13 +138,14 @@ void GameManager::idle(U32 timeDelta)
 
 void GameManager::setHostingModePhase(HostingModePhase phase)
 {
-   mHostingModePhase = phase;
+   if(getServerGame())
+      getServerGame()->setHostingModePhase(phase);
 }
 
 
 GameManager::HostingModePhase GameManager::getHostingModePhase()
 {
-   return mHostingModePhase;
+   return getServerGame() ? getServerGame()->getHostingModePhase() : NotHosting;
 }
 
 
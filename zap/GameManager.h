@@ -31,21 +31,22 @@ public:
    };
 
 private:
-   static ServerGame *mServerGame;
+   static Vector<ServerGame *> mServerGames;    // The first is the main game; any others are hosted alongside it
 #ifndef ZAP_DEDICATED
    static Vector<ClientGame *> mClientGames;
 #endif
 
-   static HostingModePhase mHostingModePhase;
-
 public:
    GameManager();
    virtual ~GameManager();
 
    // ServerGame related
-   static void setServerGame(ServerGame *serverGame);
-   static ServerGame *getServerGame();
-   static void deleteServerGame();
+   static void setServerGame(ServerGame *serverGame);       // Set the main game
+   static ServerGame *getServerGame();                      // Get the main game
+   static void addServerGame(ServerGame *serverGame);       // Host another game in this process
+   static const Vector<ServerGame *> *getServerGames();     // Main game first
+   static void deleteServerGame();                          // Delete all games
+   static void deleteServerGame(ServerGame *serverGame);    // Delete specified game
    static void idleServerGame(U32 timeDelta);
 
    // ClientGame related
@@ -60,7 +61,7 @@ public:
 
    // Other
    static void idle(U32 timeDelta);
-   static void setHostingModePhase(HostingModePhase);
+   static void setHostingModePhase(HostingModePhase);    // Of the main game
    static HostingModePhase getHostingModePhase();
 };
 
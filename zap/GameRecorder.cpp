@@ -187,11 +187,14 @@ GameRecorderServer::GameRecorderServer(ServerGame *game)
       mConnectionParameters.mIsInitiator = false;
       mConnectionParameters.mDebugObjectSizes = false;
 
+      // Every packet counts as received as soon as it's written, so recordings can always use deltas
+      setGhostDeltaCompression(game->getSettings()->getIniSettings()->enableGhostDeltaCompression);
+
       U8 *data = mWriter->getBuffer(4);
       data[0] = CS_PROTOCOL_VERSION;
       data[1] = U8(mGhostClassCount);
       data[2] = U8(mEventClassCount);
-      data[3] = U8(mEventClassCount >> 8) | 0x10;
+      data[3] = U8(mEventClassCount >> 8) | 0x10 | (isGhostDeltaCompression() ? 0x20 : 0);
       mWriter->addBuffer(4);
       gameRecorderScoping(this, game);
 
@@ -95,6 +95,11 @@ GameRecorderPlayback::GameRecorderPlayback(ClientGame *game, const char *filenam
          mPackUnpackShipEnergyMeter = true;
          mEventClassCount &= ~0x1000;
       }
+      if(mEventClassCount & 0x2000)
+      {
+         setGhostDeltaCompression(true);
+         mEventClassCount &= ~0x2000;
+      }
       if(data[0] != CS_PROTOCOL_VERSION || 
          mEventClassCount > NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeEvent) || 
          mGhostClassCount > NetClassRep::getNetClassCount(getNetClassGroup(), NetClassTypeObject))
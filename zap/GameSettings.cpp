@@ -156,6 +156,7 @@ const char *helpTitles[] = {
 ////////////////////////////////////////
 // Define statics
 FolderManager *GameSettings::mFolderManager = NULL;
+S32 GameSettings::mInstanceCount = 0;
 
 // List of controllers we found attached to this machine.  This contains the
 // Controller index as the key, the name as the value
@@ -170,6 +171,8 @@ CIniFile GameSettings::userPrefs("dummy");               // Our INI file.  Real
 // Constructor
 GameSettings::GameSettings()
 {
+   mInstanceCount++;
+
    mBanList = new BanList(getFolderManager()->iniDir);
    mLoadoutPresets.resize(LoadoutPresetCount);   // Make sure we have the right number of slots available
 }
@@ -179,7 +182,10 @@ GameSettings::GameSettings()
 GameSettings::~GameSettings()
 {
    delete mBanList;
-   if(mFolderManager)
+
+   mInstanceCount--;
+
+   if(mInstanceCount == 0 && mFolderManager)
    {
       delete mFolderManager;
       mFolderManager = NULL;
@@ -121,6 +121,7 @@ private:
 
    Vector<string> mLevelSkipList;      // Levels we'll never load, to create a pseudo delete function for remote server mgt  <=== does this ever get loaded???
    static FolderManager *mFolderManager;
+   static S32 mInstanceCount;          // The FolderManager is shared, so the last GameSettings to go deletes it
    InputCodeManager mInputCodeManager;
 
    BanList *mBanList;                  // Our ban list
@@ -35,12 +35,61 @@ void checkArgCount(lua_State *L, S32 argsWanted, const char *methodName)
 }
 
 
+// Every Lua-bound method starts by finding its parameter profile by name, which used to mean strcmp'ing its way
+// through the class's function table on every call -- and bots make thousands of calls a second.  But each call site
+// always passes the same table and the same string literal, so once a call site has found its profile, we remember
+// it against those two pointers.  From then on, finding it is a hash and a compare.
+struct ArgListCacheEntry
+{
+   const void *table;                  // Function table or module name the profile was found in
+   const char *functionName;
+   const LuaFunctionArgList *functionArgList;
+};
+
+static const U32 ArgListCacheSize = 1024;      // Must be a power of 2; we have a couple hundred call sites
+static ArgListCacheEntry argListCache[ArgListCacheSize];
+
+
+// Returns the slot the entry for table/functionName is in, or should go in; NULL if the cache is full
+static ArgListCacheEntry *findArgListCacheEntry(const void *table, const char *functionName)
+{
+   size_t hash = (size_t(functionName) >> 2) * 2654435761u ^ (size_t(table) >> 4);
+
+   for(U32 i = 0; i < ArgListCacheSize; i++)
+   {
+      ArgListCacheEntry *entry = &argListCache[(hash + i) & (ArgListCacheSize - 1)];
+
+      if(!entry->table || (entry->table == table && entry->functionName == functionName))
+         return entry;
+   }
+
+   return NULL;
+}
+
+
+static void cacheArgList(ArgListCacheEntry *entry, const void *table, const char *functionName, 
+                         const LuaFunctionArgList *functionArgList)
+{
+   if(!entry)
+      return;
+
+   entry->table = table;
+   entry->functionName = functionName;
+   entry->functionArgList = functionArgList;
+}
+
+
 // === Centralized Parameter Checking ===
 // Returns index of matching parameter profile; throws error if it can't find one.  If you get a valid profile index back,
 // you can blindly convert the stack items with the confidence you'll get what you want; no further type checking is required.
 // In writing this function, I tried to be extra clear, perhaps at the expense of slight redundancy.
 S32 checkArgList(lua_State *L, const LuaFunctionProfile *functionInfos, const char *className, const char *functionName)
 {
+   ArgListCacheEntry *entry = findArgListCacheEntry(functionInfos, functionName);
+
+   if(entry && entry->table)
+      return checkArgList(L, *entry->functionArgList, className, functionName);
+
    const LuaFunctionProfile *functionInfo = NULL;
 
    // First, find the correct profile for this function
@@ -54,13 +103,20 @@ S32 checkArgList(lua_State *L, const LuaFunctionProfile *functionInfos, const ch
    if(!functionInfo)
       return -1;
 
+   cacheArgList(entry, functionInfos, functionName, &functionInfo->functionArgList);
+
    return checkArgList(L, functionInfo->functionArgList, className, functionName);
 }
 
 
 S32 checkArgList(lua_State *L, const char *moduleName, const char *functionName)
 {
-   ProfileMap profileMap = LuaModuleRegistrarBase::getModuleProfiles();
+   ArgListCacheEntry *entry = findArgListCacheEntry(moduleName, functionName);
+
+   if(entry && entry->table)
+      return checkArgList(L, *entry->functionArgList, moduleName, functionName);
+
+   ProfileMap &profileMap = LuaModuleRegistrarBase::getModuleProfiles();
 
    ProfileMap::iterator iter = profileMap.find(string(moduleName));
    if(iter != profileMap.end())
@@ -70,6 +126,7 @@ S32 checkArgList(lua_State *L, const char *moduleName, const char *functionName)
       {
          if(!strcmp(profiles[i].functionName, functionName))
          {
+            cacheArgList(entry, moduleName, functionName, &profiles[i].functionArgList);
             return checkArgList(L, profiles[i].functionArgList, moduleName, functionName);
          }
       }
@@ -196,6 +196,8 @@ void setScriptContext(lua_State *L, ScriptContext context);
 
 /////
 // Documenting and help
+// The profile each call site finds is remembered against the functionName (and moduleName) pointers, so these must be
+// string literals, as they are everywhere now
 S32 checkArgList(lua_State *L, const LuaFunctionProfile *functionInfos,   const char *className, const char *functionName);
 S32 checkArgList(lua_State *L, const LuaFunctionArgList &functionArgList, const char *className, const char *functionName);
 S32 checkArgList(lua_State *L, const char *moduleName, const char *functionName);
@@ -0,0 +1,368 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LuaObjectQuery.h"
+
+#include "BfObject.h"
+#include "gridDB.h"
+#include <new>             // For placement new
+
+namespace Zap
+{
+
+// What the iterator function keeps between calls; lives in a userdata so Lua tells us when it's done with it
+struct QueryCursor
+{
+   RefPtr<LuaObjectQuery> query;
+   const Vector<DatabaseObject *> *objects;     // The query's results, or our own survivors once anything's been removed
+   const Vector<S32> *serialNumbers;            // And their serial numbers
+   Vector<DatabaseObject *> survivors;
+   Vector<S32> survivorSerialNumbers;
+   S32 index;
+
+   U32 removalCount;                            // Database removal counts objects was last known to be good for
+   U32 botZoneRemovalCount;
+};
+
+static const char *CursorMetatable = "LuaObjectQuery.Cursor";
+
+
+Vector<RefPtr<LuaObjectQuery> > LuaObjectQuery::mCache;
+S32 LuaObjectQuery::mNextCacheSlot = 0;
+
+
+// Constructor -- runs the search
+LuaObjectQuery::LuaObjectQuery(GridDatabase *database, GridDatabase *botZoneDatabase, const Vector<U8> &types, const Rect *area)
+{
+   mDatabase = database;
+   mBotZoneDatabase = botZoneDatabase;
+   mDatabaseId = database->getDatabaseId();
+   mBotZoneDatabaseId = botZoneDatabase ? botZoneDatabase->getDatabaseId() : 0;
+
+   mTypes = types;
+   mHasArea = area != NULL;
+
+   if(area)
+      mArea = *area;
+
+   mChangeCount = getChangeCount(database);
+   mBotZoneChangeCount = botZoneDatabase ? getChangeCount(botZoneDatabase) : 0;
+   mRemovalCount = getRemovalCount(database);
+   mBotZoneRemovalCount = getRemovalCount(botZoneDatabase);
+
+   // Bot zones first, as findAllObjects() has always returned them
+   if(botZoneDatabase)
+   {
+      if(area)
+         botZoneDatabase->findObjects(BotNavMeshZoneTypeNumber, mObjects, *area);
+      else
+         botZoneDatabase->findObjects(BotNavMeshZoneTypeNumber, mObjects);
+   }
+
+   if(area)
+      database->findObjects(types, mObjects, *area);
+   else if(types.size() > 0)
+      database->findObjects(types, mObjects);
+   else if(!botZoneDatabase)        // No types at all means everything
+      database->findObjects(mObjects);
+
+   mSerialNumbers.resize(mObjects.size());
+   for(S32 i = 0; i < mObjects.size(); i++)
+      mSerialNumbers[i] = static_cast<BfObject *>(mObjects[i])->getSerialNumber();
+}
+
+
+// Destructor
+LuaObjectQuery::~LuaObjectQuery()
+{
+   // Do nothing
+}
+
+
+// Area searches care about things moving; whole-level searches only about things coming and going
+U32 LuaObjectQuery::getChangeCount(const GridDatabase *database) const
+{
+   return mHasArea ? database->getChangeCount() : database->getMembershipChangeCount();
+}
+
+
+bool LuaObjectQuery::matches(const GridDatabase *database, const GridDatabase *botZoneDatabase,
+                             const Vector<U8> &types, const Rect *area) const
+{
+   if(database != mDatabase || botZoneDatabase != mBotZoneDatabase || (area != NULL) != mHasArea)
+      return false;
+
+   // Databases come and go with levels, and a new one may well land at the same address
+   if(database->getDatabaseId() != mDatabaseId || (botZoneDatabase && botZoneDatabase->getDatabaseId() != mBotZoneDatabaseId))
+      return false;
+
+   if(area && !(*area == mArea))
+      return false;
+
+   if(types.size() != mTypes.size())
+      return false;
+
+   for(S32 i = 0; i < types.size(); i++)
+      if(types[i] != mTypes[i])
+         return false;
+
+   return true;
+}
+
+
+// Would running the search again give the same answer?  Only call this on a query that matches() a live database.
+bool LuaObjectQuery::isCurrent() const
+{
+   return getChangeCount(mDatabase) == mChangeCount &&
+          (!mBotZoneDatabase || getChangeCount(mBotZoneDatabase) == mBotZoneChangeCount);
+}
+
+
+LuaObjectQuery *LuaObjectQuery::find(GridDatabase *database, GridDatabase *botZoneDatabase, const Vector<U8> &types, const Rect *area)
+{
+   // Put the types in order, and drop any repeats, so the same question asked two ways shares its answer
+   static Vector<U8> sortedTypes;
+   sortedTypes.clear();
+
+   for(S32 i = 0; i < types.size(); i++)
+   {
+      S32 j = 0;
+      while(j < sortedTypes.size() && sortedTypes[j] < types[i])
+         j++;
+
+      if(j == sortedTypes.size() || sortedTypes[j] != types[i])
+         sortedTypes.insert(j, types[i]);
+   }
+
+   S32 slot = -1;
+
+   for(S32 i = 0; i < mCache.size(); i++)
+      if(mCache[i]->matches(database, botZoneDatabase, sortedTypes, area))
+      {
+         if(mCache[i]->isCurrent())
+            return mCache[i];
+
+         slot = i;      // Stale; replace it.  Any iterators still using the old results keep them alive.
+         break;
+      }
+
+   LuaObjectQuery *query = new LuaObjectQuery(database, botZoneDatabase, sortedTypes, area);
+
+   if(slot == -1)
+   {
+      if(mCache.size() < MaxCachedQueries)
+      {
+         slot = mCache.size();
+         mCache.push_back(RefPtr<LuaObjectQuery>());
+      }
+      else
+      {
+         slot = mNextCacheSlot;
+         mNextCacheSlot = (mNextCacheSlot + 1) % MaxCachedQueries;
+      }
+   }
+
+   mCache[slot] = query;
+
+   return query;
+}
+
+
+void LuaObjectQuery::clearCache()
+{
+   mCache.clear();
+   mNextCacheSlot = 0;
+}
+
+
+S32 LuaObjectQuery::size() const
+{
+   return mObjects.size();
+}
+
+
+BfObject *LuaObjectQuery::get(S32 index) const
+{
+   DatabaseObject *object = mObjects[index];
+
+   if(object->isDeleted())
+      return NULL;
+
+   return static_cast<BfObject *>(object);
+}
+
+
+U32 LuaObjectQuery::getRemovalCount(const GridDatabase *database) const
+{
+   return database ? database->getRemovalCount() : 0;
+}
+
+
+// Only call this on an object known to still be in one of our databases.  Checks the serial number and type, as
+// whatever is at this address now may not be what we found there.
+bool LuaObjectQuery::isLive(DatabaseObject *object, S32 serialNumber) const
+{
+   if(object->isDeleted() || static_cast<BfObject *>(object)->getSerialNumber() != serialNumber)
+      return false;
+
+   U8 type = object->getObjectTypeNumber();
+
+   if(type == BotNavMeshZoneTypeNumber)
+      return mBotZoneDatabase != NULL;
+
+   if(mTypes.size() == 0)
+      return mBotZoneDatabase == NULL;     // No types at all means everything
+
+   for(S32 i = 0; i < mTypes.size(); i++)
+      if(mTypes[i] == type)
+         return true;
+
+   return false;
+}
+
+
+static bool pointerLessThan(DatabaseObject * const &a, DatabaseObject * const &b)
+{
+   return a < b;
+}
+
+
+static bool containsPointer(const Vector<DatabaseObject *> &sortedObjects, DatabaseObject *object)
+{
+   S32 low = 0;
+   S32 high = sortedObjects.size() - 1;
+
+   while(low <= high)
+   {
+      S32 mid = (low + high) / 2;
+
+      if(sortedObjects[mid] == object)
+         return true;
+
+      if(sortedObjects[mid] < object)
+         low = mid + 1;
+      else
+         high = mid - 1;
+   }
+
+   return false;
+}
+
+
+// Copies objects[start] onwards into survivors, leaving out anything no longer in our databases.  Any pointer we
+// keep points at a live object, though not necessarily the one we found; isLive() sorts that out.
+void LuaObjectQuery::findSurvivors(const Vector<DatabaseObject *> &objects, const Vector<S32> &serialNumbers, S32 start,
+                                   Vector<DatabaseObject *> &survivors, Vector<S32> &survivorSerialNumbers) const
+{
+   static Vector<DatabaseObject *> present;
+
+   present = *mDatabase->findObjects_fast();
+
+   if(mBotZoneDatabase)
+   {
+      const Vector<DatabaseObject *> *botZones = mBotZoneDatabase->findObjects_fast();
+
+      for(S32 i = 0; i < botZones->size(); i++)
+         present.push_back(botZones->get(i));
+   }
+
+   present.sort(pointerLessThan);
+
+   // Build into scratch lists first; objects may well be survivors itself
+   static Vector<DatabaseObject *> kept;
+   static Vector<S32> keptSerialNumbers;
+   kept.clear();
+   keptSerialNumbers.clear();
+
+   for(S32 i = start; i < objects.size(); i++)
+      if(containsPointer(present, objects[i]))
+      {
+         kept.push_back(objects[i]);
+         keptSerialNumbers.push_back(serialNumbers[i]);
+      }
+
+   survivors = kept;
+   survivorSerialNumbers = keptSerialNumbers;
+}
+
+
+S32 LuaObjectQuery::pushIterator(lua_State *L)
+{
+   QueryCursor *cursor = new(lua_newuserdata(L, sizeof(QueryCursor))) QueryCursor();    // -- cursor
+   cursor->query = this;
+   cursor->objects = &mObjects;
+   cursor->serialNumbers = &mSerialNumbers;
+   cursor->index = 0;
+   cursor->removalCount = mRemovalCount;
+   cursor->botZoneRemovalCount = mBotZoneRemovalCount;
+
+   if(luaL_newmetatable(L, CursorMetatable))                                        // -- cursor, mt
+   {
+      lua_pushcfunction(L, deleteCursor);                                           // -- cursor, mt, fn
+      lua_setfield(L, -2, "__gc");                                                  // -- cursor, mt
+   }
+
+   lua_setmetatable(L, -2);                                                         // -- cursor
+   lua_pushcclosure(L, nextObject, 1);                                              // -- iterator
+
+   return 1;
+}
+
+
+// The iterator itself; the cursor is its only upvalue
+S32 LuaObjectQuery::nextObject(lua_State *L)
+{
+   QueryCursor *cursor = static_cast<QueryCursor *>(lua_touserdata(L, lua_upvalueindex(1)));
+   LuaObjectQuery *query = cursor->query;
+
+   if(!query)
+   {
+      lua_pushnil(L);
+      return 1;
+   }
+
+   // Something's been removed -- very likely by the script itself -- and possibly freed.  Rare enough that we
+   // can afford to check what's left against the database.
+   if(query->getRemovalCount(query->mDatabase) != cursor->removalCount ||
+      query->getRemovalCount(query->mBotZoneDatabase) != cursor->botZoneRemovalCount)
+   {
+      query->findSurvivors(*cursor->objects, *cursor->serialNumbers, cursor->index, cursor->survivors, cursor->survivorSerialNumbers);
+
+      cursor->objects = &cursor->survivors;
+      cursor->serialNumbers = &cursor->survivorSerialNumbers;
+      cursor->index = 0;
+      cursor->removalCount = query->getRemovalCount(query->mDatabase);
+      cursor->botZoneRemovalCount = query->getRemovalCount(query->mBotZoneDatabase);
+   }
+
+   while(cursor->index < cursor->objects->size())
+   {
+      DatabaseObject *object = cursor->objects->get(cursor->index);
+      S32 serialNumber = cursor->serialNumbers->get(cursor->index);
+      cursor->index++;
+
+      if(query->isLive(object, serialNumber))
+      {
+         static_cast<BfObject *>(object)->push(L);
+         return 1;
+      }
+   }
+
+   cursor->query = NULL;      // All done; let the results go now, rather than whenever the garbage collector gets to us
+   cursor->survivors.clear();
+   cursor->survivorSerialNumbers.clear();
+   lua_pushnil(L);
+   return 1;
+}
+
+
+S32 LuaObjectQuery::deleteCursor(lua_State *L)
+{
+   static_cast<QueryCursor *>(lua_touserdata(L, 1))->~QueryCursor();
+   return 0;
+}
+
+
+};
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LUA_OBJECT_QUERY_H_
+#define _LUA_OBJECT_QUERY_H_
+
+#include "LuaInc.h"
+#include "Rect.h"
+
+#include "tnlNetBase.h"    // For RefPtrData
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class BfObject;
+class DatabaseObject;
+class GridDatabase;
+
+// The results of one findAllObjects()-style search, kept around so that other scripts asking the same question
+// can share them.  All the robots run their onTick()s back to back, and nothing moves while they do, so a dozen
+// bots looking for ships in the same tick cost one database search rather than a dozen.
+//
+// Whole-level results stay good until something is added to or removed from the database; results for an area
+// also go stale when anything moves, so in practice they last for the rest of the tick.
+//
+// Results are just object pointers; nothing is pushed into Lua until a script asks for that particular object.
+// Iterators check, before each step, whether anything has left the database since the search, as a script removing
+// objects as it goes would otherwise leave them holding pointers to freed memory.  A new object may since have been
+// allocated at the same address (pooled objects reuse the most recently freed slot first), so we also keep each
+// object's serial number, and only hand over an object whose serial number still matches.
+class LuaObjectQuery : public RefPtrData
+{
+private:
+   static const S32 MaxCachedQueries = 32;
+
+   static Vector<RefPtr<LuaObjectQuery> > mCache;
+   static S32 mNextCacheSlot;
+
+   GridDatabase *mDatabase;
+   GridDatabase *mBotZoneDatabase;     // NULL unless bot zones were asked for, as they live in a database of their own
+
+   U32 mDatabaseId;
+   U32 mBotZoneDatabaseId;
+
+   Vector<U8> mTypes;                  // Sorted, and never includes BotNavMeshZoneTypeNumber
+   bool mHasArea;
+   Rect mArea;
+
+   U32 mChangeCount;                   // Database's change counts when the search was run
+   U32 mBotZoneChangeCount;
+   U32 mRemovalCount;
+   U32 mBotZoneRemovalCount;
+
+   Vector<DatabaseObject *> mObjects;
+   Vector<S32> mSerialNumbers;         // Serial numbers of mObjects, as they were when we found them
+
+   LuaObjectQuery(GridDatabase *database, GridDatabase *botZoneDatabase, const Vector<U8> &types, const Rect *area);
+
+   bool matches(const GridDatabase *database, const GridDatabase *botZoneDatabase, const Vector<U8> &types, const Rect *area) const;
+   bool isCurrent() const;
+   U32 getChangeCount(const GridDatabase *database) const;
+   U32 getRemovalCount(const GridDatabase *database) const;
+
+   bool isLive(DatabaseObject *object, S32 serialNumber) const;
+   void findSurvivors(const Vector<DatabaseObject *> &objects, const Vector<S32> &serialNumbers, S32 start,
+                      Vector<DatabaseObject *> &survivors, Vector<S32> &survivorSerialNumbers) const;
+
+   static S32 nextObject(lua_State *L);
+   static S32 deleteCursor(lua_State *L);
+
+public:
+   virtual ~LuaObjectQuery();    // Destructor
+
+   // Pass a NULL area to search the whole level
+   static LuaObjectQuery *find(GridDatabase *database, GridDatabase *botZoneDatabase, const Vector<U8> &types, const Rect *area);
+   static void clearCache();
+
+   S32 size() const;
+   BfObject *get(S32 index) const;     // NULL if the object has been deleted since we found it
+
+   S32 pushIterator(lua_State *L);     // Pushes a function that returns each object in turn, then nil
+};
+
+
+};
+
+#endif
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "LuaScriptCache.h"
+
+#include "LuaException.h"
+#include "md5wrapper.h"
+#include "stringUtils.h"
+
+#include "tnlLog.h"
+
+extern "C" {
+#include <luajit.h>        // For LUAJIT_VERSION
+}
+
+#include <algorithm>
+#include <cstdio>          // For rename and remove
+#include <fstream>
+
+namespace Zap
+{
+
+// Bytecode is only good for the LuaJIT that wrote it, and differs between 32 and 64 bit builds
+static const string BytecodeVersion = string(LUAJIT_VERSION) + (sizeof(void *) == 8 ? " 64" : " 32");
+static const string BytecodeExtension = ".ljbc";
+static const char BytecodeSignature[] = "\033LJ";
+
+LuaScriptCache::EntryList LuaScriptCache::mEntries;
+unordered_map<string, LuaScriptCache::EntryList::iterator> LuaScriptCache::mIndex;
+
+S32 LuaScriptCache::mMaxScripts = 32;
+string LuaScriptCache::mBytecodeDir;
+LuaScriptCache::Stats LuaScriptCache::mStats = { 0, 0, 0 };
+
+
+void LuaScriptCache::setMaxScripts(S32 maxScripts)
+{
+   mMaxScripts = max(maxScripts, 0);
+}
+
+
+void LuaScriptCache::setBytecodeDir(const string &dir)
+{
+   mBytecodeDir = "";
+
+   if(dir != "" && makeSureFolderExists(dir))
+      mBytecodeDir = dir;
+}
+
+
+void LuaScriptCache::load(lua_State *L, const string &filename, bool keepInMemory)
+{
+   S64 modifiedTime = 0, size = 0;
+   getFileStamp(filename, modifiedTime, size);     // If it's missing, compile() will complain
+
+   if(keepInMemory && mMaxScripts > 0)
+   {
+      unordered_map<string, EntryList::iterator>::iterator found = mIndex.find(filename);
+
+      if(found != mIndex.end())
+      {
+         EntryList::iterator entry = found->second;
+
+         if(entry->modifiedTime == modifiedTime && entry->size == size)
+         {
+            mEntries.splice(mEntries.begin(), mEntries, entry);      // Now the most recently used
+            lua_getfield(L, LUA_REGISTRYINDEX, filename.c_str());
+            mStats.memoryHits++;
+            return;
+         }
+
+         forget(L, entry);      // File has changed since we loaded it
+      }
+   }
+
+   compile(L, filename);      // Throws if there is an error
+
+   if(!keepInMemory || mMaxScripts == 0)
+      return;
+
+   while((S32)mEntries.size() >= mMaxScripts)
+      forget(L, --mEntries.end());
+
+   lua_pushvalue(L, -1);                                       // -- chunk, chunk
+   lua_setfield(L, LUA_REGISTRYINDEX, filename.c_str());       // -- chunk
+
+   Entry entry;
+   entry.filename = filename;
+   entry.modifiedTime = modifiedTime;
+   entry.size = size;
+
+   mEntries.push_front(entry);
+   mIndex[filename] = mEntries.begin();
+}
+
+
+// Pushes the compiled chunk, from the bytecode folder if we've seen this source before
+void LuaScriptCache::compile(lua_State *L, const string &filename)
+{
+   if(!fileExists(filename))
+   {
+      lua_pushfstring(L, "cannot open %s", filename.c_str());
+      throw LuaException("Error compiling script " + filename + "\n" + string(lua_tostring(L, -1)));
+   }
+
+   string source = readFile(filename);
+
+   // Like luaL_loadfile, ignore a first line starting with #, but keep the line numbers the same
+   if(source.size() > 0 && source[0] == '#')
+      source.insert(0, "--");
+
+   string chunkName = "@" + filename;     // As luaL_loadfile would name it, so errors look the same either way
+   string bytecodePath;
+
+   if(mBytecodeDir != "")
+   {
+      static md5wrapper md5;
+      bytecodePath = joindir(mBytecodeDir, md5.getHashFromString(BytecodeVersion + "\n" + filename + "\n" + source) + BytecodeExtension);
+
+      if(loadBytecode(L, bytecodePath, chunkName))
+      {
+         mStats.bytecodeHits++;
+         return;
+      }
+   }
+
+   if(luaL_loadbuffer(L, source.c_str(), source.size(), chunkName.c_str()) != 0)
+      throw LuaException("Error compiling script " + filename + "\n" + string(lua_tostring(L, -1)));
+
+   mStats.compiles++;
+
+   if(bytecodePath != "")
+      saveBytecode(L, bytecodePath);
+}
+
+
+// Leaves the chunk on the stack and returns true if there was usable bytecode at path
+bool LuaScriptCache::loadBytecode(lua_State *L, const string &path, const string &chunkName)
+{
+   if(!fileExists(path))
+      return false;
+
+   string bytecode = readFile(path);
+
+   // Make sure we don't mistake something else for bytecode -- luaL_loadbuffer would happily run it as source
+   if(bytecode.compare(0, sizeof(BytecodeSignature) - 1, BytecodeSignature) != 0)
+   {
+      logprintf(LogConsumer::LogWarning, "Ignoring invalid Lua bytecode file %s", path.c_str());
+      return false;
+   }
+
+   if(luaL_loadbuffer(L, bytecode.c_str(), bytecode.size(), chunkName.c_str()) != 0)
+   {
+      logprintf(LogConsumer::LogWarning, "Ignoring unreadable Lua bytecode file %s: %s", path.c_str(), lua_tostring(L, -1));
+      lua_pop(L, 1);
+      return false;
+   }
+
+   return true;
+}
+
+
+static int writeBytecode(lua_State *L, const void *data, size_t size, void *bytecode)
+{
+   static_cast<string *>(bytecode)->append(static_cast<const char *>(data), size);
+   return 0;
+}
+
+
+// Saves the chunk on the top of the stack.  Written to a temporary file first, so another server sharing the
+// folder never sees half a file.
+void LuaScriptCache::saveBytecode(lua_State *L, const string &path)
+{
+   string bytecode;
+
+   if(lua_dump(L, writeBytecode, &bytecode) != 0)
+      return;
+
+   string tempPath = path + ".tmp";
+
+   {
+      ofstream file(tempPath.c_str(), ios_base::out | ios_base::binary);
+      file.write(bytecode.c_str(), bytecode.size());
+
+      if(!file.good())
+      {
+         logprintf(LogConsumer::LogWarning, "Could not save Lua bytecode to %s", tempPath.c_str());
+         return;
+      }
+   }
+
+   if(rename(tempPath.c_str(), path.c_str()) != 0)
+      remove(tempPath.c_str());     // Most likely someone else got there first
+}
+
+
+void LuaScriptCache::forget(lua_State *L, EntryList::iterator entry)
+{
+   if(L)
+   {
+      lua_pushnil(L);
+      lua_setfield(L, LUA_REGISTRYINDEX, entry->filename.c_str());
+   }
+
+   mIndex.erase(entry->filename);
+   mEntries.erase(entry);
+}
+
+
+void LuaScriptCache::clear(lua_State *L)
+{
+   while(!mEntries.empty())
+      forget(L, mEntries.begin());
+}
+
+
+const LuaScriptCache::Stats &LuaScriptCache::getStats()
+{
+   return mStats;
+}
+
+
+void LuaScriptCache::resetStats()
+{
+   mStats.memoryHits = 0;
+   mStats.bytecodeHits = 0;
+   mStats.compiles = 0;
+}
+
+
+};
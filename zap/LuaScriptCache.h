@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _LUA_SCRIPT_CACHE_H_
+#define _LUA_SCRIPT_CACHE_H_
+
+#include "LuaInc.h"
+
+#include "tnlTypes.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+using namespace TNL;
+
+namespace Zap
+{
+
+// Saves us compiling the same scripts over and over.  There are two levels to it:
+//
+// Compiled chunks are kept in the Lua registry, so starting another copy of a popular bot costs a lookup rather than
+// a compile.  The least recently used are dropped once there are more than the configured number, and a script whose
+// file has changed (going by its size and modification time) is reloaded.
+//
+// Beneath that, if we have somewhere to put it, the LuaJIT bytecode for each script is saved to disk, named for a
+// hash of the script's source, so a restarted server can pick up where the last one left off.  As files are looked up
+// by what's in them, an edited script simply misses, and is compiled afresh.  Old versions are left where they are.
+class LuaScriptCache
+{
+public:
+   struct Stats
+   {
+      U32 memoryHits;         // Chunk was already in the registry
+      U32 bytecodeHits;       // Chunk was loaded from the bytecode folder
+      U32 compiles;           // Chunk had to be compiled from source
+   };
+
+private:
+   struct Entry
+   {
+      string filename;        // Also the chunk's key in the registry
+      S64 modifiedTime;
+      S64 size;
+   };
+
+   typedef list<Entry> EntryList;
+
+   static EntryList mEntries;                                     // Most recently used first
+   static unordered_map<string, EntryList::iterator> mIndex;      // By filename
+
+   static S32 mMaxScripts;
+   static string mBytecodeDir;
+   static Stats mStats;
+
+   static void compile(lua_State *L, const string &filename);
+   static bool loadBytecode(lua_State *L, const string &path, const string &chunkName);
+   static void saveBytecode(lua_State *L, const string &path);
+   static void forget(lua_State *L, EntryList::iterator entry);
+
+public:
+   static void setMaxScripts(S32 maxScripts);         // How many compiled chunks to keep in the registry
+   static void setBytecodeDir(const string &dir);     // Empty to not save bytecode
+
+   // Pushes the compiled chunk onto the stack, compiling it if need be; keepInMemory adds it to the registry cache.
+   // Throws a LuaException, with Lua's error message on the top of the stack, if the script can't be loaded.
+   static void load(lua_State *L, const string &filename, bool keepInMemory);
+
+   static void clear(lua_State *L);     // Empties the registry cache; pass NULL if L is going away anyway
+
+   static const Stats &getStats();
+   static void resetStats();
+};
+
+
+};
+
+#endif
@@ -5,6 +5,8 @@
 
 #include "LuaScriptRunner.h"   // Header
 #include "LuaModule.h"
+#include "LuaObjectQuery.h"
+#include "LuaScriptCache.h"
 #include "BfObject.h"
 #include "ship.h"
 #include "BotNavMeshZone.h"
@@ -42,15 +44,9 @@ namespace Zap
 lua_State *LuaScriptRunner::L = NULL;
 string LuaScriptRunner::mScriptingDir;
 
-deque<string> LuaScriptRunner::mCachedScripts;
-
 void LuaScriptRunner::clearScriptCache()
 {
-	while(mCachedScripts.size() != 0)
-	{
-		deleteScript(mCachedScripts.front().c_str());
-		mCachedScripts.pop_front();
-	}
+   LuaScriptCache::clear(L);
 }
 
 
@@ -81,7 +77,7 @@ LuaScriptRunner::~LuaScriptRunner()
    // send an event to a dead bot, after all...
    for(S32 i = 0; i < EventManager::EventTypes; i++)
       if(mSubscriptions[i])
-         EventManager::get()->unsubscribeImmediate(this, (EventManager::EventType)i);
+         mLuaGame->getEventManager()->unsubscribeImmediate(this, (EventManager::EventType)i);
 
    // Clean-up any game objects that were added in Lua with '.new()' but not added
    // with bf:addItem()
@@ -110,6 +106,9 @@ void LuaScriptRunner::shutdown()
       lua_close(L);
       L = NULL;
    }
+
+   LuaScriptCache::clear(NULL);     // Compiled chunks went with L
+   LuaObjectQuery::clearCache();
 }
 
 
@@ -191,8 +190,8 @@ void LuaScriptRunner::pushStackTracer()
 // Use this method to load an external script directly into the currently running script's
 // environment.  This loaded script will be cleared when the parent script terminates
 bool LuaScriptRunner::loadCompileRunEnvironmentScript(const string &scriptName) {
-   // The timer is loaded in each script
-   loadCompileScript(joindir(mScriptingDir, scriptName).c_str());
+   // The timer is loaded in each script, so keep a compiled copy handy
+   LuaScriptCache::load(L, joindir(mScriptingDir, scriptName), true);
    setEnvironment();
 
    S32 err = lua_pcall(L, 0, 0, 0);
@@ -217,8 +216,6 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
    if(mScriptName == "")
       return true;
 
-   static const S32 MAX_CACHE_SIZE = 16;
-
    // On a dedicated server, we'll always cache our scripts; on a regular server, we'll cache script except when the user is testing
    // from the editor.  In that case, we'll want to see script changes take place immediately, and we're willing to pay a small
    // performance penalty on level load to get that.
@@ -229,39 +226,7 @@ bool LuaScriptRunner::loadScript(bool cacheScript)
    {
       pushStackTracer();            // -- _stackTracer
 
-      if(!cacheScript)
-         loadCompileScript(mScriptName.c_str());
-      else  
-      {
-         bool found = false;
-
-         // Check if script is in our cache
-         S32 cacheSize = (S32)mCachedScripts.size();
-
-         for(S32 i = 0; i < cacheSize; i++)
-            if(mCachedScripts[i] == mScriptName)
-            {
-               found = true;
-               break;
-            }
-
-         if(!found)     // Script is not (yet) cached
-         {
-            if(cacheSize > MAX_CACHE_SIZE)
-            {
-               // Remove oldest script from the cache
-               deleteScript(mCachedScripts.front().c_str());
-               mCachedScripts.pop_front();
-            }
-
-            // Load new script into cache using full name as registry key
-            loadCompileSaveScript(mScriptName.c_str(), mScriptName.c_str());
-            mCachedScripts.push_back(mScriptName);
-         }
-
-         lua_getfield(L, LUA_REGISTRYINDEX, mScriptName.c_str());    // Load script from cache
-      }
-
+      LuaScriptCache::load(L, mScriptName, cacheScript);      // -- _stackTracer, chunk
 
       // If we are here, script loaded and compiled; everything should be dandy.
       TNLAssert((lua_gettop(L) == 2 && lua_isfunction(L, 1) && lua_isfunction(L, 2)) 
@@ -502,8 +467,8 @@ void LuaScriptRunner::loadCompileScript(const char *filename)
    // LUA_ERRSYNTAX: syntax error during pre-compilation;  [[ err == 3 ]]
    // LUA_ERRMEM: memory allocation error.  [[ err == 4 ]]
 
-   if(filename[0] != '\0' && luaL_loadfile(L, filename) != 0)
-      throw LuaException("Error compiling script " + string(filename) + "\n" + string(lua_tostring(L, -1)));
+   if(filename[0] != '\0')
+      LuaScriptCache::load(L, filename, false);      // Not worth keeping; these are only run once for each L
 }
 
 
@@ -678,7 +643,7 @@ S32 LuaScriptRunner::doSubscribe(lua_State *L, ScriptContext context)
 
    if(!mSubscriptions[eventType])
    {
-      EventManager::get()->subscribe(this, (EventManager::EventType)eventType, context);
+      mLuaGame->getEventManager()->subscribe(this, (EventManager::EventType)eventType, context);
       mSubscriptions[eventType] = true;
    }
 
@@ -694,7 +659,7 @@ S32 LuaScriptRunner::doUnsubscribe(lua_State *L)
 
    if(mSubscriptions[eventType])
    {
-      EventManager::get()->unsubscribe(this, (EventManager::EventType)eventType);
+      mLuaGame->getEventManager()->unsubscribe(this, (EventManager::EventType)eventType);
       mSubscriptions[eventType] = false;
    }
 
@@ -980,6 +945,8 @@ void LuaScriptRunner::setGlobalObjectArrays(lua_State *L)
       METHOD(CLASS, findObjectById,        ARRAYDEF({{ INT, END }}), 1 )    \
       METHOD(CLASS, findAllObjects,        ARRAYDEF({{ TABLE, INTS, END }, { TABLE, END }, { INTS, END }, { END }}), 4 ) \
       METHOD(CLASS, findAllObjectsInArea,  ARRAYDEF({{ TABLE, PT, PT, INTS, END }, { PT, PT, INTS, END }}), 2 ) \
+      METHOD(CLASS, eachObject,            ARRAYDEF({{ INTS, END }, { END }}), 2 )            \
+      METHOD(CLASS, eachObjectInArea,      ARRAYDEF({{ PT, PT, INTS, END }}), 1 )           \
       METHOD(CLASS, addItem,               ARRAYDEF({{ BFOBJ, END }}), 1 )  \
       METHOD(CLASS, getGameInfo,           ARRAYDEF({{ END }}), 1 )         \
       METHOD(CLASS, getPlayerCount,        ARRAYDEF({{ END }}), 1 )         \
@@ -992,7 +959,7 @@ GENERATE_LUA_METHODS_TABLE(LuaScriptRunner, LUA_METHODS);
 
 void LuaScriptRunner::registerLooseFunctions(lua_State *L)
 {
-   ProfileMap moduleProfiles = LuaModuleRegistrarBase::getModuleProfiles();
+   ProfileMap &moduleProfiles = LuaModuleRegistrarBase::getModuleProfiles();
 
    ProfileMap::iterator it;
    for(it = moduleProfiles.begin(); it != moduleProfiles.end(); it++)
@@ -1115,47 +1082,28 @@ S32 LuaScriptRunner::lua_findAllObjects(lua_State *L)
 
    TNLAssert(mLuaGridDatabase != NULL, "Grid Database must not be NULL!");
 
-   fillVector.clear();
-   static Vector<U8> types;
-
-   types.clear();
-
    // We expect the stack to look like this: -- objType1, objType2, ...
    // or this, if using the deprecated fill table option -- [fillTable], objType1, objType2, ...
-   // We'll work our way down from the top of the stack (element -1) until we find something that is not a number.
-   // We expect that when we find something that is not a number, the stack will only contain a fillTable.  If the stack
-   // is empty at that point, we'll add a table later.
    // Note that even if stack is empty, lua_isnumber will return a value... which makes no sense!
-   while(lua_gettop(L) > 0 && lua_isnumber(L, -1))
-   {
-      U8 typenum = (U8)lua_tointeger(L, -1);
-
-      // Requests for botzones have to be handled separately; not a problem, we'll just do the search here, and add them to
-      // fillVector, where they'll be merged with the rest of our search results.
-      if(typenum != BotNavMeshZoneTypeNumber)
-         types.push_back(typenum);
-      else
-         mLuaGame->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, fillVector);
+   bool hasTypes = lua_gettop(L) > 0 && lua_isnumber(L, -1);
 
-      lua_pop(L, 1);
-   }
-
-   const Vector<DatabaseObject *> * results;
+   // With no types, there's nothing to search for; we can hand over the database's own list
+   const Vector<DatabaseObject *> *allObjects = NULL;
+   LuaObjectQuery *query = NULL;
 
-   if(types.size() == 0)
-      results = mLuaGridDatabase->findObjects_fast();
+   if(hasTypes)
+      query = popObjectQuery(L, false);
    else
-   {
-      mLuaGridDatabase->findObjects(types, fillVector);
-      results = &fillVector;
-   }
+      allObjects = mLuaGridDatabase->findObjects_fast();
+
+   S32 count = query ? query->size() : allObjects->size();
 
    // This will guarantee a table at the top of the stack to return our found objects
    if(!lua_istable(L, -1))
    {
       TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack not cleared!");
 
-      lua_createtable(L, results->size(), 0);    // Create a table, with enough slots pre-allocated for our data
+      lua_createtable(L, count, 0);    // Create a table, with enough slots pre-allocated for our data
    }
    else
       logprintf(LogConsumer::LuaBotMessage, "Usage of a fill table with findAllObjects() "
@@ -1165,9 +1113,14 @@ S32 LuaScriptRunner::lua_findAllObjects(lua_State *L)
 
    S32 pushed = 0;      // Count of items we put into our table
 
-   for(S32 i = 0; i < results->size(); i++)
+   for(S32 i = 0; i < count; i++)
    {
-      static_cast<BfObject *>(results->get(i))->push(L);
+      BfObject *obj = query ? query->get(i) : static_cast<BfObject *>(allObjects->get(i));
+
+      if(!obj)          // Deleted since the query was run
+         continue;
+
+      obj->push(L);
       pushed++;      // Increment pushed before using it because Lua uses 1-based arrays
       lua_rawseti(L, 1, pushed);
    }
@@ -1202,21 +1155,57 @@ S32 LuaScriptRunner::lua_findAllObjectsInArea(lua_State *L)
 
    TNLAssert(mLuaGridDatabase != NULL, "Grid Database must not be NULL!");
 
+   // We expect the stack to look like this: -- point1, point2, objType1, objType2, ...
+   // or this, if using the deprecated fill table option -- [fillTable], point1, point2, objType1, objType2, ...
+   LuaObjectQuery *query = popObjectQuery(L, true);
+
+   // This will guarantee a table at the top of the stack to return our found objects
+   if(!lua_istable(L, -1))
+   {
+      TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack not cleared!");
+
+      lua_createtable(L, query->size(), 0);    // Create a table, with enough slots pre-allocated for our data
+   }
+   else
+      logprintf(LogConsumer::LuaBotMessage, "Usage of a fill table with findAllObjectsInArea() "
+            "is deprecated and will be removed in the future.  Instead, don't use one");
+
+   S32 pushed = 0;      // Count of items we put into our table
+
+   for(S32 i = 0; i < query->size(); i++)
+   {
+      BfObject *obj = query->get(i);
+
+      if(!obj)          // Deleted since the query was run
+         continue;
+
+      obj->push(L);
+      pushed++;      // Increment pushed before using it because Lua uses 1-based arrays
+      lua_rawseti(L, 1, pushed);
+   }
+
+   TNLAssert(lua_gettop(L) == 1 || dumpStack(L), "Stack has unexpected items on it!");
+
+   return 1;
+}
+
+
+// Works its way down from the top of the stack (element -1), reading ObjTypes until it finds something that is not a
+// number, then, if inArea is set, the two points defining the search area.  Whatever is below that is left alone.
+// The results are shared with any other script that asks the same question before anything changes; see LuaObjectQuery.
+LuaObjectQuery *LuaScriptRunner::popObjectQuery(lua_State *L, bool inArea)
+{
    static Vector<U8> types;
 
    types.clear();
-   fillVector.clear();
 
    bool hasBotZoneType = false;
 
-   // We expect the stack to look like this: -- point1, point2, objType1, objType2, ...
-   // or this, if using the deprecated fill table option -- [fillTable], point1, point2, objType1, objType2, ...
-   // We'll work our way down from the top of the stack (element -1) until we find something that is not a number.
    while(lua_gettop(L) > 0 && lua_isnumber(L, -1))
    {
       U8 typenum = (U8)lua_tointeger(L, -1);
 
-      // Requests for botzones have to be handled separately
+      // Requests for botzones have to be handled separately, as they live in a database of their own
       if(typenum != BotNavMeshZoneTypeNumber)
          types.push_back(typenum);
       else
@@ -1225,6 +1214,11 @@ S32 LuaScriptRunner::lua_findAllObjectsInArea(lua_State *L)
       lua_pop(L, 1);
    }
 
+   GridDatabase *botZoneDatabase = hasBotZoneType ? mLuaGame->getBotZoneDatabase() : NULL;
+
+   if(!inArea)
+      return LuaObjectQuery::find(mLuaGridDatabase, botZoneDatabase, types, NULL);
+
    // We should be left with 2 points and maybe a table
    Point p1 = getPointOrXY(L, -1);
    Point p2 = getPointOrXY(L, -2);
@@ -1232,34 +1226,79 @@ S32 LuaScriptRunner::lua_findAllObjectsInArea(lua_State *L)
 
    Rect searchArea = Rect(p1, p2);
 
-   if(hasBotZoneType)
-      mLuaGame->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, fillVector, searchArea);
+   return LuaObjectQuery::find(mLuaGridDatabase, botZoneDatabase, types, &searchArea);
+}
 
-   mLuaGridDatabase->findObjects(types, fillVector, searchArea);
 
-   // This will guarantee a table at the top of the stack to return our found objects
-   if(!lua_istable(L, -1))
-   {
-      TNLAssert(lua_gettop(L) == 0 || dumpStack(L), "Stack not cleared!");
+/**
+ * @luafunc function LuaScriptRunner::eachObject(ObjType objType, ...)
+ *
+ * @brief Iterates over all items of the specified object type anywhere on the
+ * level.
+ *
+ * @descr Finds the same objects as findAllObjects, but rather than building a
+ * table of them all up front, hands them over one at a time, for use in a `for`
+ * loop.  This is much cheaper when you're only interested in a few of them, or
+ * only want to know whether there are any at all.
+ *
+ * If no object types are provided, this will iterate over every object on the
+ * level.
+ *
+ * @param [objType] ObjTypes specifying what types of objects to find.
+ *
+ * @return An iterator function, returning the next object each time it is
+ * called, or `nil` when there are no more.
+ *
+ * @code
+ * for ship in bf:eachObject(ObjType.Ship) do
+ *   if ship:getTeamIndx() ~= bot:getTeamIndx() then
+ *     return ship                         -- Found an enemy, no need to look at the rest
+ *   end
+ * end
+ * @endcode
+ */
+S32 LuaScriptRunner::lua_eachObject(lua_State *L)
+{
+   checkArgList(L, functionArgs, luaClassName, "eachObject");
 
-      lua_createtable(L, fillVector.size(), 0);    // Create a table, with enough slots pre-allocated for our data
-   }
-   else
-      logprintf(LogConsumer::LuaBotMessage, "Usage of a fill table with findAllObjectsInArea() "
-            "is deprecated and will be removed in the future.  Instead, don't use one");
+   TNLAssert(mLuaGridDatabase != NULL, "Grid Database must not be NULL!");
 
-   S32 pushed = 0;      // Count of items we put into our table
+   LuaObjectQuery *query = popObjectQuery(L, false);
+   lua_settop(L, 0);
 
-   for(S32 i = 0; i < fillVector.size(); i++)
-   {
-      static_cast<BfObject *>(fillVector[i])->push(L);
-      pushed++;      // Increment pushed before using it because Lua uses 1-based arrays
-      lua_rawseti(L, 1, pushed);
-   }
+   return query->pushIterator(L);
+}
 
-   TNLAssert(lua_gettop(L) == 1 || dumpStack(L), "Stack has unexpected items on it!");
 
-   return 1;
+/**
+ * @luafunc function LuaScriptRunner::eachObjectInArea(point point1, point point2, ObjType objType, ...)
+ *
+ * @brief Iterates over all items of the specified type(s) in a given search
+ * area.
+ *
+ * @descr Finds the same objects as findAllObjectsInArea, handing them over one
+ * at a time for use in a `for` loop.
+ *
+ * @note See LuaScriptRunner::eachObject for a code example
+ *
+ * @param point1 One corner of a search rectangle.
+ * @param point2 Another corner of a search rectangle diagonally opposite to the
+ * first.
+ * @param objType The \ref ObjTypeEnum to look for. Multiple can be specified.
+ *
+ * @return An iterator function, returning the next object each time it is
+ * called, or `nil` when there are no more.
+ */
+S32 LuaScriptRunner::lua_eachObjectInArea(lua_State *L)
+{
+   checkArgList(L, functionArgs, luaClassName, "eachObjectInArea");
+
+   TNLAssert(mLuaGridDatabase != NULL, "Grid Database must not be NULL!");
+
+   LuaObjectQuery *query = popObjectQuery(L, true);
+   lua_settop(L, 0);
+
+   return query->pushIterator(L);
 }
 
 
@@ -13,7 +13,6 @@
 #include "tnl.h"
 #include "tnlVector.h"
 
-#include <deque>
 #include <string>
 
 using namespace std;
@@ -30,6 +29,7 @@ class BfObject;
 class DatabaseObject;
 class Game;
 class GridDatabase;
+class LuaObjectQuery;
 class LuaPlayerInfo;
 class Rect;
 class Ship;
@@ -47,7 +47,6 @@ class LuaScriptRunner
 {
 
 private:
-   static deque<string> mCachedScripts;
 
    static string mScriptingDir;
 
@@ -103,6 +102,8 @@ protected:
 
    static S32 findObjectById(lua_State *L, const Vector<DatabaseObject *> *objects);
 
+   LuaObjectQuery *popObjectQuery(lua_State *L, bool inArea);     // Reads the ObjTypes (and points) off the stack
+
 
 // Sets a var in the script's environment to give access to the caller's "this" obj, with the var name "name".
 // Basically sets the "bot", "levelgen", and "plugin" vars.
@@ -187,6 +188,8 @@ public:
    S32 lua_findAllObjects(lua_State *L);
    S32 lua_findAllObjectsInArea(lua_State *L);
    S32 lua_findObjectById(lua_State *L);
+   S32 lua_eachObject(lua_State *L);
+   S32 lua_eachObjectInArea(lua_State *L);
 
    S32 lua_addItem(lua_State *L);
 
@@ -491,7 +491,7 @@ void NexusGameType::openNexus(S32 timeNexusOpened)
    }
 
    // Fire an event
-   EventManager::get()->fireEvent(EventManager::NexusOpenedEvent);
+   getGame()->getEventManager()->fireEvent(EventManager::NexusOpenedEvent);
 }
 
 
@@ -502,7 +502,7 @@ void NexusGameType::closeNexus(S32 timeNexusClosed)
    mNexusChangeAtTime = getNextChangeTime(timeNexusClosed, mNexusClosedTime);
 
    // Fire an event
-   EventManager::get()->fireEvent(EventManager::NexusClosedEvent);
+   getGame()->getEventManager()->fireEvent(EventManager::NexusClosedEvent);
 }
 
 
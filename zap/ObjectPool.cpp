@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ObjectPool.h"
+
+#include "tnlAssert.h"
+
+namespace Zap
+{
+
+ObjectPool *ObjectPool::mFirstPool = NULL;
+
+// Constructor
+ObjectPool::ObjectPool(const char *name, U32 elementSize) :
+   mName(name),
+   mElementSize((elementSize + ElementAlignment - 1) & ~(ElementAlignment - 1)),
+   mChunker(S32(((elementSize + ElementAlignment - 1) & ~(ElementAlignment - 1)) * ElementsPerPage))
+{
+   mFreeListHead = NULL;
+
+   mLiveCount = 0;
+   mPeakCount = 0;
+   mSlotCount = 0;
+   mAllocCount = 0;
+   mOversizeCount = 0;
+
+   mNextPool = mFirstPool;
+   mFirstPool = this;
+}
+
+
+void *ObjectPool::alloc(size_t size)
+{
+   if(size > mElementSize)
+   {
+      mOversizeCount++;
+      return ::operator new(size);
+   }
+
+   void *ptr;
+
+   if(mFreeListHead)
+   {
+      ptr = mFreeListHead;
+      mFreeListHead = *reinterpret_cast<void **>(ptr);
+   }
+   else
+   {
+      ptr = mChunker.alloc(mElementSize);
+      mSlotCount++;
+   }
+
+   mAllocCount++;
+   mLiveCount++;
+
+   if(mLiveCount > mPeakCount)
+      mPeakCount = mLiveCount;
+
+   return ptr;
+}
+
+
+void ObjectPool::free(void *ptr, size_t size)
+{
+   if(!ptr)
+      return;
+
+   if(size > mElementSize)
+   {
+      ::operator delete(ptr);
+      return;
+   }
+
+   TNLAssert(mLiveCount > 0, "Freeing more objects than were allocated!");
+
+   *reinterpret_cast<void **>(ptr) = mFreeListHead;
+   mFreeListHead = ptr;
+   mLiveCount--;
+}
+
+
+const char *ObjectPool::getName()      const { return mName;          }
+U32 ObjectPool::getElementSize()       const { return mElementSize;   }
+U32 ObjectPool::getLiveCount()         const { return mLiveCount;     }
+U32 ObjectPool::getPeakCount()         const { return mPeakCount;     }
+U32 ObjectPool::getSlotCount()         const { return mSlotCount;     }
+U64 ObjectPool::getAllocCount()        const { return mAllocCount;    }
+U64 ObjectPool::getOversizeCount()     const { return mOversizeCount; }
+
+ObjectPool *ObjectPool::getFirstPool()       { return mFirstPool;     }
+ObjectPool *ObjectPool::getNextPool()  const { return mNextPool;      }
+
+
+};
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _OBJECT_POOL_H_
+#define _OBJECT_POOL_H_
+
+#include "tnlTypes.h"
+#include "tnlDataChunker.h"
+
+#include <stddef.h>
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Free-list allocator for objects that come and go many times a second, like projectiles.  Memory is carved
+// out of a DataChunker in pages and never handed back; a freed slot goes on a free list and is reused by the
+// next object of the class.  Since objects are still created with new and destroyed with delete, the delete
+// list, RefPtrs and ghost creation on the client all work exactly as before.
+//
+// Each pool links itself into a global list so that its occupancy can be reported.
+class ObjectPool
+{
+private:
+   enum {
+      ElementAlignment = 16,
+      ElementsPerPage  = 32
+   };
+
+   const char *mName;
+   U32 mElementSize;
+
+   DataChunker mChunker;
+   void *mFreeListHead;
+
+   U32 mLiveCount;         // Objects currently allocated
+   U32 mPeakCount;         // Most objects ever allocated at once
+   U32 mSlotCount;         // Slots carved out of the chunker; live + free
+   U64 mAllocCount;        // Allocations since startup
+   U64 mOversizeCount;     // Allocations too big for the pool (from subclasses that aren't pooled), passed to the heap
+
+   ObjectPool *mNextPool;
+   static ObjectPool *mFirstPool;
+
+public:
+   ObjectPool(const char *name, U32 elementSize);   // Constructor
+
+   void *alloc(size_t size);
+   void free(void *ptr, size_t size);
+
+   const char *getName() const;
+   U32 getElementSize() const;
+   U32 getLiveCount() const;
+   U32 getPeakCount() const;
+   U32 getSlotCount() const;
+   U64 getAllocCount() const;
+   U64 getOversizeCount() const;
+
+   static ObjectPool *getFirstPool();
+   ObjectPool *getNextPool() const;
+};
+
+
+// Put BF_DECLARE_POOLED_ALLOCATION in the class declaration and BF_IMPLEMENT_POOLED_ALLOCATION(Class) in its
+// .cpp.  Subclasses must declare their own pool (or get sent to the heap, see mOversizeCount).  Pools are
+// created on first use and deliberately never destroyed, so objects freed during shutdown are still safe.
+// Build with BF_NO_OBJECT_POOLS to use the regular heap, which is handy when running under a memory checker.
+#ifdef BF_NO_OBJECT_POOLS
+#  define BF_DECLARE_POOLED_ALLOCATION
+#  define BF_IMPLEMENT_POOLED_ALLOCATION(className)
+#else
+#  define BF_DECLARE_POOLED_ALLOCATION \
+      static void *operator new(size_t size); \
+      static void operator delete(void *ptr, size_t size); \
+      static ObjectPool &getObjectPool();
+
+#  define BF_IMPLEMENT_POOLED_ALLOCATION(className) \
+      ObjectPool &className::getObjectPool() { static ObjectPool *pool = new ObjectPool(#className, sizeof(className)); return *pool; } \
+      void *className::operator new(size_t size) { return getObjectPool().alloc(size); } \
+      void className::operator delete(void *ptr, size_t size) { getObjectPool().free(ptr, size); }
+#endif
+
+
+};
+
+#endif
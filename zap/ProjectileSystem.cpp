@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ProjectileSystem.h"
+
+#include "projectile.h"
+#include "gridDB.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+// Constructor
+ProjectileSystem::ProjectileSystem()
+{
+   mFreeFlightCount = 0;
+   mDetailedCount = 0;
+}
+
+
+void ProjectileSystem::add(Projectile *projectile)
+{
+   mProjectiles.push_back(projectile);
+}
+
+
+// Bullets never hit each other (Projectile has no collide()), so they can't be what stops another bullet
+static bool isBulletObstacleType(U8 x)
+{
+   return isWeaponCollideableType(x) && x != BulletTypeNumber;
+}
+
+
+static const Vector<S64> *sortBuckets;
+
+static bool bucketLess(const S32 &a, const S32 &b)
+{
+   return (*sortBuckets)[a] < (*sortBuckets)[b];
+}
+
+
+void ProjectileSystem::sortByBucket()
+{
+   mOrder.resize(mInFlight.size());
+   for(S32 i = 0; i < mOrder.size(); i++)
+      mOrder[i] = i;
+
+   sortBuckets = &mBucket;
+   mOrder.sort(bucketLess);
+}
+
+
+void ProjectileSystem::idle(GridDatabase *database, U32 timeDelta)
+{
+   mInFlight.clear();
+   mFreeFlightCount = 0;
+   mDetailedCount = 0;
+
+   // Drop bullets that are gone, and advance the clock on those that have stopped flying
+   for(S32 i = 0; i < mProjectiles.size(); i++)
+   {
+      Projectile *projectile = mProjectiles[i];
+
+      if(!projectile || projectile->getDatabase() != database)
+      {
+         if(projectile)
+            projectile->mInProjectileSystem = false;
+
+         mProjectiles.erase_fast(i);
+         i--;
+         continue;
+      }
+
+      if(projectile->isDeleted())         // Main loop skips these too
+         continue;
+
+      if(projectile->isInFlight())
+         mInFlight.push_back(projectile);
+      else
+         projectile->advance(timeDelta, BfObject::ServerIdleMainLoop);
+   }
+
+   const S32 count = mInFlight.size();
+
+   mStartX.resize(count);
+   mStartY.resize(count);
+   mEndX.resize(count);
+   mEndY.resize(count);
+   mBucket.resize(count);
+
+   // Where would each bullet end up if it hit nothing?  Same arithmetic as Projectile::advance(), so we land on
+   // exactly the same spot.
+   const F32 timeLeft = (F32)timeDelta;
+
+   for(S32 i = 0; i < count; i++)
+   {
+      Point pos = mInFlight[i]->getPos();
+      Point vel = mInFlight[i]->getActualVel();
+
+      mStartX[i] = pos.x;
+      mStartY[i] = pos.y;
+      mEndX[i] = pos.x + (vel.x * .001f) * timeLeft;     // Velocity in units/sec, time in ms
+      mEndY[i] = pos.y + (vel.y * .001f) * timeLeft;
+   }
+
+   for(S32 i = 0; i < count; i++)
+   {
+      S64 col = S64(floor(mStartX[i])) >> BucketBitShift;
+      S64 row = S64(floor(mStartY[i])) >> BucketBitShift;
+      mBucket[i] = (row << 32) ^ (col & 0xFFFFFFFF);
+   }
+
+   sortByBucket();
+
+   // One query per bucket, covering every path starting in it
+   static Vector<DatabaseObject *> obstacles;
+
+   for(S32 first = 0; first < count; )
+   {
+      S32 last = first;
+      while(last + 1 < count && mBucket[mOrder[last + 1]] == mBucket[mOrder[first]])
+         last++;
+
+      Rect bucketRect(Point(mStartX[mOrder[first]], mStartY[mOrder[first]]), Point(mEndX[mOrder[first]], mEndY[mOrder[first]]));
+
+      for(S32 j = first + 1; j <= last; j++)
+      {
+         S32 i = mOrder[j];
+         bucketRect.unionPoint(Point(mStartX[i], mStartY[i]));
+         bucketRect.unionPoint(Point(mEndX[i], mEndY[i]));
+      }
+
+      obstacles.clear();
+      database->findObjects((TestFunc)isBulletObstacleType, obstacles, bucketRect);
+
+      for(S32 j = first; j <= last; j++)
+      {
+         S32 i = mOrder[j];
+         Rect path(Point(mStartX[i], mStartY[i]), Point(mEndX[i], mEndY[i]));
+
+         // findObjectLOS() only considers objects whose extents overlap the path's bounding box, so if nothing
+         // does, the bullet is sure to fly straight through
+         bool clear = true;
+         for(S32 k = 0; k < obstacles.size() && clear; k++)
+            if(obstacles[k]->getExtent().intersects(path))
+               clear = false;
+
+         if(clear)
+         {
+            mInFlight[i]->setPos(Point(mEndX[i], mEndY[i]));
+            mInFlight[i]->updateTimeRemaining(timeDelta);
+            mFreeFlightCount++;
+         }
+         else
+         {
+            mInFlight[i]->advance(timeDelta, BfObject::ServerIdleMainLoop);
+            mDetailedCount++;
+         }
+      }
+
+      first = last + 1;
+   }
+}
+
+
+S32 ProjectileSystem::getProjectileCount() const
+{
+   return mProjectiles.size();
+}
+
+
+U32 ProjectileSystem::getFreeFlightCount() const
+{
+   return mFreeFlightCount;
+}
+
+
+U32 ProjectileSystem::getDetailedCount() const
+{
+   return mDetailedCount;
+}
+
+
+};
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _PROJECTILE_SYSTEM_H_
+#define _PROJECTILE_SYSTEM_H_
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include "BfObject.h"      // For SafePtr
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class Projectile;
+class GridDatabase;
+
+// Moves all of the server's bullets (phasers, bouncers, triples) in one sweep, rather than one idle() at a time.
+//
+// Each tick we copy every bullet's path into flat arrays, sort the paths by grid bucket, and do a single database
+// query per bucket to find anything they might hit.  The bullets whose paths come near nothing, which is nearly
+// all of them, just get moved to the end of their path; the rest go through Projectile::advance(), the same code
+// clients run, which handles bounces and hits.
+class ProjectileSystem
+{
+private:
+   static const S32 BucketBitShift = 8;      // Group paths into 256 pixel buckets, same as the GridDatabase
+
+   Vector<SafePtr<Projectile> > mProjectiles;
+
+   // Per-sweep scratch space, one entry per bullet in flight
+   Vector<Projectile *> mInFlight;
+   Vector<F32> mStartX, mStartY, mEndX, mEndY;
+   Vector<S64> mBucket;
+   Vector<S32> mOrder;        // Indices of the above, sorted by bucket
+
+   U32 mFreeFlightCount;
+   U32 mDetailedCount;
+
+   void sortByBucket();
+
+public:
+   ProjectileSystem();     // Constructor
+
+   void add(Projectile *projectile);
+   void idle(GridDatabase *database, U32 timeDelta);
+
+   S32 getProjectileCount() const;
+   U32 getFreeFlightCount() const;    // Bullets on the last sweep that came near nothing
+   U32 getDetailedCount() const;      // ...and those that needed the full collision check
+};
+
+
+};
+
+#endif
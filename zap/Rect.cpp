@@ -173,6 +173,40 @@ void Rect::unionRect(const Rect &r)
    if(r.max.y > max.y)    max.y = r.max.y;
 }
 
+// Fills pieces with up to four non-overlapping rects that together cover the parts of this rect that lie
+// outside r: full-height strips to the left and right, and strips above and below in between
+void Rect::subtract(const Rect &r, Vector<Rect> &pieces) const
+{
+   pieces.clear();
+
+   if(!(min.x < r.max.x && min.y < r.max.y && max.x > r.min.x && max.y > r.min.y))    // No overlap
+   {
+      pieces.push_back(*this);
+      return;
+   }
+
+   F32 innerMinX = min.x;
+   F32 innerMaxX = max.x;
+
+   if(min.x < r.min.x)
+   {
+      pieces.push_back(Rect(min.x, min.y, r.min.x, max.y));
+      innerMinX = r.min.x;
+   }
+
+   if(max.x > r.max.x)
+   {
+      pieces.push_back(Rect(r.max.x, min.y, max.x, max.y));
+      innerMaxX = r.max.x;
+   }
+
+   if(min.y < r.min.y)
+      pieces.push_back(Rect(innerMinX, min.y, innerMaxX, r.min.y));
+
+   if(max.y > r.max.y)
+      pieces.push_back(Rect(innerMinX, r.max.y, innerMaxX, max.y));
+}
+
 // Does rect interset rect r?
 bool Rect::intersects(const Rect &r)
 {
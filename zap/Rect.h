@@ -71,6 +71,9 @@ public:
 
    void unionRect(const Rect &r);
 
+   // Split the part of this rect not covered by r into rects
+   void subtract(const Rect &r, Vector<Rect> &pieces) const;
+
    // Does rect interset rect r?
    bool intersects(const Rect &r);
    
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "RobotBrain.h"
+
+#include "SBotBrain.h"
+
+namespace Zap
+{
+
+const char *RobotBrain::ScriptPrefix = "native:";
+
+
+template <class T>
+static RobotBrain *createBrain(Robot *bot, const Vector<string> &args)
+{
+   return new T(bot, args);
+}
+
+
+typedef RobotBrain *(*BrainFactory)(Robot *bot, const Vector<string> &args);
+
+struct BrainInfo
+{
+   const char *name;
+   BrainFactory create;
+};
+
+// Every brain we know how to build; add new ones here
+static const BrainInfo brainInfos[] = {
+   { "s_bot", createBrain<SBotBrain> },
+};
+
+
+// Returns NULL if scriptName doesn't name a native brain
+static const BrainInfo *findBrain(const string &scriptName)
+{
+   static const string prefix = RobotBrain::ScriptPrefix;
+
+   if(scriptName.compare(0, prefix.length(), prefix) != 0)
+      return NULL;
+
+   string name = scriptName.substr(prefix.length());
+
+   for(U32 i = 0; i < ARRAYSIZE(brainInfos); i++)
+      if(name == brainInfos[i].name)
+         return &brainInfos[i];
+
+   return NULL;
+}
+
+
+// Constructor
+RobotBrain::RobotBrain(Robot *bot, const Vector<string> &args)
+{
+   mBot = bot;
+   mArgs = args;
+}
+
+
+// Destructor
+RobotBrain::~RobotBrain()
+{
+   // Do nothing
+}
+
+
+bool RobotBrain::isBrainName(const string &scriptName)
+{
+   return findBrain(scriptName) != NULL;
+}
+
+
+RobotBrain *RobotBrain::create(const string &scriptName, Robot *bot, const Vector<string> &args)
+{
+   const BrainInfo *info = findBrain(scriptName);
+
+   return info ? info->create(bot, args) : NULL;
+}
+
+
+};
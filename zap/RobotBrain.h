@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _ROBOT_BRAIN_H_
+#define _ROBOT_BRAIN_H_
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <string>
+
+using namespace std;
+using namespace TNL;
+
+namespace Zap
+{
+
+class Robot;
+
+// Drives a robot from C++ rather than from a Lua script.  A brain gets the same senses and controls a script does,
+// through Robot's C++ methods (getWaypoint(), findVisibleObjects(), setThrust(), and so on), without paying for the
+// trip through Lua on every call.  Brains are picked by giving a bot a script name of "native:<brain>", anywhere a
+// bot script can be named, so "native:s_bot" runs the built-in port of s_bot.bot.
+class RobotBrain
+{
+protected:
+   Robot *mBot;                  // The bot we're driving
+   Vector<string> mArgs;         // Arguments given after the script name, like a script's arg table
+
+public:
+   RobotBrain(Robot *bot, const Vector<string> &args);   // Constructor
+   virtual ~RobotBrain();                                // Destructor
+
+   virtual string getName() = 0;          // Name for the bot, as a script's getName() would give it
+   virtual void onStart() = 0;            // Runs once when the bot joins the game, like a script's main()
+   virtual void onTick(U32 deltaT) = 0;   // Runs every time the bots think, like a script's onTick()
+
+   static const char *ScriptPrefix;
+
+   static bool isBrainName(const string &scriptName);    // Does scriptName name one of our brains?
+   static RobotBrain *create(const string &scriptName, Robot *bot, const Vector<string> &args);  // NULL if no such brain
+};
+
+
+};
+
+#endif
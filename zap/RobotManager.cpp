@@ -396,4 +396,12 @@ void RobotManager::clearMoves()
 }
 
 
+void RobotManager::runBrains(U32 deltaT)
+{
+   for(S32 i = 0; i < mRobots.size(); i++)
+      if(mRobots[i]->hasBrain())
+         mRobots[i]->think(deltaT);
+}
+
+
 } 
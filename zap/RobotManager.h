@@ -71,6 +71,7 @@ public:
    void deleteAllBots();
 
    void clearMoves();
+   void runBrains(U32 deltaT);   // Tick bots with native brains; scripted bots get the TickEvent instead
 };
 
 }
@@ -0,0 +1,570 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "SBotBrain.h"
+
+#include "robot.h"
+#include "flagItem.h"
+#include "goalZone.h"
+#include "projectile.h"
+#include "NexusGame.h"
+#include "game.h"
+
+#include "MathUtils.h"           // For degreesToRadians()
+
+#include "tnlRandom.h"
+
+#include <stdlib.h>              // For strtod()
+
+namespace Zap
+{
+
+// Angle from a to b, like point.angleTo() in Lua
+static F32 angleTo(const Point &a, const Point &b)
+{
+   return (b - a).ATAN2();
+}
+
+
+// Angle between a and b, in the range -pi to pi
+static F32 angleDifference(F32 a, F32 b)
+{
+   return fmod(fmod(a - b, FloatTau) + 3 * FloatPi, FloatTau) - FloatPi;
+}
+
+
+// Projectiles don't keep their velocity where MoveObjects do
+static Point getThreatVel(BfObject *obj)
+{
+   if(obj->getObjectTypeNumber() == BulletTypeNumber)
+      return static_cast<Projectile *>(obj)->getActualVel();
+
+   return static_cast<MoveObject *>(obj)->getActualVel();
+}
+
+
+static F32 getThreatRadius(BfObject *obj)
+{
+   if(obj->getObjectTypeNumber() == BulletTypeNumber)
+      return static_cast<Projectile *>(obj)->getRadius();
+
+   return static_cast<Item *>(obj)->getRadius();
+}
+
+
+// Constructor
+SBotBrain::SBotBrain(Robot *bot, const Vector<string> &args) : Parent(bot, args)
+{
+   mDifficulty = 0.5f;
+   mAggression = 0.5f;
+   mDefense = 0;
+   mSpeed = 1;
+   mDirectionThreshold = 0.25f;
+
+   mBotRadius = 0;
+   mPathTimer = PathTimerMax;
+   mDirToGo = 0;
+
+   mHasPrevTarget = false;
+   mGotoPositionWasNil = true;
+
+   mGameType = NoGameType;
+
+   for(S32 i = 0; i < AverageMax; i++)
+      mAverageArray[i] = false;
+
+   mAverageIndex = 0;
+   mOrbitalDirection = 1;
+   mObjective = 0;
+}
+
+
+// Destructor
+SBotBrain::~SBotBrain()
+{
+   // Do nothing
+}
+
+
+string SBotBrain::getName()
+{
+   return "S_Bot";
+}
+
+
+// Numeric arguments, where index starts at 1 as it does in the script's arg table; anything missing or non-numeric
+// gets the default, as tonumber() would have it
+F32 SBotBrain::getArg(S32 index, F32 defaultValue)
+{
+   if(index > mArgs.size())
+      return defaultValue;
+
+   const char *arg = mArgs[index - 1].c_str();
+   char *end;
+
+   F32 value = (F32)strtod(arg, &end);
+
+   return (end != arg && *end == '\0') ? value : defaultValue;
+}
+
+
+void SBotBrain::onStart()
+{
+   mBotRadius = mBot->getRadius();
+   mPathTimer = PathTimerMax;
+   mDirToGo = 0;
+
+   mDifficulty         = getArg(1, 0.5f);
+   mAggression         = getArg(2, 0.5f);
+   mDefense            = getArg(3, 0);
+   mSpeed              = getArg(4, 1);
+   mDirectionThreshold = getArg(5, 0.25f);
+
+   mGameType = mBot->getGame()->getGameType()->getGameTypeId();
+
+   mOrbitalDirection = 1;
+   mObjective = TNL::Random::readI(0, 10);
+}
+
+
+bool SBotBrain::isTeamGame()
+{
+   return mBot->getGame()->getGameType()->isTeamGame();
+}
+
+
+bool SBotBrain::shieldSelf()
+{
+   static Vector<U8> threatTypes;
+
+   if(threatTypes.size() == 0)
+   {
+      threatTypes.push_back(BulletTypeNumber);
+      threatTypes.push_back(SeekerTypeNumber);
+      threatTypes.push_back(AsteroidTypeNumber);
+      threatTypes.push_back(MineTypeNumber);
+   }
+
+   mBot->findVisibleObjects(threatTypes, mFound);
+
+   F32 distToShieldAt = mBotRadius * 2 + (1 - mDifficulty) * 100;
+
+   for(S32 i = 0; i < mFound.size(); i++)
+   {
+      BfObject *bullet = static_cast<BfObject *>(mFound[i]);
+
+      Point bulletPos = bullet->getPos();
+      Point bulletVel = getThreatVel(bullet);
+      F32 angleDiff = fabs(angleDifference(angleTo(Point(0,0), bulletVel), angleTo(bulletPos, mBotPos)));
+
+      bool bulletFromTeam = isTeamGame() && bullet->getTeam() == mBot->getTeam();
+
+      if(!bulletFromTeam &&
+         bulletPos.distanceTo(mBotPos) < distToShieldAt + getThreatRadius(bullet) + bulletVel.len() * 50 &&
+         angleDiff < FloatPi / 4)
+      {
+         mBot->fireModule(ModuleShield);
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+void SBotBrain::fireAtObjects()
+{
+   static Vector<U8> targetTypes;
+
+   if(targetTypes.size() == 0)
+   {
+      targetTypes.push_back(RobotShipTypeNumber);
+      targetTypes.push_back(TurretTypeNumber);
+      targetTypes.push_back(PlayerShipTypeNumber);
+      targetTypes.push_back(AsteroidTypeNumber);
+      targetTypes.push_back(ForceFieldProjectorTypeNumber);
+      targetTypes.push_back(SpyBugTypeNumber);
+      targetTypes.push_back(CoreTypeNumber);
+   }
+
+   mBot->findVisibleObjects(targetTypes, mFound);
+
+   // Cycle through list of potential items until we find one that we can attack
+   for(S32 i = 0; i < mFound.size(); i++)
+      if(fireAtObject(static_cast<BfObject *>(mFound[i]), WeaponPhaser))
+         break;
+}
+
+
+// Fires at the specified object with the specified weapon if the obj is a good target.  Does not fire if object is on
+// the same team or if there is something in the way.  Returns whether it fired or not.
+bool SBotBrain::fireAtObject(BfObject *obj, WeaponType weapon)
+{
+   U8 classId = obj->getObjectTypeNumber();
+
+   if(classId == TurretTypeNumber || classId == ForceFieldProjectorTypeNumber)
+   {
+      // Ignore all same-team engineered objects...  even in single-team games
+      if(obj->getTeam() == mBot->getTeam())
+         return false;
+
+      if(obj->getHealth() < .1)     // If item is essentially dead
+         return false;
+   }
+
+   bool isShip = classId == PlayerShipTypeNumber || classId == RobotShipTypeNumber;
+
+   // No shooting various team related objects
+   if((obj->getTeam() == mBot->getTeam() && isTeamGame()) || obj->getTeam() == TEAM_NEUTRAL)
+      if(isShip || classId == CoreTypeNumber || classId == SpyBugTypeNumber)    // Turrets and FFs handled above
+         return false;
+
+   // No shooting non-flag carriers in single player rabbit
+   if(mGameType == RabbitGame && !isTeamGame() && isShip &&
+         mBot->getFlagCount() == 0 && static_cast<Ship *>(obj)->getFlagCount() == 0)
+      return false;
+
+   // We made it here!  We have a valid target..
+   F32 angle;
+
+   if(mBot->getFiringSolution(obj, angle) && mBot->hasWeapon(weapon))
+   {
+      mBot->setAngle(angle + degreesToRadians((TNL::Random::readF() - 0.5f) * 20 * (1 - mDifficulty)));
+      mBot->fireWeapon(weapon);
+      return true;
+   }
+
+   return false;
+}
+
+
+void SBotBrain::shield()
+{
+   mAverageArray[mAverageIndex] = shieldSelf();
+   mAverageIndex = (mAverageIndex + 1) % AverageMax;
+
+   // The script counts the slot it's about to overwrite AverageMax times over, so this comes out all or nothing;
+   // we count the same way so the two bots turn alike
+   F32 shieldPercent = mAverageArray[mAverageIndex] ? 1.0f : 0.0f;
+
+   if(shieldPercent > mDirectionThreshold)
+   {
+      mOrbitalDirection = -mOrbitalDirection;
+
+      for(S32 i = 0; i < AverageMax; i++)
+         mAverageArray[i] = false;
+   }
+}
+
+
+void SBotBrain::orbitPoint(const Point &pt, S32 direction, F32 distAway, F32 strictness)
+{
+   F32 dist = pt.distanceTo(mBotPos);
+   F32 deltaDistance = (dist - distAway) * strictness / distAway;
+   F32 sign = deltaDistance < 0 ? -1.0f : 1.0f;
+
+   F32 changeInAngle = (fabs(deltaDistance) / (deltaDistance + sign)) * FloatHalfPi;
+   F32 angleToPoint = angleTo(pt, mBot->getPos());
+
+   mDirToGo = angleToPoint + (FloatHalfPi + changeInAngle) * direction;
+}
+
+
+void SBotBrain::gotoPosition(const Point &pt)
+{
+   mGotoPositionWasNil = false;
+
+   if(mPathTimer < .01)
+   {
+      Point goalPt;
+
+      if(mBot->getWaypoint(pt, goalPt))
+         mDirToGo = angleTo(mBotPos, goalPt);
+   }
+}
+
+
+void SBotBrain::gotoAndOrbitPosition(const Point &pt)
+{
+   mGotoPositionWasNil = false;
+
+   if(!mBot->canSeePoint(pt))
+      gotoPosition(pt);
+   else
+      orbitPoint(pt, mOrbitalDirection, mBotRadius * 5, 2);
+}
+
+
+// Remembers the target's position if we like our chances against it
+void SBotBrain::attackNearbyEnemies(Ship *target, F32 aggressionLevel)
+{
+   if(!target)
+      return;
+
+   static Vector<U8> shipTypes;
+
+   if(shipTypes.size() == 0)
+   {
+      shipTypes.push_back(PlayerShipTypeNumber);
+      shipTypes.push_back(RobotShipTypeNumber);
+   }
+
+   F32 myPow = (F32)mBot->getEnergy() / Ship::EnergyMax + mBot->getHealth();
+
+   mBot->findVisibleObjects(shipTypes, mFound);
+
+   F32 otherPow = (F32)target->getEnergy() / Ship::EnergyMax + target->getHealth() * mFound.size();
+
+   // Advantage is between -1 and 1, -1 meaning an extreme disadvantage and 1 meaning an extreme advantage
+   F32 advantage = (myPow - otherPow) / max(myPow, otherPow);
+
+   if(advantage / 2 + .5 > aggressionLevel)
+   {
+      mPrevTarget = target->getPos();
+      mHasPrevTarget = true;
+   }
+}
+
+
+BfObject *SBotBrain::getObjective(U8 objType)
+{
+   return getObjective(objType, false, TEAM_NEUTRAL, false);
+}
+
+
+BfObject *SBotBrain::getObjective(U8 objType, S32 team, bool onTeam)
+{
+   return getObjective(objType, true, team, onTeam);
+}
+
+
+// Returns the objective for the bot, in the form of an object the bot can navigate towards.  This makes bots choose
+// different defending locations.  If onTeam is true, will only return items on specified team.  If onTeam is false,
+// will return items *not* on specified team.  If useTeam is false, will ignore team altogether.
+BfObject *SBotBrain::getObjective(U8 objType, bool useTeam, S32 team, bool onTeam)
+{
+   mItems.clear();
+   mBot->getGame()->getGameObjDatabase()->findObjects(objType, mItems);
+
+   bool holdsFlags = mGameType == HTFGame || mGameType == RetrieveGame;
+
+   S32 count = 0;
+
+   for(S32 i = 0; i < mItems.size(); i++)
+   {
+      BfObject *item = static_cast<BfObject *>(mItems[i]);
+      S32 itemTeam = item->getTeam();
+      bool keep;
+
+      if(objType == FlagTypeNumber && mGameType == NexusGame)
+         keep = !static_cast<FlagItem *>(item)->isMounted();
+
+      else if(objType == FlagTypeNumber && holdsFlags && static_cast<FlagItem *>(item)->getZone())
+         keep = static_cast<FlagItem *>(item)->getZone()->getTeam() != mBot->getTeam();
+
+      else if(objType == GoalZoneTypeNumber && holdsFlags)
+         keep = (!useTeam || (itemTeam == team) == onTeam) && !static_cast<GoalZone *>(item)->hasFlag();
+
+      else
+      {
+         // Anything neutral is on our team (except zone control neutral goal zone)
+         if(itemTeam == TEAM_NEUTRAL && (objType != GoalZoneTypeNumber || mGameType != ZoneControlGame))
+            itemTeam = team;
+
+         keep = !useTeam || (itemTeam == team) == onTeam;
+      }
+
+      if(keep)
+      {
+         mItems[count] = mItems[i];
+         count++;
+      }
+   }
+
+   if(count == 0)
+      return NULL;
+
+   return static_cast<BfObject *>(mItems[mObjective % count]);
+}
+
+
+void SBotBrain::doObjective(Ship *closestEnemy)
+{
+   mGotoPositionWasNil = true;
+
+   S32 team = mBot->getTeam();
+   bool hasFlag = mBot->getFlagCount() > 0;
+
+   if(mGameType == BitmatchGame)
+   {
+      // Nothing to do here
+   }
+   else if(mGameType == NexusGame)
+   {
+      // Grab any flags that are found, and go to nexus when it opens
+      BfObject *otherFlag = getObjective(FlagTypeNumber);
+      if(otherFlag)
+         gotoPosition(otherFlag->getPos());
+
+      // If bot has more than 4 flags and the nexus is open or we're within 10 seconds of opening
+      NexusGameType *nexusGameType = static_cast<NexusGameType *>(mBot->getGame()->getGameType());
+
+      if(mBot->getFlagCount() > 4 && (nexusGameType->mNexusIsOpen || nexusGameType->getNexusTimeLeftMs() / 1000 < 10))
+      {
+         BfObject *nexus = getObjective(NexusTypeNumber);
+         if(nexus)
+            gotoPosition(nexus->getPos());
+      }
+   }
+   else if(mGameType == RabbitGame)
+   {
+      // Grab a flag, or go after the flag
+      if(!hasFlag)
+      {
+         BfObject *otherFlag = getObjective(FlagTypeNumber, team, true);
+         if(otherFlag)
+            gotoPosition(otherFlag->getPos());
+      }
+   }
+   else if(mGameType == HTFGame || mGameType == RetrieveGame)
+   {
+      // Grab the flag and put it into goal zones
+      BfObject *objective;
+
+      if(hasFlag)
+         objective = getObjective(GoalZoneTypeNumber, team, true);    // Find an available GoalZone on our team
+      else
+         objective = getObjective(FlagTypeNumber, team, true);        // Find flags on our team
+
+      if(objective)
+         gotoPosition(objective->getPos());
+   }
+   else if(mGameType == CTFGame)
+   {
+      FlagItem *myFlag    = static_cast<FlagItem *>(getObjective(FlagTypeNumber, team, true));     // Flags on our team
+      FlagItem *otherFlag = static_cast<FlagItem *>(getObjective(FlagTypeNumber, team, false));    // Flags not on our team
+
+      if(mDefense < .5)
+      {
+         if(hasFlag)
+         {
+            if(myFlag)
+            {
+               if(!myFlag->isMounted())
+                  gotoPosition(myFlag->getPos());
+               else
+                  gotoAndOrbitPosition(myFlag->getPos());      // Orbit the enemy carrying our flag
+            }
+         }
+         else
+         {
+            bool retrievingFlag = false;
+
+            // If our flag is lying around somewhere other than home, and within some sane range, go return it
+            if(myFlag && !myFlag->isAtHome() && !myFlag->isMounted() &&
+                  myFlag->getPos().distSquared(mBot->getPos()) <= 2000 * 2000)
+            {
+               gotoPosition(myFlag->getPos());
+               retrievingFlag = true;
+            }
+
+            if(otherFlag && !retrievingFlag)
+            {
+               if(myFlag && myFlag->isMounted())
+                  gotoPosition(myFlag->getPos());
+               else if(!otherFlag->isMounted())
+                  gotoPosition(otherFlag->getPos());
+               else
+                  gotoAndOrbitPosition(otherFlag->getPos());   // Orbit our team's flag carrier
+            }
+         }
+      }
+      else if(myFlag)
+      {
+         if(hasFlag)
+            gotoPosition(myFlag->getPos());
+         else if(myFlag->isAtHome() || myFlag->isMounted())
+            gotoAndOrbitPosition(myFlag->getPos());
+         else
+            gotoPosition(myFlag->getPos());
+      }
+   }
+   else if(mGameType == SoccerGame)
+   {
+      // Grab the ball and put it into the enemy goal
+      BfObject *objective;
+
+      if(mBot->isCarryingItem(SoccerBallItemTypeNumber))
+         objective = getObjective(GoalZoneTypeNumber, team, false);   // Find GoalZones not on our team
+      else
+         objective = getObjective(SoccerBallItemTypeNumber);
+
+      if(objective)
+         gotoPosition(objective->getPos());
+   }
+   else if(mGameType == ZoneControlGame)
+   {
+      // Grab flag, then go after zones that are not ours
+      if(!hasFlag)
+      {
+         FlagItem *otherFlag = static_cast<FlagItem *>(getObjective(FlagTypeNumber, team, true));
+
+         if(otherFlag)
+         {
+            if(otherFlag->isMounted())
+               gotoAndOrbitPosition(otherFlag->getPos());
+            else
+               gotoPosition(otherFlag->getPos());
+         }
+      }
+      else
+      {
+         BfObject *zone = getObjective(GoalZoneTypeNumber, team, false);
+         if(zone)
+            gotoPosition(zone->getPos());
+      }
+   }
+   else if(mGameType == CoreGame)
+   {
+      BfObject *core = getObjective(CoreTypeNumber, team, false);     // Find enemy Core
+      if(core)
+         gotoAndOrbitPosition(core->getPos());
+   }
+
+   // If we have nowhere to go, go to nearest enemy
+   if(mGotoPositionWasNil)
+   {
+      if(closestEnemy)
+      {
+         mPrevTarget = closestEnemy->getPos();
+         mHasPrevTarget = true;
+      }
+
+      if(mHasPrevTarget)
+         gotoAndOrbitPosition(mPrevTarget);
+   }
+}
+
+
+void SBotBrain::onTick(U32 deltaT)
+{
+   mBotPos = mBot->getPos();
+   mPathTimer -= deltaT;
+
+   Ship *closestEnemy = mBot->findClosestEnemy();
+
+   attackNearbyEnemies(closestEnemy, 1 - mAggression);
+   doObjective(closestEnemy);          // Set bot's objective
+
+   mBot->setThrust(mSpeed, mDirToGo);  // Move the ship
+   fireAtObjects();                    // Fire weapons
+   shield();                           // Apply shield
+
+   if(mPathTimer < 0)
+      mPathTimer = (F32)(PathTimerMax + TNL::Random::readI(0, PathTimerMax));
+}
+
+
+};
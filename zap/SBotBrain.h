@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _S_BOT_BRAIN_H_
+#define _S_BOT_BRAIN_H_
+
+#include "RobotBrain.h"
+
+#include "GameTypesEnum.h"
+#include "WeaponInfo.h"
+#include "Point.h"
+
+namespace Zap
+{
+
+class BfObject;
+class DatabaseObject;
+class Ship;
+
+// A line-for-line port of s_bot.bot, our standard bot, and the reference for anyone writing a native brain.  It takes
+// the same arguments as the script (difficulty, aggression, defense, speed, direction threshold) and makes the same
+// random draws in the same order, so the two should play alike.  Where the script would hit a Lua error and die (a
+// CTF level without a flag for our team, say), this carries on instead.
+class SBotBrain : public RobotBrain
+{
+   typedef RobotBrain Parent;
+
+private:
+   static const S32 PathTimerMax = 250;
+   static const S32 AverageMax = 20;
+
+   F32 mDifficulty;
+   F32 mAggression;
+   F32 mDefense;
+   F32 mSpeed;
+   F32 mDirectionThreshold;
+
+   F32 mBotRadius;
+   F32 mPathTimer;               // Time until we next ask for a waypoint
+   F32 mDirToGo;
+   Point mBotPos;                // Where we were at the start of this tick
+
+   Point mPrevTarget;
+   bool mHasPrevTarget;
+   bool mGotoPositionWasNil;     // True if our objective didn't give us anywhere to go
+
+   GameTypeId mGameType;
+
+   bool mAverageArray[AverageMax];
+   S32 mAverageIndex;
+   S32 mOrbitalDirection;
+   S32 mObjective;               // Picks which of several equivalent objectives is ours
+
+   Vector<DatabaseObject *> mFound;
+   Vector<DatabaseObject *> mItems;
+
+   F32 getArg(S32 index, F32 defaultValue);
+
+   bool shieldSelf();
+   void shield();
+   void fireAtObjects();
+   bool fireAtObject(BfObject *obj, WeaponType weapon);
+
+   void orbitPoint(const Point &pt, S32 direction, F32 distAway, F32 strictness);
+   void gotoPosition(const Point &pt);
+   void gotoAndOrbitPosition(const Point &pt);
+
+   void attackNearbyEnemies(Ship *target, F32 aggressionLevel);
+   BfObject *getObjective(U8 objType);
+   BfObject *getObjective(U8 objType, S32 team, bool onTeam);
+   BfObject *getObjective(U8 objType, bool useTeam, S32 team, bool onTeam);
+   void doObjective(Ship *closestEnemy);
+
+   bool isTeamGame();
+
+public:
+   SBotBrain(Robot *bot, const Vector<string> &args);   // Constructor
+   virtual ~SBotBrain();                               // Destructor
+
+   string getName();
+   void onStart();
+   void onTick(U32 deltaT);
+};
+
+
+};
+
+#endif
@@ -27,6 +27,11 @@
 
 #include "IniFile.h"
 
+#include "tnlNetBase.h"
+#include "tnlPlatform.h"
+
+#include <time.h>
+
 
 using namespace TNL;
 
@@ -34,19 +39,11 @@ namespace Zap
 {
 
 
-static bool instantiated;           // Just a little something to keep us from creating multiple ServerGames...
-
-
 // Constructor -- be sure to see Game constructor too!  Lots going on there!
 ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSourcePtr levelSource, bool testMode, bool dedicated, bool hostOnServer) : 
       Game(address, settings),
       mRobotManager(this, settings)
 {
-   TNLAssert(!instantiated, "Only one ServerGame at a time, please!  If this trips while testing, "
-      "it is probably because a test failed before another instance could be deleted.  Try disabling "
-      "this assert, see what test fails, and fix it.  Then re-enable it, please!");
-   instantiated = true;
-
    mLevelSource = levelSource;
 
    mVoteTimer = 0;
@@ -68,7 +65,7 @@ ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSo
 
    mShuttingDown = false;
 
-   EventManager::get()->setPaused(false);
+   mEventManager.setPaused(false);
 
    mInfoFlags = 0;                           // Currently used to specify test mode and debug builds
    mCurrentLevelIndex = 0;
@@ -119,7 +116,7 @@ ServerGame::ServerGame(const Address &address, GameSettingsPtr settings, LevelSo
    botControlTickTimer.reset(BotControlTickInterval);
 
    mLevelSwitchTimer.setPeriod(LevelSwitchTime);
-   GameManager::setHostingModePhase(GameManager::NotHosting);
+   mHostingModePhase = GameManager::NotHosting;
 
    mGameRecorderServer = NULL;
 }
@@ -135,13 +132,9 @@ ServerGame::~ServerGame()
 
    clearAddTarget();
 
-   instantiated = false;
-
    delete mGameInfo;
    delete mBotZoneDatabase;
 
-   GameManager::setHostingModePhase(GameManager::NotHosting);
-
    if(mGameRecorderServer)
       delete mGameRecorderServer;
 }
@@ -369,13 +362,16 @@ string ServerGame::loadNextLevelInfo()
    if(mLevelLoadIndex == mLevelSource->getLevelCount())
    {
       TNLAssert(mHostOnServer, "Shouldn't be empty if not using -hostonserver");
-      GameManager::setHostingModePhase(GameManager::DoneLoadingLevels);
+      setHostingModePhase(GameManager::DoneLoadingLevels);
       return string("No levels loaded");
    }
 
-   FolderManager *folderManager = getSettings()->getFolderManager();
+   // Levels remember which folder they came from, which won't be the main level folder for extra games
+   string folder = mLevelSource->getLevelInfo(mLevelLoadIndex).folder;
+   if(folder == "")
+      folder = getSettings()->getFolderManager()->levelDir;
 
-   string filename = folderManager->findLevelFile(mLevelSource->getLevelFileName(mLevelLoadIndex));
+   string filename = FolderManager::findLevelFile(folder, mLevelSource->getLevelFileName(mLevelLoadIndex));
    TNLAssert(filename != "", "Expected a filename here!");
 
    // populateLevelInfoFromSource() will return true if the level was processed successfully
@@ -390,7 +386,7 @@ string ServerGame::loadNextLevelInfo()
 
    // Last level to process?
    if(mLevelLoadIndex == mLevelSource->getLevelCount())
-      GameManager::setHostingModePhase(GameManager::DoneLoadingLevels);
+      setHostingModePhase(GameManager::DoneLoadingLevels);
 
    return levelName;
 }
@@ -719,7 +715,7 @@ void ServerGame::cycleLevel(S32 nextLevel)
 
    // Fire onPlayerJoined event for any players already on the server
    for(S32 i = 0; i < getClientCount(); i++)
-      EventManager::get()->fireEvent(NULL, EventManager::PlayerJoinedEvent, getClientInfo(i)->getPlayerInfo());
+      mEventManager.fireEvent(NULL, EventManager::PlayerJoinedEvent, getClientInfo(i)->getPlayerInfo());
 
 
    mRobotManager.balanceTeams();
@@ -755,7 +751,7 @@ void ServerGame::sendLevelStatsToMaster()
       return;
 
    // Also don't bother if we are not yet in full-on hosting mode
-   if(GameManager::getHostingModePhase() != GameManager::Hosting)
+   if(mHostingModePhase != GameManager::Hosting)
       return;
 
    MasterServerConnection *masterConn = getConnectionToMaster();
@@ -1094,7 +1090,7 @@ bool ServerGame::loadLevel()
       runLevelGenScript(scriptList[i]);
 
    // Fire an update to make sure certain events run on level start (like onShipSpawned)
-   EventManager::get()->update();
+   mEventManager.update();
 
    // Check after script, script might add Teams
    if(getGameType()->makeSureTeamCountIsNotZero())
@@ -1395,13 +1391,75 @@ bool ServerGame::isServer() const
 }
 
 
+// Totals since startup, one row per class that has sent anything, so the file can be graphed by diffing rows
+void ServerGame::writeNetStats()
+{
+   string filename = joindir(mSettings->getFolderManager()->logDir, "netstats.csv");
+   bool newFile = !fileExists(filename);
+
+   FILE *file = fopen(filename.c_str(), "a");
+   if(!file)
+   {
+      logprintf(LogConsumer::LogError, "Could not open %s to write net stats", filename.c_str());
+      return;
+   }
+
+   if(newFile)
+      fprintf(file, "time,class,type,initial_count,initial_bits,partial_count,partial_bits,pack_ms\n");
+
+   U32 now = (U32)time(NULL);
+
+   for(NetClassRep *rep = NetClassRep::getFirstClass(); rep; rep = rep->getNextClass())
+      if(rep->getInitialUpdateCount() > 0 || rep->getPartialUpdateCount() > 0)
+         fprintf(file, "%u,%s,%s,%llu,%llu,%llu,%llu,%.3f\n", now, rep->getClassName(),
+                 rep->getClassType() == NetClassTypeEvent ? "event" : "object",
+                 rep->getInitialUpdateCount(), rep->getInitialUpdateBitsUsed(),
+                 rep->getPartialUpdateCount(), rep->getPartialUpdateBitsUsed(),
+                 Platform::getHighPrecisionMilliseconds(rep->getPackTime()));
+
+   fclose(file);
+}
+
+
+void ServerGame::writeTickStats()
+{
+   string filename = joindir(mSettings->getFolderManager()->logDir, "tickstats.csv");
+   bool newFile = !fileExists(filename);
+
+   FILE *file = fopen(filename.c_str(), "a");
+   if(!file)
+   {
+      logprintf(LogConsumer::LogError, "Could not open %s to write tick stats", filename.c_str());
+      return;
+   }
+
+   if(newFile)
+      fprintf(file, "time,zone,kind,samples,p50_ms,p99_ms,max_ms\n");
+
+   U32 now = (U32)time(NULL);
+
+   for(U32 i = 0; i < TickProfiler::getZoneCount(); i++)
+   {
+      TickProfiler::ZoneStats stats = mTickProfiler.getStats(i);
+
+      if(stats.samples > 0)
+         fprintf(file, "%u,%s,%s,%u,%.3f,%.3f,%.3f\n", now, TickProfiler::getZoneName(i),
+                 TickProfiler::isTypeZone(i) ? "type" : "stage", stats.samples, stats.p50, stats.p99, stats.max);
+   }
+
+   fclose(file);
+}
+
+
 // Top-level idle loop for server, runs only on the server by definition
 void ServerGame::idle(U32 timeDelta)
 {
    // No idle during pre-game level loading
-   if(GameManager::getHostingModePhase() == GameManager::LoadingLevels)
+   if(mHostingModePhase == GameManager::LoadingLevels)
       return;
 
+   TICK_PROFILE_TICK(mTickProfiler);
+
    Parent::idle(timeDelta);
 
    processSimulatedStutter(timeDelta);
@@ -1432,6 +1490,29 @@ void ServerGame::idle(U32 timeDelta)
    if(mMasterUpdateTimer.update(timeDelta))
       updateStatusOnMaster();
 
+   // Periodically dump bandwidth stats, for whoever is monitoring this server.  The counters are kept per net class,
+   // so they cover every game this process is hosting; only the main game writes them out, or they'd appear once per game.
+   U32 netStatsDumpInterval = mSettings->getIniSettings()->netStatsDumpInterval;
+   if(netStatsDumpInterval > 0 && GameManager::getServerGame() == this)
+   {
+      if(mNetStatsDumpTimer.update(timeDelta))
+         writeNetStats();
+
+      if(mNetStatsDumpTimer.getCurrent() == 0)
+         mNetStatsDumpTimer.reset(netStatsDumpInterval * 1000);
+   }
+
+   // Likewise for tick timings
+   U32 tickStatsDumpInterval = mSettings->getIniSettings()->tickStatsDumpInterval;
+   if(tickStatsDumpInterval > 0)
+   {
+      if(mTickStatsDumpTimer.update(timeDelta))
+         writeTickStats();
+
+      if(mTickStatsDumpTimer.getCurrent() == 0)
+         mTickStatsDumpTimer.reset(tickStatsDumpInterval * 1000);
+   }
+
    // If we have a data transfer going on, process it
    if(!dataSender.isDone())
       dataSender.sendNextLine();
@@ -1445,6 +1526,7 @@ void ServerGame::idle(U32 timeDelta)
 
    if(mGameSuspended)     // If game is suspended, we need do nothing more
    {
+      TICK_PROFILE_STAGE(mTickProfiler, StageConnections);
       mNetInterface->processConnections();
       return;
    }
@@ -1466,8 +1548,12 @@ void ServerGame::idle(U32 timeDelta)
    }
 
    // Tick levelgen timers
-   for(S32 i = 0; i < mLevelGens.size(); i++)
-      mLevelGens[i]->tickTimer<LuaLevelGenerator>(timeDelta);
+   {
+      TICK_PROFILE_STAGE(mTickProfiler, StageScripts);
+
+      for(S32 i = 0; i < mLevelGens.size(); i++)
+         mLevelGens[i]->tickTimer<LuaLevelGenerator>(timeDelta);
+   }
 
    // Check for any levelgens that must die
    for(S32 i = 0; i < mLevelGenDeleteList.size(); i++)
@@ -1486,38 +1572,64 @@ void ServerGame::idle(U32 timeDelta)
 
    if(botControlTickTimer.update(timeDelta))
    {
+      TICK_PROFILE_STAGE(mTickProfiler, StageScripts);
+
       // Clear all old bot moves, so that if the bot does nothing, it doesn't just continue with what it was doing before
       mRobotManager.clearMoves();
 
       // Fire TickEvent, in case anyone is listening
-      EventManager::get()->fireEvent(EventManager::TickEvent, botControlTickElapsed + timeDelta);
+      mEventManager.fireEvent(EventManager::TickEvent, botControlTickElapsed + timeDelta);
+
+      // Bots with native brains think right after the scripted ones, and hold still when scripting is paused
+      if(!mEventManager.isPaused())
+         mRobotManager.runBrains(botControlTickElapsed + timeDelta);
 
       botControlTickTimer.reset();
    }
    
-   const Vector<DatabaseObject *> *gameObjects = mGameObjDatabase->findObjects_fast();
+   mTargetIndex.startTick(mGameObjDatabase.get());
 
-   // Visit each game object, handling moves and running its idle method
-   for(S32 i = gameObjects->size() - 1; i >= 0; i--)
+   // Bullets go before everything else; any fired in the object loop below first move next tick, as they always have
    {
-      BfObject *obj = static_cast<BfObject *>((*gameObjects)[i]);
+      TICK_PROFILE_STAGE(mTickProfiler, StageProjectiles);
+      mProjectileSystem.idle(mGameObjDatabase.get(), timeDelta);
+   }
 
-      if(obj->isDeleted())
-         continue;
+   {
+      TICK_PROFILE_STAGE(mTickProfiler, StageObjectIdle);
 
-      // Here is where the time gets set for all the various object moves
-      Move thisMove = obj->getCurrentMove();
-      thisMove.time = timeDelta;
+      const Vector<DatabaseObject *> *gameObjects = mGameObjDatabase->findObjects_fast();
 
-      // Give the object its move, then have it idle
-      obj->setCurrentMove(thisMove);
-      obj->idle(BfObject::ServerIdleMainLoop);
+      // Visit each game object, handling moves and running its idle method
+      for(S32 i = gameObjects->size() - 1; i >= 0; i--)
+      {
+         BfObject *obj = static_cast<BfObject *>((*gameObjects)[i]);
+
+         if(obj->isDeleted())
+            continue;
+
+         TICK_PROFILE_TYPE(mTickProfiler, obj->getObjectTypeNumber());
+
+         // Here is where the time gets set for all the various object moves
+         Move thisMove = obj->getCurrentMove();
+         thisMove.time = timeDelta;
+
+         // Give the object its move, then have it idle
+         obj->setCurrentMove(thisMove);
+         obj->idle(BfObject::ServerIdleMainLoop);
+      }
    }
 
    if(mGameType)
+   {
+      TICK_PROFILE_STAGE(mTickProfiler, StageGameType);
       mGameType->idle(BfObject::ServerIdleMainLoop, timeDelta);
+   }
 
-   processDeleteList(timeDelta);
+   {
+      TICK_PROFILE_STAGE(mTickProfiler, StageDeleteList);
+      processDeleteList(timeDelta);
+   }
 
    // Load a new level if the time is out on the current one
    if(mLevelSwitchTimer.update(timeDelta))
@@ -1560,12 +1672,30 @@ void ServerGame::idle(U32 timeDelta)
 
 
    if(mGameRecorderServer)
+   {
+      TICK_PROFILE_STAGE(mTickProfiler, StageGameRecorder);
       mGameRecorderServer->idle(timeDelta);
+   }
 
+   // When the scheduler is sending packets on its own cadence, leave them to it
+   if(mTickScheduler.isSchedulingSends())
+      return;
+
+   TICK_PROFILE_STAGE(mTickProfiler, StageConnections);
    mNetInterface->processConnections(); // Update to other clients right after idling everything else, so clients get more up to date information
 }
 
 
+// Called by the dedicated server's scheduler, between ticks, when packets are due
+void ServerGame::sendPackets()
+{
+   TICK_PROFILE_STAGE(mTickProfiler, StageConnections);
+
+   mNetInterface->checkIncomingPackets();
+   mNetInterface->processConnections();
+}
+
+
 void ServerGame::processSimulatedStutter(U32 timeDelta)
 {
    // Simulate CPU stutter without impacting ClientGames
@@ -1834,7 +1964,7 @@ bool ServerGame::startHosting()
 
    if(mHostOnServer)
    {
-      GameManager::setHostingModePhase(GameManager::NotHosting);
+      setHostingModePhase(GameManager::NotHosting);
       cycleLevel(FIRST_LEVEL);   // Start with the first level
       return true;
    }
@@ -1848,7 +1978,7 @@ bool ServerGame::startHosting()
    if(!levelCount)            // No levels loaded... we'll crash if we try to start a game       
       return false;
 
-   GameManager::setHostingModePhase(GameManager::NotHosting);
+   setHostingModePhase(GameManager::NotHosting);
    cycleLevel(FIRST_LEVEL);   // Start with the first level
 
    return true;
@@ -1947,6 +2077,48 @@ void ServerGame::queueVoiceChatBuffer(const SFXHandle &effect, const ByteBufferP
 }
 
 
+ProjectileSystem *ServerGame::getProjectileSystem()
+{
+   return &mProjectileSystem;
+}
+
+
+TargetIndex *ServerGame::getTargetIndex()
+{
+   return &mTargetIndex;
+}
+
+
+ZoneCoverage *ServerGame::getZoneCoverage()
+{
+   return &mZoneCoverage;
+}
+
+
+TickProfiler *ServerGame::getTickProfiler()
+{
+   return &mTickProfiler;
+}
+
+
+TickScheduler *ServerGame::getTickScheduler()
+{
+   return &mTickScheduler;
+}
+
+
+GameManager::HostingModePhase ServerGame::getHostingModePhase() const
+{
+   return mHostingModePhase;
+}
+
+
+void ServerGame::setHostingModePhase(GameManager::HostingModePhase phase)
+{
+   mHostingModePhase = phase;
+}
+
+
 LuaGameInfo *ServerGame::getGameInfo()
 {
    // Lazily initialize
@@ -2005,6 +2177,8 @@ void ServerGame::setGameType(GameType *gameType)
 
 void ServerGame::onObjectAdded(BfObject *obj)
 {
+   mTargetIndex.onObjectAdded(obj);
+
    if(mGameRecorderServer && obj->isGhostable())
       mGameRecorderServer->objectLocalScopeAlways(obj);
 }
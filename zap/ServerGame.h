@@ -10,9 +10,15 @@
 
 #include "BotNavMeshZone.h"
 #include "dataConnection.h"
+#include "GameManager.h"         // For HostingModePhase def
 #include "LevelSource.h"         // For LevelSourcePtr def
 #include "LevelSpecifierEnum.h"
 #include "RobotManager.h"
+#include "ProjectileSystem.h"
+#include "TargetIndex.h"
+#include "TickProfiler.h"
+#include "TickScheduler.h"
+#include "ZoneCoverage.h"
 
 #include "Intervals.h"
 
@@ -55,6 +61,8 @@ private:
    U32 mCurrentLevelIndex;                // Index of level currently being played
    Timer mLevelSwitchTimer;               // Track how long after game has ended before we actually switch levels
    Timer mMasterUpdateTimer;              // Periodically let the master know how we're doing
+   Timer mNetStatsDumpTimer;              // Periodically write out bandwidth stats, if NetStatsDumpInterval is set
+   Timer mTickStatsDumpTimer;             // Periodically write out tick timings, if TickStatsDumpInterval is set
 
    bool mShuttingDown;
    string mShutdownReason;                // Message to local user about why we're shutting down, optional
@@ -86,6 +94,12 @@ private:
    U32 mAccumulatedSleepTime;
 
    RobotManager mRobotManager;
+   TargetIndex mTargetIndex;              // What turrets and seekers can shoot at this tick
+   ProjectileSystem mProjectileSystem;    // Moves all the bullets at once
+   ZoneCoverage mZoneCoverage;            // Which zones cover which parts of the level
+   TickProfiler mTickProfiler;            // Where the time in idle() goes
+   TickScheduler mTickScheduler;          // When a dedicated server runs its ticks and sends its packets
+   GameManager::HostingModePhase mHostingModePhase;
 
    Vector<LuaLevelGenerator *> mLevelGens;
    Vector<LuaLevelGenerator *> mLevelGenDeleteList;
@@ -94,6 +108,8 @@ private:
    Vector<string> mSentHashes;            // Hashes of levels already sent to master
 
    void updateStatusOnMaster();           // Give master a status report for this server
+   void writeNetStats();                  // Append bandwidth used by each net class, by all games, to netstats.csv
+   void writeTickStats();                 // Append timings for each tick profiler zone to tickstats.csv
    void processVoting(U32 timeDelta);     // Manage any ongoing votes
    void processSimulatedStutter(U32 timeDelta);
 
@@ -221,6 +237,7 @@ public:
 
    bool isServer() const;
    void idle(U32 timeDelta);
+   void sendPackets();                 // Send to clients now, rather than at the end of idle()
    bool isReadyToShutdown(U32 timeDelta, string &shutdownReason);
    void gameEnded();
 
@@ -259,6 +276,14 @@ public:
    void queueVoiceChatBuffer(const SFXHandle &effect, const ByteBufferPtr &p) const;
 
    LuaGameInfo *getGameInfo();
+   TargetIndex *getTargetIndex();
+   ProjectileSystem *getProjectileSystem();
+   ZoneCoverage *getZoneCoverage();
+   TickProfiler *getTickProfiler();
+   TickScheduler *getTickScheduler();
+
+   GameManager::HostingModePhase getHostingModePhase() const;
+   void setHostingModePhase(GameManager::HostingModePhase phase);
 
    /////
    // BotNavMeshZone management
@@ -9,6 +9,8 @@
 #include "GameSettings.h"
 #include "ServerGame.h"
 #include "LevelSource.h"
+#include "config.h"
+#include "IniFile.h"
 
 #ifndef ZAP_DEDICATED
 #  include "ClientGame.h"
@@ -84,6 +86,59 @@ void initHosting(GameSettingsPtr settings, LevelSourcePtr levelSource, bool test
 }
 
 
+// Host another game on a dedicated server, alongside the one initHosting() started.  It takes its settings from
+// iniFile, which needs at least its own ServerAddress, and gets its own level rotation from that file's LevelDir.
+// It shares the process's Lua interpreter, FolderManager and master server, but nothing that happens in a game.
+// Levels are all loaded up front, rather than one per frame, as there's no one waiting on this game to start.
+void initExtraHosting(const string &iniFile)
+{
+   GameSettingsPtr settings = GameSettingsPtr(new GameSettings());
+   FolderManager *folderManager = settings->getFolderManager();
+
+   CIniFile ini(joindir(folderManager->iniDir, iniFile));
+   loadSettingsFromINI(&ini, settings.get());
+
+   string levelDir = folderManager->resolveLevelDir(settings->getIniSettings()->levelDir);
+   if(levelDir == "")
+      levelDir = folderManager->levelDir;
+
+   LevelSourcePtr levelSource = LevelSourcePtr(new FolderLevelSource(settings->getLevelList(levelDir), levelDir));
+
+   if(levelSource->getLevelCount() == 0)
+   {
+      logprintf(LogConsumer::LogError, "No levels found in folder %s.  Cannot host the game in %s.", levelDir.c_str(), iniFile.c_str());
+      return;
+   }
+
+   Address address(IPProtocol, Address::Any, GameSettings::DEFAULT_GAME_PORT);
+   address.set(settings->getHostAddress());
+
+   ServerGame *serverGame = new ServerGame(address, settings, levelSource, false, true, false);
+
+   // Each game lists itself with the master separately, over its own connection, so players see it as a server
+   // in its own right
+   serverGame->setReadyToConnectToMaster(true);
+
+   serverGame->resetLevelLoadIndex();
+   serverGame->setHostingModePhase(GameManager::LoadingLevels);
+
+   while(serverGame->getHostingModePhase() == GameManager::LoadingLevels)
+      serverGame->loadNextLevelInfo();
+
+   if(!serverGame->startHosting())
+   {
+      logprintf(LogConsumer::LogError, "No loadable levels found in folder %s.  Cannot host the game in %s.", levelDir.c_str(), iniFile.c_str());
+      delete serverGame;
+      return;
+   }
+
+   logprintf(LogConsumer::ServerFilter, "Also hosting hostname=[%s] on %s with %d levels", settings->getHostName().c_str(),
+             address.toString(), levelSource->getLevelCount());
+
+   GameManager::addServerGame(serverGame);
+}
+
+
 void shutdownBitfighter();    // Forward declaration
 
 // If we can't load any levels, here's the plan...
@@ -28,6 +28,7 @@ typedef shared_ptr<GameSettings> GameSettingsPtr;
 
 
 extern void initHosting(GameSettingsPtr settings, LevelSourcePtr levelSource, bool testMode, bool dedicatedServer, bool hostOnServer = false);
+extern void initExtraHosting(const string &iniFile);
 extern void abortHosting_noLevels(ServerGame *serverGame);
 extern bool writeToConsole();
 extern string getInstalledDataDir();
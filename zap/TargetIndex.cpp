@@ -0,0 +1,199 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TargetIndex.h"
+
+#include "gridDB.h"
+#include "moveObject.h"    // For ActualState
+
+namespace Zap
+{
+
+bool TargetIndex::VisibilityKey::operator<(const VisibilityKey &other) const
+{
+   if(viewerSerialNumber != other.viewerSerialNumber)
+      return viewerSerialNumber < other.viewerSerialNumber;
+   if(fromX != other.fromX)
+      return fromX < other.fromX;
+   if(fromY != other.fromY)
+      return fromY < other.fromY;
+   if(targetSerialNumber != other.targetSerialNumber)
+      return targetSerialNumber < other.targetSerialNumber;
+
+   return blockers < other.blockers;
+}
+
+
+// Anything a turret or seeker might go after
+static bool isIndexedTargetType(U8 x)
+{
+   return isTurretTargetType(x) || isSeekerTarget(x);
+}
+
+
+// Constructor
+TargetIndex::TargetIndex()
+{
+   mDatabase = NULL;
+   mValid = false;
+   mVisibilityTests = 0;
+   mVisibilityHits = 0;
+}
+
+
+void TargetIndex::startTick(GridDatabase *database)
+{
+   mDatabase = database;
+   mValid = false;
+   mTeams.clear();
+   mVisibility.clear();
+   mVisibilityTests = 0;
+   mVisibilityHits = 0;
+}
+
+
+// Once the list has been gathered this tick, anything that can be targeted goes straight onto it
+void TargetIndex::onObjectAdded(BfObject *obj)
+{
+   if(mValid && obj->getDatabase() == mDatabase && isIndexedTargetType(obj->getObjectTypeNumber()))
+      getTeam(obj->getTeam()).targets.push_back(obj);
+}
+
+
+TargetIndex::TeamTargets &TargetIndex::getTeam(S32 team)
+{
+   for(S32 i = 0; i < mTeams.size(); i++)
+      if(mTeams[i].team == team)
+         return mTeams[i];
+
+   mTeams.resize(mTeams.size() + 1);
+   mTeams.last().team = team;
+   return mTeams.last();
+}
+
+
+void TargetIndex::build()
+{
+   mValid = true;
+
+   if(!mDatabase)
+      return;
+
+   static Vector<DatabaseObject *> fillVector;
+   fillVector.clear();
+
+   mDatabase->findObjects((TestFunc)isIndexedTargetType, fillVector);
+
+   for(S32 i = 0; i < fillVector.size(); i++)
+   {
+      BfObject *obj = static_cast<BfObject *>(fillVector[i]);
+      getTeam(obj->getTeam()).targets.push_back(obj);
+   }
+}
+
+
+void TargetIndex::addTargets(const TeamTargets &teamTargets, TestFunc testFunc, const Rect &rect, Vector<DatabaseObject *> &fillVector) const
+{
+   for(S32 i = 0; i < teamTargets.targets.size(); i++)
+   {
+      BfObject *obj = teamTargets.targets[i];
+
+      if(obj && testFunc(obj->getObjectTypeNumber()) && obj->getDatabase() == mDatabase && obj->getExtent().intersects(rect))
+         fillVector.push_back(obj);
+   }
+}
+
+
+void TargetIndex::findTargets(TestFunc testFunc, const Rect &rect, Vector<DatabaseObject *> &fillVector)
+{
+   if(!mValid)
+      build();
+
+   for(S32 i = 0; i < mTeams.size(); i++)
+      addTargets(mTeams[i], testFunc, rect, fillVector);
+}
+
+
+void TargetIndex::findEnemyTargets(S32 team, TestFunc testFunc, const Rect &rect, Vector<DatabaseObject *> &fillVector)
+{
+   if(!mValid)
+      build();
+
+   for(S32 i = 0; i < mTeams.size(); i++)
+      if(mTeams[i].team != team)
+         addTargets(mTeams[i], testFunc, rect, fillVector);
+}
+
+
+bool TargetIndex::canSee(BfObject *viewer, const Point &from, BfObject *target, Blockers blockers)
+{
+   mVisibilityTests++;
+
+   VisibilityKey key;
+   key.viewerSerialNumber = viewer->getSerialNumber();
+   key.fromX = from.x;
+   key.fromY = from.y;
+   key.targetSerialNumber = target->getSerialNumber();
+   key.blockers = blockers;
+
+   map<VisibilityKey, bool>::iterator it = mVisibility.find(key);
+
+   if(it != mVisibility.end())
+   {
+      mVisibilityHits++;
+      return it->second;
+   }
+
+   bool visible = isVisible(viewer, from, target, blockers);
+   mVisibility[key] = visible;
+
+   return visible;
+}
+
+
+bool TargetIndex::isVisible(BfObject *viewer, const Point &from, BfObject *target, Blockers blockers) const
+{
+   if(!mDatabase)
+      return true;
+
+   if(blockers == BlockedByWalls)
+   {
+      F32 t;
+      Point n;
+      return mDatabase->findObjectLOS((TestFunc)isWallType, ActualState, from, target->getPos(), t, n) == NULL;
+   }
+
+   // Collideables -- we need to ask each one whether it's solid right now (forcefields may be down)
+   static Vector<DatabaseObject *> fillVector;
+   fillVector.clear();
+   mDatabase->findObjects((TestFunc)isCollideableType, fillVector, Rect(from, target->getPos()));
+
+   F32 dummy;
+
+   for(S32 i = 0; i < fillVector.size(); i++)
+   {
+      BfObject *collideObject = static_cast<BfObject *>(fillVector[i]);
+
+      if(collideObject->collide(viewer) && viewer->objectIntersectsSegment(collideObject, from, target->getPos(), dummy))
+         return false;
+   }
+
+   return true;
+}
+
+
+U32 TargetIndex::getVisibilityTestCount() const
+{
+   return mVisibilityTests;
+}
+
+
+U32 TargetIndex::getVisibilityHitCount() const
+{
+   return mVisibilityHits;
+}
+
+
+};
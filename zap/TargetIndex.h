@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _TARGET_INDEX_H_
+#define _TARGET_INDEX_H_
+
+#include "BfObject.h"      // For TestFunc, SafePtr<BfObject>
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+#include <map>
+
+using namespace TNL;
+using namespace std;
+
+namespace Zap
+{
+
+class GridDatabase;
+
+// Server-side list of everything turrets and seekers might shoot at, grouped by team and gathered once per
+// tick, plus a cache of which of those targets each viewer can see.  A level full of turrets, or a swarm
+// of seekers, would otherwise have each of them query the database for the same ships, all on the same tick.
+// Targets that arrive mid-tick are added to the list as they come; see onObjectAdded().
+class TargetIndex
+{
+public:
+   enum Blockers {
+      BlockedByWalls,            // Only walls block the view (turrets)
+      BlockedByCollideables      // Anything collideable that is currently solid, like a raised forcefield (seekers)
+   };
+
+private:
+   struct TeamTargets
+   {
+      S32 team;
+      Vector<SafePtr<BfObject> > targets;
+   };
+
+   // Only the same viewer, looking from exactly the same spot, gets a cached answer; a viewer a few units away
+   // may be on the other side of a wall corner
+   struct VisibilityKey
+   {
+      S32 viewerSerialNumber;
+      F32 fromX;
+      F32 fromY;
+      S32 targetSerialNumber;
+      Blockers blockers;
+
+      bool operator<(const VisibilityKey &other) const;
+   };
+
+   GridDatabase *mDatabase;
+   bool mValid;
+   Vector<TeamTargets> mTeams;
+   map<VisibilityKey, bool> mVisibility;
+
+   U32 mVisibilityTests;
+   U32 mVisibilityHits;
+
+   void build();
+   TeamTargets &getTeam(S32 team);
+   void addTargets(const TeamTargets &teamTargets, TestFunc testFunc, const Rect &rect, Vector<DatabaseObject *> &fillVector) const;
+
+   bool isVisible(BfObject *viewer, const Point &from, BfObject *target, Blockers blockers) const;
+
+public:
+   TargetIndex();    // Constructor
+
+   void startTick(GridDatabase *database);    // Throws out last tick's targets and visibility
+   void onObjectAdded(BfObject *obj);         // Lets new arrivals be targeted this tick, not just from the next
+
+   // Targets of types passing testFunc whose extents touch rect.  findEnemyTargets() leaves out team's own objects.
+   void findTargets(TestFunc testFunc, const Rect &rect, Vector<DatabaseObject *> &fillVector);
+   void findEnemyTargets(S32 team, TestFunc testFunc, const Rect &rect, Vector<DatabaseObject *> &fillVector);
+
+   // True if viewer, at from, has a clear line to target.  Answers are remembered for the rest of the tick.
+   bool canSee(BfObject *viewer, const Point &from, BfObject *target, Blockers blockers);
+
+   U32 getVisibilityTestCount() const;    // Calls to canSee() this tick
+   U32 getVisibilityHitCount() const;     // ...and how many of them were answered from the cache
+};
+
+
+};
+
+#endif
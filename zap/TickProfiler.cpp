@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TickProfiler.h"
+
+#include "BfObject.h"      // For TypeNumbers
+
+#include <algorithm>
+
+namespace Zap
+{
+
+static const char *stageNames[] = {
+   "Tick",
+   "Scripts",
+   "Projectiles",
+   "ObjectIdle",
+   "GameType",
+   "DeleteList",
+   "GameRecorder",
+   "Connections",
+};
+
+static const char *typeNames[] = {
+#  define TYPE_NUMBER(value, shareWithLua, name, luaName)  name,
+      TYPE_NUMBER_TABLE
+#  undef TYPE_NUMBER
+};
+
+
+// Constructor
+TickProfiler::TickProfiler()
+{
+   mZones.resize(getZoneCount());
+
+   for(S32 i = 0; i < mZones.size(); i++)
+      mZones[i].history.resize(HistoryLength);
+
+   reset();
+}
+
+
+void TickProfiler::endTick()
+{
+   for(S32 i = 0; i < mZones.size(); i++)
+   {
+      Zone &zone = mZones[i];
+
+      if(!zone.entered)
+         continue;
+
+      F64 ms = Platform::getHighPrecisionMilliseconds(zone.elapsed);
+
+      zone.history[zone.next] = F32(ms);
+      zone.totalTime += ms;
+      zone.totalCount++;
+      zone.next = (zone.next + 1) % HistoryLength;
+
+      if(zone.count < HistoryLength)
+         zone.count++;
+
+      zone.elapsed = 0;
+      zone.entered = false;
+   }
+
+   mTickCount++;
+}
+
+
+void TickProfiler::reset()
+{
+   for(S32 i = 0; i < mZones.size(); i++)
+   {
+      mZones[i].elapsed = 0;
+      mZones[i].entered = false;
+      mZones[i].next = 0;
+      mZones[i].count = 0;
+      mZones[i].totalTime = 0;
+      mZones[i].totalCount = 0;
+   }
+
+   mTickCount = 0;
+}
+
+
+U32 TickProfiler::getZoneCount()
+{
+   return StageCount + TypesNumbers;
+}
+
+
+U32 TickProfiler::getTypeZone(U8 typeNumber)
+{
+   return StageCount + typeNumber;
+}
+
+
+const char *TickProfiler::getZoneName(U32 zone)
+{
+   if(zone < StageCount)
+      return stageNames[zone];
+
+   return typeNames[zone - StageCount];
+}
+
+
+bool TickProfiler::isTypeZone(U32 zone)
+{
+   return zone >= StageCount;
+}
+
+
+// Percentiles use the nearest rank, so they're always a time we actually saw
+TickProfiler::ZoneStats TickProfiler::getStats(U32 zone) const
+{
+   const Zone &z = mZones[zone];
+
+   ZoneStats stats;
+   stats.samples = z.count;
+   stats.mean = 0;
+   stats.p50 = 0;
+   stats.p99 = 0;
+   stats.max = 0;
+
+   if(z.count == 0)
+      return stats;
+
+   stats.mean = F32(z.totalTime / z.totalCount);
+
+   // The oldest samples are overwritten first, so until the ring fills the samples are at the front
+   Vector<F32> sorted(z.count);
+   for(U32 i = 0; i < z.count; i++)
+      sorted.push_back(z.history[i]);
+
+   std::sort(sorted.address(), sorted.address() + sorted.size());
+
+   stats.p50 = sorted[(z.count * 50 + 99) / 100 - 1];
+   stats.p99 = sorted[(z.count * 99 + 99) / 100 - 1];
+   stats.max = sorted.last();
+
+   return stats;
+}
+
+
+U32 TickProfiler::getTickCount() const
+{
+   return mTickCount;
+}
+
+
+};
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _TICK_PROFILER_H_
+#define _TICK_PROFILER_H_
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+#include "tnlPlatform.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Times the stages of ServerGame::idle, and the object idles for each TypeNumber, so we can tell where a hitch
+// came from.  Each zone adds up the time spent in it over a tick; at the end of the tick that total goes into a
+// ring of recent samples, from which we work out the p50, p99 and max on demand.  Zones that weren't entered
+// during a tick don't record a sample, so a type with nothing on the map doesn't drag its numbers down to 0.
+// Time added between ticks, such as packets the scheduler sends on their own cadence, counts toward the next tick.
+//
+// Build with BF_NO_TICK_PROFILER to compile out the timers; the profiler then never records anything.
+class TickProfiler
+{
+public:
+   enum Stage {
+      StageTick,                 // All of ServerGame::idle
+      StageScripts,              // Levelgen timers, the robot TickEvent, and native robot brains
+      StageProjectiles,
+      StageObjectIdle,           // The whole object loop; broken down by type in the type zones
+      StageGameType,
+      StageDeleteList,
+      StageGameRecorder,
+      StageConnections,          // processConnections(), which is mostly ghost packing
+      StageCount
+   };
+
+   enum {
+      HistoryLength = 512        // Ticks kept per zone
+   };
+
+   struct ZoneStats
+   {
+      U32 samples;
+      F32 mean;      // All times in ms; the mean is over every sample since the last reset, the rest only the ring
+      F32 p50;
+      F32 p99;
+      F32 max;
+   };
+
+private:
+   struct Zone
+   {
+      S64 elapsed;               // Timer ticks accumulated during the current tick
+      bool entered;
+      Vector<F32> history;       // Ring of per-tick totals, in ms
+      U32 next;                  // Where the next sample goes
+      U32 count;                 // Samples in the ring, up to HistoryLength
+      F64 totalTime;             // Sum of every sample since the last reset, in ms
+      U32 totalCount;
+   };
+
+   Vector<Zone> mZones;
+   U32 mTickCount;
+
+public:
+   TickProfiler();   // Constructor
+
+   void endTick();
+
+   void addTime(U32 zone, S64 timerDelta)
+   {
+      mZones[zone].elapsed += timerDelta;
+      mZones[zone].entered = true;
+   }
+
+   void reset();
+
+   static U32 getZoneCount();
+   static U32 getTypeZone(U8 typeNumber);
+   static const char *getZoneName(U32 zone);
+   static bool isTypeZone(U32 zone);
+
+   ZoneStats getStats(U32 zone) const;
+   U32 getTickCount() const;     // Ticks profiled since startup or the last reset
+};
+
+
+// Adds the time between its construction and destruction to a zone
+class TickProfilerScope
+{
+private:
+   TickProfiler &mProfiler;
+   U32 mZone;
+   S64 mStart;
+
+public:
+   TickProfilerScope(TickProfiler &profiler, U32 zone) : mProfiler(profiler), mZone(zone)
+   {
+      mStart = Platform::getHighPrecisionTimerValue();
+   }
+
+   ~TickProfilerScope()
+   {
+      mProfiler.addTime(mZone, Platform::getHighPrecisionTimerValue() - mStart);
+   }
+};
+
+
+// Wraps a whole tick, so the samples get recorded however we leave ServerGame::idle
+class TickProfilerTick
+{
+private:
+   TickProfiler &mProfiler;
+   S64 mStart;
+
+public:
+   TickProfilerTick(TickProfiler &profiler) : mProfiler(profiler)
+   {
+      mStart = Platform::getHighPrecisionTimerValue();
+   }
+
+   ~TickProfilerTick()
+   {
+      mProfiler.addTime(TickProfiler::StageTick, Platform::getHighPrecisionTimerValue() - mStart);
+      mProfiler.endTick();
+   }
+};
+
+
+#ifdef BF_NO_TICK_PROFILER
+#  define TICK_PROFILE_TICK(profiler)
+#  define TICK_PROFILE_STAGE(profiler, stage)
+#  define TICK_PROFILE_TYPE(profiler, typeNumber)
+#else
+#  define TICK_PROFILE_TICK(profiler)              TickProfilerTick  tickProfilerTick(profiler)
+#  define TICK_PROFILE_STAGE(profiler, stage)      TickProfilerScope tickProfilerStage(profiler, TickProfiler::stage)
+#  define TICK_PROFILE_TYPE(profiler, typeNumber)  TickProfilerScope tickProfilerType(profiler, TickProfiler::getTypeZone(typeNumber))
+#endif
+
+
+};
+
+#endif
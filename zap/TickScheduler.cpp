@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "TickScheduler.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace Zap
+{
+
+// Constructor
+TickScheduler::TickScheduler()
+{
+   mTickRate = 100;
+   mTickPeriod = 10;
+   mSendRate = 0;
+   mSendPeriod = 0;
+   mMaxCatchUpTicks = 10;
+
+   mRunning = false;
+   mNextTick = 0;
+   mNextSend = 0;
+
+   resetStats();
+}
+
+
+// Ticks are a whole number of ms, as that's what ServerGame::idle takes, so rates that don't divide
+// into 1000 end up running a little fast
+void TickScheduler::setTickRate(U32 ticksPerSecond)
+{
+   mTickRate = ticksPerSecond;
+   mTickPeriod = max(1000 / max(ticksPerSecond, 1u), 1u);
+}
+
+
+void TickScheduler::setSendRate(U32 sendsPerSecond)
+{
+   mSendRate = sendsPerSecond;
+   mSendPeriod = sendsPerSecond > 0 ? 1000.0 / sendsPerSecond : 0;
+}
+
+
+void TickScheduler::setMaxCatchUpTicks(U32 ticks)
+{
+   mMaxCatchUpTicks = max(ticks, 1u);
+}
+
+
+U32 TickScheduler::getTickPeriod() const
+{
+   return mTickPeriod;
+}
+
+
+// As requested, which may not be quite what we run at; see setTickRate()
+U32 TickScheduler::getTickRate() const
+{
+   return mTickRate;
+}
+
+
+U32 TickScheduler::getSendRate() const
+{
+   return mSendRate;
+}
+
+
+void TickScheduler::start(F64 now)
+{
+   mRunning = true;
+   mNextTick = now;
+   mNextSend = now + mSendPeriod;
+}
+
+
+void TickScheduler::stop()
+{
+   mRunning = false;
+}
+
+
+bool TickScheduler::isRunning() const
+{
+   return mRunning;
+}
+
+
+// True if packets should go out when isSendDue() says so, rather than at the end of each tick
+bool TickScheduler::isSchedulingSends() const
+{
+   return mRunning && mSendPeriod > 0;
+}
+
+
+U32 TickScheduler::getTicksDue(F64 now)
+{
+   if(!mRunning)
+      return 0;
+
+   // A clock that's been set back would otherwise leave us waiting, tickless, until it caught up again
+   if(now < mNextTick - mTickPeriod)
+   {
+      start(now);
+      mStats.clockResets++;
+   }
+
+   if(now < mNextTick)
+      return 0;
+
+   F64 lateness = now - mNextTick;
+   U32 due = U32(lateness / mTickPeriod) + 1;
+
+   mStats.maxLateness = max(mStats.maxLateness, lateness);
+
+   // Skip over the deadlines we won't be running, so we stay on the same grid
+   mNextTick += F64(due) * mTickPeriod;
+
+   if(due > mMaxCatchUpTicks)
+   {
+      mStats.droppedTicks += due - mMaxCatchUpTicks;
+      due = mMaxCatchUpTicks;
+   }
+
+   mStats.ticks += due;
+   mStats.catchUpTicks += due - 1;
+
+   return due;
+}
+
+
+void TickScheduler::recordTickTime(F64 ms)
+{
+   if(ms > mTickPeriod)
+      mStats.overruns++;
+
+   mStats.maxTickTime = max(mStats.maxTickTime, ms);
+}
+
+
+bool TickScheduler::isSendDue(F64 now)
+{
+   if(!isSchedulingSends() || now < mNextSend)
+      return false;
+
+   mNextSend += mSendPeriod;
+
+   // Sends we missed aren't worth making up; one packet carries the latest state just as well as three
+   if(mNextSend <= now)
+      mNextSend = now + mSendPeriod;
+
+   mStats.sends++;
+
+   return true;
+}
+
+
+// How long we can sleep before there's something to do
+F64 TickScheduler::getTimeUntilNextDeadline(F64 now) const
+{
+   F64 next = mNextTick;
+
+   if(isSchedulingSends())
+      next = min(next, mNextSend);
+
+   return max(next - now, 0.0);
+}
+
+
+const TickScheduler::Stats &TickScheduler::getStats() const
+{
+   return mStats;
+}
+
+
+void TickScheduler::resetStats()
+{
+   mStats.ticks = 0;
+   mStats.catchUpTicks = 0;
+   mStats.droppedTicks = 0;
+   mStats.overruns = 0;
+   mStats.clockResets = 0;
+   mStats.sends = 0;
+   mStats.maxLateness = 0;
+   mStats.maxTickTime = 0;
+}
+
+
+};
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _TICK_SCHEDULER_H_
+#define _TICK_SCHEDULER_H_
+
+#include "tnlTypes.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+// Decides when the dedicated server should run its next tick, and when it should send packets.  Ticks come on a
+// fixed grid of deadlines, each one advancing the game by exactly one tick period, so the simulation no longer
+// depends on how late the OS woke us up.  When we do fall behind, the missed ticks are run back to back to catch
+// up, but only so many of them; beyond that the oldest are dropped and we carry on from where the grid is now.
+// If the clock jumps back, we start a fresh grid from the new time rather than wait for the clock to catch up.
+//
+// Packets can go out on their own cadence rather than after every tick, so a burst of catch-up ticks doesn't
+// turn into a burst of sends.  With no send rate set, the ServerGame sends at the end of each tick, as it always has.
+//
+// The scheduler doesn't read the clock itself; the caller passes in the time, in ms, which keeps it testable.
+class TickScheduler
+{
+public:
+   struct Stats
+   {
+      U64 ticks;              // Ticks run
+      U64 catchUpTicks;       // Ticks run back to back with the one before, because we'd fallen behind
+      U64 droppedTicks;       // Ticks skipped because we'd fallen too far behind to catch up
+      U64 overruns;           // Ticks that took longer to run than a tick period
+      U64 clockResets;        // Times the clock went backwards and we started over from the new time
+      U64 sends;
+      F64 maxLateness;        // Worst gap between a tick's deadline and when it started, in ms
+      F64 maxTickTime;        // Longest a tick took to run, in ms
+   };
+
+private:
+   U32 mTickRate;
+   U32 mTickPeriod;           // In ms, and the timeDelta each tick is run with
+   U32 mSendRate;
+   F64 mSendPeriod;           // In ms, 0 if the ServerGame sends after each tick
+   U32 mMaxCatchUpTicks;
+
+   bool mRunning;
+   F64 mNextTick;
+   F64 mNextSend;
+
+   Stats mStats;
+
+public:
+   TickScheduler();     // Constructor
+
+   void setTickRate(U32 ticksPerSecond);
+   void setSendRate(U32 sendsPerSecond);     // 0 to send after every tick
+   void setMaxCatchUpTicks(U32 ticks);
+
+   U32 getTickPeriod() const;
+   U32 getTickRate() const;
+   U32 getSendRate() const;
+
+   void start(F64 now);       // The first tick is due straight away
+   void stop();
+   bool isRunning() const;
+   bool isSchedulingSends() const;
+
+   U32 getTicksDue(F64 now);              // Ticks to run right now, back to back; moves the deadline along
+   void recordTickTime(F64 ms);           // How long one of those ticks took
+   bool isSendDue(F64 now);               // Moves the send deadline along if so
+   F64 getTimeUntilNextDeadline(F64 now) const;
+
+   const Stats &getStats() const;
+   void resetStats();
+};
+
+
+};
+
+#endif
@@ -1454,9 +1454,15 @@ bool GameUserInterface::processPlayModeKey(InputCode inputCode)
    // engineering menu modes if not used in the loadout menu above
    // They are currently hardcoded, both here and in the instructions
    if(inputCode == KEY_CLOSEBRACKET && InputCodeManager::checkModifier(KEY_ALT))          // Alt+] advances bots by one step if frozen
-      EventManager::get()->addSteps(1);
+   {
+      if(getGame()->getServerGame())
+         getGame()->getServerGame()->getEventManager()->addSteps(1);
+   }
    else if(inputCode == KEY_CLOSEBRACKET && InputCodeManager::checkModifier(KEY_CTRL))    // Ctrl+] advances bots by 10 steps if frozen
-      EventManager::get()->addSteps(10);
+   {
+      if(getGame()->getServerGame())
+         getGame()->getServerGame()->getEventManager()->addSteps(10);
+   }
 
    else if(checkInputCode(BINDING_LOAD_PRESET_1, inputCode))  // Loading loadout presets
       loadLoadoutPreset(getGame(), 0);
@@ -2547,8 +2553,10 @@ void GameUserInterface::renderTalkingClients() const
 
 void GameUserInterface::renderDebugStatus() const
 {
+   ServerGame *serverGame = getGame()->getServerGame();
+
    // When bots are frozen, render large pause icon in lower left
-   if(EventManager::get()->isPaused())
+   if(serverGame && serverGame->getEventManager()->isPaused())
    {
       glColor(Colors::white);
 
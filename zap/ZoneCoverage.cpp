@@ -0,0 +1,243 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#include "ZoneCoverage.h"
+
+#include "Zone.h"
+#include "gridDB.h"
+#include "GeomUtils.h"
+
+#include <math.h>
+
+namespace Zap
+{
+
+// Constructor
+ZoneCoverage::ZoneCoverage()
+{
+   mDatabase = NULL;
+   mStaticChangeCount = 0;
+   mValid = false;
+   mCellSize = MinCellSize;
+   mCols = 0;
+   mRows = 0;
+   mPolygonTests = 0;
+}
+
+
+static bool sortBySerialNumber(DatabaseObject * const &a, DatabaseObject * const &b)
+{
+   return static_cast<BfObject *>(a)->getSerialNumber() < static_cast<BfObject *>(b)->getSerialNumber();
+}
+
+
+void ZoneCoverage::getCellRect(S32 col, S32 row, Rect &rect) const
+{
+   rect.min.set(mBounds.min.x + col * mCellSize, mBounds.min.y + row * mCellSize);
+   rect.max.set(rect.min.x + mCellSize, rect.min.y + mCellSize);
+}
+
+
+// Liang-Barsky clip, counting a segment that only grazes the rect's border as touching it
+static bool segmentTouchesRect(const Point &p1, const Point &p2, const Rect &rect)
+{
+   F32 p[4] = { p1.x - p2.x, p2.x - p1.x, p1.y - p2.y, p2.y - p1.y };
+   F32 q[4] = { p1.x - rect.min.x, rect.max.x - p1.x, p1.y - rect.min.y, rect.max.y - p1.y };
+
+   F32 t0 = 0, t1 = 1;
+
+   for(S32 i = 0; i < 4; i++)
+   {
+      if(p[i] == 0)
+      {
+         if(q[i] < 0)
+            return false;
+      }
+      else
+      {
+         F32 t = q[i] / p[i];
+
+         if(p[i] < 0)
+            t0 = max(t0, t);
+         else
+            t1 = min(t1, t);
+
+         if(t0 > t1)
+            return false;
+      }
+   }
+
+   return true;
+}
+
+
+// Does any part of the polygon's outline come near the cell?  We pad the cell a little so that rounding can
+// only ever make us say yes when the answer is no, which just costs a polygon test later.
+static bool outlineTouchesCell(const Vector<Point> &poly, const Rect &cell)
+{
+   const F32 Padding = 0.01f;
+   Rect padded(cell.min - Point(Padding, Padding), cell.max + Point(Padding, Padding));
+
+   for(S32 i = 0; i < poly.size(); i++)
+      if(segmentTouchesRect(poly[i], poly[(i + 1) % poly.size()], padded))
+         return true;
+
+   return false;
+}
+
+
+void ZoneCoverage::build(const GridDatabase *database)
+{
+   mDatabase = database;
+   mStaticChangeCount = database->getStaticChangeCount();
+   mValid = true;
+   mPolygonTests = 0;
+
+   mCellStart.clear();
+   mCellZones.clear();
+   mCols = 0;
+   mRows = 0;
+
+   static Vector<DatabaseObject *> zones;
+   zones.clear();
+   database->findObjects((TestFunc)isZoneType, zones);
+
+   if(zones.size() == 0)
+      return;
+
+   zones.sort(sortBySerialNumber);     // Each cell's list comes out in this order
+
+   mBounds = zones[0]->getExtent();
+   for(S32 i = 1; i < zones.size(); i++)
+      mBounds.unionRect(zones[i]->getExtent());
+
+   // Coarser cells on big levels, to keep the raster a sensible size
+   F32 largestSide = max(mBounds.getWidth(), mBounds.getHeight());
+   mCellSize = max((F32)MinCellSize, largestSide / MaxCellsPerSide);
+
+   mCols = max(1, (S32)ceil(mBounds.getWidth()  / mCellSize));
+   mRows = max(1, (S32)ceil(mBounds.getHeight() / mCellSize));
+
+   // Collect (cell, zone) pairs zone by zone, then bucket them by cell, keeping zone order within each cell
+   Vector<S32> pairCells;
+   Vector<CellZone> pairZones;
+
+   for(S32 i = 0; i < zones.size(); i++)
+   {
+      Zone *zone = static_cast<Zone *>(zones[i]);
+      const Vector<Point> *poly = zone->getCollisionPoly();
+      Rect extent = zone->getExtent();
+
+      S32 minCol = max(0, (S32)floor((extent.min.x - mBounds.min.x) / mCellSize));
+      S32 minRow = max(0, (S32)floor((extent.min.y - mBounds.min.y) / mCellSize));
+      S32 maxCol = min(mCols - 1, (S32)floor((extent.max.x - mBounds.min.x) / mCellSize));
+      S32 maxRow = min(mRows - 1, (S32)floor((extent.max.y - mBounds.min.y) / mCellSize));
+
+      for(S32 row = minRow; row <= maxRow; row++)
+         for(S32 col = minCol; col <= maxCol; col++)
+         {
+            Rect cell;
+            getCellRect(col, row, cell);
+
+            CellZone cellZone;
+            cellZone.zone = zone;
+
+            // With no edge anywhere in the cell, one corner tells us about the whole cell
+            if(!poly || poly->size() < 3 || outlineTouchesCell(*poly, cell))
+               cellZone.full = false;
+            else if(polygonContainsPoint(poly->address(), poly->size(), cell.min))
+               cellZone.full = true;
+            else
+               continue;      // Cell is entirely outside the zone
+
+            pairCells.push_back(row * mCols + col);
+            pairZones.push_back(cellZone);
+         }
+   }
+
+   mCellStart.resize(mCols * mRows + 1);
+   for(S32 i = 0; i < mCellStart.size(); i++)
+      mCellStart[i] = 0;
+
+   for(S32 i = 0; i < pairCells.size(); i++)
+      mCellStart[pairCells[i] + 1]++;
+
+   for(S32 i = 1; i < mCellStart.size(); i++)
+      mCellStart[i] += mCellStart[i - 1];
+
+   Vector<S32> next(mCellStart);
+   mCellZones.resize(pairZones.size());
+
+   for(S32 i = 0; i < pairCells.size(); i++)
+      mCellZones[next[pairCells[i]]++] = pairZones[i];
+}
+
+
+void ZoneCoverage::findZones(const GridDatabase *database, const Point &point, Vector<Zone *> &zoneList)
+{
+   zoneList.clear();
+
+   if(!mValid || database != mDatabase || database->getStaticChangeCount() != mStaticChangeCount)
+      build(database);
+
+   if(mCols == 0)
+      return;
+
+   S32 col = (S32)floor((point.x - mBounds.min.x) / mCellSize);
+   S32 row = (S32)floor((point.y - mBounds.min.y) / mCellSize);
+
+   // Rounding can put a point sitting on a cell border into the wrong cell; the cell must really contain it
+   Rect cellRect;
+   getCellRect(col, row, cellRect);
+
+   if(point.x < cellRect.min.x)      col--;
+   else if(point.x > cellRect.max.x) col++;
+
+   if(point.y < cellRect.min.y)      row--;
+   else if(point.y > cellRect.max.y) row++;
+
+   if(col < 0 || col >= mCols || row < 0 || row >= mRows)
+      return;
+
+   S32 cell = row * mCols + col;
+
+   for(S32 i = mCellStart[cell]; i < mCellStart[cell + 1]; i++)
+   {
+      const CellZone &cellZone = mCellZones[i];
+
+      if(cellZone.full)
+      {
+         zoneList.push_back(cellZone.zone);
+         continue;
+      }
+
+      // Same test findObjects() and the polygon check would make; the extent test matters for points right
+      // on a zone's bottom or left edge, which polygonContainsPoint() counts as inside
+      const Rect &extent = cellZone.zone->getExtent();
+      if(!(extent.min.x < point.x && extent.max.x > point.x && extent.min.y < point.y && extent.max.y > point.y))
+         continue;
+
+      const Vector<Point> *poly = cellZone.zone->getCollisionPoly();
+      mPolygonTests++;
+
+      if(polygonContainsPoint(poly->address(), poly->size(), point))
+         zoneList.push_back(cellZone.zone);
+   }
+}
+
+
+S32 ZoneCoverage::getCellCount() const
+{
+   return mCols * mRows;
+}
+
+
+U32 ZoneCoverage::getPolygonTestCount() const
+{
+   return mPolygonTests;
+}
+
+
+};
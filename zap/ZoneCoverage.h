@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+// Copyright Chris Eykamp
+// See LICENSE.txt for full copyright information
+//------------------------------------------------------------------------------
+
+#ifndef _ZONE_COVERAGE_H_
+#define _ZONE_COVERAGE_H_
+
+#include "Rect.h"
+
+#include "tnlTypes.h"
+#include "tnlVector.h"
+
+using namespace TNL;
+
+namespace Zap
+{
+
+class GridDatabase;
+class Zone;
+
+// Raster of the level recording which zones cover each cell, so that working out which zones an object is in
+// usually needs no polygon test at all.  Cells well inside a zone are marked as fully covered; only cells that
+// a zone's outline passes through need the real point-in-polygon check.
+//
+// The raster is built on first use and rebuilt whenever a zone is added, removed, or moved (which we notice
+// through the database's static change count).
+class ZoneCoverage
+{
+public:
+   static const S32 MinCellSize = 64;
+   static const S32 MaxCellsPerSide = 256;
+
+private:
+   struct CellZone
+   {
+      Zone *zone;
+      bool full;     // Zone covers the whole cell, edges and all
+   };
+
+   const GridDatabase *mDatabase;
+   U32 mStaticChangeCount;
+   bool mValid;
+
+   Rect mBounds;
+   F32 mCellSize;
+   S32 mCols;
+   S32 mRows;
+
+   Vector<S32> mCellStart;          // Zones for cell i are mCellZones[mCellStart[i]] up to mCellZones[mCellStart[i + 1]]
+   Vector<CellZone> mCellZones;     // In each cell, sorted by zone serial number
+
+   U32 mPolygonTests;
+
+   void build(const GridDatabase *database);
+   void getCellRect(S32 col, S32 row, Rect &rect) const;
+
+public:
+   ZoneCoverage();   // Constructor
+
+   // Fills zoneList with the zones containing point, in order of serial number -- the same zones a findObjects()
+   // over isZoneType followed by polygonContainsPoint() would find
+   void findZones(const GridDatabase *database, const Point &point, Vector<Zone *> &zoneList);
+
+   S32 getCellCount() const;
+   U32 getPolygonTestCount() const;      // Point-in-polygon tests we couldn't avoid, since the last rebuild
+};
+
+
+};
+
+#endif
@@ -0,0 +1,39 @@
+#
+# Server benchmark executable
+# 
+
+set(BENCH_SOURCES
+	${CMAKE_SOURCE_DIR}/bitfighter_test/LuaCallBenchmark.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/ServerBenchmark.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/TestUtils.cpp
+	${CMAKE_SOURCE_DIR}/bitfighter_test/main_bench.cpp
+)
+
+
+add_executable(bitfighter_bench EXCLUDE_FROM_ALL
+	$<TARGET_OBJECTS:bitfighter_client>
+	${BENCH_SOURCES}
+)
+
+target_link_libraries(bitfighter_bench
+	${CLIENT_LIBS}
+	${SHARED_LIBS}
+	gtest
+)
+
+add_dependencies(bitfighter_bench
+	bitfighter_client
+	gtest
+)
+
+set_target_properties(bitfighter_bench
+	PROPERTIES
+	RUNTIME_OUTPUT_DIRECTORY ${CMAKE_SOURCE_DIR}/exe
+	COMPILE_DEFINITIONS BITFIGHTER_TEST
+)
+
+set_target_properties(bitfighter_bench PROPERTIES COMPILE_DEFINITIONS_DEBUG "TNL_DEBUG")
+
+BF_PLATFORM_SET_TARGET_PROPERTIES(bitfighter_bench)
+
+BF_PLATFORM_POST_BUILD_INSTALL_RESOURCES(bitfighter_bench)
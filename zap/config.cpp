@@ -92,6 +92,8 @@ IniSettings::IniSettings()
    allowGetMap = false;               // Disabled by default -- many admins won't want this
 
    maxDedicatedFPS = 100;             // Max FPS on dedicated server
+   packetSendRate = 0;                // Send after every tick
+   maxCatchUpTicks = 10;              // A tenth of a second at the default 100 FPS
    maxFPS = 100;                      // Max FPS on client/non-dedicated server
 
    masterAddress = MASTER_SERVER_LIST_ADDRESS;   // Default address of our master server
@@ -106,6 +108,12 @@ IniSettings::IniSettings()
    playWithBots = false;
    minBalancedPlayers = 6;
    enableServerVoiceChat = true;
+   enableGhostDeltaCompression = true;
+   enableIncrementalScoping = true;
+   netStatsDumpInterval = 0;
+   tickStatsDumpInterval = 0;
+   scriptCacheSize = 32;
+   saveScriptBytecode = true;
    allowTeamChanging = true;
    kickIdlePlayers = true;
    serverPassword = "";               // Passwords empty by default
@@ -113,6 +121,7 @@ IniSettings::IniSettings()
    adminPassword = "";
    levelChangePassword = "";
    levelDir = "";
+   extraGames = "";
 
    connectionSpeed = 0;
 
@@ -644,11 +653,18 @@ static void loadHostConfiguration(CIniFile *ini, IniSettings *iniSettings)
    iniSettings->adminPassword          = ini->GetValue  (section, "AdminPassword", iniSettings->adminPassword);
    iniSettings->levelChangePassword    = ini->GetValue  (section, "LevelChangePassword", iniSettings->levelChangePassword);
    iniSettings->levelDir               = ini->GetValue  (section, "LevelDir", iniSettings->levelDir);
+   iniSettings->extraGames             = ini->GetValue  (section, "ExtraGames", iniSettings->extraGames);
    iniSettings->maxPlayers             = ini->GetValueI (section, "MaxPlayers", iniSettings->maxPlayers);
    iniSettings->maxBots                = ini->GetValueI (section, "MaxBots", iniSettings->maxBots);
    iniSettings->playWithBots           = ini->GetValueYN(section, "AddRobots", iniSettings->playWithBots);
    iniSettings->minBalancedPlayers     = ini->GetValueI (section, "MinBalancedPlayers", iniSettings->minBalancedPlayers);
    iniSettings->enableServerVoiceChat  = ini->GetValueYN (section, "EnableServerVoiceChat", iniSettings->enableServerVoiceChat);
+   iniSettings->enableGhostDeltaCompression = ini->GetValueYN (section, "GhostDeltaCompression", iniSettings->enableGhostDeltaCompression);
+   iniSettings->enableIncrementalScoping = ini->GetValueYN (section, "IncrementalScoping", iniSettings->enableIncrementalScoping);
+   iniSettings->netStatsDumpInterval = max(ini->GetValueI(section, "NetStatsDumpInterval", iniSettings->netStatsDumpInterval), 0);
+   iniSettings->tickStatsDumpInterval = max(ini->GetValueI(section, "TickStatsDumpInterval", iniSettings->tickStatsDumpInterval), 0);
+   iniSettings->scriptCacheSize        = max(ini->GetValueI(section, "ScriptCacheSize", iniSettings->scriptCacheSize), 0);
+   iniSettings->saveScriptBytecode     = ini->GetValueYN (section, "SaveScriptBytecode", iniSettings->saveScriptBytecode);
    iniSettings->kickIdlePlayers        = ini->GetValueYN (section, "KickIdlePlayers", iniSettings->kickIdlePlayers);
 
    iniSettings->alertsVolLevel       = (F32) ini->GetValueI(section, "AlertsVolume", (S32) (iniSettings->alertsVolLevel * 10)) / 10.0f;
@@ -661,6 +677,9 @@ static void loadHostConfiguration(CIniFile *ini, IniSettings *iniSettings)
       iniSettings->maxDedicatedFPS = fps; 
    // TODO: else warn?
 
+   iniSettings->packetSendRate  = max(ini->GetValueI(section, "PacketSendRate", iniSettings->packetSendRate), 0);
+   iniSettings->maxCatchUpTicks = max(ini->GetValueI(section, "MaxCatchUpTicks", iniSettings->maxCatchUpTicks), 1);
+
    iniSettings->logStats = ini->GetValueYN(section, "LogStats", iniSettings->logStats);
 
    //iniSettings->SendStatsToMaster = (lcase(ini->GetValue(section, "SendStatsToMaster", "yes")) != "no");
@@ -1783,14 +1802,24 @@ static void writeHost(CIniFile *ini, IniSettings *iniSettings)
       addComment(" AdminPassword - Use this password to manage players & change levels on your server.");
       addComment(" LevelChangePassword - Use this password to change levels on your server.  Leave blank to grant access to all.");
       addComment(" LevelDir - Specify where level files are stored; can be overridden on command line with -leveldir param.");
+      addComment(" ExtraGames - Comma separated list of INI files, relative to this one, each setting up another game for a dedicated server to");
+      addComment("              host alongside this one.  Each needs its own ServerAddress, and will usually have its own ServerName and LevelDir.");
       addComment(" MaxPlayers - The max number of players that can play on your server.");
       addComment(" MaxBots - The max number of bots allowed on this server.");
       addComment(" AddRobots - Add robot players to this server.");
       addComment(" MinBalancedPlayers - The minimum number of players ensured in each map.  Bots will be added up to this number.");
       addComment(" EnableServerVoiceChat - If false, prevents any voice chat in a server.");
+      addComment(" GhostDeltaCompression - Send object movement as changes since the last update each client received, saving bandwidth.");
+      addComment(" IncrementalScoping - Save CPU by only looking for walls, zones, and other fixed objects as they come into view.");
+      addComment(" NetStatsDumpInterval - Seconds between writing bandwidth used by each object and message type, across all games this server hosts, to netstats.csv in the log folder; 0 to disable.");
+      addComment(" TickStatsDumpInterval - Seconds between writing how long each stage of the server's game loop takes to tickstats.csv in the log folder; 0 to disable.");
+      addComment(" ScriptCacheSize - Number of compiled robot and levelgen scripts to keep in memory, so adding another copy of a bot is quick (default = 32).");
+      addComment(" SaveScriptBytecode - Save compiled scripts in the luacache folder next to this file, so they needn't be compiled again after a restart.");
       addComment(" KickIdlePlayers - If true, the server will kick players that are considered idle.");
       addComment(" AlertsVolume - Volume of audio alerts when players join or leave game from 0 (mute) to 10 (full bore).");
       addComment(" MaxFPS - Maximum FPS the dedicaetd server will run at.  Higher values use more CPU, lower may increase lag (default = 100).");
+      addComment(" PacketSendRate - Times per second a dedicated server sends updates to its clients; 0 to send after every frame (default = 0).");
+      addComment(" MaxCatchUpTicks - Frames a dedicated server will run back to back to catch up after a stall; any more are skipped (default = 10).");
       addComment(" RandomLevels - When current level ends, this can enable randomly switching to any available levels.");
       addComment(" SkipUploads - When current level ends, enables skipping all uploaded levels.");
       addComment(" AllowGetMap - When getmap is allowed, anyone can download the current level using the /getmap command.");
@@ -1798,6 +1827,7 @@ static void writeHost(CIniFile *ini, IniSettings *iniSettings)
       addComment("                        levelGen scripts.  This feature is probably insecure, and should be DISABLED unless you require the functionality.");
       addComment(" LogStats - Save game stats locally to built-in sqlite database (saves the same stats as are sent to the master)");
       addComment(" DefaultRobotScript - If user adds a robot, this script is used if none is specified");
+      addComment("                      Use native:s_bot for the built-in C++ version of the standard bot, which is much cheaper to run");
       addComment(" GlobalLevelScript - Specify a levelgen that will get run on every level");
       addComment(" MySqlStatsDatabaseCredentials - If MySql integration has been compiled in (which it probably hasn't been), you can specify the");
       addComment("                                 database server, database name, login, and password as a comma delimeted list");
@@ -1816,17 +1846,26 @@ static void writeHost(CIniFile *ini, IniSettings *iniSettings)
    ini->SetValue  (section, "AdminPassword", iniSettings->adminPassword);
    ini->SetValue  (section, "LevelChangePassword", iniSettings->levelChangePassword);
    ini->SetValue  (section, "LevelDir", iniSettings->levelDir);
+   ini->SetValue  (section, "ExtraGames", iniSettings->extraGames);
    ini->SetValueI (section, "MaxPlayers", iniSettings->maxPlayers);
    ini->SetValueI (section, "MaxBots", iniSettings->maxBots);
    ini->setValueYN(section, "AddRobots", iniSettings->playWithBots);
    ini->SetValueI (section, "MinBalancedPlayers", iniSettings->minBalancedPlayers);
    ini->setValueYN(section, "EnableServerVoiceChat", iniSettings->enableServerVoiceChat);
+   ini->setValueYN(section, "GhostDeltaCompression", iniSettings->enableGhostDeltaCompression);
+   ini->setValueYN(section, "IncrementalScoping", iniSettings->enableIncrementalScoping);
+   ini->SetValueI (section, "NetStatsDumpInterval", iniSettings->netStatsDumpInterval);
+   ini->SetValueI (section, "TickStatsDumpInterval", iniSettings->tickStatsDumpInterval);
+   ini->SetValueI (section, "ScriptCacheSize", iniSettings->scriptCacheSize);
+   ini->setValueYN(section, "SaveScriptBytecode", iniSettings->saveScriptBytecode);
    ini->setValueYN(section, "KickIdlePlayers", iniSettings->kickIdlePlayers);
    ini->setValueYN(section, "AllowTeamChanging", iniSettings->allowTeamChanging);
    ini->SetValueI (section, "AlertsVolume", (S32) (iniSettings->alertsVolLevel * 10));
    ini->setValueYN(section, "AllowGetMap", iniSettings->allowGetMap);
    ini->setValueYN(section, "AllowDataConnections", iniSettings->allowDataConnections);
    ini->SetValueI (section, "MaxFPS", iniSettings->maxDedicatedFPS);
+   ini->SetValueI (section, "PacketSendRate", iniSettings->packetSendRate);
+   ini->SetValueI (section, "MaxCatchUpTicks", iniSettings->maxCatchUpTicks);
    ini->setValueYN(section, "LogStats", iniSettings->logStats);
 
    ini->setValueYN(section, "RandomLevels", S32(iniSettings->randomLevels) );
@@ -2362,7 +2401,7 @@ string FolderManager::findBotFile(const string &filename) const
    Vector<string> folders;
    folders.push_back(robotDir);
 
-   const char *extensions[] = { ".bot" };
+   const char *extensions[] = { ".bot", "" };
 
    return checkName(filename, folders, extensions);
 }
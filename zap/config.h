@@ -199,6 +199,8 @@ public:
    bool allowDataConnections;       // Specify whether data connections are allowed on this computer
 
    U32 maxDedicatedFPS;
+   U32 packetSendRate;              // Packet sends per second on a dedicated server, 0 to send after every tick
+   U32 maxCatchUpTicks;             // Ticks a dedicated server will run back to back when it falls behind
    U32 maxFPS;
 
 
@@ -218,11 +220,18 @@ public:
    string adminPassword;
    string levelChangePassword;      // Password to allow access to level changing functionality on non-local server
    string levelDir;                 // Folder where levels are stored, by default
+   string extraGames;               // INI files, comma separated, each setting up another game for a dedicated server to host
    S32 maxPlayers;                  // Max number of players that can play on local server
    S32 maxBots;
    bool playWithBots;               // Should the server add bots
    S32 minBalancedPlayers;          // If bot auto-balance, make sure there are at least this many players
    bool enableServerVoiceChat;      // No voice chat allowed in server if disabled
+   bool enableGhostDeltaCompression; // Send object positions as deltas to clients that support it
+   bool enableIncrementalScoping;   // Only look for static objects newly in range when working out what each client can see
+   U32 netStatsDumpInterval;        // Seconds between appending per-class bandwidth stats to netstats.csv, 0 to disable
+   U32 tickStatsDumpInterval;       // Seconds between appending tick profiler timings to tickstats.csv, 0 to disable
+   S32 scriptCacheSize;             // Number of compiled Lua scripts kept in memory
+   bool saveScriptBytecode;         // Save compiled Lua scripts to disk, so they needn't be compiled again after a restart
    bool allowTeamChanging;
    bool enableGameRecording;
    bool kickIdlePlayers;
@@ -360,25 +360,42 @@ bool ControlObjectConnection::getObjectMovedThisGame()
 }
 
 
-void ControlObjectConnection::writeCompressedPoint(const Point &p, BitStream *stream)
+// Points near the control object are sent as whole-unit offsets from it; anything else goes out as floats
+bool ControlObjectConnection::canCompressPointRelative(const Point &p) const
 {
    if(!mCompressPointsRelative)
-   {
-      stream->write(p.x);
-      stream->write(p.y);
-      return;
-   }
+      return false;
 
    Point delta = p - mServerPosition;
-    // floor(number + 0.5) fix rounding problems (was 5 = (U32)5.95)
    S32 dx = (S32) floor((delta.x + Game::PLAYER_VISUAL_DISTANCE_HORIZONTAL + Game::PLAYER_SCOPE_MARGIN) + 0.5f);
    S32 dy = (S32) floor((delta.y + Game::PLAYER_VISUAL_DISTANCE_VERTICAL + Game::PLAYER_SCOPE_MARGIN) + 0.5f);
 
    S32 maxx = (Game::PLAYER_VISUAL_DISTANCE_HORIZONTAL + Game::PLAYER_SCOPE_MARGIN) * 2;
    S32 maxy = (Game::PLAYER_VISUAL_DISTANCE_VERTICAL + Game::PLAYER_SCOPE_MARGIN) * 2;
 
-   if(stream->writeFlag(dx >= 0 && dx <= maxx && dy >= 0 && dy <= maxy))
+   return dx >= 0 && dx <= maxx && dy >= 0 && dy <= maxy;
+}
+
+
+void ControlObjectConnection::writeCompressedPoint(const Point &p, BitStream *stream)
+{
+   if(!mCompressPointsRelative)
+   {
+      stream->write(p.x);
+      stream->write(p.y);
+      return;
+   }
+
+   if(stream->writeFlag(canCompressPointRelative(p)))
    {
+      Point delta = p - mServerPosition;
+      // floor(number + 0.5) fix rounding problems (was 5 = (U32)5.95)
+      S32 dx = (S32) floor((delta.x + Game::PLAYER_VISUAL_DISTANCE_HORIZONTAL + Game::PLAYER_SCOPE_MARGIN) + 0.5f);
+      S32 dy = (S32) floor((delta.y + Game::PLAYER_VISUAL_DISTANCE_VERTICAL + Game::PLAYER_SCOPE_MARGIN) + 0.5f);
+
+      S32 maxx = (Game::PLAYER_VISUAL_DISTANCE_HORIZONTAL + Game::PLAYER_SCOPE_MARGIN) * 2;
+      S32 maxy = (Game::PLAYER_VISUAL_DISTANCE_VERTICAL + Game::PLAYER_SCOPE_MARGIN) * 2;
+
       stream->writeRangedU32(dx, 0, maxx);
       stream->writeRangedU32(dy, 0, maxy);
    }
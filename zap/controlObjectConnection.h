@@ -100,6 +100,7 @@ public:
 
    bool isDataToTransmit();
 
+   bool canCompressPointRelative(const Point &p) const;     // True if writeCompressedPoint() would round p to whole units
    void writeCompressedPoint(const Point &p, BitStream *stream);
    void readCompressedPoint(Point &p, BitStream *stream);
 
@@ -406,6 +406,12 @@ GameType *Game::getGameType() const
 }
 
 
+EventManager *Game::getEventManager()
+{
+   return &mEventManager;
+}
+
+
 // There is a bigger need to use StringTableEntry and not const char *
 //    mainly to prevent errors on CTF neutral flag and out of range team number.
 StringTableEntry Game::getTeamName(S32 teamIndex) const
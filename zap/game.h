@@ -15,6 +15,7 @@
 
 #include "teamInfo.h"            // For ClassManager
 #include "BfObject.h"            // For TypeNumber def
+#include "EventManager.h"
 #include "md5wrapper.h"
 
 #include "Timer.h"
@@ -248,6 +249,8 @@ protected:
 
    TeamManager mTeamManager;
 
+   EventManager mEventManager;            // Tells this game's scripts what's going on in it
+
    virtual AbstractTeam *getNewTeam() = 0;
 
 public:
@@ -391,6 +394,7 @@ public:
 
    void setScopeAlwaysObject(BfObject *theObject);
    GameType *getGameType() const;
+   EventManager *getEventManager();
 
    // MD5 utilties
    string getSaltedHash(const string &stringToBeHashed) const;
@@ -33,7 +33,8 @@ namespace Zap
 
 TNL_IMPLEMENT_NETCONNECTION(GameConnection, NetClassGroupGame, true);
 
-const U8 GameConnection::CONNECT_VERSION = 1;  // GameConnection's version, for possible future use with changes on compatible versions
+const U8 GameConnection::CONNECT_VERSION = 2;  // GameConnection's version, for possible future use with changes on compatible versions
+const U8 GameConnection::CONNECT_VERSION_GHOST_DELTAS = 2;  // First version that understands delta-compressed ghost updates
 
 // Constructor -- used on Server by TNL, not called directly, used when a new client connects to the server
 GameConnection::GameConnection()
@@ -82,6 +83,7 @@ void GameConnection::initialize()
    mServerGame = NULL;
    setTranslatesStrings();
    mInCommanderMap = false;
+   mLastScope.valid = false;
    mGotPermissionsReply = false;
    mWaitingForPermissionsReply = false;
    mSwitchTimer.reset(0);
@@ -2123,6 +2125,13 @@ void GameConnection::writeConnectAccept(BitStream *stream)
    stream->write(CONNECT_VERSION);
 
    stream->writeFlag(mServerGame->getSettings()->getIniSettings()->enableServerVoiceChat);
+
+   // Older clients don't know about this flag, and will just ignore it
+   if(mConnectionVersion >= CONNECT_VERSION_GHOST_DELTAS)
+   {
+      setGhostDeltaCompression(mServerGame->getSettings()->getIniSettings()->enableGhostDeltaCompression);
+      stream->writeFlag(isGhostDeltaCompression());
+   }
 }
 
 
@@ -2134,6 +2143,10 @@ bool GameConnection::readConnectAccept(BitStream *stream, NetConnection::Termina
    stream->read(&mConnectionVersion);
 
    mVoiceChatEnabled = stream->readFlag();
+
+   if(mConnectionVersion >= CONNECT_VERSION_GHOST_DELTAS)
+      setGhostDeltaCompression(stream->readFlag());
+
    return true;
 }
 
@@ -2376,7 +2389,7 @@ void GameConnection::onConnectionEstablished_server()
    mAcheivedConnection = true;
       
    // Notify the bots that a new player has joined
-   EventManager::get()->fireEvent(NULL, EventManager::PlayerJoinedEvent, getClientInfo()->getPlayerInfo());
+   mServerGame->getEventManager()->fireEvent(NULL, EventManager::PlayerJoinedEvent, getClientInfo()->getPlayerInfo());
 
    const char *name =  mClientInfo->getName().getString();
 
@@ -2456,7 +2469,7 @@ void GameConnection::onConnectionTerminated(NetConnection::TerminationReason rea
    {
       LuaPlayerInfo *playerInfo = getClientInfo()->getPlayerInfo();
 
-      EventManager::get()->fireEvent(NULL, EventManager::PlayerLeftEvent, playerInfo);
+      mServerGame->getEventManager()->fireEvent(NULL, EventManager::PlayerLeftEvent, playerInfo);
 
       mServerGame->removeClient(mClientInfo);
    }
@@ -2571,6 +2584,49 @@ bool GameConnection::isInCommanderMap()
 }
 
 
+// Incremental version of the simple scope query in GameType::performProxyScopeQuery().  TNL only re-checks the
+// scope of ghosts that have updates pending, so static objects that were in range last packet and haven't changed
+// since stay in scope by themselves.  That leaves the static objects in the area that has just come into range, any
+// static ghosts that do have updates pending, and the moving objects.  Anything that breaks that reasoning --
+// static objects being added, removed or moved, ghosting restarting, or the ghost table filling up -- sends us
+// back to a full query.  Adds what it finds to fillVector.
+void GameConnection::findObjectsInScope(GridDatabase *database, const Rect &queryRect, Vector<DatabaseObject *> &fillVector)
+{
+   ScopeState &last = mLastScope;
+
+   if(!last.valid || last.database != database || last.staticChangeCount != database->getStaticChangeCount() ||
+         last.ghostingSequence != getGhostingSequence() || isGhostSpaceLow())
+      database->findObjects((TestFunc)isAnyObjectType, fillVector, queryRect);
+   else
+   {
+      // Static ghosts with updates pending get marked out of scope every packet, like everything else that's changing
+      for(S32 i = 0; i < getUpdatingGhostCount(); i++)
+      {
+         BfObject *obj = dynamic_cast<BfObject *>(getUpdatingGhost(i));
+
+         if(obj && isStaticObjectType(obj->getObjectTypeNumber()) && obj->getDatabase() == database &&
+               obj->getExtent().intersects(queryRect))
+            fillVector.push_back(obj);
+      }
+
+      // Static objects in the part of the scope rect that wasn't in range last time
+      queryRect.subtract(last.rect, last.newAreas);
+
+      for(S32 i = 0; i < last.newAreas.size(); i++)
+         database->findObjects((TestFunc)isStaticObjectType, fillVector, last.newAreas[i], i > 0);
+
+      // Everything else could have moved anywhere
+      database->findObjects((TestFunc)isNonStaticObjectType, fillVector, queryRect);
+   }
+
+   last.valid = true;
+   last.rect = queryRect;
+   last.database = database;
+   last.staticChangeCount = database->getStaticChangeCount();
+   last.ghostingSequence = getGhostingSequence();
+}
+
+
 
 };
 
@@ -36,6 +36,7 @@ class ServerGame;
 struct LevelInfo;
 class LuaPlayerInfo;
 class GameSettings;
+class GridDatabase;
 class LevelSource;
 
 class GameConnection: public ControlObjectConnection, public ChatCheck
@@ -93,6 +94,19 @@ private:
 
 public:
    bool mPackUnpackShipEnergyMeter; // Only true for game recorder
+
+   // What GameType::performProxyScopeQuery() scoped for this connection last packet, so it can skip finding
+   // static objects again if nothing has moved much
+   struct ScopeState
+   {
+      bool valid;
+      Rect rect;
+      const GridDatabase *database;
+      U32 staticChangeCount;
+      U32 ghostingSequence;
+      Vector<Rect> newAreas;     // Scratch space for findObjectsInScope()
+   };
+   ScopeState mLastScope;
    U16 switchedTeamCount;
 
    U8 mVote;                     // 0 = not voted,  1 = vote yes,  2 = vote no    TODO: Make 
@@ -234,6 +248,9 @@ public:
 
    bool isInCommanderMap();
 
+   // Finds what the simple scope query needs to look at this packet, skipping static objects that are still in scope
+   void findObjectsInScope(GridDatabase *database, const Rect &queryRect, Vector<DatabaseObject *> &fillVector);
+
    TNL_DECLARE_RPC(c2sRequestCommanderMap, ());
    TNL_DECLARE_RPC(c2sReleaseCommanderMap, ());
 
@@ -326,6 +343,7 @@ public:
    void displayMessageE(U32 color, U32 sfx, StringTableEntry formatString, Vector<StringTableEntry> e);
 
    static const U8 CONNECT_VERSION;  // may be useful in future version with same CS protocol number
+   static const U8 CONNECT_VERSION_GHOST_DELTAS;
    U8 mConnectionVersion;  // the CONNECT_VERSION of the other side of this connection
 
    void writeConnectRequest(BitStream *stream);
@@ -11,6 +11,7 @@
 #include "barrier.h"
 #include "game.h"
 #include "GameRecorder.h"     // Needed, despite resharper
+#include "gameNetInterface.h"  // For connectstats
 #include "GeomUtils.h"
 #include "IniFile.h"          // For CIniFile
 #include "ServerGame.h"
@@ -35,6 +36,10 @@
 #include "stringUtils.h"
 
 #include "tnlThread.h"
+#include "tnlNetBase.h"     // For netstats
+#include "ObjectPool.h"     // For poolstats
+#include "TickProfiler.h"   // For tickstats
+#include "tnlPlatform.h"
 #include <math.h>
 
 namespace Zap
@@ -599,7 +604,7 @@ void GameType::idle_server(U32 deltaT)
    }
 
    // Process any pending Robot events
-   EventManager::get()->update();
+   mGame->getEventManager()->update();
 
    // If game time has expired... game is over, man, it's over
    if(!isTimeUnlimited() && mEndingGamePlay <= mTotalGamePlay)
@@ -740,7 +745,7 @@ void GameType::gameOverManGameOver()
    ((ServerGame *)mGame)->gameEnded();   // Sets level-switch timer, which gives us a short delay before switching games
 
    // Fire a Lua event
-   EventManager::get()->fireEvent(EventManager::GameOverEvent);
+   mGame->getEventManager()->fireEvent(EventManager::GameOverEvent);
 
    saveGameStats();
 }
@@ -1188,7 +1193,7 @@ bool GameType::spawnShip(ClientInfo *clientInfo)
       spawnRobot(robot);
 
       // Fire ShipSpawned event for robots
-      EventManager::get()->fireEvent(EventManager::ShipSpawnedEvent, robot);
+      mGame->getEventManager()->fireEvent(EventManager::ShipSpawnedEvent, robot);
    }
    else
    {
@@ -1200,7 +1205,7 @@ bool GameType::spawnShip(ClientInfo *clientInfo)
       newShip->addToGame(mGame, mGame->getGameObjDatabase());
 
       // Fire ShipSpawned event for players
-      EventManager::get()->fireEvent(EventManager::ShipSpawnedEvent, newShip);
+      mGame->getEventManager()->fireEvent(EventManager::ShipSpawnedEvent, newShip);
 
       if(!levelHasLoadoutZone())
       {
@@ -1432,6 +1437,8 @@ void GameType::performProxyScopeQuery(BfObject *scopeObject, ClientInfo *clientI
 
    if(isTeamGame() && connection->isInCommanderMap())
    {
+      connection->mLastScope.valid = false;     // Incremental scoping only tracks the simple query below
+
       S32 teamId = clientInfo->getTeamIndex();
       fillVector.clear();
       bool sameQuery = false;  // helps speed up by not repeatedly finding same objects
@@ -1474,7 +1481,14 @@ void GameType::performProxyScopeQuery(BfObject *scopeObject, ClientInfo *clientI
       queryRect.expand( mGame->getScopeRange(co->hasModule(ModuleSensor)) );
 
       fillVector.clear();
-      mGame->getGameObjDatabase()->findObjects((TestFunc)isAnyObjectType, fillVector, queryRect);
+
+      if(mGame->getSettings()->getIniSettings()->enableIncrementalScoping)
+         connection->findObjectsInScope(mGame->getGameObjDatabase(), queryRect, fillVector);
+      else
+      {
+         connection->mLastScope.valid = false;
+         mGame->getGameObjDatabase()->findObjects((TestFunc)isAnyObjectType, fillVector, queryRect);
+      }
    }
 
    // Set object-in-scope for all objects found above
@@ -1870,15 +1884,15 @@ void GameType::updateScore(ClientInfo *player, S32 teamIndex, ScoringEvent scori
          {
             // Fire Lua event, but not for scoring team
             if(i != teamIndex)
-               EventManager::get()->fireEvent(EventManager::ScoreChangedEvent, -teamPoints, i + 1, playerInfo);
+               mGame->getEventManager()->fireEvent(EventManager::ScoreChangedEvent, -teamPoints, i + 1, playerInfo);
          }
       }
       // Not own-goal
       else
-         EventManager::get()->fireEvent(EventManager::ScoreChangedEvent, teamPoints, teamIndex + 1, playerInfo);
+         mGame->getEventManager()->fireEvent(EventManager::ScoreChangedEvent, teamPoints, teamIndex + 1, playerInfo);
    }
    else
-      EventManager::get()->fireEvent(EventManager::ScoreChangedEvent, playerPoints, teamIndex + 1, playerInfo);
+      mGame->getEventManager()->fireEvent(EventManager::ScoreChangedEvent, playerPoints, teamIndex + 1, playerInfo);
 
 
    // End game if max score has been reached
@@ -2228,7 +2242,7 @@ void GameType::changeClientTeam(ClientInfo *client, S32 team)
       return;
 
    // Fire onPlayerTeamChangedEvent
-   EventManager::get()->fireEvent(NULL, EventManager::PlayerTeamChangedEvent, client->getPlayerInfo());
+   mGame->getEventManager()->fireEvent(NULL, EventManager::PlayerTeamChangedEvent, client->getPlayerInfo());
 
    TNLAssert(client->isRobot() || client->getConnection()->getControlObject() == client->getShip(), "Not equal?!?");
    Ship *ship = client->getShip();    // Get the ship that's switching
@@ -2660,6 +2674,151 @@ TNL_IMPLEMENT_NETOBJECT_RPC(GameType, s2cAddWalls, (Vector<F32> verts, F32 width
 }
 
 
+static U64 getBitsUsed(NetClassRep *rep)
+{
+   return rep->getInitialUpdateBitsUsed() + rep->getPartialUpdateBitsUsed();
+}
+
+
+static bool sortByBitsUsed(NetClassRep * const &a, NetClassRep * const &b)
+{
+   return getBitsUsed(a) > getBitsUsed(b);
+}
+
+
+// Lists the object and event classes that have used the most bandwidth since startup, or since the last reset.
+// The counts are server-wide: they include every game this process hosts, and a reset clears them for all of them.
+static void showNetStats(GameConnection *conn, bool reset)
+{
+   if(reset)
+   {
+      NetClassRep::resetBitUsage();
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "Net stats reset for all games on this server");
+      return;
+   }
+
+   const S32 MaxClassesToShow = 8;
+
+   Vector<NetClassRep *> reps;
+   U64 totalBits = 0;
+
+   for(NetClassRep *rep = NetClassRep::getFirstClass(); rep; rep = rep->getNextClass())
+      if(getBitsUsed(rep) > 0)
+      {
+         reps.push_back(rep);
+         totalBits += getBitsUsed(rep);
+      }
+
+   reps.sort(sortByBitsUsed);
+
+   conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone,
+         "All games on this server sent " + itos(totalBits / 8192) + " KB in " + itos(reps.size()) + " classes; top classes:");
+
+   for(S32 i = 0; i < reps.size() && i < MaxClassesToShow; i++)
+   {
+      NetClassRep *rep = reps[i];
+      U64 updates = rep->getInitialUpdateCount() + rep->getPartialUpdateCount();
+
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, string(rep->getClassName()) + ": " +
+            itos(getBitsUsed(rep) / 8192) + " KB, " + itos(updates) +
+            (rep->getClassType() == NetClassTypeEvent ? " sent, " : " updates, ") +
+            ftos(F32(Platform::getHighPrecisionMilliseconds(rep->getPackTime())), 1) + " ms packing");
+   }
+}
+
+
+static void showPoolStats(GameConnection *conn)
+{
+   if(!ObjectPool::getFirstPool())
+   {
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "No object pools in use");
+      return;
+   }
+
+   for(ObjectPool *pool = ObjectPool::getFirstPool(); pool; pool = pool->getNextPool())
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, string(pool->getName()) + ": " +
+            itos(pool->getLiveCount()) + " live, " + itos(pool->getPeakCount()) + " peak, " +
+            itos(pool->getSlotCount()) + " slots of " + itos(pool->getElementSize()) + " bytes, " +
+            itos(pool->getAllocCount()) + " allocated" +
+            (pool->getOversizeCount() > 0 ? ", " + itos(pool->getOversizeCount()) + " from heap" : ""));
+}
+
+
+static string formatTickStats(const char *name, const TickProfiler::ZoneStats &stats)
+{
+   return string(name) + ": p50 " + ftos(stats.p50, 2) + " ms, p99 " + ftos(stats.p99, 2) +
+          " ms, max " + ftos(stats.max, 2) + " ms";
+}
+
+
+static bool sortByP99(const pair<U32, TickProfiler::ZoneStats> &a, const pair<U32, TickProfiler::ZoneStats> &b)
+{
+   return a.second.p99 > b.second.p99;
+}
+
+
+// How well a dedicated server is keeping up with its fixed timestep
+static void showSchedulerStats(GameConnection *conn, TickScheduler *scheduler)
+{
+   const TickScheduler::Stats &stats = scheduler->getStats();
+
+   conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "Scheduler: " + itos(scheduler->getTickRate()) +
+         " ticks/sec, " + itos(stats.ticks) + " ticks, " + itos(stats.catchUpTicks) + " caught up, " +
+         itos(stats.droppedTicks) + " dropped, " + itos(stats.overruns) + " overran, " +
+         itos(stats.clockResets) + " clock resets");
+
+   conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "Scheduler: worst lateness " +
+         ftos(F32(stats.maxLateness), 2) + " ms, longest tick " + ftos(F32(stats.maxTickTime), 2) + " ms, " +
+         itos(stats.sends) + " scheduled sends");
+}
+
+
+// Shows how long each stage of the server's game loop took over the last few hundred ticks, along with
+// the object types whose idles took longest
+static void showTickStats(GameConnection *conn, TickProfiler *profiler, TickScheduler *scheduler, bool reset)
+{
+   if(reset)
+   {
+      profiler->reset();
+      scheduler->resetStats();
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "Tick stats reset");
+      return;
+   }
+
+   if(scheduler->isRunning())
+      showSchedulerStats(conn, scheduler);
+
+   if(profiler->getTickCount() == 0)
+   {
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, "No ticks profiled");
+      return;
+   }
+
+   const S32 MaxTypesToShow = 5;
+
+   Vector<pair<U32, TickProfiler::ZoneStats> > types;
+
+   for(U32 i = 0; i < TickProfiler::getZoneCount(); i++)
+   {
+      TickProfiler::ZoneStats stats = profiler->getStats(i);
+
+      if(stats.samples == 0)
+         continue;
+
+      if(TickProfiler::isTypeZone(i))
+         types.push_back(make_pair(i, stats));
+      else
+         conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone, formatTickStats(TickProfiler::getZoneName(i), stats));
+   }
+
+   types.sort(sortByP99);
+
+   for(S32 i = 0; i < types.size() && i < MaxTypesToShow; i++)
+      conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone,
+            formatTickStats(TickProfiler::getZoneName(types[i].first), types[i].second));
+}
+
+
 extern void writeServerBanList(CIniFile *ini, BanList *banList);
 
 // Runs the server side commands, which the client may or may not know about
@@ -2703,6 +2862,45 @@ void GameType::processServerCommand(ClientInfo *clientInfo, const char *cmd, Vec
       else
          clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
    }
+   else if(stricmp(cmd, "connectstats") == 0)
+   {
+      if(clientInfo->isAdmin())
+      {
+         GameNetInterface *netInterface = serverGame->getNetInterface();
+         ClientPuzzleManager &puzzles = netInterface->getPuzzleManager();
+         GameConnection *conn = clientInfo->getConnection();
+
+         conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone,
+               "Puzzle difficulty " + itos(puzzles.getCurrentDifficulty()) + (puzzles.isAdaptiveDifficulty() ? " (adaptive)" : " (fixed)"));
+         conn->s2cDisplayMessage(GameConnection::ColorInfo, SFXNone,
+               "Connect requests: " + ftos(puzzles.getRequestRate(), 1) + "/s, handshake load " +
+               ftos(puzzles.getHandshakeLoad(), 1) + " ms/s, " + itos(netInterface->getPendingHandshakeCount()) + " pending");
+      }
+      else
+         clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
+   }
+   else if(stricmp(cmd, "netstats") == 0)
+   {
+      if(clientInfo->isAdmin())
+         showNetStats(clientInfo->getConnection(), args.size() > 0 && stricmp(args[0].getString(), "reset") == 0);
+      else
+         clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
+   }
+   else if(stricmp(cmd, "poolstats") == 0)
+   {
+      if(clientInfo->isAdmin())
+         showPoolStats(clientInfo->getConnection());
+      else
+         clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
+   }
+   else if(stricmp(cmd, "tickstats") == 0)
+   {
+      if(clientInfo->isAdmin())
+         showTickStats(clientInfo->getConnection(), serverGame->getTickProfiler(), serverGame->getTickScheduler(),
+                       args.size() > 0 && stricmp(args[0].getString(), "reset") == 0);
+      else
+         clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Need admin");
+   }
    else
       clientInfo->getConnection()->s2cDisplayErrorMessage("!!! Invalid Command");
 }
@@ -3400,7 +3598,7 @@ void GameType::sendChat(const StringTableEntry &senderName, ClientInfo *senderCl
    // And fire an event handler...
    // But don't add event if called by robot - it is already called in Robot::globalMsg/teamMsg
    if(senderClientInfo && !senderClientInfo->isRobot())
-      EventManager::get()->fireEvent(NULL, EventManager::MsgReceivedEvent, message, senderClientInfo->getPlayerInfo(), global);
+      mGame->getEventManager()->fireEvent(NULL, EventManager::MsgReceivedEvent, message, senderClientInfo->getPlayerInfo(), global);
 
    GameConnection *gc = ((ServerGame*)mGame)->getGameRecorder();
    if(gc)
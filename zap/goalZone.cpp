@@ -217,6 +217,12 @@ S32 GoalZone::getScore()
 }
 
 
+bool GoalZone::hasFlag()
+{
+   return mHasFlag;
+}
+
+
 void GoalZone::setHasFlag(bool hasFlag)
 {
    mHasFlag = hasFlag;
@@ -297,7 +303,7 @@ REGISTER_LUA_SUBCLASS(GoalZone, Zone);
  * @return `true` if the GoalZone is currently holding a flag, `false`
  * otherwise.
  */
-S32 GoalZone::lua_hasFlag(lua_State *L) { return returnBool(L, mHasFlag); }
+S32 GoalZone::lua_hasFlag(lua_State *L) { return returnBool(L, hasFlag()); }
 
 };
 
@@ -60,7 +60,7 @@ public:
    void setFlashCount(S32 i);
 
    S32 getScore();
-   //bool hasFlag();
+   bool hasFlag();
    void setHasFlag(bool hasFlag);
    
    ClientInfo *getCapturer();
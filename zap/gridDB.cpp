@@ -41,6 +41,10 @@ GridDatabase::GridDatabase(bool createWallSegmentManager)
       mWallSegmentManager = NULL;
 
    mDatabaseId = getNextId();
+   mStaticChangeCount = 0;
+   mChangeCount = 0;
+   mMembershipChangeCount = 0;
+   mRemovalCount = 0;
 }
 
 
@@ -155,6 +159,12 @@ void GridDatabase::addToDatabase(DatabaseObject *theObject)
       mFlags.push_back(theObject);
    else if(type == SpyBugTypeNumber)
       mSpyBugs.push_back(theObject);
+
+   if(isStaticObjectType(type))
+      mStaticChangeCount++;
+
+   mChangeCount++;
+   mMembershipChangeCount++;
    
    //sortObjects(mAllObjects);  // problem: Barriers in-game don't have mGeometry (it is NULL)
 }
@@ -192,6 +202,10 @@ void GridDatabase::removeEverythingFromDatabase()
    mSpyBugs.clear();
 
    mAllObjects.deleteAndClear();
+   mStaticChangeCount++;
+   mChangeCount++;
+   mMembershipChangeCount++;
+   mRemovalCount++;
    
    if(mWallSegmentManager)
       mWallSegmentManager->clear();
@@ -252,6 +266,13 @@ void GridDatabase::removeFromDatabase(DatabaseObject *object, bool deleteObject)
    else if(type == SpyBugTypeNumber)
       eraseObject_fast(&mSpyBugs, object);
 
+   if(isStaticObjectType(type))
+      mStaticChangeCount++;
+
+   mChangeCount++;
+   mMembershipChangeCount++;
+   mRemovalCount++;
+
    if(deleteObject)
       delete object;      
 }
@@ -794,6 +815,36 @@ DatabaseObject *GridDatabase::getObjectByIndex(S32 index) const
 } 
 
 
+U32 GridDatabase::getDatabaseId() const
+{
+   return mDatabaseId;
+}
+
+
+U32 GridDatabase::getStaticChangeCount() const
+{
+   return mStaticChangeCount;
+}
+
+
+U32 GridDatabase::getChangeCount() const
+{
+   return mChangeCount;
+}
+
+
+U32 GridDatabase::getMembershipChangeCount() const
+{
+   return mMembershipChangeCount;
+}
+
+
+U32 GridDatabase::getRemovalCount() const
+{
+   return mRemovalCount;
+}
+
+
 void DatabaseObject::addToDatabase(GridDatabase *database)
 {
    TNLAssert(mExtentSet, "Extent has not been set on this object!");    // Sanity check
@@ -887,6 +938,14 @@ void DatabaseObject::setExtent(const Rect &extents)
 
    if(gridDB)
    {
+      if(!(mExtent == extents))
+      {
+         gridDB->mChangeCount++;
+
+         if(isStaticObjectType(mObjectTypeNumber))
+            gridDB->mStaticChangeCount++;
+      }
+
       // Remove from the extents database for current extents...
       //gridDB->removeFromDatabase(this, mExtent);    // old extent
       // ...and re-add for the new extent
@@ -102,6 +102,8 @@ class GoalZone;
 
 class GridDatabase
 {
+   friend class DatabaseObject;
+
 private:
    U32 mDatabaseId;
    static U32 mQueryId;
@@ -114,6 +116,11 @@ private:
    Vector<DatabaseObject *> mFlags;
    Vector<DatabaseObject *> mSpyBugs;
 
+   U32 mStaticChangeCount;             // Bumped whenever a static object is added, removed, or changes its extent
+   U32 mChangeCount;                   // Bumped whenever any object is added, removed, or changes its extent
+   U32 mMembershipChangeCount;         // Bumped whenever any object is added or removed
+   U32 mRemovalCount;                  // Bumped whenever any object is removed
+
    void findObjects(U8 typeNumber, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
    void findObjects(Vector<U8> typeNumbers, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins) const;
    void findObjects(TestFunc testFunc, Vector<DatabaseObject *> &fillVector, const Rect *extents, const IntRect *bins, bool sameQuery = false) const;
@@ -186,6 +193,13 @@ public:
    S32 getObjectCount(U8 typeNumber) const;             // Return the number of objects currently in the database of specified type
    bool hasObjectOfType(U8 typeNumber) const;
    DatabaseObject *getObjectByIndex(S32 index) const;   // Kind of hacky, kind of useful
+
+   U32 getDatabaseId() const;                           // Unique for every database created, unlike its address
+
+   U32 getStaticChangeCount() const;                    // Changes when any isStaticObjectType object is added, removed, or moved
+   U32 getChangeCount() const;                          // Changes when any object is added, removed, or moved
+   U32 getMembershipChangeCount() const;                // Changes when any object is added or removed
+   U32 getRemovalCount() const;                         // Changes when any object is removed
 };
 
 
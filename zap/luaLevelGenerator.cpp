@@ -165,7 +165,7 @@ S32 LuaLevelGenerator::lua_globalMsg(lua_State *L)
    lua_pop(L, 1);
 
    // Fire our event handler
-   EventManager::get()->fireEvent(this, EventManager::MsgReceivedEvent, message, NULL, true);
+   mGame->getEventManager()->fireEvent(this, EventManager::MsgReceivedEvent, message, NULL, true);
 
    return 0;
 }
@@ -192,7 +192,7 @@ S32 LuaLevelGenerator::lua_teamMsg(lua_State *L)
    lua_pop(L, 2);
 
    // Fire our event handler
-   EventManager::get()->fireEvent(this, EventManager::MsgReceivedEvent, message, NULL, true);
+   mGame->getEventManager()->fireEvent(this, EventManager::MsgReceivedEvent, message, NULL, true);
 
    return 0;
 }
@@ -123,6 +123,7 @@ using namespace TNL;
 #include "BotNavMeshZone.h"
 #include "ship.h"
 #include "LevelSource.h"
+#include "LuaScriptCache.h"
 
 #include <math.h>
 #include <stdarg.h>
@@ -403,10 +404,117 @@ void idle()
 }  // end idle()
 
 
+// Milliseconds since the first call, for the tick scheduler
+static F64 getSchedulerTime()
+{
+   static S64 startTime = Platform::getHighPrecisionTimerValue();
+
+   return Platform::getHighPrecisionMilliseconds(Platform::getHighPrecisionTimerValue() - startTime);
+}
+
+
+// An empty game only needs to keep an ear open for players arriving, so it can get by with fewer, longer ticks
+static const U32 SuspendedTickRate = 25;
+
+// (Re)starts a game's scheduler whenever it needs to run at different rates than it is: when it first starts
+// hosting, and as it goes into and comes out of suspension
+static void updateTickScheduler(ServerGame *serverGame)
+{
+   IniSettings *iniSettings = serverGame->getSettings()->getIniSettings();
+   TickScheduler *scheduler = serverGame->getTickScheduler();
+
+   bool suspended = serverGame->isSuspended();
+   U32 tickRate = suspended ? SuspendedTickRate : iniSettings->maxDedicatedFPS;
+   U32 sendRate = suspended ? 0 : iniSettings->packetSendRate;
+
+   if(scheduler->isRunning() && scheduler->getTickRate() == tickRate && scheduler->getSendRate() == sendRate)
+      return;
+
+   scheduler->setTickRate(tickRate);
+   scheduler->setSendRate(sendRate);
+   scheduler->setMaxCatchUpTicks(iniSettings->maxCatchUpTicks);
+   scheduler->start(getSchedulerTime());
+}
+
+
+// Runs whatever ticks are due for one game, and sends its packets if they're due.  Returns false if the game
+// shut down and was deleted.  The main game going down takes the whole process with it, as it always has.
+static bool idleScheduledGame(ServerGame *serverGame)
+{
+   updateTickScheduler(serverGame);
+
+   TickScheduler *scheduler = serverGame->getTickScheduler();
+
+   U32 ticks = scheduler->getTicksDue(getSchedulerTime());
+   U32 tickPeriod = scheduler->getTickPeriod();
+
+   for(U32 i = 0; i < ticks; i++)
+   {
+      F64 tickStart = getSchedulerTime();
+
+      if(serverGame == GameManager::getServerGame())
+         checkIfServerGameIsShuttingDown(tickPeriod);
+      else
+      {
+         string shutdownReason;
+         if(serverGame->isReadyToShutdown(tickPeriod, shutdownReason))
+         {
+            logprintf(LogConsumer::ServerFilter, "Game hostname=[%s] shut down", serverGame->getSettings()->getHostName().c_str());
+            GameManager::deleteServerGame(serverGame);
+            return false;
+         }
+      }
+
+      serverGame->idle(tickPeriod);
+
+      scheduler->recordTickTime(getSchedulerTime() - tickStart);
+   }
+
+   if(scheduler->isSendDue(getSchedulerTime()))
+      serverGame->sendPackets();
+
+   return true;
+}
+
+
+// Once a dedicated server is hosting, each of its games runs on a fixed timestep: its scheduler tells us how many
+// ticks are due, we run them, send packets if they're due, then sleep until the soonest deadline of any game.
+// The games take turns on this thread; they share the Lua interpreter and the network layer, neither of which
+// would take kindly to being run from several threads at once.  Loading the main game's levels is still left to
+// idle(), as it loads one level per call.
 void dedicatedServerLoop()
 {
    for(;;)        // Loop forever!
-      idle();     // Idly!
+   {
+      bool loadingLevels = GameManager::getHostingModePhase() == GameManager::LoadingLevels ||
+                           GameManager::getHostingModePhase() == GameManager::DoneLoadingLevels;
+
+      if(!GameManager::getServerGame() || loadingLevels)
+      {
+         idle();     // Idly!
+         continue;
+      }
+
+      const Vector<ServerGame *> *serverGames = GameManager::getServerGames();
+
+      F64 sleepTime = 1000.0 / SuspendedTickRate;
+
+      for(S32 i = 0; i < serverGames->size(); i++)
+      {
+         ServerGame *serverGame = serverGames->get(i);
+
+         if(!idleScheduledGame(serverGame))
+         {
+            i--;     // It's gone from the list
+            continue;
+         }
+
+         sleepTime = min(sleepTime, serverGame->getTickScheduler()->getTimeUntilNextDeadline(getSchedulerTime()));
+      }
+
+      if(sleepTime > 0)
+         Platform::sleepMicroseconds(U32(sleepTime * 1000));
+   }
 }
 
 ////////////////////////////////////////
@@ -478,7 +586,6 @@ void shutdownBitfighter()
 
    TNLAssert(settings, "Should always have a value here!");
 
-   EventManager::shutdown();
    LuaScriptRunner::shutdown();
    SoundSystem::shutdown();
 
@@ -1182,6 +1289,10 @@ int main(int argc, char **argv)
       checkIfThisIsAnUpdate(settings.get(), isStandalone);
 
    // Load Lua stuff
+   IniSettings *iniSettings = settings->getIniSettings();
+   LuaScriptCache::setMaxScripts(iniSettings->scriptCacheSize);
+   LuaScriptCache::setBytecodeDir(iniSettings->saveScriptBytecode ? joindir(folderManager->iniDir, "luacache") : "");
+
    LuaScriptRunner::startLua(folderManager->luaDir);  // Create single "L" instance which all scripts will use
    // TODO: What should we do if this fails?  Quit the game?
 
@@ -1209,6 +1320,14 @@ int main(int argc, char **argv)
 
       // Figure out what levels we'll be playing with, and start hosting  
       initHosting(settings, levelSource, false, true, settings->getSpecified(HOST_ON_DEDICATED));
+
+      // Any other games we're hosting get set up all in one go, while the main game loads its levels
+      Vector<string> extraGames;
+      parseString(settings->getIniSettings()->extraGames, extraGames, ',');
+
+      for(S32 i = 0; i < extraGames.size(); i++)
+         if(GameManager::getServerGame())
+            initExtraHosting(extraGames[i]);
    }
    else
    {
@@ -9,6 +9,7 @@
 #include "SoundSystemEnums.h"
 
 #include "game.h"
+#include "ServerGame.h"
 #include "gameConnection.h"
 #include "ship.h"
 #include "Zone.h"
@@ -574,27 +575,59 @@ void MoveObject::checkForZones()
 
    getZonesObjectIsIn(currZoneList);     // Fill currZoneList with a list of all zones ship is currently in
 
-   // Now compare currZoneList with prevZoneList to figure out if ship entered or exited any zones
-   for(S32 i = 0; i < currZoneList.size(); i++)
-      if(!prevZoneList.contains(currZoneList[i]))
-         onEnteredZone(currZoneList[i].getPointer());
+   // Both lists are sorted by zone serial number, so one pass over them finds the differences.  We collect
+   // them before firing any events, as event handlers can remove zones out from under us.
+   static Vector<Zone *> entered;
+   static Vector<Zone *> left;
 
-   for(S32 i = 0; i < prevZoneList.size(); i++)
-      // Zone can sometimes disappear if removed from the game via Lua, check if valid first
-      if(prevZoneList[i].isValid() && !currZoneList.contains(prevZoneList[i]))
-         onLeftZone(prevZoneList[i].getPointer());
+   entered.clear();
+   left.clear();
+
+   S32 curr = 0, prev = 0;
+
+   while(curr < currZoneList.size() || prev < prevZoneList.size())
+   {
+      // Zone can sometimes disappear if removed from the game via Lua; no event for those
+      if(prev < prevZoneList.size() && !prevZoneList[prev].isValid())
+         prev++;
+      else if(prev == prevZoneList.size())
+         entered.push_back(currZoneList[curr++].getPointer());
+      else if(curr == currZoneList.size())
+         left.push_back(prevZoneList[prev++].getPointer());
+      else
+      {
+         S32 currId = currZoneList[curr]->getSerialNumber();
+         S32 prevId = prevZoneList[prev]->getSerialNumber();
+
+         if(currId < prevId)
+            entered.push_back(currZoneList[curr++].getPointer());
+         else if(currId > prevId)
+            left.push_back(prevZoneList[prev++].getPointer());
+         else
+         {
+            curr++;
+            prev++;
+         }
+      }
+   }
+
+   for(S32 i = 0; i < entered.size(); i++)
+      onEnteredZone(entered[i]);
+
+   for(S32 i = 0; i < left.size(); i++)
+      onLeftZone(left[i]);
 }
 
 
 void MoveObject::onEnteredZone(Zone *zone)
 {
-   EventManager::get()->fireEvent(EventManager::ObjectEnteredZoneEvent, this, zone);
+   getGame()->getEventManager()->fireEvent(EventManager::ObjectEnteredZoneEvent, this, zone);
 }
 
 
 void MoveObject::onLeftZone(Zone *zone)
 {
-   EventManager::get()->fireEvent(EventManager::ObjectLeftZoneEvent, this, zone);
+   getGame()->getEventManager()->fireEvent(EventManager::ObjectLeftZoneEvent, this, zone);
 }
 
 
@@ -606,22 +639,22 @@ void MoveObject::getZonesObjectIsIn(Vector<SafePtr<Zone> > &zoneList)
    // Use this boolean as a cheap way of making the current zone list be the previous out without copying
    mZones1IsCurrent = !mZones1IsCurrent;
 
+   // Zone coverage tells us which zones might contain the object, and skips the polygon test when the object is
+   // well inside one.  Zones come back sorted by serial number, which checkForZones() relies on.
+   static Vector<Zone *> zones;
+
    zoneList.clear();
 
-   Rect rect(getActualPos(), getActualPos());            // Center of object
+   if(!getGame() || !getDatabase())
+      return;
 
-   fillVector.clear();
-   findObjects((TestFunc)isZoneType, fillVector, rect);  // Find all zones the object might be in
+   TNLAssert(getGame()->isServer(), "Zone tracking is server only!");
 
-   // Extents overlap...  now check for actual overlap
-   for(S32 i = 0; i < fillVector.size(); i++)
-   {
-      // Get points that define the zone boundaries
-      const Vector<Point> *polyPoints = fillVector[i]->getCollisionPoly();
+   ZoneCoverage *zoneCoverage = static_cast<ServerGame *>(getGame())->getZoneCoverage();
+   zoneCoverage->findZones(getDatabase(), getActualPos(), zones);
 
-      if(polygonContainsPoint(polyPoints->address(), polyPoints->size(), getActualPos()))
-         zoneList.push_back(SafePtr<Zone>(static_cast<Zone *>(fillVector[i])));
-   }
+   for(S32 i = 0; i < zones.size(); i++)
+      zoneList.push_back(SafePtr<Zone>(zones[i]));
 }
 
 
@@ -1070,8 +1103,7 @@ U32 MoveItem::packUpdate(GhostConnection *connection, U32 updateMask, BitStream
 
    if(stream->writeFlag(updateMask & PositionMask))
    {
-      ((GameConnection *) connection)->writeCompressedPoint(getActualPos(), stream);
-      writeCompressedVelocity(getActualVel(), VEL_POINT_SEND_BITS, stream);
+      writePositionAndVelocity(connection, getActualPos(), getActualVel(), VEL_POINT_SEND_BITS, stream);
       stream->writeFlag(updateMask & WarpPositionMask);     // WarpPositionMask
    }
 
@@ -1091,9 +1123,9 @@ void MoveItem::unpackUpdate(GhostConnection *connection, BitStream *stream)
 
    if(stream->readFlag())                          // PositionMask
    {
-      Point pt;
+      Point pt, vel;
 
-      ((GameConnection *) connection)->readCompressedPoint(pt, stream);
+      readPositionAndVelocity(connection, pt, vel, VEL_POINT_SEND_BITS, stream);
 
       // Here, we need to set the renderPos BEFORE setting actualPos -- setting actualPos triggers a 
       // recalculation of the object's extent, which, for whatever reason, will extend from the renderPos
@@ -1104,9 +1136,7 @@ void MoveItem::unpackUpdate(GhostConnection *connection, BitStream *stream)
          setRenderPos(pt);
 
       setActualPos(pt);
-
-      readCompressedVelocity(pt, VEL_POINT_SEND_BITS, stream);   
-      setActualVel(pt);
+      setActualVel(vel);
 
       positionChanged = true;
       warpToNewPosition = stream->readFlag();     // WarpPositionMask
@@ -6,6 +6,7 @@
 #include "projectile.h"
 #include "ship.h"
 #include "game.h"
+#include "ServerGame.h"
 #include "gameConnection.h"
 
 #ifndef ZAP_DEDICATED
@@ -20,6 +21,7 @@
 
 
 TNL_IMPLEMENT_NETOBJECT(Projectile);
+BF_IMPLEMENT_POOLED_ALLOCATION(Projectile);
 
 namespace Zap 
 {
@@ -74,6 +76,7 @@ void Projectile::initialize(WeaponType type, const Point &pos, const Point &vel,
    mAlive = true;
    mBounced = false;
    mLiveTimeIncreases = 0;
+   mInProjectileSystem = false;
    mShooter = shooter;
 
    setOwner(NULL);
@@ -213,12 +216,33 @@ void Projectile::handleCollision(BfObject *hitObject, Point collisionPoint)
 void Projectile::onAddedToGame(Game *game)
 {
    Parent::onAddedToGame(game);
+
+   if(game->isServer() && !mInProjectileSystem)
+   {
+      static_cast<ServerGame *>(game)->getProjectileSystem()->add(this);
+      mInProjectileSystem = true;
+   }
 }
 
+
 void Projectile::idle(BfObject::IdleCallPath path)
 {
-   U32 deltaT = mCurrentMove.time;
+   // On the server, ProjectileSystem moves us along with all the other bullets
+   if(path == BfObject::ServerIdleMainLoop && mInProjectileSystem)
+      return;
+
+   advance(mCurrentMove.time, path);
+}
+
+
+bool Projectile::isInFlight() const
+{
+   return !mCollided && mAlive;
+}
+
 
+void Projectile::advance(U32 deltaT, BfObject::IdleCallPath path)
+{
    if(!mCollided && mAlive)
    {
       U32 objAge = getGame()->getCurrentTime() - getCreationTime();  // Age of object, in ms
@@ -359,18 +383,25 @@ void Projectile::idle(BfObject::IdleCallPath path)
    }
          
 
-   // Kill old projectiles
-   if(mAlive && path == BfObject::ServerIdleMainLoop)
+   if(path == BfObject::ServerIdleMainLoop)
+      updateTimeRemaining(deltaT);
+}
+
+
+// Kill old projectiles
+void Projectile::updateTimeRemaining(U32 deltaT)
+{
+   if(!mAlive)
+      return;
+
+   if(mTimeRemaining > deltaT)
+      mTimeRemaining -= deltaT;     // Decrement time left to live
+   else
    {
-      if(mTimeRemaining > deltaT)
-         mTimeRemaining -= deltaT;     // Decrement time left to live
-      else
-      {
-         deleteObject(500);
-         mTimeRemaining = 0;
-         mAlive = false;
-         setMaskBits(ExplodedMask);
-      }
+      deleteObject(500);
+      mTimeRemaining = 0;
+      mAlive = false;
+      setMaskBits(ExplodedMask);
    }
 }
 
@@ -531,6 +562,7 @@ S32 Projectile::lua_setVel(lua_State *L)
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Burst);
+BF_IMPLEMENT_POOLED_ALLOCATION(Burst);
 
 // Constructor -- used when burst is fired
 Burst::Burst(const Point &pos, const Point &vel, BfObject *shooter, F32 radius) : MoveItem(pos, true, radius, BurstMass)
@@ -799,6 +831,7 @@ S32 Burst::lua_getWeapon(lua_State *L) { return returnWeaponType(L, mWeaponType)
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Mine);
+BF_IMPLEMENT_POOLED_ALLOCATION(Mine);
 
 
 const U32 Mine::FuseDelay = 100;
@@ -1097,6 +1130,7 @@ REGISTER_LUA_SUBCLASS(Mine, Burst);
 //////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(SpyBug);
+BF_IMPLEMENT_POOLED_ALLOCATION(SpyBug);
 
 // Constructor -- used when SpyBug is deployed
 SpyBug::SpyBug(const Point &pos, BfObject *planter) : Burst(pos, Point(0,0), planter)
@@ -1365,6 +1399,7 @@ REGISTER_LUA_SUBCLASS(SpyBug, Burst);
 ////////////////////////////////////////
 
 TNL_IMPLEMENT_NETOBJECT(Seeker);
+BF_IMPLEMENT_POOLED_ALLOCATION(Seeker);
 
 // Constructor
 const F32 Seeker_Radius = 4;
@@ -1570,12 +1605,11 @@ void Seeker::acquireTarget()
 {
    F32 ourAngle = getActualAngle();
 
-   // Used for wall detection
-   static Vector<DatabaseObject *> localFillVector;
+   TargetIndex *targetIndex = static_cast<ServerGame *>(getGame())->getTargetIndex();
 
    Rect queryRect(getPos(), TargetAcquisitionRadius);
    fillVector.clear();
-   findObjects(isSeekerTarget, fillVector, queryRect);
+   targetIndex->findTargets(isSeekerTarget, queryRect, fillVector);
 
    F32 closest = F32_MAX;
 
@@ -1610,25 +1644,7 @@ void Seeker::acquireTarget()
          continue;
 
       // Finally make sure there are no collideable objects in the way (like walls, forcefields)
-      localFillVector.clear();
-      findObjects((TestFunc)isCollideableType, localFillVector, Rect(getPos(), foundObject->getPos()));
-
-      F32 dummy;
-      bool wallInTheWay = false;
-
-      for(S32 i = 0; i < localFillVector.size(); i++)
-      {
-         BfObject *collideObject = static_cast<BfObject *>(localFillVector[i]);
-
-         if(collideObject->collide(this) &&   // Test forcefield up or down
-               objectIntersectsSegment(collideObject, getPos(), foundObject->getPos(), dummy))
-         {
-            wallInTheWay = true;
-            break;
-         }
-      }
-
-      if(wallInTheWay)
+      if(!targetIndex->canSee(this, getPos(), foundObject, TargetIndex::BlockedByCollideables))
          continue;
 
       closest = distanceSq;
@@ -8,6 +8,7 @@
 
 #include "BfObject.h"      // Parent
 #include "moveObject.h"    // Parent
+#include "ObjectPool.h"
 
 #include "Point.h"
 #include "WeaponInfo.h"
@@ -45,9 +46,9 @@ protected:
 
    Point mVelocity;
 
+public:
    virtual F32 getRadius();
 
-public:
    U32 mTimeRemaining;
    ProjectileType mType;
    WeaponType mWeaponType;
@@ -56,6 +57,7 @@ public:
    bool mAlive;
    bool mBounced;
    U32 mLiveTimeIncreases;
+   bool mInProjectileSystem;     // Server moves us in ProjectileSystem rather than in idle()
 
    Projectile(WeaponType type, const Point &pos, const Point &vel, BfObject *shooter);  // Constructor -- used when weapon is fired  
    explicit Projectile(lua_State *L = NULL);                                            // Combined Lua / C++ default constructor -- only used in Lua at the moment
@@ -69,6 +71,10 @@ public:
    void onAddedToGame(Game *game);
 
    void idle(BfObject::IdleCallPath path);
+   void advance(U32 deltaT, BfObject::IdleCallPath path);   // Move, bounce, and check for hits
+   void updateTimeRemaining(U32 deltaT);                    // Server only
+   bool isInFlight() const;
+
    void damageObject(DamageInfo *info);
    void explode(BfObject *hitObject, Point p);
 
@@ -85,6 +91,7 @@ public:
    BfObject *getShooter() const;
 
    TNL_DECLARE_CLASS(Projectile);
+   BF_DECLARE_POOLED_ALLOCATION     // Fired by the dozen, so these come from an ObjectPool
 
    //// Lua interface
    LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(Projectile);
@@ -151,6 +158,7 @@ public:
    BfObject *getShooter() const;
 
    TNL_DECLARE_CLASS(Burst);
+   BF_DECLARE_POOLED_ALLOCATION
 
    //// Lua interface
    LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(Burst);
@@ -197,6 +205,7 @@ public:
    void unpackUpdate(GhostConnection *connection, BitStream *stream);
 
    TNL_DECLARE_CLASS(Mine);
+   BF_DECLARE_POOLED_ALLOCATION
 
    /////
    // Editor methods
@@ -258,6 +267,7 @@ public:
    void unpackUpdate(GhostConnection *connection, BitStream *stream);
 
    TNL_DECLARE_CLASS(SpyBug);
+   BF_DECLARE_POOLED_ALLOCATION
 
    /////
    // Editor methods
@@ -350,6 +360,7 @@ public:
    BfObject *getShooter() const;
 
    TNL_DECLARE_CLASS(Seeker);
+   BF_DECLARE_POOLED_ALLOCATION
 
    //// Lua interface
    LUAW_DECLARE_CLASS_CUSTOM_CONSTRUCTOR(Seeker);
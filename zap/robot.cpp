@@ -5,6 +5,7 @@
 
 #include "robot.h"
 
+#include "RobotBrain.h"
 #include "playerInfo.h"          // For RobotPlayerInfo constructor
 #include "BotNavMeshZone.h"      // For BotNavMeshZone class definition
 #include "gameObjectRender.h"
@@ -14,7 +15,6 @@
 #include "GeomUtils.h"
 
 #include "ServerGame.h"
-#include "GameManager.h"
 
 
 #define hypot _hypot    // Kill some warnings
@@ -29,6 +29,16 @@ using namespace LuaArgs;
 
 TNL_IMPLEMENT_NETOBJECT(Robot);
 
+
+// Native brains aren't files, so their names go through as they are
+static string findBotScript(const string &scriptName)
+{
+   if(RobotBrain::isBrainName(scriptName))
+      return scriptName;
+
+   return GameSettings::getFolderManager()->findBotFile(scriptName);
+}
+
 /**
  * @luafunc Robot::Robot(point position, int teamIndex, string scriptName, string scriptArg)
  *
@@ -54,7 +64,7 @@ Robot::Robot(lua_State *L) : Ship(NULL, TEAM_NEUTRAL, Point(0,0), true),
 
       if(profile == 2)
       {
-         mScriptName = GameSettings::getFolderManager()->findBotFile(getString(L, i++));
+         mScriptName = findBotScript(getString(L, i++));
 
          while(i <= lua_gettop(L))
          {
@@ -67,10 +77,11 @@ Robot::Robot(lua_State *L) : Ship(NULL, TEAM_NEUTRAL, Point(0,0), true),
    }
 
    mHasSpawned = false;
+   mBrain = NULL;
    mObjectTypeNumber = RobotShipTypeNumber;
 
    mCurrentZone = U16_MAX;
-   flightPlanTo = U16_MAX;
+   mZonePathRetargets = 0;
 
    mPlayerInfo = new RobotPlayerInfo(this);
 
@@ -101,7 +112,7 @@ Robot::~Robot()
    // Server only from here on down
    if(getGame())  // can be NULL if this robot was never added to game (bad / missing robot file)
    {
-      EventManager::get()->fireEvent(this, EventManager::PlayerLeftEvent, getPlayerInfo());
+      getGame()->getEventManager()->fireEvent(this, EventManager::PlayerLeftEvent, getPlayerInfo());
 
       if(getGame()->getGameType())
          getGame()->getGameType()->serverRemoveClient(mClientInfo);
@@ -111,6 +122,8 @@ Robot::~Robot()
    }
 
    delete mPlayerInfo;
+   delete mBrain;
+
    if(mClientInfo.isValid())
    {
       getGame()->removeFromClientList(mClientInfo.getPointer());
@@ -132,6 +145,7 @@ bool Robot::initialize(Point &pos)
    try
    {
       flightPlan.clear();
+      mZonePath.clear();
 
       mCurrentZone = U16_MAX;   // Correct value will be calculated upon first request
 
@@ -146,7 +160,7 @@ bool Robot::initialize(Point &pos)
       setMaskBits(RespawnMask | HealthMask        | LoadoutMask         | PositionMask | 
                   MoveMask    | ModulePrimaryMask | ModuleSecondaryMask | WarpPositionMask);      // Send lots to the client
 
-      EventManager::get()->update();   // Ensure registrations made during bot initialization are ready to go
+      getGame()->getEventManager()->update();   // Ensure registrations made during bot initialization are ready to go
    }
    catch(LuaException &e)
    {
@@ -165,15 +179,35 @@ const char *Robot::getErrorMessagePrefix() { return "***ROBOT ERROR***"; }
 // Server only
 bool Robot::start()
 {
-   if(!getGame() || !runScript(!getGame()->isTestServer()))   // Load the script, execute the chunk to get it in memory, then run its main() function
+   if(!getGame())
       return false;
 
-   // Pass true so that if this bot doesn't have a TickEvent handler, we don't print a message
-   EventManager::get()->subscribe(this, EventManager::TickEvent, RobotContext, true);
+   string name;
+
+   if(RobotBrain::isBrainName(mScriptName))
+   {
+      // Native bots skip Lua altogether; RobotManager::runBrains() ticks them instead of the TickEvent
+      mBrain = RobotBrain::create(mScriptName, this, mScriptArgs);
+
+      if(!mBrain)
+         return false;
+
+      mBrain->onStart();
+      name = mBrain->getName();
+   }
+   else
+   {
+      if(!runScript(!getGame()->isTestServer()))   // Load the script, execute the chunk to get it in memory, then run its main() function
+         return false;
+
+      // Pass true so that if this bot doesn't have a TickEvent handler, we don't print a message
+      getGame()->getEventManager()->subscribe(this, EventManager::TickEvent, RobotContext, true);
+
+      mSubscriptions[EventManager::TickEvent] = true;
 
-   mSubscriptions[EventManager::TickEvent] = true;
+      name = runGetName();                                              // Run bot's getName function
+   }
 
-   string name = runGetName();                                          // Run bot's getName function
    mClientInfo->setName(getGame()->makeUnique(name.c_str()).c_str());   // Make sure name is unique
 
    mHasSpawned = true;
@@ -279,7 +313,7 @@ void Robot::onAddedToGame(Game *game)
    if(mScriptName == "")
    {
       string scriptName = game->getSettings()->getIniSettings()->defaultRobotScript;
-      mScriptName = GameSettings::getFolderManager()->findBotFile(scriptName);
+      mScriptName = findBotScript(scriptName);
    }
 
    mLuaGame = game;
@@ -297,7 +331,7 @@ void Robot::onAddedToGame(Game *game)
 
    // This needs to run after serverAddClient so the playerInfo is properly
    // filled out for this bot
-   EventManager::get()->fireEvent(this, EventManager::PlayerJoinedEvent, getPlayerInfo());
+   game->getEventManager()->fireEvent(this, EventManager::PlayerJoinedEvent, getPlayerInfo());
 
    Parent::onAddedToGame(game);
 }
@@ -345,9 +379,9 @@ bool Robot::processArguments(S32 argc, const char **argv, Game *game)
          line += argv[i];
       }
 
-      if(GameManager::getServerGame())
+      if(game && game->isServer())
          logprintf(LogConsumer::LogLevelError, "Levelcode error in level %s, line \"%s\":\n\t%s",
-                   GameManager::getServerGame()->getCurrentLevelFileName().c_str(), line.c_str(), errorMessage.c_str());
+                   game->getCurrentLevelFileName().c_str(), line.c_str(), errorMessage.c_str());
       else
          logprintf(LogConsumer::LogLevelError, "Levelcode error, line \"%s\":\n\t%s",
                    line.c_str(), errorMessage.c_str());
@@ -384,10 +418,8 @@ bool Robot::processArguments(S32 argc, const char **argv, Game *game, string &er
    else
       scriptName = game->getSettings()->getIniSettings()->defaultRobotScript;
 
-   FolderManager *folderManager = game->getSettings()->getFolderManager();
-
    if(scriptName != "")
-      mScriptName = folderManager->findBotFile(scriptName);
+      mScriptName = findBotScript(scriptName);
 
    if(mScriptName == "")     // Bot script could not be located
    {
@@ -507,7 +539,8 @@ void Robot::idle(BfObject::IdleCallPath path)
 
       TNLAssert(deltaT != 0, "Time should never be zero!");    
 
-      tickTimer<Robot>(deltaT);
+      if(!mBrain)
+         tickTimer<Robot>(deltaT);
 
       Parent::idle(BfObject::ServerProcessingUpdatesFromClient);   // Let's say the script is the client  ==> really not sure this is right
    }
@@ -529,6 +562,342 @@ void Robot::clearMove()
 }
 
 
+void Robot::think(U32 deltaT)
+{
+   if(mBrain)
+      mBrain->onTick(deltaT);
+}
+
+
+bool Robot::hasBrain() const
+{
+   return mBrain != NULL;
+}
+
+
+// The area findVisibleObjects() and findClosestEnemy() search by default
+Rect Robot::getScannerArea()
+{
+   Point pos = getActualPos();
+   Rect area(pos, pos);
+   area.expand(getGame()->computePlayerVisArea(this));
+
+   return area;
+}
+
+
+// Finds the next point to head for on the way to target.  Note that this function will be called frequently by
+// various robots, so any optimizations will be helpful.
+bool Robot::getWaypoint(const Point &target, Point &waypoint)
+{
+   TNLAssert(getGame()->isServer(), "Not a ServerGame");
+
+   // If we can see the target, go there directly
+   if(canSeePoint(target, true))
+   {
+      flightPlan.clear();
+      waypoint = target;
+      return true;
+   }
+
+   ServerGame *serverGame = static_cast<ServerGame *>(getGame());
+
+   U16 targetZone = serverGame->findZoneContaining(target);    // Where we're going  ===> returns zone id
+
+   if(targetZone == U16_MAX)       // Our target is off the map.  See if it's visible from any of our zones, and, if so, go there
+   {
+      targetZone = findClosestZone(target);
+
+      if(targetZone == U16_MAX)
+         return false;
+   }
+
+   U16 currentZone = getCurrentZone();     // Zone we're in
+
+   if(currentZone == U16_MAX)      // We don't really know where we are... bad news!  Let's find closest visible zone and go that way.
+      currentZone = findClosestZone(getActualPos());
+
+   if(currentZone == U16_MAX)      // That didn't go so well...
+      return false;
+
+   flightPlan.clear();
+
+   // We're in, or on the cusp of, the zone containing our target.  We're close!!
+   if(currentZone == targetZone)
+   {
+      // Keep the zone as our path, so if the target slips into the next zone over we can follow without a search
+      mZonePath.clear();
+      mZonePath.push_back(currentZone);
+
+      // We couldn't see the target, which is possible if we're just on a boundary, and a protrusion's blocking a ship
+      // edge; head for the middle of the zone, from where we should have a clear shot
+      BotNavMeshZone *zone = static_cast<BotNavMeshZone *>(getGame()->getBotZoneDatabase()->getObjectByIndex(targetZone));
+
+      flightPlan.push_back(target);
+      flightPlan.push_back(zone->getCenter());
+
+      waypoint = flightPlan.last();
+      return true;
+   }
+
+   const Vector<BotNavMeshZone *> *zones = serverGame->getBotZones();  // Our pre-cached list of nav zones
+
+   // A target that's moved around a bit, or a bot that's been knocked off course, usually leaves us only a zone
+   // or two away from the path we already have; only when it's no good do we need to find a new one
+   if(!retargetZonePath(zones, currentZone, targetZone))
+   {
+      // Check cache for path first
+      pair<U16,U16> pathIndex = pair<U16,U16>(currentZone, targetZone);
+      map<pair<U16,U16>, Vector<U16> > &cache = getGame()->getGameType()->cachedBotZonePaths;
+      map<pair<U16,U16>, Vector<U16> >::iterator it = cache.find(pathIndex);
+
+      if(it == cache.end())
+      {
+         // Not found so calculate path, and add it to the cache
+         mZonePath = AStar::findZonePath(zones, currentZone, targetZone);
+         cache[pathIndex] = mZonePath;
+      }
+      else
+         mZonePath = it->second;
+
+      mZonePathRetargets = 0;
+   }
+
+   if(mZonePath.size() == 0)
+      return false;           // Out of options, end of the road
+
+   // Now find the shortest way through our zones.  It's cheap enough, with no line-of-sight checks, to work out
+   // afresh every time, so it always runs from exactly where we are to exactly where the target is.
+   AStar::findCorners(zones, mZonePath, getActualPos(), target, flightPlan);
+   flightPlan.reverse();      // Closest point goes at the end, the target at index 0
+
+   // If we're sitting right on a corner, we've made it; head for the next one
+   static const F32 ArrivedDistSq = 1;
+
+   while(flightPlan.size() > 1 && flightPlan.last().distSquared(getActualPos()) < ArrivedDistSq)
+      flightPlan.pop_back();
+
+   waypoint = flightPlan.last();
+   return true;
+}
+
+
+// Brings mZonePath up to date with where we and our target are now by trimming or extending it, so long as neither of
+// us has moved more than a zone off the ends of it.  Returns false if the path will need to be found afresh.
+bool Robot::retargetZonePath(const Vector<BotNavMeshZone *> *zones, U16 currentZone, U16 targetZone)
+{
+   if(mZonePath.size() == 0)
+      return false;
+
+   // Each step we add may take us a little out of our way; after a few, a fresh search will likely find a better route
+   if(mZonePathRetargets >= MaxZonePathRetargets)
+      return false;
+
+   // Drop any zones we've already flown through
+   S32 start = mZonePath.getIndex(currentZone);
+
+   for(S32 i = 0; i < start; i++)
+      mZonePath.erase(0);
+
+   if(start < 0)
+   {
+      // We've strayed off the path -- but if only into the zone next door, we can just step back onto it
+      if(zones->get(currentZone)->getNeighborIndex(mZonePath[0]) < 0)
+         return false;
+
+      mZonePath.push_front(currentZone);
+      mZonePathRetargets++;
+   }
+
+   // Likewise if our target has moved
+   S32 end = mZonePath.getIndex(targetZone);
+
+   if(end >= 0)
+      mZonePath.resize(end + 1);
+
+   else
+   {
+      if(zones->get(mZonePath.last())->getNeighborIndex(targetZone) < 0)
+         return false;
+
+      mZonePath.push_back(targetZone);
+      mZonePathRetargets++;
+   }
+
+   return true;
+}
+
+
+void Robot::setAngle(F32 angle)
+{
+   Move move = getCurrentMove();
+   move.angle = angle;
+   setCurrentMove(move);
+}
+
+
+void Robot::setThrust(F32 speed, F32 angle)
+{
+   Move move = getCurrentMove();
+
+   move.x = speed * cos(angle);
+   move.y = speed * sin(angle);
+
+   setCurrentMove(move);
+}
+
+
+Ship *Robot::findClosestEnemy()
+{
+   fillVector.clear();
+   getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector, getScannerArea());
+
+   return findClosestEnemy(fillVector);
+}
+
+
+Ship *Robot::findClosestEnemy(F32 range)
+{
+   fillVector.clear();
+
+   if(range == -1)
+      getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector);
+   else
+   {
+      Point pos = getActualPos();
+      Rect queryRect(pos, pos);
+      queryRect.expand(Point(range, range));
+
+      getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector, queryRect);
+   }
+
+   return findClosestEnemy(fillVector);
+}
+
+
+// Picks the nearest live, visible enemy out of ships; returns NULL if there isn't one
+Ship *Robot::findClosestEnemy(const Vector<DatabaseObject *> &ships)
+{
+   F32 minDist = F32_MAX;
+   Ship *closest = NULL;
+
+   for(S32 i = 0; i < ships.size(); i++)
+   {
+      // Ignore self 
+      if(ships[i] == this) 
+         continue;
+
+      // Ignore ship/robot if it's dead or cloaked
+      Ship *ship = static_cast<Ship *>(ships[i]);
+      if(ship->mHasExploded || !ship->isVisible(hasModule(ModuleSensor)))
+         continue;
+
+      // Ignore ships on same team during team games
+      if(ship->getTeam() == getTeam() && getGame()->getGameType()->isTeamGame())
+         continue;
+
+      F32 dist = ship->getActualPos().distSquared(getActualPos());
+      if(dist < minDist)
+      {
+         minDist = dist;
+         closest = ship;
+      }
+   }
+
+   return closest;
+}
+
+
+// Fills found with objects of the given types within scanner range, leaving out this bot and any ships it can't see
+void Robot::findVisibleObjects(const Vector<U8> &types, Vector<DatabaseObject *> &found)
+{
+   Rect queryRect = getScannerArea();
+
+   static Vector<U8> objectTypes;
+   objectTypes.clear();
+
+   found.clear();
+
+   for(S32 i = 0; i < types.size(); i++)
+   {
+      // Requests for botzones have to be handled separately; not a problem, we'll just do the search here, and add them to
+      // found, where they'll be merged with the rest of our search results.
+      if(types[i] != BotNavMeshZoneTypeNumber)
+         objectTypes.push_back(types[i]);
+      else
+         getGame()->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, found, queryRect);
+   }
+
+   // Get other objects on screen-visible area only
+   getGame()->getGameObjDatabase()->findObjects(objectTypes, found, queryRect);
+
+   bool hasSensor = hasModule(ModuleSensor);
+   S32 visibleCount = 0;
+
+   for(S32 i = 0; i < found.size(); i++)
+   {
+      if(isShipType(found[i]->getObjectTypeNumber()))
+      {
+         if(found[i] == this)  // Don't add this bot to the list of found objects!
+            continue;
+
+         // Ignore ship/robot if it's dead or cloaked (unless bot has sensor)
+         Ship *ship = static_cast<Ship *>(found[i]);
+         if(!ship->isVisible(hasSensor) || ship->mHasExploded)
+            continue;
+      }
+
+      found[visibleCount] = found[i];
+      visibleCount++;
+   }
+
+   found.resize(visibleCount);
+}
+
+
+bool Robot::hasWeapon(WeaponType weapon)
+{
+   for(S32 i = 0; i < ShipWeaponCount; i++)
+      if(mLoadout.getWeapon(i) == weapon)
+         return true;      // We have it!
+
+   return false;           // We don't!
+}
+
+
+bool Robot::fireWeapon(WeaponType weapon)
+{
+   // Check the weapons we have on board -- if any match the requested weapon, select it and fire!
+   for(S32 i = 0; i < ShipWeaponCount; i++)
+      if(mLoadout.getWeapon(i) == weapon)
+      {
+         selectWeapon(i);
+
+         Move move = getCurrentMove();
+         move.fire = true;
+         setCurrentMove(move);
+
+         return true;
+      }
+
+   return false;
+}
+
+
+bool Robot::fireModule(ShipModule module)
+{
+   // Check if module is equipped and fire it
+   for(S32 i = 0; i < ShipModuleCount; i++)
+      if(getModule(i) == module)
+      {
+         mCurrentMove.modulePrimary[i] = true;
+         return true;
+      }
+
+   return false;
+}
+
+
 bool Robot::isRobot()
 {
    return true;
@@ -549,7 +918,10 @@ const char *Robot::getScriptName()
 
 Robot *Robot::clone() const
 {
-   return new Robot(*this);
+   Robot *robot = new Robot(*this);
+   robot->mBrain = NULL;      // Brains aren't shared; the clone gets its own when it starts
+
+   return robot;
 }
 
 
@@ -666,18 +1038,15 @@ S32 Robot::lua_setAngle(lua_State *L)
 {
    S32 profile = checkArgList(L, functionArgs, "Robot", "setAngle");
 
-   Move move = getCurrentMove();
-
    if(profile == 0)        // Args: PT    ==> Aim towards point
    {
       Point point = getPointOrXY(L, 1);
-      move.angle = getAnglePt(point);
+      setAngle(getAnglePt(point));
    }
 
    else if(profile == 1)   // Args: NUM   ==> Aim at this angle (radians)
-      move.angle = getFloat(L, 1);
+      setAngle(getFloat(L, 1));
 
-   setCurrentMove(move);
    return 0;
 }
 
@@ -735,133 +1104,16 @@ S32 Robot::lua_canSeePoint(lua_State *L)
  * @return The next point to head towards, or `nil` if no path can be found
  */
 
-// Note that this function will be called frequently by various robots, so any
-// optimizations will be helpful.
 S32 Robot::lua_getWaypoint(lua_State *L)
 {
-   TNLAssert(getGame()->isServer(), "Not a ServerGame");
-
    checkArgList(L, functionArgs, "Robot", "getWaypoint");
 
-   Point target = getPointOrXY(L, 1);
-
-   // If we can see the target, go there directly
-   if(canSeePoint(target, true))
-   {
-      flightPlan.clear();
-      return returnPoint(L, target);
-   }
-
-   // TODO: cache destination point; if it hasn't moved, then skip ahead.
-
-   U16 targetZone = static_cast<ServerGame *>(getGame())->findZoneContaining(target); // Where we're going  ===> returns zone id
-
-   if(targetZone == U16_MAX)       // Our target is off the map.  See if it's visible from any of our zones, and, if so, go there
-   {
-      targetZone = findClosestZone(target);
-
-      if(targetZone == U16_MAX)
-         return returnNil(L);
-   }
-
-   // Make sure target is still in the same zone it was in when we created our flightplan.
-   // If we're not, our flightplan is invalid, and we need to skip forward and build a fresh one.
-   if(flightPlan.size() > 0 && targetZone == flightPlanTo)
-   {
-      // In case our target has moved, replace final point of our flightplan with the current target location
-      flightPlan[0] = target;
-
-      // First, let's scan through our pre-calculated waypoints and see if we can see any of them.
-      // If so, we'll just head there with no further rigamarole.  Remember that our flightplan is
-      // arranged so the closest points are at the end of the list, and the target is at index 0.
-      Point dest;
-      bool found = false;
-//      bool first = true;
-
-      while(flightPlan.size() > 0)
-      {
-         Point last = flightPlan.last();
-
-         // We'll assume that if we could see the point on the previous turn, we can
-         // still see it, even though in some cases, the turning of the ship around a
-         // protruding corner may make it technically not visible.  This will prevent
-         // rapidfire recalcuation of the path when it's not really necessary.
-
-         // removed if(first) ... Problems with Robot get stuck after pushed from burst or mines.
-         // To save calculations, might want to avoid (canSeePoint(last))
-         if(canSeePoint(last, true))
-         {
-            dest = last;
-            found = true;
-//            first = false;
-            flightPlan.pop_back();   // Discard now possibly superfluous waypoint
-         }
-         else
-            break;
-      }
-
-      // If we found one, that means we found a visible waypoint, and we can head there...
-      if(found)
-      {
-         flightPlan.push_back(dest);    // Put dest back at the end of the flightplan
-         return returnPoint(L, dest);
-      }
-   }
-
-   // We need to calculate a new flightplan
-   flightPlan.clear();
-
-   U16 currentZone = getCurrentZone();     // Zone we're in
-
-   if(currentZone == U16_MAX)      // We don't really know where we are... bad news!  Let's find closest visible zone and go that way.
-      currentZone = findClosestZone(getActualPos());
-
-   if(currentZone == U16_MAX)      // That didn't go so well...
-      return returnNil(L);
-
-   // We're in, or on the cusp of, the zone containing our target.  We're close!!
-   if(currentZone == targetZone)
-   {
-      Point p;
-      flightPlan.push_back(target);
-
-      if(!canSeePoint(target, true))           // Possible, if we're just on a boundary, and a protrusion's blocking a ship edge
-      {
-         BotNavMeshZone *zone = static_cast<BotNavMeshZone *>(getGame()->getBotZoneDatabase()->getObjectByIndex(targetZone));
-
-         p = zone->getCenter();
-         flightPlan.push_back(p);
-      }
-      else
-         p = target;
-
-      return returnPoint(L, p);
-   }
-
-   // If we're still here, then we need to find a new path.  Either our original path was invalid for some reason,
-   // or the path we had no longer applied to our current location
-   flightPlanTo = targetZone;
+   Point waypoint;
 
-   // check cache for path first
-   pair<S32,S32> pathIndex = pair<S32,S32>(currentZone, targetZone);
+   if(getWaypoint(getPointOrXY(L, 1), waypoint))
+      return returnPoint(L, waypoint);
 
-   const Vector<BotNavMeshZone *> *zones = static_cast<ServerGame *>(getGame())->getBotZones();  // Our pre-cached list of nav zones
-
-   if(getGame()->getGameType()->cachedBotFlightPlans.find(pathIndex) == getGame()->getGameType()->cachedBotFlightPlans.end())
-   {
-      // Not found so calculate flight plan
-      flightPlan = AStar::findPath(zones, currentZone, targetZone, target);
-
-      // Add to cache
-      getGame()->getGameType()->cachedBotFlightPlans[pathIndex] = flightPlan;
-   }
-   else
-      flightPlan = getGame()->getGameType()->cachedBotFlightPlans[pathIndex];
-
-   if(flightPlan.size() > 0)
-      return returnPoint(L, flightPlan.last());
-   else
-      return returnNil(L);    // Out of options, end of the road
+   return returnNil(L);
 }
 
 
@@ -885,54 +1137,12 @@ S32 Robot::lua_findClosestEnemy(lua_State *L)
 {
    S32 profile = checkArgList(L, functionArgs, "Robot", "findClosestEnemy");
 
-   Point pos = getActualPos();
-   Rect queryRect(pos, pos);
-   bool useRange = true;
+   Ship *closest;
 
    if(profile == 0)           // Args: None
-      queryRect.expand(getGame()->computePlayerVisArea(this));  
+      closest = findClosestEnemy();
    else                       // Args: Range
-   {
-      F32 range = getFloat(L, 1);
-      if(range == -1)
-         useRange = false;
-        else
-         queryRect.expand(Point(range, range));
-   }
-
-
-   F32 minDist = F32_MAX;
-   Ship *closest = NULL;
-
-   fillVector.clear();
-
-   if(useRange)
-      getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector, queryRect);   
-   else
-      getGame()->getGameObjDatabase()->findObjects((TestFunc)isShipType, fillVector);   
-
-   for(S32 i = 0; i < fillVector.size(); i++)
-   {
-      // Ignore self 
-      if(fillVector[i] == this) 
-         continue;
-
-      // Ignore ship/robot if it's dead or cloaked
-      Ship *ship = static_cast<Ship *>(fillVector[i]);
-      if(ship->mHasExploded || !ship->isVisible(hasModule(ModuleSensor)))
-         continue;
-
-      // Ignore ships on same team during team games
-      if(ship->getTeam() == getTeam() && getGame()->getGameType()->isTeamGame())
-         continue;
-
-      F32 dist = ship->getActualPos().distSquared(getActualPos());
-      if(dist < minDist)
-      {
-         minDist = dist;
-         closest = ship;
-      }
-   }
+      closest = findClosestEnemy(getFloat(L, 1));
 
    return returnShip(L, closest);    // Handles closest == NULL
 }
@@ -972,12 +1182,7 @@ S32 Robot::lua_setThrust(lua_State *L)
       ang = getAnglePt(point) - 0 * FloatHalfPi;
    }
 
-   Move move = getCurrentMove();
-
-   move.x = vel * cos(ang);
-   move.y = vel * sin(ang);
-
-   setCurrentMove(move);
+   setThrust(vel, ang);
 
    return 0;
 }
@@ -1028,25 +1233,8 @@ S32 Robot::lua_fireWeapon(lua_State *L)
    checkArgList(L, functionArgs, luaClassName, "fireWeapon");
 
    WeaponType weapon = getWeaponType(L, 1);
-   bool hasWeapon = false;
 
-   // Check the weapons we have on board -- if any match the requested weapon, select it
-   for(S32 i = 0; i < ShipWeaponCount; i++)
-      if(mLoadout.getWeapon(i) == weapon)
-      {
-         hasWeapon = true;
-         selectWeapon(i);
-         break;
-      }
-
-   // If weapon was equipped, fire!
-   if(hasWeapon)
-   {
-      Move move = getCurrentMove();
-      move.fire = true;
-      setCurrentMove(move);
-   }
-   else
+   if(!fireWeapon(weapon))
       THROW_LUA_EXCEPTION(L, "The weapon given to bot:fireWeapon(weapon) is not equipped!");
 
    return 0;
@@ -1067,11 +1255,7 @@ S32 Robot::lua_hasWeapon(lua_State *L)
    checkArgList(L, functionArgs, "Robot", "hasWeapon");
    WeaponType weap = getWeaponType(L, 1);
 
-   for(S32 i = 0; i < ShipWeaponCount; i++)
-      if(mLoadout.getWeapon(i) == weap)
-         return returnBool(L, true);      // We have it!
-
-   return returnBool(L, false);           // We don't!
+   return returnBool(L, hasWeapon(weap));
 }
 
 
@@ -1088,18 +1272,7 @@ S32 Robot::lua_fireModule(lua_State *L)
 
    ShipModule module = getShipModule(L, 1);
 
-   bool hasModule = false;
-
-   // Check if module is equipped and fire it
-   for(S32 i = 0; i < ShipModuleCount; i++)
-      if(getModule(i) == module)
-      {
-         hasModule = true;
-         mCurrentMove.modulePrimary[i] = true;
-         break;
-      }
-
-   if(!hasModule)
+   if(!fireModule(module))
       THROW_LUA_EXCEPTION(L, "The module given to bot:fireModule(module) is not equipped!");
 
    return 0;
@@ -1208,7 +1381,7 @@ S32 Robot::lua_globalMsg(lua_State *L)
       lua_pop(L, 1);
 
       // Fire our event handler
-      EventManager::get()->fireEvent(this, EventManager::MsgReceivedEvent, message, getPlayerInfo(), true);
+      getGame()->getEventManager()->fireEvent(this, EventManager::MsgReceivedEvent, message, getPlayerInfo(), true);
    }
 
    return 0;
@@ -1238,7 +1411,7 @@ S32 Robot::lua_teamMsg(lua_State *L)
       lua_pop(L, 1);
 
       // Fire our event handler
-      EventManager::get()->fireEvent(this, EventManager::MsgReceivedEvent, message, getPlayerInfo(), false);
+      getGame()->getEventManager()->fireEvent(this, EventManager::MsgReceivedEvent, message, getPlayerInfo(), false);
    }
 
    return 0;
@@ -1297,11 +1470,6 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
 {
    checkArgList(L, functionArgs, "Robot", "findVisibleObjects");
 
-   Point pos = getActualPos();
-   Rect queryRect(pos, pos);
-   queryRect.expand(getGame()->computePlayerVisArea(this));
-
-   fillVector.clear();
    static Vector<U8> types;
 
    types.clear();
@@ -1313,20 +1481,11 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
    // is empty at that point, we'll add a table.
    while(lua_gettop(L) > 0 && lua_isnumber(L, -1))
    {
-      U8 typenum = (U8)lua_tointeger(L, -1);
-
-      // Requests for botzones have to be handled separately; not a problem, we'll just do the search here, and add them to
-      // fillVector, where they'll be merged with the rest of our search results.
-      if(typenum != BotNavMeshZoneTypeNumber)
-         types.push_back(typenum);
-      else
-         getGame()->getBotZoneDatabase()->findObjects(BotNavMeshZoneTypeNumber, fillVector, queryRect);
-
+      types.push_back((U8)lua_tointeger(L, -1));
       lua_pop(L, 1);
    }
 
-   // Get other objects on screen-visible area only
-   getGame()->getGameObjDatabase()->findObjects(types, fillVector, queryRect);
+   findVisibleObjects(types, fillVector);
 
 
    // We are expecting a table to be on top of the stack when we get here.  If not, we can add one.
@@ -1345,25 +1504,10 @@ S32 Robot::lua_findVisibleObjects(lua_State *L)
    TNLAssert((lua_gettop(L) == 1 && lua_istable(L, -1)) || dumpStack(L), "Should only have table!");
 
 
-   S32 pushed = 0;      // Count of items we put into our table
-
    for(S32 i = 0; i < fillVector.size(); i++)
    {
-      if(isShipType(fillVector[i]->getObjectTypeNumber()))
-      {
-         if(fillVector[i] == this)  // Don't add this bot to the list of found objects!
-            continue;
-
-         // Ignore ship/robot if it's dead or cloaked (unless bot has sensor)
-         Ship *ship = static_cast<Ship *>(fillVector[i]);
-         bool callerHasSensor = this->hasModule(ModuleSensor);
-         if(!ship->isVisible(callerHasSensor) || ship->mHasExploded)
-            continue;
-      }
-
       static_cast<BfObject *>(fillVector[i])->push(L);
-      pushed++;      // Increment pushed before using it because Lua uses 1-based arrays
-      lua_rawseti(L, 1, pushed);
+      lua_rawseti(L, 1, i + 1);     // Lua uses 1-based arrays
    }
 
    TNLAssert(lua_gettop(L) == 1 || dumpStack(L), "Stack has unexpected items on it!");
@@ -1436,6 +1580,16 @@ static bool calcInterceptCourse(BfObject *target, Point aimPos, F32 aimRadius, S
 }
 
 
+// Angle to fire the active weapon at to hit target.  Note that this WILL fire at teammates!
+bool Robot::getFiringSolution(BfObject *target, F32 &angle)
+{
+   WeaponInfo weap = WeaponInfo::getWeaponInfo(mLoadout.getActiveWeapon());    // Robot's active weapon
+
+   return calcInterceptCourse(target, getActualPos(), getRadius(), getTeam(), (F32)weap.projVelocity, 
+                              (F32)weap.projLiveTime, false, hasModule(ModuleSensor), angle);
+}
+
+
 /**
  * @luafunc num Robot::getFiringSolution(BfObject obj)
  *
@@ -1454,12 +1608,9 @@ S32 Robot::lua_getFiringSolution(lua_State *L)
 
    BfObject *target = luaW_check<BfObject>(L, 1);
 
-   WeaponInfo weap = WeaponInfo::getWeaponInfo(mLoadout.getActiveWeapon());    // Robot's active weapon
-
    F32 interceptAngle;
 
-   if(calcInterceptCourse(target, getActualPos(), getRadius(), getTeam(), (F32)weap.projVelocity, 
-                          (F32)weap.projLiveTime, false, hasModule(ModuleSensor), interceptAngle))
+   if(getFiringSolution(target, interceptAngle))
       return returnFloat(L, interceptAngle);
 
    return returnNil(L);
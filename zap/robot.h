@@ -14,6 +14,8 @@ namespace Zap
 
 class MoveItem;
 class ServerGame;
+class RobotBrain;
+class BotNavMeshZone;
 
 /**
  * This is the wrapper around the C++ object found in object.cc
@@ -34,12 +36,24 @@ private:
 
    U16 mCurrentZone;                // Zone robot is currently in
 
+   // Zones from the one we're in to our target's, which our flightPlan threads its way through.  As we and our target
+   // move, we trim it and add to it rather than searching for a new one, up to MaxZonePathRetargets times.
+   static const S32 MaxZonePathRetargets = 8;
+   Vector<U16> mZonePath;
+   S32 mZonePathRetargets;
+
    LuaPlayerInfo *mPlayerInfo;      // Player info object describing the robot
 
    bool mHasSpawned;
 
+   RobotBrain *mBrain;              // Does our thinking when we run native code instead of a script; NULL for scripted bots
+
+   Rect getScannerArea();
+
    Point getNextWaypoint();                          // Helper function for getWaypoint()
    U16 findClosestZone(const Point &point);          // Finds zone closest to point, used when robots get off the map
+   bool retargetZonePath(const Vector<BotNavMeshZone *> *zones, U16 currentZone, U16 targetZone);  // Helper for getWaypoint()
+   Ship *findClosestEnemy(const Vector<DatabaseObject *> &ships);   // Helper for findClosestEnemy()
 
 protected:
    void killScript();
@@ -63,8 +77,7 @@ public:
    void setCurrentZone(S32 zone);
    bool canSeePoint(Point point, bool wallOnly = false);         // Is point within robot's LOS?
 
-   Vector<Point> flightPlan;           // List of points to get from one point to another
-   U16 flightPlanTo;                   // Zone our flightplan was calculated to
+   Vector<Point> flightPlan;           // List of points to get from one point to another, target first
 
    // Some informational functions
    F32 getAnglePt(Point point);
@@ -80,6 +93,21 @@ public:
    string runGetName();                // Run bot's getName() function
 
    void clearMove();                   // Reset bot's move to do nothing
+   void think(U32 deltaT);             // Let a native brain have its turn; scripted bots think in their TickEvent handler
+
+   bool hasBrain() const;
+
+   // What scripts can do through the bot, for brains that live in C++; the Lua methods below are built on these
+   void setAngle(F32 angle);
+   void setThrust(F32 speed, F32 angle);
+   bool getWaypoint(const Point &target, Point &waypoint);     // False if there's no way to get there
+   Ship *findClosestEnemy();                                   // Looks within scanner range
+   Ship *findClosestEnemy(F32 range);                          // Range of -1 searches the whole map
+   void findVisibleObjects(const Vector<U8> &types, Vector<DatabaseObject *> &found);
+   bool getFiringSolution(BfObject *target, F32 &angle);       // False if there's no shot
+   bool hasWeapon(WeaponType weapon);
+   bool fireWeapon(WeaponType weapon);                         // False if weapon isn't equipped
+   bool fireModule(ShipModule module);                         // False if module isn't equipped
 
 
    const char *getScriptName();
@@ -1391,8 +1391,7 @@ U32 Ship::packUpdate(GhostConnection *connection, U32 updateMask, BitStream *str
          // Send position and speed  ==> use renderPos because that is the server's best guess of where a client-controlled
          //                              ship is at any given moment, even if the server hasn't heard from the client for
          //                              dseveral frames due to network delays.
-         gameConnection->writeCompressedPoint(getRenderPos(), stream);
-         writeCompressedVelocity(getRenderVel(), BoostMaxVelocity + 1, stream);
+         writePositionAndVelocity(connection, getRenderPos(), getRenderVel(), BoostMaxVelocity + 1, stream);
       }
       if(stream->writeFlag(updateMask & MoveMask))             // <=== TWO
          mCurrentMove.pack(stream, NULL, false);               // Send current move
@@ -1571,12 +1570,10 @@ void Ship::unpackUpdate(GhostConnection *connection, BitStream *stream)
 
    if(stream->readFlag())     // UpdateMask
    {
-      Point p;
-      ((GameConnection *) connection)->readCompressedPoint(p, stream);
+      Point p, vel;
+      readPositionAndVelocity(connection, p, vel, BoostMaxVelocity + 1, stream);
       Parent::setActualPos(p);
-
-      readCompressedVelocity(p, BoostMaxVelocity + 1, stream);
-      Parent::setActualVel(p);
+      Parent::setActualVel(vel);
       positionChanged = true;
    }
 
@@ -1874,13 +1871,13 @@ ShipModule Ship::getModule(U32 modIndex)
 
 void Ship::onEnteredZone(Zone *zone)
 {
-   EventManager::get()->fireEvent(EventManager::ShipEnteredZoneEvent, this, zone);
+   getGame()->getEventManager()->fireEvent(EventManager::ShipEnteredZoneEvent, this, zone);
 }
 
 
 void Ship::onLeftZone(Zone *zone)
 {
-   EventManager::get()->fireEvent(EventManager::ShipLeftZoneEvent, this, zone);
+   getGame()->getEventManager()->fireEvent(EventManager::ShipLeftZoneEvent, this, zone);
 }
 
 
@@ -1896,7 +1893,7 @@ void Ship::killAndScore(DamageInfo *theInfo)
    BfObject *shooter = WeaponInfo::getWeaponShooterFromObject(theInfo->damagingObject);
 
    // Fire ShipKilled event
-   EventManager::get()->fireEvent(EventManager::ShipKilledEvent,
+   getGame()->getEventManager()->fireEvent(EventManager::ShipKilledEvent,
          this, theInfo->damagingObject, shooter);
 
    kill();
@@ -1917,7 +1914,7 @@ void Ship::kill()
       getZonesObjectIsIn(zoneList);
    
       for(S32 i = 0; i < zoneList.size(); i++)
-         EventManager::get()->fireEvent(EventManager::ShipLeftZoneEvent, this, static_cast<Zone *>(zoneList[i].getPointer()));
+         getGame()->getEventManager()->fireEvent(EventManager::ShipLeftZoneEvent, this, static_cast<Zone *>(zoneList[i].getPointer()));
    }
 
    // Client and server
@@ -499,6 +499,21 @@ bool makeSureFolderExists(const string &folder)
 }
 
 
+// Last modified time (in seconds) and size of a file, which between them are a cheap way of telling if it's changed
+bool getFileStamp(const string &path, S64 &modifiedTime, S64 &size)
+{
+   struct stat st;
+
+   if(stat(path.c_str(), &st) != 0)
+      return false;
+
+   modifiedTime = (S64)st.st_mtime;
+   size = (S64)st.st_size;
+
+   return true;
+}
+
+
 // Read files from folder
 bool getFilesFromFolder(const string &dir, Vector<string> &files, const string extensions[], S32 extensionCount)
 {
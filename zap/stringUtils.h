@@ -89,6 +89,7 @@ bool caseInsensitiveStringCompare(const string &str1, const string &str2);
 string getFileSeparator();
 bool fileExists(const string &path);               // Does file exist?
 bool makeSureFolderExists(const string &dir);      // Like the man said: Make sure folder exists
+bool getFileStamp(const string &path, S64 &modifiedTime, S64 &size);    // False if file doesn't exist
 bool getFilesFromFolder(const string &dir, Vector<string> &files, const string extensions[] = 0, S32 extensionCount = 0);
 bool safeFilename(const char *str);
 bool copyFile(const string &sourceFilename, const string &destFilename);
@@ -315,6 +315,20 @@ S32 Team::lua_getScore(lua_State *L)
 }
 
 
+// Teams don't know which game they belong to, and a dedicated server may be hosting several, so go and look
+static ServerGame *findServerGame(const Team *team)
+{
+   const Vector<ServerGame *> *serverGames = GameManager::getServerGames();
+
+   for(S32 i = 0; i < serverGames->size(); i++)
+      for(S32 j = 0; j < serverGames->get(i)->getTeamCount(); j++)
+         if(serverGames->get(i)->getTeam(j) == team)
+            return serverGames->get(i);
+
+   return GameManager::getServerGame();
+}
+
+
 /**
  * @luafunc int Team::getPlayerCount()
  *
@@ -324,7 +338,7 @@ S32 Team::lua_getScore(lua_State *L)
  */
 S32 Team::lua_getPlayerCount(lua_State *L)
 {
-   GameManager::getServerGame()->countTeamPlayers();    // Make sure player counts are up-to-date
+   findServerGame(this)->countTeamPlayers();    // Make sure player counts are up-to-date
    return returnInt(L, mPlayerCount);
 }
 
@@ -346,7 +360,7 @@ S32 Team::lua_getPlayerCount(lua_State *L)
  */
 S32 Team::lua_getPlayers(lua_State *L)
 {
-   ServerGame *game = GameManager::getServerGame();
+   ServerGame *game = findServerGame(this);
 
    TNLAssert(game->getPlayerCount() == game->getClientCount(), "Mismatched player counts!");
 